@@ -0,0 +1,110 @@
+/* BEGIN Header */
+/**
+ ******************************************************************************
+ * \file            bench_LPHashTableBatch.c
+ * \author          Andrea Vivani
+ * \brief           Benchmark of batched vs per-key hash-table lookups
+ ******************************************************************************
+ * \copyright
+ *
+ * Copyright 2024 Andrea Vivani
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the “Software”), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ ******************************************************************************
+ */
+/* END Header */
+
+/* Includes ------------------------------------------------------------------*/
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "LPHashTable.h"
+
+/* Macros --------------------------------------------------------------------*/
+
+#define BENCH_MIN_TIME_S 0.2
+#define BENCH_LOOKUPS    4096
+#define BENCH_KEY_LEN    16
+
+/* Private Functions ---------------------------------------------------------*/
+
+static double benchNow(void) {
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static uint32_t benchRand(uint32_t* seed) {
+    *seed = *seed * 1664525u + 1013904223u;
+    return *seed >> 8;
+}
+
+/* Functions -----------------------------------------------------------------*/
+
+int main(void) {
+    static const uint32_t sizes[] = {1u << 12, 1u << 16, 1u << 20, 1u << 22};
+    static char* lookupKeys[BENCH_LOOKUPS];
+    static uint64_t values[BENCH_LOOKUPS];
+    uint32_t seed = 12345;
+
+    printf("slots,items,lookups,lpHashTableGet_ns,lpHashTableGetBatch_ns,speedup\n");
+    for (size_t ii = 0; ii < sizeof(sizes) / sizeof(sizes[0]); ii++) {
+        lpHashTable_t lpht;
+        uint32_t items = sizes[ii] / 10 * 7;
+        char* keys = malloc((size_t)items * BENCH_KEY_LEN);
+        if ((keys == NULL) || (lpHashTableInit(&lpht, sizeof(uint64_t), sizes[ii], LPHT_NOT_RESIZABLE) != UTILS_STATUS_SUCCESS)) {
+            return 1;
+        }
+        for (uint32_t jj = 0; jj < items; jj++) {
+            uint64_t value = jj;
+            snprintf(keys + (size_t)jj * BENCH_KEY_LEN, BENCH_KEY_LEN, "key%u", jj);
+            lpHashTablePut(&lpht, keys + (size_t)jj * BENCH_KEY_LEN, &value);
+        }
+        for (uint32_t jj = 0; jj < BENCH_LOOKUPS; jj++) {
+            lookupKeys[jj] = keys + (size_t)(benchRand(&seed) % items) * BENCH_KEY_LEN;
+        }
+
+        uint32_t iters = 0;
+        double start = benchNow(), tLoop, tBatch;
+        do {
+            for (uint32_t jj = 0; jj < BENCH_LOOKUPS; jj++) {
+                lpHashTableGet(&lpht, lookupKeys[jj], &values[jj], LPHT_DO_NOT_REMOVE_ITEM);
+            }
+            iters++;
+        } while ((tLoop = benchNow() - start) < BENCH_MIN_TIME_S);
+        tLoop /= (double)iters * BENCH_LOOKUPS;
+
+        iters = 0;
+        start = benchNow();
+        do {
+            lpHashTableGetBatch(&lpht, lookupKeys, BENCH_LOOKUPS, values, NULL);
+            iters++;
+        } while ((tBatch = benchNow() - start) < BENCH_MIN_TIME_S);
+        tBatch /= (double)iters * BENCH_LOOKUPS;
+
+        printf("%u,%u,%u,%.1f,%.1f,%.2f\n", sizes[ii], items, BENCH_LOOKUPS, tLoop * 1e9, tBatch * 1e9, tLoop / tBatch);
+        lpHashTableDelete(&lpht);
+        free(keys);
+    }
+    return 0;
+}
@@ -0,0 +1,123 @@
+/* BEGIN Header */
+/**
+ ******************************************************************************
+ * \file            bench_LinSolveBatch.c
+ * \author          Andrea Vivani
+ * \brief           Benchmark of batched vs per-system linear system solvers
+ ******************************************************************************
+ * \copyright
+ *
+ * Copyright 2024 Andrea Vivani
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the “Software”), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ ******************************************************************************
+ */
+/* END Header */
+
+/* Includes ------------------------------------------------------------------*/
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "numMethods.h"
+
+/* Macros --------------------------------------------------------------------*/
+
+#define BENCH_MIN_TIME_S 0.2
+#define BENCH_SYSTEMS    512
+
+/* Private Functions ---------------------------------------------------------*/
+
+static double benchNow(void) {
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static float benchRand(uint32_t* seed) {
+    *seed = *seed * 1664525u + 1013904223u;
+    return (float)(*seed >> 8) / (float)(1u << 24) * 2.0f - 1.0f;
+}
+
+/* Functions -----------------------------------------------------------------*/
+
+int main(void) {
+    static const uint8_t sizes[] = {3, 4, 6, 8};
+    static float A_aos[BENCH_SYSTEMS][64], B_aos[BENCH_SYSTEMS][8], X_aos[BENCH_SYSTEMS][8];
+    static float A_soa[64 * BENCH_SYSTEMS], B_soa[8 * BENCH_SYSTEMS], A_work[64 * BENCH_SYSTEMS];
+    uint32_t seed = 12345;
+
+    printf("n,systems,LinSolveLUStatic_us,LinSolveLUPBatch_us,speedup,max_abs_err\n");
+    for (size_t ii = 0; ii < sizeof(sizes) / sizeof(sizes[0]); ii++) {
+        uint8_t n = sizes[ii];
+        for (uint16_t ss = 0; ss < BENCH_SYSTEMS; ss++) {
+            for (uint16_t jj = 0; jj < n * n; jj++) {
+                /* Diagonally dominant, so that pivot-free LU of LinSolveLUStatic is accurate */
+                A_aos[ss][jj] = benchRand(&seed) + ((jj % (n + 1)) == 0 ? (float)n : 0.0f);
+                A_soa[jj * BENCH_SYSTEMS + ss] = A_aos[ss][jj];
+            }
+            for (uint16_t jj = 0; jj < n; jj++) {
+                B_aos[ss][jj] = benchRand(&seed);
+            }
+        }
+
+        uint32_t iters = 0;
+        double start = benchNow(), tLoop, tBatch;
+        do {
+            for (uint16_t ss = 0; ss < BENCH_SYSTEMS; ss++) {
+                matrix_t A, B, X;
+                matrixInitStatic(&A, A_aos[ss], n, n);
+                matrixInitStatic(&B, B_aos[ss], n, 1);
+                matrixInitStatic(&X, X_aos[ss], n, 1);
+                LinSolveLUStatic(&A, &B, &X);
+            }
+            iters++;
+        } while ((tLoop = benchNow() - start) < BENCH_MIN_TIME_S);
+        tLoop /= iters;
+
+        /* Batched solver works in place, so copy the inputs as part of the measured time */
+        iters = 0;
+        start = benchNow();
+        do {
+            memcpy(A_work, A_soa, (size_t)n * n * BENCH_SYSTEMS * sizeof(float));
+            for (uint16_t ss = 0; ss < BENCH_SYSTEMS; ss++) {
+                for (uint16_t jj = 0; jj < n; jj++) {
+                    B_soa[jj * BENCH_SYSTEMS + ss] = B_aos[ss][jj];
+                }
+            }
+            LinSolveLUPBatch(A_work, B_soa, n, 1, BENCH_SYSTEMS, NULL);
+            iters++;
+        } while ((tBatch = benchNow() - start) < BENCH_MIN_TIME_S);
+        tBatch /= iters;
+
+        float err = 0.0f;
+        for (uint16_t ss = 0; ss < BENCH_SYSTEMS; ss++) {
+            for (uint16_t jj = 0; jj < n; jj++) {
+                float diff = X_aos[ss][jj] - B_soa[jj * BENCH_SYSTEMS + ss];
+                diff = diff < 0.0f ? -diff : diff;
+                err = diff > err ? diff : err;
+            }
+        }
+        printf("%u,%u,%.1f,%.1f,%.2f,%.3g\n", n, BENCH_SYSTEMS, tLoop * 1e6, tBatch * 1e6, tLoop / tBatch, err);
+    }
+    return 0;
+}
@@ -0,0 +1,162 @@
+/* BEGIN Header */
+/**
+ ******************************************************************************
+ * \file            bench_RCHashTableReaders.c
+ * \author          Andrea Vivani
+ * \brief           Benchmark of concurrent readers throughput, lock-free vs reader-writer locked hash-tables
+ ******************************************************************************
+ * \copyright
+ *
+ * Copyright 2024 Andrea Vivani
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the “Software”), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ ******************************************************************************
+ */
+/* END Header */
+
+/* Includes ------------------------------------------------------------------*/
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "RCHashTable.h"
+#include "SHHashTable.h"
+
+/* Macros --------------------------------------------------------------------*/
+
+#define BENCH_TIME_S      0.3
+#define BENCH_ITEMS       4096
+#define BENCH_KEY_LEN     16
+#define BENCH_MAX_THREADS 16
+#define BENCH_SHARD_BITS  4
+
+/* Typedefs ------------------------------------------------------------------*/
+
+typedef struct {
+    rcHashTable_t* rcht;
+    shHashTable_t* shht;
+    char* keys;
+    atomic_int* stop;
+    uint32_t seed;
+    uint64_t lookups;
+} benchArgs_t;
+
+/* Private Functions ---------------------------------------------------------*/
+
+static double benchNow(void) {
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static uint32_t benchRand(uint32_t* seed) {
+    *seed = *seed * 1664525u + 1013904223u;
+    return *seed >> 8;
+}
+
+static void* benchReader(void* arg) {
+    benchArgs_t* args = (benchArgs_t*)arg;
+    rcHashTableReader_t* reader = NULL;
+    uint32_t seed = args->seed;
+    uint64_t lookups = 0;
+    uint64_t value;
+
+    /* seed and lookups are kept in locals and written back once, args of neighbouring threads share cache lines */
+    if ((args->rcht != NULL) && (rcHashTableReaderRegister(args->rcht, &reader) != UTILS_STATUS_SUCCESS)) {
+        return NULL;
+    }
+    while (!atomic_load_explicit(args->stop, memory_order_relaxed)) {
+        for (uint32_t ii = 0; ii < 256; ii++) {
+            char* key = args->keys + (size_t)(benchRand(&seed) % BENCH_ITEMS) * BENCH_KEY_LEN;
+            if (args->rcht != NULL) {
+                rcHashTableGet(args->rcht, reader, key, &value, RCHT_DO_NOT_REMOVE_ITEM);
+            } else {
+                shHashTableGet(args->shht, key, &value, SHHT_DO_NOT_REMOVE_ITEM);
+            }
+        }
+        lookups += 256;
+    }
+    if (reader != NULL) {
+        rcHashTableReaderUnregister(args->rcht, reader);
+    }
+    args->seed = seed;
+    args->lookups = lookups;
+    return NULL;
+}
+
+/* Run threadsNum readers for BENCH_TIME_S and return millions of lookups per second */
+static double benchRun(rcHashTable_t* rcht, shHashTable_t* shht, char* keys, uint32_t threadsNum) {
+    pthread_t threads[BENCH_MAX_THREADS];
+    benchArgs_t args[BENCH_MAX_THREADS];
+    atomic_int stop;
+    uint64_t lookups = 0;
+    double start;
+
+    atomic_init(&stop, 0);
+    for (uint32_t ii = 0; ii < threadsNum; ii++) {
+        args[ii] = (benchArgs_t){rcht, shht, keys, &stop, 12345 + ii, 0};
+        pthread_create(&threads[ii], NULL, benchReader, &args[ii]);
+    }
+    start = benchNow();
+    while ((benchNow() - start) < BENCH_TIME_S) {
+        struct timespec ts = {0, 10000000};
+        nanosleep(&ts, NULL);
+    }
+    atomic_store(&stop, 1);
+    for (uint32_t ii = 0; ii < threadsNum; ii++) {
+        pthread_join(threads[ii], NULL);
+        lookups += args[ii].lookups;
+    }
+    return (double)lookups / (benchNow() - start) * 1e-6;
+}
+
+/* Functions -----------------------------------------------------------------*/
+
+int main(void) {
+    static const uint32_t threadsNums[] = {1, 2, 4, 8, 16};
+    rcHashTable_t rcht;
+    shHashTable_t shht;
+    char* keys = malloc((size_t)BENCH_ITEMS * BENCH_KEY_LEN);
+
+    if ((keys == NULL) || (rcHashTableInit(&rcht, sizeof(uint64_t), BENCH_ITEMS * 2, BENCH_MAX_THREADS) != UTILS_STATUS_SUCCESS)
+        || (shHashTableInit(&shht, sizeof(uint64_t), BENCH_ITEMS * 2, BENCH_SHARD_BITS) != UTILS_STATUS_SUCCESS)) {
+        return 1;
+    }
+    for (uint64_t ii = 0; ii < BENCH_ITEMS; ii++) {
+        snprintf(keys + ii * BENCH_KEY_LEN, BENCH_KEY_LEN, "key%u", (unsigned)ii);
+        rcHashTablePut(&rcht, keys + ii * BENCH_KEY_LEN, &ii);
+        shHashTablePut(&shht, keys + ii * BENCH_KEY_LEN, &ii);
+    }
+
+    printf("threads,rcHashTableGet_Mops,shHashTableGet_Mops,ratio\n");
+    for (size_t ii = 0; ii < sizeof(threadsNums) / sizeof(threadsNums[0]); ii++) {
+        double rc = benchRun(&rcht, NULL, keys, threadsNums[ii]);
+        double sh = benchRun(NULL, &shht, keys, threadsNums[ii]);
+        printf("%u,%.1f,%.1f,%.2f\n", threadsNums[ii], rc, sh, rc / sh);
+    }
+
+    rcHashTableDelete(&rcht);
+    shHashTableDelete(&shht);
+    free(keys);
+    return 0;
+}
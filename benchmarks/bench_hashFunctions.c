@@ -0,0 +1,290 @@
+/* BEGIN Header */
+/**
+ ******************************************************************************
+ * \file            bench_hashFunctions.c
+ * \author          Andrea Vivani
+ * \brief           Benchmark of hash functions throughput and distribution quality
+ ******************************************************************************
+ * \copyright
+ *
+ * Copyright 2024 Andrea Vivani
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the “Software”), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ ******************************************************************************
+ */
+/* END Header */
+
+/* Includes ------------------------------------------------------------------*/
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "CRC.h"
+#include "hashFunctions.h"
+
+/* Macros --------------------------------------------------------------------*/
+
+#define BENCH_MIN_TIME_S      0.1
+#define BENCH_THROUGHPUT_DATA (256 * 1024) /* bytes of keys hashed by each throughput round, so that they stay in cache */
+#define BENCH_AVALANCHE_KEYS  2000
+#define BENCH_CHI2_BUCKETS    4096
+#define BENCH_CHI2_KEYS       (BENCH_CHI2_BUCKETS * 16)
+#define BENCH_COLLISION_KEYS  (1u << 20)
+#define BENCH_KEY_SIZE        48 /* room for each generated key, terminator included */
+
+/* Typedefs ------------------------------------------------------------------*/
+
+typedef struct {
+    const char* name;
+    uint32_t (*fun)(char* key);
+    uint32_t (*bufFun)(const void* key, size_t len); /* variant taking key length, NULL if the hash has none */
+} benchHash_t;
+
+/* Fill key with the idx-th key of the set, NUL-terminated */
+typedef void (*benchKeyGen_t)(char* key, uint32_t idx);
+
+typedef struct {
+    const char* name;
+    benchKeyGen_t gen;
+} benchKeySet_t;
+
+/* Private Functions ---------------------------------------------------------*/
+
+static const benchHash_t hashes[] = {
+    {"FNV1A", hash_FNV1A, hash_FNV1A_buf},
+    {"djb", hash_djb, NULL},
+    {"sdbm", hash_sdbm, NULL},
+    {"murmur3", hash_murmur3, hash_murmur3_buf},
+    {"wy", hash_wy, hash_wy_buf},
+    {"crc32c", hash_crc32c, hash_crc32c_buf},
+};
+
+#define BENCH_HASHES (sizeof(hashes) / sizeof(hashes[0]))
+
+static double benchNow(void) {
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+/* Weyl sequence with MurmurHash3 finalizer, all output bits are usable: key bytes take the lowest ones */
+static uint32_t benchRand(uint32_t* seed) {
+    uint32_t z = (*seed += 0x9E3779B9u);
+    z = (z ^ (z >> 16)) * 0x85EBCA6Bu;
+    z = (z ^ (z >> 13)) * 0xC2B2AE35u;
+    return z ^ (z >> 16);
+}
+
+/* Random key with bytes in 0x40-0x7F, so that flipping any of the 6 lowest bits never gives a terminator */
+static void benchRandomKey(char* key, size_t len, uint32_t* seed) {
+    for (size_t ii = 0; ii < len; ii++) {
+        key[ii] = (char)(0x40 | (benchRand(seed) & 0x3F));
+    }
+    key[len] = '\0';
+}
+
+/* Realistic key sets: sequential numeric IDs, prefixed zero-padded IDs, file-system paths and random alphanumeric strings */
+static void benchKeySeq(char* key, uint32_t idx) { snprintf(key, BENCH_KEY_SIZE, "%u", idx); }
+
+static void benchKeyId(char* key, uint32_t idx) { snprintf(key, BENCH_KEY_SIZE, "user:%08u", idx); }
+
+static void benchKeyPath(char* key, uint32_t idx) {
+    snprintf(key, BENCH_KEY_SIZE, "/var/log/app%u/node%02u/file%04u.log", idx >> 16, (idx >> 10) & 0x3F, idx & 0x3FF);
+}
+
+static void benchKeyRandom(char* key, uint32_t idx) {
+    static const char alnum[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789";
+    uint32_t seed = idx;
+    size_t len = 8 + benchRand(&seed) % 17;
+    for (size_t ii = 0; ii < len; ii++) {
+        key[ii] = alnum[benchRand(&seed) % (sizeof(alnum) - 1)];
+    }
+    key[len] = '\0';
+}
+
+static const benchKeySet_t keySets[] = {
+    {"seq", benchKeySeq},
+    {"id", benchKeyId},
+    {"path", benchKeyPath},
+    {"random", benchKeyRandom},
+};
+
+#define BENCH_KEYSETS (sizeof(keySets) / sizeof(keySets[0]))
+
+static int benchCompare(const void* a, const void* b) {
+    uint32_t x = *(const uint32_t*)a, y = *(const uint32_t*)b;
+    return (x > y) - (x < y);
+}
+
+/*
+ * Throughput on keys whose length is minLen, or uniformly distributed in [minLen, maxLen]. Keys are packed in a single buffer
+ * that stays in cache, so that only hashing is measured. Key lengths are known in advance, as in hash-tables storing them, so the
+ * variant taking the length is used when available and only djb and sdbm scan for the terminator
+ */
+static void benchThroughput(const benchHash_t* hash, const char* dist, size_t minLen, size_t maxLen) {
+    static char buffer[BENCH_THROUGHPUT_DATA + 2048];
+    static char* keys[BENCH_THROUGHPUT_DATA];
+    static size_t lens[BENCH_THROUGHPUT_DATA];
+    uint32_t seed = 1, count = 0, iters = 0;
+    size_t used = 0, bytes = 0;
+    volatile uint32_t sink = 0;
+    double start, elapsed;
+
+    while (used < BENCH_THROUGHPUT_DATA) {
+        size_t len = minLen + ((maxLen > minLen) ? benchRand(&seed) % (maxLen - minLen + 1) : 0);
+        lens[count] = len;
+        keys[count++] = buffer + used;
+        benchRandomKey(buffer + used, len, &seed);
+        used += len + 1;
+        bytes += len;
+    }
+
+    start = benchNow();
+    do {
+        if (hash->bufFun != NULL) {
+            for (uint32_t ii = 0; ii < count; ii++) {
+                sink += hash->bufFun(keys[ii], lens[ii]);
+            }
+        } else {
+            for (uint32_t ii = 0; ii < count; ii++) {
+                sink += hash->fun(keys[ii]);
+            }
+        }
+        iters++;
+    } while ((elapsed = benchNow() - start) < BENCH_MIN_TIME_S);
+    (void)sink;
+
+    printf("%s,ns_per_key,%s,%.1f,%.2f\n", hash->name, dist, (double)bytes / count, elapsed * 1e9 / ((double)iters * count));
+    printf("%s,GBps,%s,%.1f,%.3f\n", hash->name, dist, (double)bytes / count, (double)bytes * iters / elapsed * 1e-9);
+}
+
+/*
+ * Avalanche: for random keys, each of the 6 lowest bits of each byte is flipped and the probability that every output bit flips is
+ * measured. Bias of each input/output bit pair is |2 * P(flip) - 1|, 0 for an ideal hash; mean and worst pair are reported
+ */
+static void benchAvalanche(const benchHash_t* hash, size_t len) {
+    static uint32_t flips[BENCH_KEY_SIZE * 6][32];
+    char key[BENCH_KEY_SIZE];
+    uint32_t seed = 7;
+    double bias, sum = 0, worst = 0;
+
+    memset(flips, 0, sizeof(flips));
+    for (uint32_t kk = 0; kk < BENCH_AVALANCHE_KEYS; kk++) {
+        benchRandomKey(key, len, &seed);
+        uint32_t base = hash->fun(key);
+        for (size_t ii = 0; ii < len * 6; ii++) {
+            key[ii / 6] ^= (char)(1 << (ii % 6));
+            uint32_t diff = base ^ hash->fun(key);
+            key[ii / 6] ^= (char)(1 << (ii % 6));
+            for (uint8_t jj = 0; jj < 32; jj++) {
+                flips[ii][jj] += (diff >> jj) & 1;
+            }
+        }
+    }
+
+    for (size_t ii = 0; ii < len * 6; ii++) {
+        for (uint8_t jj = 0; jj < 32; jj++) {
+            bias = 2.0 * flips[ii][jj] / BENCH_AVALANCHE_KEYS - 1.0;
+            bias = (bias < 0) ? -bias : bias;
+            sum += bias;
+            worst = (bias > worst) ? bias : worst;
+        }
+    }
+
+    printf("%s,avalanche_bias_mean,random,%zu,%.4f\n", hash->name, len, sum / (len * 6 * 32));
+    printf("%s,avalanche_bias_worst,random,%zu,%.4f\n", hash->name, len, worst);
+}
+
+/*
+ * Uniformity of buckets selected the way hash-tables do, by masking the lowest bits. Chi-square is divided by its degrees of freedom,
+ * so an ideal hash gives about 1
+ */
+static void benchChiSquare(const benchHash_t* hash, const benchKeySet_t* set) {
+    static uint32_t buckets[BENCH_CHI2_BUCKETS];
+    char key[BENCH_KEY_SIZE];
+    double expected = (double)BENCH_CHI2_KEYS / BENCH_CHI2_BUCKETS, chi2 = 0;
+
+    memset(buckets, 0, sizeof(buckets));
+    for (uint32_t ii = 0; ii < BENCH_CHI2_KEYS; ii++) {
+        set->gen(key, ii);
+        buckets[hash->fun(key) & (BENCH_CHI2_BUCKETS - 1)]++;
+    }
+    for (uint32_t ii = 0; ii < BENCH_CHI2_BUCKETS; ii++) {
+        chi2 += (buckets[ii] - expected) * (buckets[ii] - expected) / expected;
+    }
+
+    printf("%s,chi2_per_dof,%s,%u,%.3f\n", hash->name, set->name, BENCH_CHI2_BUCKETS, chi2 / (BENCH_CHI2_BUCKETS - 1));
+}
+
+/* Full 32-bit collisions, an ideal hash gives about n^2 / 2^33 */
+static void benchCollisions(const benchHash_t* hash, const benchKeySet_t* set, uint32_t* values) {
+    char key[BENCH_KEY_SIZE];
+    uint32_t collisions = 0;
+
+    for (uint32_t ii = 0; ii < BENCH_COLLISION_KEYS; ii++) {
+        set->gen(key, ii);
+        values[ii] = hash->fun(key);
+    }
+    qsort(values, BENCH_COLLISION_KEYS, sizeof(uint32_t), benchCompare);
+    for (uint32_t ii = 1; ii < BENCH_COLLISION_KEYS; ii++) {
+        collisions += (values[ii] == values[ii - 1]);
+    }
+
+    printf("%s,collisions,%s,%u,%u\n", hash->name, set->name, BENCH_COLLISION_KEYS, collisions);
+}
+
+/* Functions -----------------------------------------------------------------*/
+
+int main(void) {
+    static const size_t lengths[] = {4, 8, 16, 32, 64, 256, 1024};
+    uint32_t* values = malloc(BENCH_COLLISION_KEYS * sizeof(uint32_t));
+    char dist[16];
+
+    if (values == NULL) {
+        return 1;
+    }
+
+    /* Long format, one measure per line: param is average key length, key length, number of buckets or number of keys */
+    printf("hash,test,keyset,param,value\n");
+    for (size_t hh = 0; hh < BENCH_HASHES; hh++) {
+        for (size_t ii = 0; ii < sizeof(lengths) / sizeof(lengths[0]); ii++) {
+            snprintf(dist, sizeof(dist), "len%zu", lengths[ii]);
+            benchThroughput(&hashes[hh], dist, lengths[ii], lengths[ii]);
+        }
+        benchThroughput(&hashes[hh], "len1-64", 1, 64);
+        benchAvalanche(&hashes[hh], 8);
+        benchAvalanche(&hashes[hh], 32);
+        for (size_t ss = 0; ss < BENCH_KEYSETS; ss++) {
+            benchChiSquare(&hashes[hh], &keySets[ss]);
+        }
+        for (size_t ss = 0; ss < BENCH_KEYSETS; ss++) {
+            benchCollisions(&hashes[hh], &keySets[ss], values);
+        }
+    }
+    for (size_t ss = 0; ss < BENCH_KEYSETS; ss++) {
+        printf("ideal,collisions,%s,%u,%.0f\n", keySets[ss].name, BENCH_COLLISION_KEYS,
+               (double)BENCH_COLLISION_KEYS * BENCH_COLLISION_KEYS / 8589934592.0);
+    }
+
+    free(values);
+    return 0;
+}
@@ -0,0 +1,111 @@
+/* BEGIN Header */
+/**
+ ******************************************************************************
+ * \file            bench_matrixMult.c
+ * \author          Andrea Vivani
+ * \brief           Benchmark of direct vs Strassen-Winograd matrix multiplication
+ ******************************************************************************
+ * \copyright
+ *
+ * Copyright 2024 Andrea Vivani
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the “Software”), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ ******************************************************************************
+ */
+/* END Header */
+
+/* Includes ------------------------------------------------------------------*/
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "matrix.h"
+
+/* Macros --------------------------------------------------------------------*/
+
+#define BENCH_MIN_TIME_S 0.2
+
+/* Private Functions ---------------------------------------------------------*/
+
+static double benchNow(void) {
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static void benchFill(matrix_t* mat, uint32_t* seed) {
+    for (uint32_t ii = 0; ii < (uint32_t)mat->rows * mat->cols; ii++) {
+        *seed = *seed * 1664525u + 1013904223u;
+        mat->data[ii] = (float)(*seed >> 8) / (float)(1u << 24) * 2.0f - 1.0f;
+    }
+}
+
+/* Functions -----------------------------------------------------------------*/
+
+int main(void) {
+    static const uint8_t sizes[] = {32, 64, 96, 128, 160, 192, 224, 255};
+    uint32_t seed = 12345;
+
+    printf("n,direct_us,strassen_us,speedup,max_abs_err\n");
+    for (size_t ii = 0; ii < sizeof(sizes) / sizeof(sizes[0]); ii++) {
+        uint8_t n = sizes[ii];
+        matrix_t A, B, C, D;
+        float* workspace = malloc(MATRIX_STRASSEN_WORKSPACE_SIZE(n) * sizeof(float));
+        if ((workspace == NULL) || (matrixInit(&A, n, n) != UTILS_STATUS_SUCCESS) || (matrixInit(&B, n, n) != UTILS_STATUS_SUCCESS)
+            || (matrixInit(&C, n, n) != UTILS_STATUS_SUCCESS) || (matrixInit(&D, n, n) != UTILS_STATUS_SUCCESS)) {
+            fprintf(stderr, "allocation failed for n = %u\n", n);
+            return 1;
+        }
+        benchFill(&A, &seed);
+        benchFill(&B, &seed);
+
+        uint32_t iters = 0;
+        double start = benchNow(), tDirect, tStrassen;
+        do {
+            matrixMult(&A, &B, &C);
+            iters++;
+        } while ((tDirect = benchNow() - start) < BENCH_MIN_TIME_S);
+        tDirect /= iters;
+
+        iters = 0;
+        start = benchNow();
+        do {
+            matrixMultStrassen(&A, &B, &D, workspace);
+            iters++;
+        } while ((tStrassen = benchNow() - start) < BENCH_MIN_TIME_S);
+        tStrassen /= iters;
+
+        float err = 0.0f;
+        for (uint32_t jj = 0; jj < (uint32_t)n * n; jj++) {
+            float diff = C.data[jj] - D.data[jj];
+            diff = diff < 0.0f ? -diff : diff;
+            err = diff > err ? diff : err;
+        }
+        printf("%u,%.1f,%.1f,%.2f,%.3g\n", n, tDirect * 1e6, tStrassen * 1e6, tDirect / tStrassen, err);
+
+        matrixDelete(&A);
+        matrixDelete(&B);
+        matrixDelete(&C);
+        matrixDelete(&D);
+        free(workspace);
+    }
+    return 0;
+}
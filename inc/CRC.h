@@ -0,0 +1,125 @@
+/* BEGIN Header */
+/**
+ ******************************************************************************
+ * \file            CRC.h
+ * \author          Andrea Vivani
+ * \brief           Table-driven CRC-8, CRC-16, CRC-32 and CRC-32C
+ ******************************************************************************
+ * \copyright
+ *
+ * Copyright 2024 Andrea Vivani
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the “Software”), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ ******************************************************************************
+ */
+/* END Header */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __CRC_H__
+#define __CRC_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+/* Includes ------------------------------------------------------------------*/
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* Macros --------------------------------------------------------------------*/
+
+/* Initial values, to be passed as crc to start a new computation */
+#define CRC8_INIT   0x00U
+#define CRC16_INIT  0xFFFFU
+#define CRC32_INIT  0x00000000UL
+#define CRC32C_INIT 0x00000000UL
+
+/* Function prototypes -------------------------------------------------------*/
+
+/**
+ * \brief           CRC-8 (CRC-8/SMBUS: polynomial 0x07, not reflected, no final xor) of data
+ *
+ * \param[in]       data: pointer to data
+ * \param[in]       len: length of data in bytes
+ * \param[in]       crc: CRC8_INIT to start a new computation, or CRC returned by a previous call to continue it
+ * 
+ * \return          CRC
+ */
+uint8_t crc8Calc(const void* data, size_t len, uint8_t crc);
+
+/**
+ * \brief           CRC-16 (CRC-16/CCITT-FALSE: polynomial 0x1021, not reflected, no final xor) of data
+ *
+ * \param[in]       data: pointer to data
+ * \param[in]       len: length of data in bytes
+ * \param[in]       crc: CRC16_INIT to start a new computation, or CRC returned by a previous call to continue it
+ * 
+ * \return          CRC
+ */
+uint16_t crc16Calc(const void* data, size_t len, uint16_t crc);
+
+/**
+ * \brief           CRC-32 (IEEE 802.3, the one of zlib and Ethernet: reflected polynomial 0xEDB88320) of data, with slicing-by-8
+ *
+ * \param[in]       data: pointer to data
+ * \param[in]       len: length of data in bytes
+ * \param[in]       crc: CRC32_INIT to start a new computation, or CRC returned by a previous call to continue it
+ * 
+ * \return          CRC
+ */
+uint32_t crc32Calc(const void* data, size_t len, uint32_t crc);
+
+/**
+ * \brief           CRC-32C (Castagnoli, the one of iSCSI and ext4: reflected polynomial 0x82F63B78) of data. Uses the SSE4.2 crc32 instruction
+ *                  when the CPU supports it (checked at runtime), slicing-by-8 otherwise
+ *
+ * \param[in]       data: pointer to data
+ * \param[in]       len: length of data in bytes
+ * \param[in]       crc: CRC32C_INIT to start a new computation, or CRC returned by a previous call to continue it
+ * 
+ * \return          CRC
+ */
+uint32_t crc32cCalc(const void* data, size_t len, uint32_t crc);
+
+/**
+ * \brief           CRC-32C hash for key (NUL-terminated), to be used as hash function of hash-tables. Fast, but as CRC is linear it
+ *                  should not be used with keys chosen by untrusted parties
+ *
+ * \param[in]       key: pointer to key string
+ * 
+ * \return          hash
+ */
+uint32_t hash_crc32c(char* key);
+
+/**
+ * \brief           CRC-32C hash for binary key of given length
+ *
+ * \param[in]       key: pointer to key
+ * \param[in]       len: length of key in bytes
+ * 
+ * \return          hash
+ */
+uint32_t hash_crc32c_buf(const void* key, size_t len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __CRC_H__ */
@@ -43,27 +43,65 @@ extern "C" {
 #include <stddef.h>
 #include <stdint.h>
 #include "commonTypes.h"
-#include "list.h"
+
+/* Macros --------------------------------------------------------------------*/
+
+#ifdef LKHT_STATS
+/* Number of bins of chain length histogram, last bin collects all longer chains */
+#ifndef LKHT_STATS_HIST_SIZE
+#define LKHT_STATS_HIST_SIZE 16
+#endif /* LKHT_STATS_HIST_SIZE */
+#endif /* LKHT_STATS */
 
 /* Typedefs ------------------------------------------------------------------*/
 
 /*
- * Hash-Table entry struct
+ * Hash-Table entry struct, value (rounded up to 8 bytes) and key follow it in the same block
  */
-typedef struct {
-    char* key; /* key is NULL if this slot is empty */
-    void* value;
+typedef struct lkHashTableEntry {
+    struct lkHashTableEntry* next; /* next entry in the same bucket */
+    uint32_t hash;
+    uint32_t keyLen; /* key length, terminator included for string keys */
 } lkHashTableEntry_t;
 
+/*
+ * Chunk of entries pool, entries follow the header
+ */
+typedef struct lkHashTablePool {
+    struct lkHashTablePool* next;
+} lkHashTablePool_t;
+
+/**
+ * Hash-Table resizability setting
+ */
+typedef enum { LKHT_NOT_RESIZABLE = 0, LKHT_RESIZABLE = 1 } lkHashTableResizable_t;
+
 /*
  * Hash-Table struct
  */
 typedef struct {
-    list_t* entries; /* hash slots */
+    lkHashTableEntry_t** entries; /* hash slots, each one pointing to the first entry of its bucket */
     uint32_t size, items;
     size_t itemSize;
+    lkHashTableResizable_t resizable;
+    size_t _valueSize;         /* item size rounded up to keep keys aligned */
+    size_t _entrySize;         /* size of pooled entries, with room for keys up to LKHT_INLINE_KEY_SIZE bytes */
+    lkHashTableEntry_t* _free; /* pooled entries not in use */
+    lkHashTablePool_t* _pool;  /* chunks of pooled entries */
 } lkHashTable_t;
 
+#ifdef LKHT_STATS
+/**
+ * Hash-Table statistics
+ */
+typedef struct {
+    uint32_t chainHist[LKHT_STATS_HIST_SIZE]; /* number of buckets by chain length, last bin includes all longer chains */
+    uint32_t maxChain;                        /* longest chain */
+    float avgChain;                           /* average length of non-empty chains */
+    float avgProbe;                           /* average number of entries visited by a successful lookup */
+} lkHashTableStats_t;
+#endif /* LKHT_STATS */
+
 /**
  * Hash-Table removal setting
  */
@@ -77,20 +115,25 @@ typedef enum { LKHT_REMOVE_ITEM = 0, LKHT_DO_NOT_REMOVE_ITEM = 1 } lkHashTableRe
  *
  * \param[in]       lkht: pointer to hash-table object
  * \param[in]       itemSize: size of items to be handled by hash-table
- * \param[in]       size: max number of items that can be allocated in the hash-table
+ * \param[in]       size: number of buckets initially allocated in the hash-table, rounded up to a power of 2
+ * \param[in]       resizable: LKHT_RESIZABLE if the number of buckets should follow the number of items (between LKHT_MIN_SATURATION and
+ *                  LKHT_MAX_SATURATION items per bucket), LKHT_NOT_RESIZABLE otherwise. Chains can hold any number of items in both cases
  * 
  * \return          UTILS_STATUS_SUCCESS if hash-table was initialized, UTILS_STATUS_ERROR if data was not allocated correctly
  */
-utilsStatus_t lkHashTableInit(lkHashTable_t* lkht, size_t itemSize, uint32_t size);
+utilsStatus_t lkHashTableInit(lkHashTable_t* lkht, size_t itemSize, uint32_t size, lkHashTableResizable_t resizable);
 
 /**
- * \brief           Set item with given key to value. If not already present in table, key is copied to newly allocated memory, otherwise it is only updated.
+ * \brief           Set item with given key to value. If not already present in table, key and value are copied inside a new entry taken from the
+ *                  hash-table pool (or allocated on its own, if key is longer than LKHT_INLINE_KEY_SIZE bytes), otherwise value is only updated.
+ *                  Bucket is scanned once for both cases.
  *
  * \param[in]       lkht: pointer to hash-table object
  * \param[in]       key: pointer to key
  * \param[in]       value: pointer to value to be written
  * 
- * \return          UTILS_STATUS_SUCCESS if data is written correctly, UTILS_STATUS_ERROR otherwise
+ * \return          UTILS_STATUS_SUCCESS if data is written correctly, UTILS_STATUS_WARNING if data is written correctly but hash-table
+ *                  could not be resized, UTILS_STATUS_ERROR otherwise
  */
 utilsStatus_t lkHashTablePut(lkHashTable_t* lkht, char* key, void* value);
 
@@ -102,15 +145,144 @@ utilsStatus_t lkHashTablePut(lkHashTable_t* lkht, char* key, void* value);
  * \param[out]      value: pointer to value to be read
  * \param[in]       remove: LKHT_REMOVE_ITEM if item should be removed after being read, LKHT_DO_NOT_REMOVE_ITEM if item should not be removed
  * 
- * \return          UTILS_STATUS_SUCCESS if data is read correctly, UTILS_STATUS_ERROR if data 
+ * \return          UTILS_STATUS_SUCCESS if data is read correctly, UTILS_STATUS_WARNING if data is read and removed correctly but
+ *                  hash-table could not be resized, UTILS_STATUS_ERROR if data 
  */
 utilsStatus_t lkHashTableGet(lkHashTable_t* lkht, char* key, void* value, lkHashTableRemoval_t remove);
 
+/**
+ * \brief           Set item with given binary key to value, same as lkHashTablePut but key can contain any byte. Binary, integer and
+ *                  string keys use different hash functions, so each table should be used with a single key type.
+ *
+ * \param[in]       lkht: pointer to hash-table object
+ * \param[in]       key: pointer to key
+ * \param[in]       keyLen: length of key in bytes (must be greater than 0)
+ * \param[in]       value: pointer to value to be written
+ * 
+ * \return          UTILS_STATUS_SUCCESS if data is written correctly, UTILS_STATUS_ERROR otherwise
+ */
+utilsStatus_t lkHashTablePutBin(lkHashTable_t* lkht, const void* key, size_t keyLen, void* value);
+
+/**
+ * \brief           Get item with given binary key from hash table
+ *
+ * \param[in]       lkht: pointer to hash-table object
+ * \param[in]       key: pointer to key
+ * \param[in]       keyLen: length of key in bytes (must be greater than 0)
+ * \param[out]      value: pointer to value to be read
+ * \param[in]       remove: LKHT_REMOVE_ITEM if item should be removed after being read, LKHT_DO_NOT_REMOVE_ITEM if item should not be removed
+ * 
+ * \return          UTILS_STATUS_SUCCESS if data is read correctly, UTILS_STATUS_ERROR otherwise
+ */
+utilsStatus_t lkHashTableGetBin(lkHashTable_t* lkht, const void* key, size_t keyLen, void* value, lkHashTableRemoval_t remove);
+
+/**
+ * \brief           Set item with given 32-bit integer key to value. Key is stored in the entry and hashed with hash_mix32, so it is never allocated
+ *
+ * \param[in]       lkht: pointer to hash-table object
+ * \param[in]       key: key
+ * \param[in]       value: pointer to value to be written
+ * 
+ * \return          UTILS_STATUS_SUCCESS if data is written correctly, UTILS_STATUS_ERROR otherwise
+ */
+utilsStatus_t lkHashTablePutU32(lkHashTable_t* lkht, uint32_t key, void* value);
+
+/**
+ * \brief           Get item with given 32-bit integer key from hash table
+ *
+ * \param[in]       lkht: pointer to hash-table object
+ * \param[in]       key: key
+ * \param[out]      value: pointer to value to be read
+ * \param[in]       remove: LKHT_REMOVE_ITEM if item should be removed after being read, LKHT_DO_NOT_REMOVE_ITEM if item should not be removed
+ * 
+ * \return          UTILS_STATUS_SUCCESS if data is read correctly, UTILS_STATUS_ERROR otherwise
+ */
+utilsStatus_t lkHashTableGetU32(lkHashTable_t* lkht, uint32_t key, void* value, lkHashTableRemoval_t remove);
+
+/**
+ * \brief           Set item with given 64-bit integer key to value. Key is stored in the entry and hashed with hash_mix64, so it is never allocated
+ *
+ * \param[in]       lkht: pointer to hash-table object
+ * \param[in]       key: key
+ * \param[in]       value: pointer to value to be written
+ * 
+ * \return          UTILS_STATUS_SUCCESS if data is written correctly, UTILS_STATUS_ERROR otherwise
+ */
+utilsStatus_t lkHashTablePutU64(lkHashTable_t* lkht, uint64_t key, void* value);
+
+/**
+ * \brief           Get item with given 64-bit integer key from hash table
+ *
+ * \param[in]       lkht: pointer to hash-table object
+ * \param[in]       key: key
+ * \param[out]      value: pointer to value to be read
+ * \param[in]       remove: LKHT_REMOVE_ITEM if item should be removed after being read, LKHT_DO_NOT_REMOVE_ITEM if item should not be removed
+ * 
+ * \return          UTILS_STATUS_SUCCESS if data is read correctly, UTILS_STATUS_ERROR otherwise
+ */
+utilsStatus_t lkHashTableGetU64(lkHashTable_t* lkht, uint64_t key, void* value, lkHashTableRemoval_t remove);
+
+/**
+ * \brief           Get pointer to the value of item with given key, without copying it. Value can be read and updated in place through the
+ *                  pointer, that stays valid until the item is removed (values are stored in their entry, that is never moved)
+ *
+ * \param[in]       lkht: pointer to hash-table object
+ * \param[in]       key: pointer to key
+ * \param[out]      value: pointer to be set to the stored value
+ * 
+ * \return          UTILS_STATUS_SUCCESS if item is found, UTILS_STATUS_EMPTY if hash-table is empty, UTILS_STATUS_BUCKET_EMPTY or UTILS_STATUS_ERROR otherwise
+ */
+utilsStatus_t lkHashTableGetRef(lkHashTable_t* lkht, char* key, void** value);
+
+/**
+ * \brief           Get pointer to the value of item with given key, inserting the item with a zeroed value if not present, with a single
+ *                  lookup. Pointer validity is the same as lkHashTableGetRef
+ *
+ * \param[in]       lkht: pointer to hash-table object
+ * \param[in]       key: pointer to key
+ * \param[out]      value: pointer to be set to the stored value
+ * \param[out]      inserted: set to 1 if item was inserted, 0 if it was already present (can be NULL)
+ * 
+ * \return          UTILS_STATUS_SUCCESS if item is found or inserted, UTILS_STATUS_WARNING if item is inserted but hash-table could not be
+ *                  resized, UTILS_STATUS_ERROR otherwise
+ */
+utilsStatus_t lkHashTableGetOrInsert(lkHashTable_t* lkht, char* key, void** value, uint8_t* inserted);
+
+/**
+ * \brief           Same as lkHashTableGetRef, for binary keys
+ */
+utilsStatus_t lkHashTableGetRefBin(lkHashTable_t* lkht, const void* key, size_t keyLen, void** value);
+
+/**
+ * \brief           Same as lkHashTableGetOrInsert, for binary keys
+ */
+utilsStatus_t lkHashTableGetOrInsertBin(lkHashTable_t* lkht, const void* key, size_t keyLen, void** value, uint8_t* inserted);
+
+/**
+ * \brief           Same as lkHashTableGetRef, for 32-bit integer keys
+ */
+utilsStatus_t lkHashTableGetRefU32(lkHashTable_t* lkht, uint32_t key, void** value);
+
+/**
+ * \brief           Same as lkHashTableGetOrInsert, for 32-bit integer keys
+ */
+utilsStatus_t lkHashTableGetOrInsertU32(lkHashTable_t* lkht, uint32_t key, void** value, uint8_t* inserted);
+
+/**
+ * \brief           Same as lkHashTableGetRef, for 64-bit integer keys
+ */
+utilsStatus_t lkHashTableGetRefU64(lkHashTable_t* lkht, uint64_t key, void** value);
+
+/**
+ * \brief           Same as lkHashTableGetOrInsert, for 64-bit integer keys
+ */
+utilsStatus_t lkHashTableGetOrInsertU64(lkHashTable_t* lkht, uint64_t key, void** value, uint8_t* inserted);
+
 /**
  * \brief           Returns hash-table info
  *
  * \param[in]       lkht: pointer to hash-table object
- * \param[out]      size: pointer to size
+ * \param[out]      size: pointer to number of buckets
  * \param[out]      items: pointer to number of items currently in the hash-table
  */
 static inline void lkHashTableInfo(lkHashTable_t* lkht, uint32_t* size, uint32_t* items) {
@@ -118,6 +290,17 @@ static inline void lkHashTableInfo(lkHashTable_t* lkht, uint32_t* size, uint32_t
     *items = lkht->items;
 }
 
+#ifdef LKHT_STATS
+/**
+ * \brief           Returns hash-table statistics, computed by walking all buckets, so this is meant for diagnostics only.
+ *                  Available only if LKHT_STATS is defined
+ *
+ * \param[in]       lkht: pointer to hash-table object
+ * \param[out]      stats: pointer to statistics
+ */
+void lkHashTableStats(lkHashTable_t* lkht, lkHashTableStats_t* stats);
+#endif /* LKHT_STATS */
+
 /**
  * \brief           Flush hash-table removing all values
  *
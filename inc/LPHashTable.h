@@ -44,31 +44,86 @@ extern "C" {
 #include <stdint.h>
 #include "commonTypes.h"
 
+/* Macros --------------------------------------------------------------------*/
+
+/* Snapshot files are supported only where they can be memory-mapped */
+#if (defined(__unix__) || defined(__APPLE__)) && !defined(LPHT_NO_SNAPSHOT)
+#define LPHT_USE_SNAPSHOT
+#endif
+
+#ifdef LPHT_STATS
+/* Number of bins of probe distance histogram, last bin collects all longer distances */
+#ifndef LPHT_STATS_HIST_SIZE
+#define LPHT_STATS_HIST_SIZE 16
+#endif /* LPHT_STATS_HIST_SIZE */
+#endif /* LPHT_STATS */
+
 /* Typedefs ------------------------------------------------------------------*/
 
 /**
- * Hash-Table resizability setting
+ * Hash-Table resizability setting. LPHT_RESIZABLE_INCREMENTAL spreads the rehash over the following operations instead of doing it at once
  */
-typedef enum { LPHT_NOT_RESIZABLE = 0, LPHT_RESIZABLE = 1 } lpHashTableResizable_t;
+typedef enum { LPHT_NOT_RESIZABLE = 0, LPHT_RESIZABLE = 1, LPHT_RESIZABLE_INCREMENTAL = 2 } lpHashTableResizable_t;
 
 /*
- * Hash-Table entry struct
+ * Hash-Table slot header. Each slot is made of this header, followed by the inline key storage and by the value
  */
 typedef struct {
-    char* key; /* key is NULL if this slot is empty */
-    void* value;
+    uint32_t hash;   /* full hash of key, compared before the key itself and reused when entries are moved */
+    uint32_t keyLen; /* key length (terminator included for string keys), 0 if this slot is empty */
+    uint32_t dist;   /* distance from home slot, used by Robin Hood probing */
 } lpHashTableEntry_t;
 
+/*
+ * Hash-Table overflow storage chunk for keys that don't fit inline, data follows the struct
+ */
+typedef struct lpHashTableArena {
+    struct lpHashTableArena* next;
+    size_t size, used;
+} lpHashTableArena_t;
+
 /*
  * Hash-Table struct
  */
 typedef struct {
-    lpHashTableEntry_t* entries; /* hash slots */
+    uint8_t* entries; /* hash slots, all allocated in a single block */
     uint32_t size, items;
     size_t itemSize;
     lpHashTableResizable_t resizable;
+    size_t _slotSize, _keySize;    /* size of each slot and of its inline key storage */
+    lpHashTableArena_t* _arena;    /* overflow storage for keys longer than _keySize */
+    size_t _arenaUsed, _arenaLive; /* bytes written to overflow storage, and still referenced by the table */
+    lpHashTableArena_t* _oldArena; /* overflow storage being replaced during an incremental resize, NULL otherwise */
+    uint8_t* _oldEntries;          /* slots being migrated during an incremental resize, NULL otherwise */
+    uint32_t _oldSize, _oldItems;  /* size of old slots array, and number of items still in it */
+    uint32_t _migrateIdx;          /* next old slot to be migrated */
+    uint32_t _migrateStep;         /* number of old slots migrated by each operation */
+    uint8_t* _mapBase;             /* snapshot file mapping, long keys are stored as offsets from it. NULL if table is not a snapshot */
+    size_t _mapSize;               /* size of snapshot file mapping */
+#ifdef LPHT_STATS
+    uint32_t _xpandCount;          /* number of resizes since init */
+    uint32_t _compactCount;        /* number of overflow storage compactions since init */
+    uint64_t _xpandTime, _shifts;  /* time spent in resizes, and number of entries moved by insertions and removals since init */
+#endif /* LPHT_STATS */
 } lpHashTable_t;
 
+#ifdef LPHT_STATS
+/**
+ * Hash-Table statistics
+ */
+typedef struct {
+    uint32_t probeHist[LPHT_STATS_HIST_SIZE]; /* number of items by distance from their home slot, last bin includes all longer distances */
+    uint32_t maxProbe;                        /* longest distance from home slot */
+    float avgProbe;                           /* average distance from home slot, a successful lookup visits avgProbe + 1 slots on average */
+    uint32_t xpandCount;                      /* number of resizes since init */
+    uint64_t xpandTime;                       /* cumulative time spent in resizes since init, in LPHT_STATS_CLOCK units. With
+                                                 LPHT_RESIZABLE_INCREMENTAL it only covers the allocation of new slots, not the
+                                                 migration done by the following operations */
+    uint32_t compactCount;                    /* number of overflow storage compactions since init, not counted as resizes */
+    uint64_t shifts;                          /* number of entries moved by Robin Hood insertions and backward-shift deletions since init */
+} lpHashTableStats_t;
+#endif /* LPHT_STATS */
+
 /**
  * Hash-Table iterator 
  */
@@ -93,14 +148,17 @@ typedef enum { LPHT_REMOVE_ITEM = 0, LPHT_DO_NOT_REMOVE_ITEM = 1 } lpHashTableRe
  * \param[in]       lpht: pointer to hash-table object
  * \param[in]       itemSize: size of items to be handled by hash-table
  * \param[in]       init_items: number of items to be initially allocated in the hash-table
- * \param[in]       resizable: LPHT_RESIZABLE if table should be resized once max saturation is reached, LPHT_NOT_RESIZABLE otherwise
+ * \param[in]       resizable: LPHT_RESIZABLE if table should be resized once max saturation is reached, LPHT_RESIZABLE_INCREMENTAL if it should
+ *                  be resized as well but moving only LPHT_MIGRATION_STEP old slots per operation (old slots are kept and searched until 
+ *                  then), LPHT_NOT_RESIZABLE otherwise
  * 
  * \return          UTILS_STATUS_SUCCESS if hash-table was initialized, UTILS_STATUS_ERROR if data was not allocated correctly
  */
 utilsStatus_t lpHashTableInit(lpHashTable_t* lpht, size_t itemSize, uint32_t init_items, lpHashTableResizable_t resizable);
 
 /**
- * \brief           Set item with given key to value. If not already present in table, key is copied to newly allocated memory, otherwise it is only updated.
+ * \brief           Set item with given key to value. If not already present in table, key and value are copied into the slot (keys longer than
+ *                  LPHT_INLINE_KEY_SIZE go to the overflow storage), otherwise value is only updated.
  *
  * \param[in]       lpht: pointer to hash-table object
  * \param[in]       key: pointer to key
@@ -122,6 +180,194 @@ utilsStatus_t lpHashTablePut(lpHashTable_t* lpht, char* key, void* value);
  */
 utilsStatus_t lpHashTableGet(lpHashTable_t* lpht, char* key, void* value, lpHashTableRemoval_t remove);
 
+/**
+ * \brief           Set item with given binary key to value, same as lpHashTablePut but key can contain any byte. Binary, integer and
+ *                  string keys use different hash functions, so each table should be used with a single key type.
+ *
+ * \param[in]       lpht: pointer to hash-table object
+ * \param[in]       key: pointer to key
+ * \param[in]       keyLen: length of key in bytes (must be greater than 0)
+ * \param[in]       value: pointer to value to be written
+ * 
+ * \return          UTILS_STATUS_SUCCESS if data is written correctly, UTILS_STATUS_ERROR otherwise 
+ */
+utilsStatus_t lpHashTablePutBin(lpHashTable_t* lpht, const void* key, size_t keyLen, void* value);
+
+/**
+ * \brief           Get item with given binary key from hash table
+ *
+ * \param[in]       lpht: pointer to hash-table object
+ * \param[in]       key: pointer to key
+ * \param[in]       keyLen: length of key in bytes (must be greater than 0)
+ * \param[out]      value: pointer to value to be read
+ * \param[in]       remove: LPHT_REMOVE_ITEM if item should be removed after being read, LPHT_DO_NOT_REMOVE_ITEM if item should not be removed
+ * 
+ * \return          UTILS_STATUS_SUCCESS if data is read correctly, UTILS_STATUS_ERROR otherwise
+ */
+utilsStatus_t lpHashTableGetBin(lpHashTable_t* lpht, const void* key, size_t keyLen, void* value, lpHashTableRemoval_t remove);
+
+/**
+ * \brief           Set item with given binary key to value, using a hash computed by the caller (e.g. to reuse it for sharding).
+ *                  The same hash function must be used for every operation on a given key.
+ *
+ * \param[in]       lpht: pointer to hash-table object
+ * \param[in]       key: pointer to key
+ * \param[in]       keyLen: length of key in bytes (must be greater than 0)
+ * \param[in]       hash: hash of the key
+ * \param[in]       value: pointer to value to be written
+ * 
+ * \return          UTILS_STATUS_SUCCESS if data is written correctly, UTILS_STATUS_ERROR otherwise 
+ */
+utilsStatus_t lpHashTablePutHashed(lpHashTable_t* lpht, const void* key, size_t keyLen, uint32_t hash, void* value);
+
+/**
+ * \brief           Get item with given binary key from hash table, using a hash computed by the caller
+ *
+ * \param[in]       lpht: pointer to hash-table object
+ * \param[in]       key: pointer to key
+ * \param[in]       keyLen: length of key in bytes (must be greater than 0)
+ * \param[in]       hash: hash of the key
+ * \param[out]      value: pointer to value to be read
+ * \param[in]       remove: LPHT_REMOVE_ITEM if item should be removed after being read, LPHT_DO_NOT_REMOVE_ITEM if item should not be removed
+ * 
+ * \return          UTILS_STATUS_SUCCESS if data is read correctly, UTILS_STATUS_EMPTY if table is empty, UTILS_STATUS_ERROR otherwise
+ */
+utilsStatus_t lpHashTableGetHashed(lpHashTable_t* lpht, const void* key, size_t keyLen, uint32_t hash, void* value, lpHashTableRemoval_t remove);
+
+/**
+ * \brief           Set item with given 32-bit integer key to value. Key is stored inline and hashed with hash_mix32, no allocation is needed
+ *
+ * \param[in]       lpht: pointer to hash-table object
+ * \param[in]       key: key
+ * \param[in]       value: pointer to value to be written
+ * 
+ * \return          UTILS_STATUS_SUCCESS if data is written correctly, UTILS_STATUS_ERROR otherwise 
+ */
+utilsStatus_t lpHashTablePutU32(lpHashTable_t* lpht, uint32_t key, void* value);
+
+/**
+ * \brief           Get item with given 32-bit integer key from hash table
+ *
+ * \param[in]       lpht: pointer to hash-table object
+ * \param[in]       key: key
+ * \param[out]      value: pointer to value to be read
+ * \param[in]       remove: LPHT_REMOVE_ITEM if item should be removed after being read, LPHT_DO_NOT_REMOVE_ITEM if item should not be removed
+ * 
+ * \return          UTILS_STATUS_SUCCESS if data is read correctly, UTILS_STATUS_ERROR otherwise
+ */
+utilsStatus_t lpHashTableGetU32(lpHashTable_t* lpht, uint32_t key, void* value, lpHashTableRemoval_t remove);
+
+/**
+ * \brief           Set item with given 64-bit integer key to value. Key is stored inline and hashed with hash_mix64, no allocation is needed
+ *
+ * \param[in]       lpht: pointer to hash-table object
+ * \param[in]       key: key
+ * \param[in]       value: pointer to value to be written
+ * 
+ * \return          UTILS_STATUS_SUCCESS if data is written correctly, UTILS_STATUS_ERROR otherwise 
+ */
+utilsStatus_t lpHashTablePutU64(lpHashTable_t* lpht, uint64_t key, void* value);
+
+/**
+ * \brief           Get item with given 64-bit integer key from hash table
+ *
+ * \param[in]       lpht: pointer to hash-table object
+ * \param[in]       key: key
+ * \param[out]      value: pointer to value to be read
+ * \param[in]       remove: LPHT_REMOVE_ITEM if item should be removed after being read, LPHT_DO_NOT_REMOVE_ITEM if item should not be removed
+ * 
+ * \return          UTILS_STATUS_SUCCESS if data is read correctly, UTILS_STATUS_ERROR otherwise
+ */
+utilsStatus_t lpHashTableGetU64(lpHashTable_t* lpht, uint64_t key, void* value, lpHashTableRemoval_t remove);
+
+/**
+ * \brief           Get pointer to the value of item with given key, without copying it. Value can be read and updated in place through the
+ *                  pointer, that stays valid until the next put or removal on the hash-table (until the next operation of any kind for
+ *                  LPHT_RESIZABLE_INCREMENTAL hash-tables, as they move items during lookups too)
+ *
+ * \param[in]       lpht: pointer to hash-table object
+ * \param[in]       key: pointer to key
+ * \param[out]      value: pointer to be set to the stored value
+ * 
+ * \return          UTILS_STATUS_SUCCESS if item is found, UTILS_STATUS_EMPTY if hash-table is empty, UTILS_STATUS_ERROR otherwise
+ */
+utilsStatus_t lpHashTableGetRef(lpHashTable_t* lpht, char* key, void** value);
+
+/**
+ * \brief           Get pointer to the value of item with given key, inserting the item with a zeroed value if not present, with a single
+ *                  lookup. Pointer validity is the same as lpHashTableGetRef
+ *
+ * \param[in]       lpht: pointer to hash-table object
+ * \param[in]       key: pointer to key
+ * \param[out]      value: pointer to be set to the stored value
+ * \param[out]      inserted: set to 1 if item was inserted, 0 if it was already present (can be NULL)
+ * 
+ * \return          UTILS_STATUS_SUCCESS if item is found or inserted, UTILS_STATUS_FULL if hash-table is full, UTILS_STATUS_ERROR otherwise
+ */
+utilsStatus_t lpHashTableGetOrInsert(lpHashTable_t* lpht, char* key, void** value, uint8_t* inserted);
+
+/**
+ * \brief           Same as lpHashTableGetRef, for binary keys
+ */
+utilsStatus_t lpHashTableGetRefBin(lpHashTable_t* lpht, const void* key, size_t keyLen, void** value);
+
+/**
+ * \brief           Same as lpHashTableGetOrInsert, for binary keys
+ */
+utilsStatus_t lpHashTableGetOrInsertBin(lpHashTable_t* lpht, const void* key, size_t keyLen, void** value, uint8_t* inserted);
+
+/**
+ * \brief           Same as lpHashTableGetOrInsertBin, using a hash computed by the caller
+ */
+utilsStatus_t lpHashTableGetOrInsertHashed(lpHashTable_t* lpht, const void* key, size_t keyLen, uint32_t hash, void** value, uint8_t* inserted);
+
+/**
+ * \brief           Same as lpHashTableGetRef, for 32-bit integer keys
+ */
+utilsStatus_t lpHashTableGetRefU32(lpHashTable_t* lpht, uint32_t key, void** value);
+
+/**
+ * \brief           Same as lpHashTableGetOrInsert, for 32-bit integer keys
+ */
+utilsStatus_t lpHashTableGetOrInsertU32(lpHashTable_t* lpht, uint32_t key, void** value, uint8_t* inserted);
+
+/**
+ * \brief           Same as lpHashTableGetRef, for 64-bit integer keys
+ */
+utilsStatus_t lpHashTableGetRefU64(lpHashTable_t* lpht, uint64_t key, void** value);
+
+/**
+ * \brief           Same as lpHashTableGetOrInsert, for 64-bit integer keys
+ */
+utilsStatus_t lpHashTableGetOrInsertU64(lpHashTable_t* lpht, uint64_t key, void** value, uint8_t* inserted);
+
+/**
+ * \brief           Get items with given keys from hash table. Keys are processed in groups of LPHT_BATCH_SIZE: all keys of a group are
+ *                  hashed and their slots prefetched before being searched, so that memory accesses of different keys overlap
+ *
+ * \param[in]       lpht: pointer to hash-table object
+ * \param[in]       keys: array of pointers to keys
+ * \param[in]       count: number of keys
+ * \param[out]      values: array of count values to be read, item i is written at offset i * itemSize
+ * \param[out]      results: array of count statuses, same as lpHashTableGet for each key (can be NULL)
+ * 
+ * \return          UTILS_STATUS_SUCCESS if all items are read correctly, UTILS_STATUS_EMPTY if hash-table is empty, UTILS_STATUS_ERROR otherwise
+ */
+utilsStatus_t lpHashTableGetBatch(lpHashTable_t* lpht, char** keys, uint32_t count, void* values, utilsStatus_t* results);
+
+/**
+ * \brief           Set items with given keys to values, with the same grouping and prefetching as lpHashTableGetBatch
+ *
+ * \param[in]       lpht: pointer to hash-table object
+ * \param[in]       keys: array of pointers to keys
+ * \param[in]       count: number of keys
+ * \param[in]       values: array of count values to be written, item i is read at offset i * itemSize
+ * \param[out]      results: array of count statuses, same as lpHashTablePut for each key (can be NULL)
+ * 
+ * \return          UTILS_STATUS_SUCCESS if all items are written correctly, UTILS_STATUS_ERROR otherwise
+ */
+utilsStatus_t lpHashTablePutBatch(lpHashTable_t* lpht, char** keys, uint32_t count, void* values, utilsStatus_t* results);
+
 /**
  * \brief           Returns hash-table info
  *
@@ -134,6 +380,17 @@ static inline void lpHashTableInfo(lpHashTable_t* lpht, uint32_t* size, uint32_t
     *items = lpht->items;
 }
 
+#ifdef LPHT_STATS
+/**
+ * \brief           Returns hash-table statistics. Probe distances are computed by scanning all slots, so this is meant for diagnostics only.
+ *                  Available only if LPHT_STATS is defined
+ *
+ * \param[in]       lpht: pointer to hash-table object
+ * \param[out]      stats: pointer to statistics
+ */
+void lpHashTableStats(lpHashTable_t* lpht, lpHashTableStats_t* stats);
+#endif /* LPHT_STATS */
+
 /**
  * \brief           Flush hash-table removing all values
  *
@@ -151,6 +408,36 @@ utilsStatus_t lpHashTableFlush(lpHashTable_t* lpht);
  * \return          UTILS_STATUS_SUCCESS if hash-table is deleted, UTILS_STATUS_ERROR if hash-table was already deleted
  */
 utilsStatus_t lpHashTableDelete(lpHashTable_t* lpht);
+
+#ifdef LPHT_USE_SNAPSHOT
+/**
+ * \brief           Save hash-table to a snapshot file, that can be loaded back with lpHashTableLoad. Slots are written as they are, with keys 
+ *                  longer than LPHT_INLINE_KEY_SIZE appended after them and referenced by file offset, so the file is position-independent.
+ *                  A pending incremental resize is completed first.
+ *
+ * \param[in]       lpht: pointer to hash-table object
+ * \param[in]       path: path of file to be written
+ *
+ * \return          UTILS_STATUS_SUCCESS if file is written correctly, UTILS_STATUS_ERROR otherwise
+ */
+utilsStatus_t lpHashTableSave(lpHashTable_t* lpht, const char* path);
+
+/**
+ * \brief           Load a read-only hash-table from a snapshot file, by memory-mapping it: nothing is rebuilt, pages are read on first access
+ *                  and shared among all processes loading the same file. Put, removal and flush return UTILS_STATUS_ERROR on the loaded table,
+ *                  values returned by GetRef must not be written, lpHashTableDelete unmaps the file.
+ *
+ * \param[in]       lpht: pointer to hash-table object
+ * \param[in]       path: path of file written by lpHashTableSave
+ * \param[in]       itemSize: size of items to be handled by hash-table, must match the saved one
+ *
+ * \return          UTILS_STATUS_SUCCESS if hash-table is loaded, UTILS_STATUS_ERROR if file can't be mapped or it was not saved with the same
+ *                  item size and slot layout (LPHT_INLINE_KEY_SIZE, endianness)
+ * 
+ * \attention       Hash functions are not checked: file must be saved by a build using the same LPHT_HASHFUN and LPHT_BIN_HASHFUN
+ */
+utilsStatus_t lpHashTableLoad(lpHashTable_t* lpht, const char* path, size_t itemSize);
+#endif /* LPHT_USE_SNAPSHOT */
 #endif /* ADVUTILS_USE_DYNAMIC_ALLOCATION */
 
 #ifdef __cplusplus
@@ -0,0 +1,138 @@
+/* BEGIN Header */
+/**
+ ******************************************************************************
+ * \file            MPHashTable.h
+ * \author          Andrea Vivani
+ * \brief           Minimal perfect hash-table, built once from a static set of keys
+ ******************************************************************************
+ * \copyright
+ *
+ * Copyright 2024 Andrea Vivani
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the “Software”), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ ******************************************************************************
+ */
+/* END Header */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __MPHASHTABLE_H__
+#define __MPHASHTABLE_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+/* Includes ------------------------------------------------------------------*/
+
+#include <stddef.h>
+#include <stdint.h>
+#include "commonTypes.h"
+
+/* Typedefs ------------------------------------------------------------------*/
+
+/*
+ * Minimal perfect hash-table struct. All data is held in a single position-independent block, that can be saved after
+ * mpHashTableBuild and attached again with mpHashTableInitStatic (e.g. from a const array or a memory-mapped file)
+ */
+typedef struct {
+    const uint8_t* data;        /* hash-table block */
+    size_t dataSize;            /* size of hash-table block in bytes */
+    uint32_t items;
+    size_t itemSize;
+    uint32_t _buckets;          /* number of pilots */
+    uint64_t _seed;             /* seed found by the builder */
+    const uint32_t* _pilots;    /* per-bucket displacement, selects the slots of the keys of the bucket */
+    const uint32_t* _keyOffsets; /* offset of each slot key in _keys, items + 1 entries */
+    const uint8_t* _values;
+    const uint8_t* _keys;
+    uint8_t _owned;             /* 1 if data was allocated by mpHashTableBuild */
+} mpHashTable_t;
+
+/* Function prototypes -------------------------------------------------------*/
+
+#ifdef ADVUTILS_USE_DYNAMIC_ALLOCATION
+/**
+ * \brief           Build minimal perfect hash-table from a set of unique keys: each key is given its own slot among the items slots,
+ *                  so that lookups take a single hash computation and a single key comparison
+ *
+ * \param[in]       mpht: pointer to hash-table object
+ * \param[in]       keys: array of items pointers to keys
+ * \param[in]       keyLens: array of items key lengths in bytes, NULL if keys are NUL-terminated strings
+ * \param[in]       values: array of items values, each of itemSize bytes
+ * \param[in]       items: number of keys
+ * \param[in]       itemSize: size of items to be handled by hash-table
+ * 
+ * \return          UTILS_STATUS_SUCCESS if hash-table was built, UTILS_STATUS_ERROR if there are no keys, keys are not unique or data was not
+ *                  allocated correctly
+ */
+utilsStatus_t mpHashTableBuild(mpHashTable_t* mpht, const void* const* keys, const size_t* keyLens, const void* values, uint32_t items,
+                               size_t itemSize);
+#endif /* ADVUTILS_USE_DYNAMIC_ALLOCATION */
+
+#ifdef ADVUTILS_USE_STATIC_ALLOCATION
+/**
+ * \brief           Init minimal perfect hash-table on a block previously produced by mpHashTableBuild (mpht->data), without allocating memory
+ *
+ * \param[in]       mpht: pointer to hash-table object
+ * \param[in]       data: pointer to hash-table block, aligned to 8 bytes
+ * \param[in]       dataSize: size of hash-table block in bytes
+ * 
+ * \return          UTILS_STATUS_SUCCESS if hash-table was initialized, UTILS_STATUS_ERROR if block is not valid or was built on a machine with
+ *                  different endianness
+ */
+utilsStatus_t mpHashTableInitStatic(mpHashTable_t* mpht, const void* data, size_t dataSize);
+#endif /* ADVUTILS_USE_STATIC_ALLOCATION */
+
+/**
+ * \brief           Get value from the minimal perfect hash-table with string key
+ *
+ * \param[in]       mpht: pointer to hash-table object
+ * \param[in]       key: string key
+ * \param[out]      value: pointer to value
+ * 
+ * \return          UTILS_STATUS_SUCCESS if data is read correctly, UTILS_STATUS_ERROR if key is not in the hash-table
+ */
+utilsStatus_t mpHashTableGet(const mpHashTable_t* mpht, const char* key, void* value);
+
+/**
+ * \brief           Get value from the minimal perfect hash-table with binary key
+ *
+ * \param[in]       mpht: pointer to hash-table object
+ * \param[in]       key: pointer to key
+ * \param[in]       keyLen: length of key in bytes
+ * \param[out]      value: pointer to value
+ * 
+ * \return          UTILS_STATUS_SUCCESS if data is read correctly, UTILS_STATUS_ERROR if key is not in the hash-table
+ */
+utilsStatus_t mpHashTableGetBin(const mpHashTable_t* mpht, const void* key, size_t keyLen, void* value);
+
+/**
+ * \brief           Delete minimal perfect hash-table, freeing its block if it was allocated by mpHashTableBuild
+ *
+ * \param[in]       mpht: pointer to hash-table object
+ * 
+ * \return          UTILS_STATUS_SUCCESS if hash-table is deleted, UTILS_STATUS_ERROR if hash-table was already deleted
+ */
+utilsStatus_t mpHashTableDelete(mpHashTable_t* mpht);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __MPHASHTABLE_H__ */
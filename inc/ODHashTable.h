@@ -0,0 +1,214 @@
+/* BEGIN Header */
+/**
+ ******************************************************************************
+ * \file            ODHashTable.h
+ * \author          Andrea Vivani
+ * \brief           Insertion-ordered compact hash-table
+ ******************************************************************************
+ * \copyright
+ *
+ * Copyright 2024 Andrea Vivani
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the “Software”), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ ******************************************************************************
+ */
+/* END Header */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __ODHASHTABLE_H__
+#define __ODHASHTABLE_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+/* Includes ------------------------------------------------------------------*/
+
+#include <stddef.h>
+#include <stdint.h>
+#include "commonTypes.h"
+
+/* Typedefs ------------------------------------------------------------------*/
+
+/**
+ * Hash-Table resizability setting
+ */
+typedef enum { ODHT_NOT_RESIZABLE = 0, ODHT_RESIZABLE = 1 } odHashTableResizable_t;
+
+/*
+ * Hash-Table entry header. Each entry is made of this header, followed by the inline key storage (or by the pointer to the allocated key,
+ * for keys longer than inline storage) and by the value
+ */
+typedef struct {
+    uint32_t hash;
+    uint32_t keyLen; /* key length (terminator included for string keys), 0 if entry was removed */
+} odHashTableEntry_t;
+
+/*
+ * Hash-Table struct
+ */
+typedef struct {
+    uint8_t* entries; /* entries in insertion order, allocated in the same block right after index slots */
+    uint32_t size, items;
+    size_t itemSize;
+    odHashTableResizable_t resizable;
+    void* _index;              /* index slots: 0 if empty, entry number + 1 if used, all ones if entry was removed */
+    uint8_t _indexWidth;       /* size in bytes of each index slot (1, 2 or 4), the smallest one that can address all entries */
+    uint32_t _capacity, _used; /* number of entries that fit in entries array, and number of entries written (removed ones included) */
+    size_t _entrySize, _keySize;
+} odHashTable_t;
+
+/**
+ * Hash-Table iterator 
+ */
+typedef struct {
+    char* key;
+    uint32_t keyLen;
+    void* value;
+    odHashTable_t* _odht;
+    uint32_t _index;
+} odHashTableIterator_t;
+
+/**
+ * Hash-Table removal setting
+ */
+typedef enum { ODHT_REMOVE_ITEM = 0, ODHT_DO_NOT_REMOVE_ITEM = 1 } odHashTableRemoval_t;
+
+/* Function prototypes -------------------------------------------------------*/
+
+#ifdef ADVUTILS_USE_DYNAMIC_ALLOCATION
+/**
+ * \brief           Init insertion-ordered compact hash-table structure. Entries are stored densely in insertion order, and found through an
+ *                  index of 8, 16 or 32-bit entry numbers, so iteration order is deterministic and only visits entries
+ *
+ * \param[in]       odht: pointer to hash-table object
+ * \param[in]       itemSize: size of items to be handled by hash-table
+ * \param[in]       init_items: number of items to be initially allocated in the hash-table
+ * \param[in]       resizable: ODHT_RESIZABLE if table should be resized once entries array is full, ODHT_NOT_RESIZABLE otherwise
+ * 
+ * \return          UTILS_STATUS_SUCCESS if hash-table was initialized, UTILS_STATUS_ERROR if data was not allocated correctly
+ */
+utilsStatus_t odHashTableInit(odHashTable_t* odht, size_t itemSize, uint32_t init_items, odHashTableResizable_t resizable);
+
+/**
+ * \brief           Set item with given key to value. If not already present in table, item is appended after all other items, otherwise it is only
+ *                  updated and keeps its position.
+ *
+ * \param[in]       odht: pointer to hash-table object
+ * \param[in]       key: pointer to key
+ * \param[in]       value: pointer to value to be written
+ * 
+ * \return          UTILS_STATUS_SUCCESS if data is written correctly, UTILS_STATUS_FULL if table is full, UTILS_STATUS_ERROR otherwise 
+ */
+utilsStatus_t odHashTablePut(odHashTable_t* odht, char* key, void* value);
+
+/**
+ * \brief           Get item with given key from hash table
+ *
+ * \param[in]       odht: pointer to hash-table object
+ * \param[in]       key: pointer to key
+ * \param[out]      value: pointer to value to be read
+ * \param[in]       remove: ODHT_REMOVE_ITEM if item should be removed after being read, ODHT_DO_NOT_REMOVE_ITEM if item should not be removed
+ * 
+ * \return          UTILS_STATUS_SUCCESS if data is read correctly, UTILS_STATUS_EMPTY if table is empty, UTILS_STATUS_WARNING if item was removed but
+ *                  down-sizing failed, UTILS_STATUS_ERROR if key is not found
+ */
+utilsStatus_t odHashTableGet(odHashTable_t* odht, char* key, void* value, odHashTableRemoval_t remove);
+
+/**
+ * \brief           Set item with given binary key to value, same as odHashTablePut but key can contain any byte
+ *
+ * \param[in]       odht: pointer to hash-table object
+ * \param[in]       key: pointer to key
+ * \param[in]       keyLen: length of key in bytes (must be greater than 0)
+ * \param[in]       value: pointer to value to be written
+ * 
+ * \return          UTILS_STATUS_SUCCESS if data is written correctly, UTILS_STATUS_FULL if table is full, UTILS_STATUS_ERROR otherwise 
+ */
+utilsStatus_t odHashTablePutBin(odHashTable_t* odht, const void* key, size_t keyLen, void* value);
+
+/**
+ * \brief           Get item with given binary key from hash table
+ *
+ * \param[in]       odht: pointer to hash-table object
+ * \param[in]       key: pointer to key
+ * \param[in]       keyLen: length of key in bytes (must be greater than 0)
+ * \param[out]      value: pointer to value to be read
+ * \param[in]       remove: ODHT_REMOVE_ITEM if item should be removed after being read, ODHT_DO_NOT_REMOVE_ITEM if item should not be removed
+ * 
+ * \return          UTILS_STATUS_SUCCESS if data is read correctly, UTILS_STATUS_EMPTY if table is empty, UTILS_STATUS_WARNING if item was removed but
+ *                  down-sizing failed, UTILS_STATUS_ERROR if key is not found
+ */
+utilsStatus_t odHashTableGetBin(odHashTable_t* odht, const void* key, size_t keyLen, void* value, odHashTableRemoval_t remove);
+
+/**
+ * \brief           Returns hash-table info
+ *
+ * \param[in]       odht: pointer to hash-table object
+ * \param[out]      size: pointer to size (number of index slots)
+ * \param[out]      items: pointer to number of items currently in the hash-table
+ */
+static inline void odHashTableInfo(odHashTable_t* odht, uint32_t* size, uint32_t* items) {
+    *size = odht->size;
+    *items = odht->items;
+}
+
+/**
+ * \brief           Flush hash-table removing all values
+ *
+ * \param[in]       odht: pointer to hash-table object
+ *
+ * \return          UTILS_STATUS_SUCCESS if hash-table is flushed correctly, UTILS_STATUS_EMPTY if hash-table was already empty
+ */
+utilsStatus_t odHashTableFlush(odHashTable_t* odht);
+
+/**
+ * \brief           Delete hash-table
+ *
+ * \param[in]       odht: pointer to hash-table object
+ *
+ * \return          UTILS_STATUS_SUCCESS if hash-table is deleted, UTILS_STATUS_ERROR if hash-table was already deleted
+ */
+utilsStatus_t odHashTableDelete(odHashTable_t* odht);
+
+/**
+ * \brief           Create new iterator
+ *
+ * \param[in]       it: pointer to iterator object
+ * \param[in]       odht: pointer to hash-table object
+ */
+void odHashTableIt(odHashTableIterator_t* it, odHashTable_t* odht);
+
+/**
+ * \brief           Move iterator to next item in insertion order, updating its key and value pointers
+ *
+ * \param[in]       it: pointer to iterator object
+ *
+ * \return          UTILS_STATUS_SUCCESS if iterator is moved to next item, UTILS_STATUS_ERROR if there are no more items
+ * 
+ * \attention       Hash-table must not be modified while iterating
+ */
+utilsStatus_t odHashTableItNext(odHashTableIterator_t* it);
+#endif /* ADVUTILS_USE_DYNAMIC_ALLOCATION */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __ODHASHTABLE_H__ */
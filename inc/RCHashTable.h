@@ -0,0 +1,214 @@
+/* BEGIN Header */
+/**
+ ******************************************************************************
+ * \file            RCHashTable.h
+ * \author          Andrea Vivani
+ * \brief           Read-copy-update hash-table, with lock-free readers and epoch-based memory reclamation
+ ******************************************************************************
+ * \copyright
+ *
+ * Copyright 2024 Andrea Vivani
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the “Software”), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ ******************************************************************************
+ */
+/* END Header */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __RCHASHTABLE_H__
+#define __RCHASHTABLE_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+/* Includes ------------------------------------------------------------------*/
+
+#include <stddef.h>
+#include <stdint.h>
+#include "commonTypes.h"
+#ifdef ADVUTILS_USE_PTHREADS
+#include <pthread.h>
+#include <stdatomic.h>
+#endif /* ADVUTILS_USE_PTHREADS */
+
+#if defined(ADVUTILS_USE_DYNAMIC_ALLOCATION) && defined(ADVUTILS_USE_PTHREADS)
+/* Typedefs ------------------------------------------------------------------*/
+
+/*
+ * Header of blocks (entries and slot arrays) waiting to be freed, once no reader can access them anymore
+ */
+typedef struct rcHashTableRetired {
+    struct rcHashTableRetired* next;
+    uint64_t epoch; /* global epoch after the block was unlinked */
+} rcHashTableRetired_t;
+
+/*
+ * Hash-Table entry, never modified once published: value follows it, key follows value
+ */
+typedef struct {
+    rcHashTableRetired_t _retired;
+    uint32_t hash;
+    uint32_t keyLen;
+} rcHashTableEntry_t;
+
+/*
+ * Hash-Table slots array, replaced as a whole when resizing
+ */
+typedef struct {
+    rcHashTableRetired_t _retired;
+    uint32_t size;
+    _Atomic(rcHashTableEntry_t*) slots[];
+} rcHashTableArray_t;
+
+/*
+ * Hash-Table reader record, each reader thread must own one
+ */
+typedef struct {
+    _Atomic uint64_t epoch; /* global epoch seen when current read started, 0 if reader is not reading */
+    atomic_uint used;
+} rcHashTableReader_t;
+
+/*
+ * Hash-Table struct
+ */
+typedef struct {
+    _Atomic(rcHashTableArray_t*) table;
+    uint32_t items;
+    size_t itemSize;
+    uint32_t readersNum;
+    uint32_t _tombstones;             /* number of removed items slots, not reusable until next resize */
+    size_t _valueSize;                /* item size rounded up to keep keys aligned */
+    _Atomic uint64_t _epoch;          /* global epoch, incremented each time a block is unlinked */
+    rcHashTableRetired_t* _retired;   /* blocks unlinked but possibly still used by readers */
+    uint8_t* _readers;                /* reader records, each one on its own cache line */
+    size_t _readerStride;             /* distance in bytes between consecutive reader records */
+    void* _readersMem;                /* reader records memory block, as returned by allocator */
+    pthread_mutex_t _writeLock;       /* serializes writers */
+} rcHashTable_t;
+
+/**
+ * Hash-Table removal setting
+ */
+typedef enum { RCHT_REMOVE_ITEM = 0, RCHT_DO_NOT_REMOVE_ITEM = 1 } rcHashTableRemoval_t;
+
+/* Function prototypes -------------------------------------------------------*/
+
+/**
+ * \brief           Init read-copy-update hash-table structure. Readers never lock nor write shared memory other than their own record,
+ *                  while writers are serialized by a mutex and publish new entries and slot arrays atomically. Replaced entries and arrays
+ *                  are freed by writers once all readers that could see them are done.
+ *
+ * \param[in]       rcht: pointer to hash-table object
+ * \param[in]       itemSize: size of items to be handled by hash-table
+ * \param[in]       init_items: number of items to be initially allocated in the hash-table, rounded up to a power of 2
+ * \param[in]       readersNum: maximum number of reader threads registered at the same time
+ * 
+ * \return          UTILS_STATUS_SUCCESS if hash-table was initialized, UTILS_STATUS_ERROR if data was not allocated correctly
+ */
+utilsStatus_t rcHashTableInit(rcHashTable_t* rcht, size_t itemSize, uint32_t init_items, uint32_t readersNum);
+
+/**
+ * \brief           Register a reader, to be called once by each thread that reads from the hash-table
+ *
+ * \param[in]       rcht: pointer to hash-table object
+ * \param[out]      reader: pointer to reader record assigned to the thread
+ * 
+ * \return          UTILS_STATUS_SUCCESS if reader is registered, UTILS_STATUS_FULL if readersNum readers are already registered
+ */
+utilsStatus_t rcHashTableReaderRegister(rcHashTable_t* rcht, rcHashTableReader_t** reader);
+
+/**
+ * \brief           Unregister a reader, so that its record can be used by another thread
+ *
+ * \param[in]       rcht: pointer to hash-table object
+ * \param[in]       reader: pointer to reader record
+ */
+void rcHashTableReaderUnregister(rcHashTable_t* rcht, rcHashTableReader_t* reader);
+
+/**
+ * \brief           Set item with given key to value. A new entry is published and the replaced one, if any, is retired.
+ *
+ * \param[in]       rcht: pointer to hash-table object
+ * \param[in]       key: pointer to key
+ * \param[in]       value: pointer to value to be written
+ * 
+ * \return          UTILS_STATUS_SUCCESS if data is written correctly, UTILS_STATUS_ERROR otherwise 
+ */
+utilsStatus_t rcHashTablePut(rcHashTable_t* rcht, char* key, void* value);
+
+/**
+ * \brief           Get item with given key from hash table. If item is not removed, no lock is taken and the only shared memory written 
+ *                  is the reader record, so concurrent readers scale with the number of cores.
+ *
+ * \param[in]       rcht: pointer to hash-table object
+ * \param[in]       reader: pointer to reader record of calling thread, can be NULL only if item is removed
+ * \param[in]       key: pointer to key
+ * \param[out]      value: pointer to value to be read
+ * \param[in]       remove: RCHT_REMOVE_ITEM if item should be removed after being read (serialized with writers), RCHT_DO_NOT_REMOVE_ITEM otherwise
+ * 
+ * \return          UTILS_STATUS_SUCCESS if data is read correctly, UTILS_STATUS_WARNING if item was removed but down-sizing failed, 
+ *                  UTILS_STATUS_ERROR if key is not found
+ */
+utilsStatus_t rcHashTableGet(rcHashTable_t* rcht, rcHashTableReader_t* reader, char* key, void* value, rcHashTableRemoval_t remove);
+
+/**
+ * \brief           Free retired entries and arrays that no reader can access anymore. Writers already do it after each change, 
+ *                  this is only needed to release memory when no more changes are expected.
+ *
+ * \param[in]       rcht: pointer to hash-table object
+ */
+void rcHashTableReclaim(rcHashTable_t* rcht);
+
+/**
+ * \brief           Returns hash-table info
+ *
+ * \param[in]       rcht: pointer to hash-table object
+ * \param[out]      size: pointer to size
+ * \param[out]      items: pointer to number of items currently in the hash-table
+ */
+void rcHashTableInfo(rcHashTable_t* rcht, uint32_t* size, uint32_t* items);
+
+/**
+ * \brief           Flush hash-table removing all values
+ *
+ * \param[in]       rcht: pointer to hash-table object
+ *
+ * \return          UTILS_STATUS_SUCCESS if hash-table is flushed correctly, UTILS_STATUS_EMPTY if hash-table was already empty, 
+ *                  UTILS_STATUS_ERROR if new slots could not be allocated
+ */
+utilsStatus_t rcHashTableFlush(rcHashTable_t* rcht);
+
+/**
+ * \brief           Delete hash-table
+ *
+ * \param[in]       rcht: pointer to hash-table object
+ *
+ * \return          UTILS_STATUS_SUCCESS if hash-table is deleted, UTILS_STATUS_ERROR if hash-table was already deleted
+ * 
+ * \attention       No other thread must be accessing the hash-table
+ */
+utilsStatus_t rcHashTableDelete(rcHashTable_t* rcht);
+#endif /* defined(ADVUTILS_USE_DYNAMIC_ALLOCATION) && defined(ADVUTILS_USE_PTHREADS) */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __RCHASHTABLE_H__ */
@@ -0,0 +1,145 @@
+/* BEGIN Header */
+/**
+ ******************************************************************************
+ * \file            RLS.h
+ * \author          Andrea Vivani
+ * \brief           Implementation of recursive least squares estimator with exponential forgetting
+ ******************************************************************************
+ * \copyright
+ *
+ * Copyright 2024 Andrea Vivani
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the “Software”), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ ******************************************************************************
+ */
+/* END Header */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __RLS_H__
+#define __RLS_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+/* Includes ------------------------------------------------------------------*/
+
+#include <stdint.h>
+#include "commonTypes.h"
+#include "matrix.h"
+
+/* Typedefs ------------------------------------------------------------------*/
+
+/**
+ * Recursive least squares struct
+ */
+typedef struct {
+    matrix_t theta; /* n x 1 parameters estimate */
+    matrix_t P;     /* n x n inverse correlation matrix */
+    matrix_t _Px;   /* n x 1 workspace, stores P * x */
+    float lambda, _invLambda;
+} rls_t;
+
+/* Function prototypes -------------------------------------------------------*/
+
+#ifdef ADVUTILS_USE_DYNAMIC_ALLOCATION
+/**
+ * \brief           Init recursive least squares structure with dynamic memory allocation
+ *
+ * \param[in]       rls: pointer to RLS object
+ * \param[in]       n: number of parameters to be estimated
+ * \param[in]       lambda: forgetting factor, in range (0, 1]. 1 means no forgetting, typical values are 0.95 - 0.999
+ * \param[in]       delta: initial value of the diagonal of P. Large values (e.g. 1e3) mean low confidence in the initial estimate
+ *
+ * \return          UTILS_STATUS_SUCCESS if RLS was initialized, UTILS_STATUS_ERROR if data was not allocated correctly
+ */
+utilsStatus_t rlsInit(rls_t* rls, uint8_t n, float lambda, float delta);
+#endif /* ADVUTILS_USE_DYNAMIC_ALLOCATION */
+
+#ifdef ADVUTILS_USE_STATIC_ALLOCATION
+/**
+ * \brief           Init recursive least squares structure with static data
+ *
+ * \param[in]       rls: pointer to RLS object
+ * \param[in]       thetaData: pointer to parameters data array of size n
+ * \param[in]       PData: pointer to inverse correlation matrix data array of size n * n
+ * \param[in]       workData: pointer to workspace data array of size n
+ * \param[in]       n: number of parameters to be estimated
+ * \param[in]       lambda: forgetting factor, in range (0, 1]. 1 means no forgetting, typical values are 0.95 - 0.999
+ * \param[in]       delta: initial value of the diagonal of P. Large values (e.g. 1e3) mean low confidence in the initial estimate
+ */
+void rlsInitStatic(rls_t* rls, float* thetaData, float* PData, float* workData, uint8_t n, float lambda, float delta);
+#endif /* ADVUTILS_USE_STATIC_ALLOCATION */
+
+/**
+ * \brief           Reset parameters estimate to zero and P to delta * I
+ *
+ * \param[in]       rls: pointer to RLS object
+ * \param[in]       delta: initial value of the diagonal of P
+ */
+void rlsReset(rls_t* rls, float delta);
+
+/**
+ * \brief           Update parameters estimate with a new sample, such that y = x' * theta. Cost is O(n^2), independent of the number of samples
+ *
+ * \param[in]       rls: pointer to RLS object
+ * \param[in]       x: pointer to regressors array of size n
+ * \param[in]       y: measured output
+ *
+ * \return          a-priori estimation error y - x' * theta
+ */
+float rlsUpdate(rls_t* rls, float* x, float y);
+
+/**
+ * \brief           Predict output with current parameters estimate
+ *
+ * \param[in]       rls: pointer to RLS object
+ * \param[in]       x: pointer to regressors array of size n
+ *
+ * \return          predicted output x' * theta
+ */
+float rlsPredict(rls_t* rls, float* x);
+
+/**
+ * \brief           Change forgetting factor
+ *
+ * \param[in]       rls: pointer to RLS object
+ * \param[in]       lambda: forgetting factor, in range (0, 1]
+ */
+static inline void rlsSetLambda(rls_t* rls, float lambda) {
+    rls->lambda = lambda;
+    rls->_invLambda = 1.0f / lambda;
+}
+
+#ifdef ADVUTILS_USE_DYNAMIC_ALLOCATION
+/**
+ * \brief           Delete RLS object
+ *
+ * \param[in]       rls: pointer to RLS object
+ *
+ * \return          UTILS_STATUS_SUCCESS if RLS data is deleted, UTILS_STATUS_ERROR if data was already deleted
+ */
+utilsStatus_t rlsDelete(rls_t* rls);
+#endif /* ADVUTILS_USE_DYNAMIC_ALLOCATION */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __RLS_H__ */
@@ -0,0 +1,221 @@
+/* BEGIN Header */
+/**
+ ******************************************************************************
+ * \file            SHHashTable.h
+ * \author          Andrea Vivani
+ * \brief           Lock-striped sharded hash-table, safe to be used concurrently by multiple threads
+ ******************************************************************************
+ * \copyright
+ *
+ * Copyright 2024 Andrea Vivani
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the “Software”), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ ******************************************************************************
+ */
+/* END Header */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __SHHASHTABLE_H__
+#define __SHHASHTABLE_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+/* Includes ------------------------------------------------------------------*/
+
+#include <stddef.h>
+#include <stdint.h>
+#include "LPHashTable.h"
+#include "commonTypes.h"
+#ifdef ADVUTILS_USE_PTHREADS
+#include <pthread.h>
+#endif /* ADVUTILS_USE_PTHREADS */
+
+#if defined(ADVUTILS_USE_DYNAMIC_ALLOCATION) && defined(ADVUTILS_USE_PTHREADS)
+/* Typedefs ------------------------------------------------------------------*/
+
+/*
+ * Hash-Table shard, a linear-probing hash-table protected by its own reader-writer lock
+ */
+typedef struct {
+    lpHashTable_t lpht;
+    pthread_rwlock_t lock;
+} shHashTableShard_t;
+
+/*
+ * Hash-Table struct
+ */
+typedef struct {
+    uint8_t* shards; /* shards, each one starting on its own cache line */
+    uint32_t shardCount;
+    size_t itemSize;
+    uint8_t _shardBits;  /* number of scrambled hash high bits used to select the shard */
+    size_t _shardStride; /* distance in bytes between consecutive shards */
+    void* _mem;          /* shards memory block, as returned by allocator */
+} shHashTable_t;
+
+/*
+ * Hash-Table update callback, called with shard write lock held. value points to the item in the table, zeroed if just inserted
+ */
+typedef void (*shHashTableUpdateFun_t)(void* value, uint8_t inserted, void* ctx);
+
+/**
+ * Hash-Table removal setting
+ */
+typedef enum { SHHT_REMOVE_ITEM = 0, SHHT_DO_NOT_REMOVE_ITEM = 1 } shHashTableRemoval_t;
+
+/* Function prototypes -------------------------------------------------------*/
+
+/**
+ * \brief           Init sharded hash-table structure. Keys are split among shards by the highest bits of their (scrambled) hash, each shard is a
+ *                  resizable linear-probing hash-table with its own reader-writer lock, so that threads accessing different shards never contend
+ *
+ * \param[in]       shht: pointer to hash-table object
+ * \param[in]       itemSize: size of items to be handled by hash-table
+ * \param[in]       init_items: number of items to be initially allocated in the hash-table, split evenly among shards and rounded up to a power of 2
+ * \param[in]       shardBits: number of hash bits used to select the shard, hash-table will have 2^shardBits shards (at most SHHT_MAX_SHARD_BITS)
+ * 
+ * \return          UTILS_STATUS_SUCCESS if hash-table was initialized, UTILS_STATUS_ERROR if data was not allocated correctly or shardBits is too big
+ */
+utilsStatus_t shHashTableInit(shHashTable_t* shht, size_t itemSize, uint32_t init_items, uint8_t shardBits);
+
+/**
+ * \brief           Set item with given key to value. If not already present in table, key is copied into the table, otherwise it is only updated.
+ *
+ * \param[in]       shht: pointer to hash-table object
+ * \param[in]       key: pointer to key
+ * \param[in]       value: pointer to value to be written
+ * 
+ * \return          UTILS_STATUS_SUCCESS if data is written correctly, UTILS_STATUS_ERROR otherwise 
+ */
+utilsStatus_t shHashTablePut(shHashTable_t* shht, char* key, void* value);
+
+/**
+ * \brief           Get item with given key from hash table. Shard is only read-locked if item is not removed, so concurrent readers don't block each other
+ *
+ * \param[in]       shht: pointer to hash-table object
+ * \param[in]       key: pointer to key
+ * \param[out]      value: pointer to value to be read
+ * \param[in]       remove: SHHT_REMOVE_ITEM if item should be removed after being read, SHHT_DO_NOT_REMOVE_ITEM if item should not be removed
+ * 
+ * \return          UTILS_STATUS_SUCCESS if data is read correctly, UTILS_STATUS_WARNING if item was removed but down-sizing failed,
+ *                  UTILS_STATUS_ERROR if key is not found
+ */
+utilsStatus_t shHashTableGet(shHashTable_t* shht, char* key, void* value, shHashTableRemoval_t remove);
+
+/**
+ * \brief           Atomically update item with given key, inserting it zero-initialized if not present. Useful for read-modify-write operations
+ *                  (e.g. counters) that would otherwise race between a Get and a Put
+ *
+ * \param[in]       shht: pointer to hash-table object
+ * \param[in]       key: pointer to key
+ * \param[in]       fun: function called on the item with shard write lock held, it must not access the hash-table
+ * \param[in]       ctx: pointer passed to fun
+ * 
+ * \return          UTILS_STATUS_SUCCESS if item is updated correctly, UTILS_STATUS_ERROR otherwise 
+ */
+utilsStatus_t shHashTableUpdate(shHashTable_t* shht, char* key, shHashTableUpdateFun_t fun, void* ctx);
+
+/**
+ * \brief           Set item with given binary key to value, same as shHashTablePut but key can contain any byte. Binary, integer and
+ *                  string keys use different hash functions, so each table should be used with a single key type.
+ *
+ * \param[in]       shht: pointer to hash-table object
+ * \param[in]       key: pointer to key
+ * \param[in]       keyLen: length of key in bytes (must be greater than 0)
+ * \param[in]       value: pointer to value to be written
+ * 
+ * \return          UTILS_STATUS_SUCCESS if data is written correctly, UTILS_STATUS_ERROR otherwise 
+ */
+utilsStatus_t shHashTablePutBin(shHashTable_t* shht, const void* key, size_t keyLen, void* value);
+
+/**
+ * \brief           Get item with given binary key from hash table
+ *
+ * \param[in]       shht: pointer to hash-table object
+ * \param[in]       key: pointer to key
+ * \param[in]       keyLen: length of key in bytes (must be greater than 0)
+ * \param[out]      value: pointer to value to be read
+ * \param[in]       remove: SHHT_REMOVE_ITEM if item should be removed after being read, SHHT_DO_NOT_REMOVE_ITEM if item should not be removed
+ * 
+ * \return          UTILS_STATUS_SUCCESS if data is read correctly, UTILS_STATUS_WARNING if item was removed but down-sizing failed,
+ *                  UTILS_STATUS_ERROR otherwise
+ */
+utilsStatus_t shHashTableGetBin(shHashTable_t* shht, const void* key, size_t keyLen, void* value, shHashTableRemoval_t remove);
+
+/**
+ * \brief           Set item with given 64-bit integer key to value. Key is stored inline and hashed with hash_mix64, no allocation is needed
+ *
+ * \param[in]       shht: pointer to hash-table object
+ * \param[in]       key: key
+ * \param[in]       value: pointer to value to be written
+ * 
+ * \return          UTILS_STATUS_SUCCESS if data is written correctly, UTILS_STATUS_ERROR otherwise 
+ */
+utilsStatus_t shHashTablePutU64(shHashTable_t* shht, uint64_t key, void* value);
+
+/**
+ * \brief           Get item with given 64-bit integer key from hash table
+ *
+ * \param[in]       shht: pointer to hash-table object
+ * \param[in]       key: key
+ * \param[out]      value: pointer to value to be read
+ * \param[in]       remove: SHHT_REMOVE_ITEM if item should be removed after being read, SHHT_DO_NOT_REMOVE_ITEM if item should not be removed
+ * 
+ * \return          UTILS_STATUS_SUCCESS if data is read correctly, UTILS_STATUS_WARNING if item was removed but down-sizing failed,
+ *                  UTILS_STATUS_ERROR otherwise
+ */
+utilsStatus_t shHashTableGetU64(shHashTable_t* shht, uint64_t key, void* value, shHashTableRemoval_t remove);
+
+/**
+ * \brief           Returns hash-table info. Shards are locked one at a time, so values are only a snapshot if other threads are writing
+ *
+ * \param[in]       shht: pointer to hash-table object
+ * \param[out]      size: pointer to total size of shards
+ * \param[out]      items: pointer to number of items currently in the hash-table
+ */
+void shHashTableInfo(shHashTable_t* shht, uint32_t* size, uint32_t* items);
+
+/**
+ * \brief           Flush hash-table removing all values
+ *
+ * \param[in]       shht: pointer to hash-table object
+ *
+ * \return          UTILS_STATUS_SUCCESS if hash-table is flushed correctly, UTILS_STATUS_EMPTY if hash-table was already empty
+ */
+utilsStatus_t shHashTableFlush(shHashTable_t* shht);
+
+/**
+ * \brief           Delete hash-table
+ *
+ * \param[in]       shht: pointer to hash-table object
+ *
+ * \return          UTILS_STATUS_SUCCESS if hash-table is deleted, UTILS_STATUS_ERROR if hash-table was already deleted
+ * 
+ * \attention       No other thread must be accessing the hash-table
+ */
+utilsStatus_t shHashTableDelete(shHashTable_t* shht);
+#endif /* defined(ADVUTILS_USE_DYNAMIC_ALLOCATION) && defined(ADVUTILS_USE_PTHREADS) */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __SHHASHTABLE_H__ */
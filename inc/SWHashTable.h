@@ -0,0 +1,183 @@
+/* BEGIN Header */
+/**
+ ******************************************************************************
+ * \file            SWHashTable.h
+ * \author          Andrea Vivani
+ * \brief           Implementation of an open-addressing hash-table with SIMD group probing
+ ******************************************************************************
+ * \copyright
+ *
+ * Copyright 2024 Andrea Vivani
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the “Software”), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ ******************************************************************************
+ */
+/* END Header */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __SWHASHTABLE_H__
+#define __SWHASHTABLE_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+/* Includes ------------------------------------------------------------------*/
+
+#include <stddef.h>
+#include <stdint.h>
+#include "commonTypes.h"
+
+/* Typedefs ------------------------------------------------------------------*/
+
+/**
+ * Hash-Table resizability setting
+ */
+typedef enum { SWHT_NOT_RESIZABLE = 0, SWHT_RESIZABLE = 1 } swHashTableResizable_t;
+
+/*
+ * Hash-Table slot header, value follows it in the same slot
+ */
+typedef struct {
+    char* key;
+    uint32_t hash;
+} swHashTableEntry_t;
+
+/*
+ * Hash-Table struct
+ */
+typedef struct {
+    int8_t* ctrl;     /* control bytes, one per slot: 7-bit hash fingerprint if slot is full, negative if empty or deleted */
+    uint8_t* entries; /* hash slots, allocated in the same block right after control bytes */
+    uint32_t size, items;
+    size_t itemSize;
+    swHashTableResizable_t resizable;
+    uint32_t _deleted; /* number of deleted slots (tombstones) */
+    size_t _slotSize;
+} swHashTable_t;
+
+/**
+ * Hash-Table iterator 
+ */
+typedef struct {
+    char* key;
+    void* value;
+    swHashTable_t* _swht;
+    uint32_t _index;
+} swHashTableIterator_t;
+
+/**
+ * Hash-Table removal setting
+ */
+typedef enum { SWHT_REMOVE_ITEM = 0, SWHT_DO_NOT_REMOVE_ITEM = 1 } swHashTableRemoval_t;
+
+/* Function prototypes -------------------------------------------------------*/
+
+#ifdef ADVUTILS_USE_DYNAMIC_ALLOCATION
+/**
+ * \brief           Init SIMD group-probing hash-table structure
+ *
+ * \param[in]       swht: pointer to hash-table object
+ * \param[in]       itemSize: size of items to be handled by hash-table
+ * \param[in]       init_items: number of items to be initially allocated in the hash-table, rounded up to a power of 2 not smaller than 16
+ * \param[in]       resizable: SWHT_RESIZABLE if table should be resized once max saturation is reached, SWHT_NOT_RESIZABLE otherwise
+ * 
+ * \return          UTILS_STATUS_SUCCESS if hash-table was initialized, UTILS_STATUS_ERROR if data was not allocated correctly
+ */
+utilsStatus_t swHashTableInit(swHashTable_t* swht, size_t itemSize, uint32_t init_items, swHashTableResizable_t resizable);
+
+/**
+ * \brief           Set item with given key to value. If not already present in table, key is copied to newly allocated memory, otherwise it is only updated.
+ *
+ * \param[in]       swht: pointer to hash-table object
+ * \param[in]       key: pointer to key
+ * \param[in]       value: pointer to value to be written
+ * 
+ * \return          UTILS_STATUS_SUCCESS if data is written correctly, UTILS_STATUS_FULL if table is full, UTILS_STATUS_ERROR otherwise 
+ */
+utilsStatus_t swHashTablePut(swHashTable_t* swht, char* key, void* value);
+
+/**
+ * \brief           Get item with given key from hash table
+ *
+ * \param[in]       swht: pointer to hash-table object
+ * \param[in]       key: pointer to key
+ * \param[out]      value: pointer to value to be read
+ * \param[in]       remove: SWHT_REMOVE_ITEM if item should be removed after being read, SWHT_DO_NOT_REMOVE_ITEM if item should not be removed
+ * 
+ * \return          UTILS_STATUS_SUCCESS if data is read correctly, UTILS_STATUS_EMPTY if table is empty, UTILS_STATUS_WARNING if item was removed but
+ *                  down-sizing failed, UTILS_STATUS_ERROR if key is not found
+ */
+utilsStatus_t swHashTableGet(swHashTable_t* swht, char* key, void* value, swHashTableRemoval_t remove);
+
+/**
+ * \brief           Returns hash-table info
+ *
+ * \param[in]       swht: pointer to hash-table object
+ * \param[out]      size: pointer to size
+ * \param[out]      items: pointer to number of items currently in the hash-table
+ */
+static inline void swHashTableInfo(swHashTable_t* swht, uint32_t* size, uint32_t* items) {
+    *size = swht->size;
+    *items = swht->items;
+}
+
+/**
+ * \brief           Flush hash-table removing all values
+ *
+ * \param[in]       swht: pointer to hash-table object
+ *
+ * \return          UTILS_STATUS_SUCCESS if hash-table is flushed correctly, UTILS_STATUS_EMPTY if hash-table was already empty
+ */
+utilsStatus_t swHashTableFlush(swHashTable_t* swht);
+
+/**
+ * \brief           Delete hash-table
+ *
+ * \param[in]       swht: pointer to hash-table object
+ *
+ * \return          UTILS_STATUS_SUCCESS if hash-table is deleted, UTILS_STATUS_ERROR if hash-table was already deleted
+ */
+utilsStatus_t swHashTableDelete(swHashTable_t* swht);
+
+/**
+ * \brief           Create new iterator
+ *
+ * \param[in]       it: pointer to iterator object
+ * \param[in]       swht: pointer to hash-table object
+ */
+void swHashTableIt(swHashTableIterator_t* it, swHashTable_t* swht);
+
+/**
+ * \brief           Move iterator to next item in hash-table, updating its key and value pointers
+ *
+ * \param[in]       it: pointer to iterator object
+ *
+ * \return          UTILS_STATUS_SUCCESS if iterator is moved to next item, UTILS_STATUS_ERROR if there are no more items
+ * 
+ * \attention       Hash-table must not be modified while iterating
+ */
+utilsStatus_t swHashTableItNext(swHashTableIterator_t* it);
+#endif /* ADVUTILS_USE_DYNAMIC_ALLOCATION */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __SWHASHTABLE_H__ */
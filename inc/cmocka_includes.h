@@ -0,0 +1,18 @@
+#ifndef __CMOCKA_INCLUDES_H__
+#define __CMOCKA_INCLUDES_H__
+
+#include <setjmp.h>
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include <cmocka.h>
+
+#define ADVUTILS_ASSERT(x) ADVUtils_testAssert((int)(x), #x, __FILE__, __LINE__);
+
+void* ADVUtils_testCalloc(const size_t number_of_elements, const size_t size);
+void* ADVUtils_testMalloc(const size_t size);
+void ADVUtils_testAssert(const int result, const char* const expression, const char* const file, const int line);
+uint32_t ADVUtils_testHash(char* key);
+
+#endif /* __CMOCKA_INCLUDES_H__ */
@@ -40,6 +40,7 @@ extern "C" {
 #endif
 /* Includes ------------------------------------------------------------------*/
 
+#include <stddef.h>
 #include <stdint.h>
 
 /* Macros --------------------------------------------------------------------*/
@@ -76,6 +77,92 @@ uint32_t hash_djb(char* key);
  */
 uint32_t hash_sdbm(char* key);
 
+/**
+ * \brief           64-bit FNV-1a hash for binary key of given length
+ *
+ * \param[in]       key: pointer to key
+ * \param[in]       len: length of key in bytes
+ * 
+ * \return          hash
+ */
+uint32_t hash_FNV1A_buf(const void* key, size_t len);
+
+/**
+ * \brief           Full-width 64-bit FNV-1a hash for binary key of given length
+ *
+ * \param[in]       key: pointer to key
+ * \param[in]       len: length of key in bytes
+ * 
+ * \return          hash
+ */
+uint64_t hash_FNV1A64_buf(const void* key, size_t len);
+
+/**
+ * \brief           Integer mix hash for 32-bit keys (MurmurHash3 finalizer), all output bits depend on all input bits
+ *
+ * \param[in]       key: key
+ * 
+ * \return          hash
+ */
+uint32_t hash_mix32(uint32_t key);
+
+/**
+ * \brief           Integer mix hash for 64-bit keys (MurmurHash3 finalizer), folded to 32 bits
+ *
+ * \param[in]       key: key
+ * 
+ * \return          hash
+ */
+uint32_t hash_mix64(uint64_t key);
+
+/**
+ * \brief           MurmurHash3 (x86, 32-bit) for key (NUL-terminated), 4 bytes per step with 32-bit arithmetic only
+ *
+ * \param[in]       key: pointer to key string
+ * 
+ * \return          hash
+ */
+uint32_t hash_murmur3(char* key);
+
+/**
+ * \brief           MurmurHash3 (x86, 32-bit) for binary key of given length
+ *
+ * \param[in]       key: pointer to key
+ * \param[in]       len: length of key in bytes
+ * 
+ * \return          hash
+ */
+uint32_t hash_murmur3_buf(const void* key, size_t len);
+
+/**
+ * \brief           wyhash for key (NUL-terminated), up to 48 bytes per step using 64x64 -> 128 bit multiplications. Folded to 32 bits
+ *
+ * \param[in]       key: pointer to key string
+ * 
+ * \return          hash
+ */
+uint32_t hash_wy(char* key);
+
+/**
+ * \brief           wyhash for binary key of given length, folded to 32 bits
+ *
+ * \param[in]       key: pointer to key
+ * \param[in]       len: length of key in bytes
+ * 
+ * \return          hash
+ */
+uint32_t hash_wy_buf(const void* key, size_t len);
+
+/**
+ * \brief           Full-width 64-bit wyhash for binary key of given length
+ *
+ * \param[in]       key: pointer to key
+ * \param[in]       len: length of key in bytes
+ * 
+ * \return          hash
+ */
+uint64_t hash_wy64_buf(const void* key, size_t len);
+
 #ifdef __cplusplus
 }
 #endif
@@ -97,7 +97,7 @@ void listInit(list_t* list, size_t itemSize, LIST_STYPE size);
  * \param[in]       list: pointer to list object
  * \param[in]       value: pointer to value to be pushed
  *
- * \return          UTILS_STATUS_SUCCESS if data can be pushed correctly, UTILS_STATUS_FULL if list is full
+ * \return          UTILS_STATUS_SUCCESS if data can be pushed correctly, UTILS_STATUS_FULL if list is full, UTILS_STATUS_ERROR if memory cannot be allocated
  */
 utilsStatus_t listPush(list_t* list, void* value);
 
@@ -107,7 +107,7 @@ utilsStatus_t listPush(list_t* list, void* value);
  * \param[in]       list: pointer to list object
  * \param[in]       value: pointer to value to be pushed to front
  *
- * \return          UTILS_STATUS_SUCCESS if data can be pushed to front correctly, UTILS_STATUS_FULL if list is full
+ * \return          UTILS_STATUS_SUCCESS if data can be pushed to front correctly, UTILS_STATUS_FULL if list is full, UTILS_STATUS_ERROR if memory cannot be allocated
  */
 utilsStatus_t listPushFront(list_t* list, void* value);
 
@@ -118,7 +118,7 @@ utilsStatus_t listPushFront(list_t* list, void* value);
  * \param[in]       value: pointer to value to be pushed to front
  * \param[in]       position: position where to add data
  *
- * \return          UTILS_STATUS_SUCCESS if data can be added correctly, UTILS_STATUS_FULL if list is full, UTILS_STATUS_ERROR if position is invalid
+ * \return          UTILS_STATUS_SUCCESS if data can be added correctly, UTILS_STATUS_FULL if list is full, UTILS_STATUS_ERROR if position is invalid or memory cannot be allocated
  */
 utilsStatus_t listInsert(list_t* list, void* value, LIST_STYPE position);
 
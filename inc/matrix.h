@@ -50,6 +50,12 @@ extern "C" {
 #define ELEMP(m, i, j) (m->data[(i) * m->cols + (j)])
 #define ELEM(m, i, j)  (m.data[(i) * m.cols + (j)])
 
+/* Size (number of floats) of workspace needed by matrixMultStrassen */
+#define MATRIX_STRASSEN_WORKSPACE_SIZE(n) ((n) * (n))
+
+/* Size (number of floats) of workspace needed by matrixExpm */
+#define MATRIX_EXPM_WORKSPACE_SIZE(n) (4 * (n) * (n))
+
 /* Typedefs ------------------------------------------------------------------*/
 
 /**
@@ -163,6 +169,16 @@ void matrixMult_lhsT(matrix_t* lhs, matrix_t* rhs, matrix_t* result);
  */
 void matrixMult_rhsT(matrix_t* lhs, matrix_t* rhs, matrix_t* result);
 
+/**
+ * \brief           Square matrix multiplication with Strassen-Winograd recursion, falling back to the direct kernel below MATRIX_STRASSEN_CUTOFF size
+ *
+ * \param[in]       lhs: pointer to left-hand side n x n matrix object
+ * \param[in]       rhs: pointer to right-hand side n x n matrix object
+ * \param[out]      result: pointer to n x n result matrix object. Must not be the same as lhs or rhs
+ * \param[in]       workspace: pointer to workspace array of size MATRIX_STRASSEN_WORKSPACE_SIZE(n)
+ */
+void matrixMultStrassen(matrix_t* lhs, matrix_t* rhs, matrix_t* result, float* workspace);
+
 /**
  * \brief           Matrix multiplication with scalar
  *
@@ -174,7 +190,9 @@ void matrixMultScalar(matrix_t* lhs, float sc, matrix_t* result);
 
 #ifdef ADVUTILS_USE_DYNAMIC_ALLOCATION
 /**
- * \brief           Matrix inversion
+ * \brief           Matrix inversion, with closed-form cofactor expansion up to 4x4 and in-place Gauss-Jordan elimination with partial pivoting above
+ *
+ * \attention       result is set to zero if lhs is singular. result can be the same as lhs
  *
  * \param[in]       lhs: pointer to left-hand side matrix object
  * \param[out]      result: pointer to result matrix object
@@ -192,7 +210,10 @@ void matrixInversed_rob(matrix_t* lhs, matrix_t* result);
 
 #ifdef ADVUTILS_USE_STATIC_ALLOCATION
 /**
- * \brief           Matrix inversion with static allocation
+ * \brief           Matrix inversion with static allocation, with closed-form cofactor expansion up to 4x4 and in-place Gauss-Jordan elimination with partial
+ *                  pivoting above
+ *
+ * \attention       result is set to zero if lhs is singular. result can be the same as lhs
  *
  * \param[in]       lhs: pointer to left-hand side matrix object
  * \param[out]      result: pointer to result matrix object
@@ -244,6 +265,17 @@ void matrixPseudoInv(matrix_t* lhs, matrix_t* result);
 void matrixPseudoInvStatic(matrix_t* lhs, matrix_t* result);
 #endif /* ADVUTILS_USE_STATIC_ALLOCATION */
 
+/**
+ * \brief           Matrix exponential calculated with scaling and squaring of a 6th order Pade approximant, without any memory allocation
+ *
+ * \param[in]       lhs: pointer to left-hand side matrix object
+ * \param[out]      result: pointer to result matrix object. Can be the same as lhs
+ * \param[in]       workspace: pointer to workspace array of size MATRIX_EXPM_WORKSPACE_SIZE(n)
+ *
+ * \return          UTILS_STATUS_SUCCESS if success, UTILS_STATUS_ERROR if Pade denominator is singular
+ */
+utilsStatus_t matrixExpm(matrix_t* lhs, matrix_t* result, float* workspace);
+
 /**
  * \brief           Set a single element inside matrix
  *
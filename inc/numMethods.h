@@ -42,6 +42,14 @@ extern "C" {
 /* Includes ------------------------------------------------------------------*/
 #include "matrix.h"
 
+/* Macros --------------------------------------------------------------------*/
+
+/* Size (number of floats) of workspace needed by DiscretizeZOH */
+#define DISCRETIZE_ZOH_WORKSPACE_SIZE(n, m) (MATRIX_EXPM_WORKSPACE_SIZE((n) + (m)) + ((n) + (m)) * ((n) + (m)))
+
+/* Size (number of floats) of workspace needed by DiscretizeTustin */
+#define DISCRETIZE_TUSTIN_WORKSPACE_SIZE(n, m) ((n) * (2 * (n) + (m)))
+
 /* Function prototypes -------------------------------------------------------*/
 
 /**
@@ -110,6 +118,59 @@ void QuadProd(matrix_t* A, matrix_t* B, matrix_t* result);
  */
 utilsStatus_t LU_Crout(matrix_t* A, matrix_t* L, matrix_t* U);
 
+/**
+ * \brief           Solve AX = B system in place using Gauss elimination with partial pivoting, without any memory allocation
+ *
+ * \param[in]       A: pointer to A matrix object, overwritten during the elimination
+ * \param[in]       B: pointer to B matrix object, overwritten with the result X
+ *
+ * \return          UTILS_STATUS_SUCCESS if success, UTILS_STATUS_ERROR if A is singular
+ */
+utilsStatus_t LinSolveGaussInPlace(matrix_t* A, matrix_t* B);
+
+/**
+ * \brief           Solve count independent n x n systems AX = B at once with LUP factorization, without any memory allocation
+ *
+ * \param[in]       A: pointer to batch of A matrices in SoA layout, i.e. element (i, j) of system s is A[(i * n + j) * count + s], overwritten during the
+ *                  elimination
+ * \param[in]       B: pointer to batch of B matrices in SoA layout, i.e. element (i, j) of system s is B[(i * m + j) * count + s], overwritten with the result X
+ * \param[in]       n: size of each A matrix
+ * \param[in]       m: number of columns of each B matrix
+ * \param[in]       count: number of systems in the batch
+ * \param[out]      singular: pointer to array of count flags, set to 1 for the singular systems. Can be NULL
+ *
+ * \return          UTILS_STATUS_SUCCESS if success, UTILS_STATUS_ERROR if at least one system is singular (the others are still solved)
+ */
+utilsStatus_t LinSolveLUPBatch(float* A, float* B, uint8_t n, uint8_t m, uint16_t count, uint8_t* singular);
+
+/**
+ * \brief           Discretize continuous-time state-space pair (A, B) with zero-order hold, such that Ad = expm(A * dT) and Bd = integral(expm(A * t) * B, t = 0..dT)
+ *
+ * \param[in]       A: pointer to n x n continuous-time A matrix object
+ * \param[in]       B: pointer to n x m continuous-time B matrix object
+ * \param[in]       dT_ms: sample time in milliseconds
+ * \param[out]      Ad: pointer to n x n discrete-time A matrix object
+ * \param[out]      Bd: pointer to n x m discrete-time B matrix object
+ * \param[in]       workspace: pointer to workspace array of size DISCRETIZE_ZOH_WORKSPACE_SIZE(n, m). n + m must not exceed 255
+ *
+ * \return          UTILS_STATUS_SUCCESS if success, UTILS_STATUS_ERROR if errors
+ */
+utilsStatus_t DiscretizeZOH(matrix_t* A, matrix_t* B, float dT_ms, matrix_t* Ad, matrix_t* Bd, float* workspace);
+
+/**
+ * \brief           Discretize continuous-time state-space pair (A, B) with Tustin (bilinear) transform, such that Ad = inv(I - A * dT / 2) * (I + A * dT / 2) and Bd = inv(I - A * dT / 2) * B * dT
+ *
+ * \param[in]       A: pointer to n x n continuous-time A matrix object
+ * \param[in]       B: pointer to n x m continuous-time B matrix object
+ * \param[in]       dT_ms: sample time in milliseconds
+ * \param[out]      Ad: pointer to n x n discrete-time A matrix object
+ * \param[out]      Bd: pointer to n x m discrete-time B matrix object
+ * \param[in]       workspace: pointer to workspace array of size DISCRETIZE_TUSTIN_WORKSPACE_SIZE(n, m)
+ *
+ * \return          UTILS_STATUS_SUCCESS if success, UTILS_STATUS_ERROR if (I - A * dT / 2) is singular
+ */
+utilsStatus_t DiscretizeTustin(matrix_t* A, matrix_t* B, float dT_ms, matrix_t* Ad, matrix_t* Bd, float* workspace);
+
 #ifdef ADVUTILS_USE_DYNAMIC_ALLOCATION
 /**
  * \brief           Calculate L (lower triangular) and U (upper triangular) matrices such that A = LU with Cormen's Method
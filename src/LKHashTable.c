@@ -60,48 +60,170 @@
 #define ADVUTILS_FREE   free
 #endif /* ADVUTILS_MEMORY_MGMT_HEADER */
 
-/* Maximum size of the list objects used by the hash-table */
-#ifndef LKHT_LIST_SIZE
-#define LKHT_LIST_SIZE UINT16_MAX
-#endif /* LKHT_LIST_SIZE */
+/* Minimum number of buckets of hash-table when resizing, must be a power of 2 */
+#ifndef LKHT_MIN_SIZE
+#define LKHT_MIN_SIZE 8
+#endif /* LKHT_MIN_SIZE */
+
+/* Maximum number of buckets of hash-table when resizing, must be a power of 2 */
+#ifndef LKHT_MAX_SIZE
+#define LKHT_MAX_SIZE 0x80000000UL
+#endif /* LKHT_MAX_SIZE */
+
+/* Minimum average number of items per bucket, that triggers a down-sizing */
+#ifndef LKHT_MIN_SATURATION
+#define LKHT_MIN_SATURATION 0.2
+#endif /* LKHT_MIN_SATURATION */
+
+/* Maximum average number of items per bucket, that triggers an up-sizing */
+#ifndef LKHT_MAX_SATURATION
+#define LKHT_MAX_SATURATION 1.0
+#endif /* LKHT_MAX_SATURATION */
+
+/* Size of key storage inside each pooled entry (terminator included), longer keys get an entry allocated on its own */
+#ifndef LKHT_INLINE_KEY_SIZE
+#define LKHT_INLINE_KEY_SIZE 24
+#endif /* LKHT_INLINE_KEY_SIZE */
+
+/* Number of entries allocated together when the pool is empty */
+#ifndef LKHT_POOL_CHUNK_SIZE
+#define LKHT_POOL_CHUNK_SIZE 64
+#endif /* LKHT_POOL_CHUNK_SIZE */
 
 /* Hash function used by hash-table */
 #ifndef LKHT_HASHFUN
 #define LKHT_HASHFUN hash_FNV1A
 #endif /* LKHT_HASHFUN */
 
+/* Hash function used by hash-table for binary keys */
+#ifndef LKHT_BIN_HASHFUN
+#define LKHT_BIN_HASHFUN hash_FNV1A_buf
+#endif /* LKHT_BIN_HASHFUN */
+
+#define LKHT_ALIGN(size)        (((size) + 7) & ~(size_t)7)
+#define LKHT_ENTRY_HEADER_SIZE  LKHT_ALIGN(sizeof(lkHashTableEntry_t))
+#define LKHT_POOL_HEADER_SIZE   LKHT_ALIGN(sizeof(lkHashTablePool_t))
+
+/* Function prototypes -------------------------------------------------------*/
+
+#ifdef ADVUTILS_USE_DYNAMIC_ALLOCATION
+static utilsStatus_t lkHashTablePutKey(lkHashTable_t* lkht, const void* key, uint32_t keyLen, uint32_t hash, void* value);
+static utilsStatus_t lkHashTableGetKey(lkHashTable_t* lkht, const void* key, uint32_t keyLen, uint32_t hash, void* value, lkHashTableRemoval_t remove);
+static utilsStatus_t lkHashTableGetRefKey(lkHashTable_t* lkht, const void* key, uint32_t keyLen, uint32_t hash, void** value);
+static utilsStatus_t lkHashTableFindOrAdd(lkHashTable_t* lkht, const void* key, uint32_t keyLen, uint32_t hash, void** value, uint8_t* inserted);
+static lkHashTableEntry_t** lkHashTableFindEntry(lkHashTable_t* lkht, const void* key, uint32_t keyLen, uint32_t hash);
+static lkHashTableEntry_t* lkHashTableAllocEntry(lkHashTable_t* lkht, uint32_t keyLen);
+static utilsStatus_t lkHashTableXpand(lkHashTable_t* lkht, uint8_t increase);
+#endif /* ADVUTILS_USE_DYNAMIC_ALLOCATION */
+
 /* Private Functions ---------------------------------------------------------*/
 
-static inline char* lkHashTableStrdup(const char* s) {
-    size_t bufsize = strlen(s) + 1;
-    char* retval = ADVUTILS_MALLOC(bufsize);
-    ADVUTILS_ASSERT(retval != NULL);
-    if (retval) {
-        memcpy(retval, s, bufsize);
+static inline void* lkHashTableEntryValue(lkHashTableEntry_t* entry) { return (uint8_t*)entry + LKHT_ENTRY_HEADER_SIZE; }
+
+static inline uint8_t* lkHashTableEntryKey(lkHashTable_t* lkht, lkHashTableEntry_t* entry) {
+    return (uint8_t*)entry + LKHT_ENTRY_HEADER_SIZE + lkht->_valueSize;
+}
+
+static inline uint8_t lkHashTableEntryMatch(lkHashTable_t* lkht, lkHashTableEntry_t* entry, const void* key, uint32_t keyLen, uint32_t hash) {
+    return (entry->hash == hash) && (entry->keyLen == keyLen) && !memcmp(key, lkHashTableEntryKey(lkht, entry), keyLen);
+}
+
+#ifdef ADVUTILS_USE_DYNAMIC_ALLOCATION
+/*
+ * Take an entry from the pool, refilling it with a new chunk if empty. Entries whose key doesn't fit a pooled one are allocated on their own
+ */
+static lkHashTableEntry_t* lkHashTableAllocEntry(lkHashTable_t* lkht, uint32_t keyLen) {
+    lkHashTableEntry_t* entry;
+    lkHashTablePool_t* chunk;
+    uint32_t ii;
+
+    if (keyLen > LKHT_INLINE_KEY_SIZE) {
+        entry = ADVUTILS_MALLOC(LKHT_ENTRY_HEADER_SIZE + lkht->_valueSize + keyLen);
+        ADVUTILS_ASSERT(entry != NULL);
+        return entry;
     }
-    return retval;
+
+    if (lkht->_free == NULL) {
+        chunk = ADVUTILS_MALLOC(LKHT_POOL_HEADER_SIZE + LKHT_POOL_CHUNK_SIZE * lkht->_entrySize);
+        ADVUTILS_ASSERT(chunk != NULL);
+        if (chunk == NULL) {
+            return NULL;
+        }
+        chunk->next = lkht->_pool;
+        lkht->_pool = chunk;
+        for (ii = LKHT_POOL_CHUNK_SIZE; ii > 0; ii--) {
+            entry = (lkHashTableEntry_t*)((uint8_t*)chunk + LKHT_POOL_HEADER_SIZE + (ii - 1) * lkht->_entrySize);
+            entry->next = lkht->_free;
+            lkht->_free = entry;
+        }
+    }
+
+    entry = lkht->_free;
+    lkht->_free = entry->next;
+    return entry;
+}
+
+static inline void lkHashTableFreeEntry(lkHashTable_t* lkht, lkHashTableEntry_t* entry) {
+    if (entry->keyLen > LKHT_INLINE_KEY_SIZE) {
+        ADVUTILS_FREE(entry);
+    } else {
+        entry->next = lkht->_free;
+        lkht->_free = entry;
+    }
+}
+
+/*
+ * Return the link (bucket head or previous entry next pointer) to the entry with given key, or to the end of the bucket if key is not present.
+ * Lookups, insertions, updates and removals all need a single pass over the bucket
+ */
+static lkHashTableEntry_t** lkHashTableFindEntry(lkHashTable_t* lkht, const void* key, uint32_t keyLen, uint32_t hash) {
+    lkHashTableEntry_t** head = &(lkht->entries[hash & (lkht->size - 1)]);
+    lkHashTableEntry_t** link = head;
+
+    while ((*link != NULL) && !lkHashTableEntryMatch(lkht, *link, key, keyLen, hash)) {
+        link = &((*link)->next);
+    }
+
+#ifdef LKHT_MOVE_TO_FRONT
+    /* entries found are moved to the head of their bucket, so that frequently used keys are found first */
+    if ((*link != NULL) && (link != head)) {
+        lkHashTableEntry_t* entry = *link;
+        *link = entry->next;
+        entry->next = *head;
+        *head = entry;
+        link = head;
+    }
+#endif /* LKHT_MOVE_TO_FRONT */
+
+    return link;
 }
+#endif /* ADVUTILS_USE_DYNAMIC_ALLOCATION */
 
 /* Functions -----------------------------------------------------------------*/
 
 #ifdef ADVUTILS_USE_DYNAMIC_ALLOCATION
 
-utilsStatus_t lkHashTableInit(lkHashTable_t* lkht, size_t itemSize, uint32_t size) {
-    uint32_t ii;
+utilsStatus_t lkHashTableInit(lkHashTable_t* lkht, size_t itemSize, uint32_t size, lkHashTableResizable_t resizable) {
     lkht->items = 0;
-    lkht->size = size;
     lkht->itemSize = itemSize;
+    lkht->resizable = resizable;
+    lkht->_valueSize = LKHT_ALIGN(itemSize);
+    lkht->_entrySize = LKHT_ENTRY_HEADER_SIZE + lkht->_valueSize + LKHT_ALIGN(LKHT_INLINE_KEY_SIZE);
+    lkht->_free = NULL;
+    lkht->_pool = NULL;
+
+    /* buckets are selected by the lowest bits of the hash */
+    lkht->size = (size > 1) ? 2 : size;
+    while ((lkht->size < size) && (lkht->size < LKHT_MAX_SIZE)) {
+        lkht->size <<= 1;
+    }
 
-    lkht->entries = ADVUTILS_CALLOC(lkht->size, sizeof(list_t));
+    lkht->entries = ADVUTILS_CALLOC(lkht->size, sizeof(lkHashTableEntry_t*));
     ADVUTILS_ASSERT(lkht->entries != NULL);
     if (lkht->entries == NULL) {
         return UTILS_STATUS_ERROR;
     }
 
-    for (ii = 0; ii < lkht->size; ii++) {
-        listInit(&(lkht->entries[ii]), sizeof(lkHashTableEntry_t), LKHT_LIST_SIZE);
-    }
-
     return UTILS_STATUS_SUCCESS;
 }
 
@@ -110,102 +232,190 @@ utilsStatus_t lkHashTablePut(lkHashTable_t* lkht, char* key, void* value) {
         return UTILS_STATUS_ERROR;
     }
 
-    if (lkht->items == lkht->size) {
-        return UTILS_STATUS_FULL;
+    return lkHashTablePutKey(lkht, key, strlen(key) + 1, LKHT_HASHFUN(key), value);
+}
+
+utilsStatus_t lkHashTableGet(lkHashTable_t* lkht, char* key, void* value, lkHashTableRemoval_t remove) {
+
+    if (!lkht->items) {
+        return UTILS_STATUS_EMPTY;
     }
 
-    /* limit hash to current memory size */
-    uint32_t ii = LKHT_HASHFUN(key) & (lkht->size - 1);
+    return lkHashTableGetKey(lkht, key, strlen(key) + 1, LKHT_HASHFUN(key), value, remove);
+}
 
-    lkHashTableEntry_t entry;
+utilsStatus_t lkHashTablePutBin(lkHashTable_t* lkht, const void* key, size_t keyLen, void* value) {
+    if ((value == NULL) || (key == NULL) || !keyLen || (keyLen > UINT32_MAX)) {
+        return UTILS_STATUS_ERROR;
+    }
 
-    /* check if entry exists and update it */
-    LIST_STYPE idx;
+    return lkHashTablePutKey(lkht, key, (uint32_t)keyLen, LKHT_BIN_HASHFUN(key, keyLen), value);
+}
 
-    for (idx = 0; idx < lkht->entries[ii].items; idx++) {
-        listPeekAtPos(&(lkht->entries[ii]), &entry, idx);
-        if (!strcmp(key, entry.key)) {
-            memcpy(entry.value, value, lkht->itemSize);
-            return UTILS_STATUS_SUCCESS;
-        }
+utilsStatus_t lkHashTableGetBin(lkHashTable_t* lkht, const void* key, size_t keyLen, void* value, lkHashTableRemoval_t remove) {
+
+    if (!lkht->items) {
+        return UTILS_STATUS_EMPTY;
     }
 
-    /* set entry and update length */
-    entry.key = lkHashTableStrdup(key);
-    entry.value = ADVUTILS_CALLOC(1, lkht->itemSize);
-    ADVUTILS_ASSERT(entry.value != NULL);
+    if ((key == NULL) || !keyLen || (keyLen > UINT32_MAX)) {
+        return UTILS_STATUS_ERROR;
+    }
+
+    return lkHashTableGetKey(lkht, key, (uint32_t)keyLen, LKHT_BIN_HASHFUN(key, keyLen), value, remove);
+}
 
-    if ((entry.key == NULL) || (entry.value == NULL)) {
-        ADVUTILS_FREE(entry.key);
-        ADVUTILS_FREE(entry.value);
+utilsStatus_t lkHashTablePutU32(lkHashTable_t* lkht, uint32_t key, void* value) {
+    if (value == NULL) {
         return UTILS_STATUS_ERROR;
     }
 
-    memcpy(entry.value, value, lkht->itemSize);
+    return lkHashTablePutKey(lkht, &key, sizeof(key), hash_mix32(key), value);
+}
 
-    if (listPush(&(lkht->entries[ii]), &entry) == UTILS_STATUS_SUCCESS) {
-        lkht->items++;
-        return UTILS_STATUS_SUCCESS;
+utilsStatus_t lkHashTableGetU32(lkHashTable_t* lkht, uint32_t key, void* value, lkHashTableRemoval_t remove) {
+
+    if (!lkht->items) {
+        return UTILS_STATUS_EMPTY;
     }
-    ADVUTILS_FREE(entry.key);
-    ADVUTILS_FREE(entry.value);
-    return UTILS_STATUS_ERROR;
+
+    return lkHashTableGetKey(lkht, &key, sizeof(key), hash_mix32(key), value, remove);
 }
 
-utilsStatus_t lkHashTableGet(lkHashTable_t* lkht, char* key, void* value, lkHashTableRemoval_t remove) {
+utilsStatus_t lkHashTablePutU64(lkHashTable_t* lkht, uint64_t key, void* value) {
+    if (value == NULL) {
+        return UTILS_STATUS_ERROR;
+    }
+
+    return lkHashTablePutKey(lkht, &key, sizeof(key), hash_mix64(key), value);
+}
+
+utilsStatus_t lkHashTableGetU64(lkHashTable_t* lkht, uint64_t key, void* value, lkHashTableRemoval_t remove) {
 
     if (!lkht->items) {
         return UTILS_STATUS_EMPTY;
     }
 
-    uint32_t ii = LKHT_HASHFUN(key) & (lkht->size - 1);
+    return lkHashTableGetKey(lkht, &key, sizeof(key), hash_mix64(key), value, remove);
+}
 
-    if (!lkht->entries[ii].items) {
-        return UTILS_STATUS_BUCKET_EMPTY;
+utilsStatus_t lkHashTableGetRef(lkHashTable_t* lkht, char* key, void** value) {
+
+    if (!lkht->items) {
+        return UTILS_STATUS_EMPTY;
     }
 
-    /* check if entry exists and return it */
-    lkHashTableEntry_t entry;
-    listIterator_t iterator;
-
-    listIt(&iterator, &(lkht->entries[ii]));
-
-    while (listItNext(&iterator) == UTILS_STATUS_SUCCESS) {
-        memcpy(&entry, iterator.ptr->data, sizeof(lkHashTableEntry_t));
-
-        if (!strcmp(key, entry.key)) {
-            memcpy(value, entry.value, lkht->itemSize);
-            if (remove == LKHT_REMOVE_ITEM) {
-                listRemove(&(lkht->entries[ii]), &entry, iterator.idx);
-                lkht->items--;
-                ADVUTILS_FREE(entry.key);
-                ADVUTILS_FREE(entry.value);
-                return UTILS_STATUS_SUCCESS;
-            }
-            return UTILS_STATUS_SUCCESS;
+    return lkHashTableGetRefKey(lkht, key, strlen(key) + 1, LKHT_HASHFUN(key), value);
+}
+
+utilsStatus_t lkHashTableGetOrInsert(lkHashTable_t* lkht, char* key, void** value, uint8_t* inserted) {
+    if ((value == NULL) || (key == NULL)) {
+        return UTILS_STATUS_ERROR;
+    }
+
+    return lkHashTableFindOrAdd(lkht, key, strlen(key) + 1, LKHT_HASHFUN(key), value, inserted);
+}
+
+utilsStatus_t lkHashTableGetRefBin(lkHashTable_t* lkht, const void* key, size_t keyLen, void** value) {
+
+    if (!lkht->items) {
+        return UTILS_STATUS_EMPTY;
+    }
+
+    if ((key == NULL) || !keyLen || (keyLen > UINT32_MAX)) {
+        return UTILS_STATUS_ERROR;
+    }
+
+    return lkHashTableGetRefKey(lkht, key, (uint32_t)keyLen, LKHT_BIN_HASHFUN(key, keyLen), value);
+}
+
+utilsStatus_t lkHashTableGetOrInsertBin(lkHashTable_t* lkht, const void* key, size_t keyLen, void** value, uint8_t* inserted) {
+    if ((value == NULL) || (key == NULL) || !keyLen || (keyLen > UINT32_MAX)) {
+        return UTILS_STATUS_ERROR;
+    }
+
+    return lkHashTableFindOrAdd(lkht, key, (uint32_t)keyLen, LKHT_BIN_HASHFUN(key, keyLen), value, inserted);
+}
+
+utilsStatus_t lkHashTableGetRefU32(lkHashTable_t* lkht, uint32_t key, void** value) {
+
+    if (!lkht->items) {
+        return UTILS_STATUS_EMPTY;
+    }
+
+    return lkHashTableGetRefKey(lkht, &key, sizeof(key), hash_mix32(key), value);
+}
+
+utilsStatus_t lkHashTableGetOrInsertU32(lkHashTable_t* lkht, uint32_t key, void** value, uint8_t* inserted) {
+    if (value == NULL) {
+        return UTILS_STATUS_ERROR;
+    }
+
+    return lkHashTableFindOrAdd(lkht, &key, sizeof(key), hash_mix32(key), value, inserted);
+}
+
+utilsStatus_t lkHashTableGetRefU64(lkHashTable_t* lkht, uint64_t key, void** value) {
+
+    if (!lkht->items) {
+        return UTILS_STATUS_EMPTY;
+    }
+
+    return lkHashTableGetRefKey(lkht, &key, sizeof(key), hash_mix64(key), value);
+}
+
+utilsStatus_t lkHashTableGetOrInsertU64(lkHashTable_t* lkht, uint64_t key, void** value, uint8_t* inserted) {
+    if (value == NULL) {
+        return UTILS_STATUS_ERROR;
+    }
+
+    return lkHashTableFindOrAdd(lkht, &key, sizeof(key), hash_mix64(key), value, inserted);
+}
+
+#ifdef LKHT_STATS
+void lkHashTableStats(lkHashTable_t* lkht, lkHashTableStats_t* stats) {
+    uint32_t ii, len, used = 0;
+    uint64_t probes = 0;
+    lkHashTableEntry_t* entry;
+
+    memset(stats, 0, sizeof(lkHashTableStats_t));
+
+    for (ii = 0; ii < lkht->size; ii++) {
+        len = 0;
+        for (entry = lkht->entries[ii]; entry != NULL; entry = entry->next) {
+            len++;
+        }
+        stats->chainHist[(len < LKHT_STATS_HIST_SIZE) ? len : (LKHT_STATS_HIST_SIZE - 1)]++;
+        if (len > stats->maxChain) {
+            stats->maxChain = len;
+        }
+        if (len) {
+            used++;
         }
+        /* Entry at position n of its chain takes n + 1 comparisons to be found */
+        probes += (uint64_t)len * (len + 1) / 2;
     }
 
-    return UTILS_STATUS_ERROR;
+    if (used) {
+        stats->avgChain = (float)lkht->items / used;
+        stats->avgProbe = (float)probes / lkht->items;
+    }
 }
+#endif /* LKHT_STATS */
 
 utilsStatus_t lkHashTableFlush(lkHashTable_t* lkht) {
     uint32_t ii;
+    lkHashTableEntry_t* entry;
 
     if (!lkht->items) {
         return UTILS_STATUS_SUCCESS;
     }
 
-    lkHashTableEntry_t entry;
-    LIST_STYPE idx;
-
+    /* pooled entries go back to the pool, to be reused by following insertions */
     for (ii = 0; ii < lkht->size; ii++) {
-        idx = lkht->entries[ii].items;
-
-        while (idx--) {
-            listPop(&(lkht->entries[ii]), &entry);
-            ADVUTILS_FREE(entry.key);
-            ADVUTILS_FREE(entry.value);
+        while (lkht->entries[ii] != NULL) {
+            entry = lkht->entries[ii];
+            lkht->entries[ii] = entry->next;
+            lkHashTableFreeEntry(lkht, entry);
         }
     }
 
@@ -215,6 +425,7 @@ utilsStatus_t lkHashTableFlush(lkHashTable_t* lkht) {
 }
 
 utilsStatus_t lkHashTableDelete(lkHashTable_t* lkht) {
+    lkHashTablePool_t* chunk;
 
     if (lkht->entries == NULL) {
         return UTILS_STATUS_ERROR;
@@ -222,10 +433,152 @@ utilsStatus_t lkHashTableDelete(lkHashTable_t* lkht) {
 
     lkHashTableFlush(lkht);
 
+    while (lkht->_pool != NULL) {
+        chunk = lkht->_pool;
+        lkht->_pool = chunk->next;
+        ADVUTILS_FREE(chunk);
+    }
+    lkht->_free = NULL;
+
     ADVUTILS_FREE(lkht->entries);
     lkht->entries = NULL;
 
     return UTILS_STATUS_SUCCESS;
 }
 
+static utilsStatus_t lkHashTablePutKey(lkHashTable_t* lkht, const void* key, uint32_t keyLen, uint32_t hash, void* value) {
+    void* ref;
+    utilsStatus_t retval = lkHashTableFindOrAdd(lkht, key, keyLen, hash, &ref, NULL);
+
+    if ((retval == UTILS_STATUS_SUCCESS) || (retval == UTILS_STATUS_WARNING)) {
+        memcpy(ref, value, lkht->itemSize);
+    }
+
+    return retval;
+}
+
+static utilsStatus_t lkHashTableFindOrAdd(lkHashTable_t* lkht, const void* key, uint32_t keyLen, uint32_t hash, void** value, uint8_t* inserted) {
+
+    /* check if entry exists and return it, otherwise link points to the end of the bucket */
+    lkHashTableEntry_t** link = lkHashTableFindEntry(lkht, key, keyLen, hash);
+    lkHashTableEntry_t* entry = *link;
+
+    if (entry != NULL) {
+        *value = lkHashTableEntryValue(entry);
+        if (inserted != NULL) {
+            *inserted = 0;
+        }
+        return UTILS_STATUS_SUCCESS;
+    }
+
+    /* key and zeroed value are stored in a single entry */
+    entry = lkHashTableAllocEntry(lkht, keyLen);
+    if (entry == NULL) {
+        return UTILS_STATUS_ERROR;
+    }
+    entry->next = NULL;
+    entry->hash = hash;
+    entry->keyLen = keyLen;
+    memset(lkHashTableEntryValue(entry), 0, lkht->itemSize);
+    memcpy(lkHashTableEntryKey(lkht, entry), key, keyLen);
+    *link = entry;
+
+    lkht->items++;
+    *value = lkHashTableEntryValue(entry);
+    if (inserted != NULL) {
+        *inserted = 1;
+    }
+
+    /* entry is already linked, so a failed resize only leaves chains longer */
+    if ((lkht->items > (lkht->size * LKHT_MAX_SATURATION)) && (lkht->resizable != LKHT_NOT_RESIZABLE)) {
+        if (lkHashTableXpand(lkht, 1) == UTILS_STATUS_ERROR) {
+            return UTILS_STATUS_WARNING;
+        }
+    }
+    return UTILS_STATUS_SUCCESS;
+}
+
+static utilsStatus_t lkHashTableGetRefKey(lkHashTable_t* lkht, const void* key, uint32_t keyLen, uint32_t hash, void** value) {
+    lkHashTableEntry_t* entry;
+
+    if (lkht->entries[hash & (lkht->size - 1)] == NULL) {
+        return UTILS_STATUS_BUCKET_EMPTY;
+    }
+
+    entry = *lkHashTableFindEntry(lkht, key, keyLen, hash);
+    if (entry == NULL) {
+        return UTILS_STATUS_ERROR;
+    }
+
+    *value = lkHashTableEntryValue(entry);
+    return UTILS_STATUS_SUCCESS;
+}
+
+static utilsStatus_t lkHashTableGetKey(lkHashTable_t* lkht, const void* key, uint32_t keyLen, uint32_t hash, void* value, lkHashTableRemoval_t remove) {
+    lkHashTableEntry_t **link, *entry;
+
+    if (lkht->entries[hash & (lkht->size - 1)] == NULL) {
+        return UTILS_STATUS_BUCKET_EMPTY;
+    }
+
+    /* check if entry exists and return it */
+    link = lkHashTableFindEntry(lkht, key, keyLen, hash);
+    entry = *link;
+    if (entry == NULL) {
+        return UTILS_STATUS_ERROR;
+    }
+
+    memcpy(value, lkHashTableEntryValue(entry), lkht->itemSize);
+    if (remove == LKHT_REMOVE_ITEM) {
+        *link = entry->next;
+        lkHashTableFreeEntry(lkht, entry);
+        if ((--lkht->items < (lkht->size * LKHT_MIN_SATURATION)) && (lkht->resizable != LKHT_NOT_RESIZABLE)) {
+            if (lkHashTableXpand(lkht, 0) == UTILS_STATUS_ERROR) {
+                return UTILS_STATUS_WARNING;
+            }
+        }
+    }
+
+    return UTILS_STATUS_SUCCESS;
+}
+
+static utilsStatus_t lkHashTableXpand(lkHashTable_t* lkht, uint8_t increase) {
+    uint32_t ii, newSize;
+    lkHashTableEntry_t **newEntries, *entry;
+
+    if (increase) {
+        if (lkht->size >= LKHT_MAX_SIZE) {
+            return UTILS_STATUS_SUCCESS;
+        }
+        newSize = lkht->size * 2;
+    } else {
+        if (lkht->size <= LKHT_MIN_SIZE) {
+            return UTILS_STATUS_SUCCESS;
+        }
+        newSize = lkht->size >> 1;
+    }
+
+    newEntries = ADVUTILS_CALLOC(newSize, sizeof(lkHashTableEntry_t*));
+    ADVUTILS_ASSERT(newEntries != NULL);
+    if (newEntries == NULL) {
+        return UTILS_STATUS_ERROR;
+    }
+
+    /* entries keep their hash, so they are relinked to the new buckets without being copied or hashed again */
+    for (ii = 0; ii < lkht->size; ii++) {
+        while (lkht->entries[ii] != NULL) {
+            entry = lkht->entries[ii];
+            lkht->entries[ii] = entry->next;
+            entry->next = newEntries[entry->hash & (newSize - 1)];
+            newEntries[entry->hash & (newSize - 1)] = entry;
+        }
+    }
+
+    ADVUTILS_FREE(lkht->entries);
+    lkht->entries = newEntries;
+    lkht->size = newSize;
+
+    return UTILS_STATUS_SUCCESS;
+}
+
 #endif /* ADVUTILS_USE_DYNAMIC_ALLOCATION */
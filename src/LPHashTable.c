@@ -42,6 +42,16 @@
 #include <string.h>
 #include "ADVUtilsAssert.h"
 #include "hashFunctions.h"
+#ifdef LPHT_USE_SNAPSHOT
+#include <fcntl.h>
+#include <stdio.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif /* LPHT_USE_SNAPSHOT */
+#ifdef LPHT_STATS
+#include <time.h>
+#endif /* LPHT_STATS */
 #ifdef ADVUTILS_MEMORY_MGMT_HEADER
 #if !defined(ADVUTILS_MALLOC) || !defined(ADVUTILS_CALLOC) || !defined(ADVUTILS_FREE)
 #error ADVUTILS_MALLOC, ADVUTILS_CALLOC and ADVUTILS_FREE must be defined by the user!
@@ -77,33 +87,204 @@
 
 /* Maximum saturation of hash-table, that triggers an up-sizing */
 #ifndef LPHT_MAX_SATURATION
-#define LPHT_MAX_SATURATION 0.7
+#define LPHT_MAX_SATURATION 0.85
 #endif /* LPHT_MAX_SATURATION */
 
+/* Size of key storage inside each slot (terminator included), longer keys are stored in the overflow storage */
+#ifndef LPHT_INLINE_KEY_SIZE
+#define LPHT_INLINE_KEY_SIZE 24
+#endif /* LPHT_INLINE_KEY_SIZE */
+
+/* Number of old slots migrated by each operation during an incremental resize */
+#ifndef LPHT_MIGRATION_STEP
+#define LPHT_MIGRATION_STEP 8
+#endif /* LPHT_MIGRATION_STEP */
+
+/* Number of empty old slots that can be skipped for each migrated one, so that sparse old slots don't make a single operation slow */
+#ifndef LPHT_MIGRATION_EMPTY_VISITS
+#define LPHT_MIGRATION_EMPTY_VISITS 10
+#endif /* LPHT_MIGRATION_EMPTY_VISITS */
+
+/* Number of keys hashed and prefetched together by batch operations */
+#ifndef LPHT_BATCH_SIZE
+#define LPHT_BATCH_SIZE 16
+#endif /* LPHT_BATCH_SIZE */
+
+/* Minimum size of each chunk of overflow storage */
+#ifndef LPHT_ARENA_CHUNK_SIZE
+#define LPHT_ARENA_CHUNK_SIZE 1024
+#endif /* LPHT_ARENA_CHUNK_SIZE */
+
 /* Hash function used by hash-table */
 #ifndef LPHT_HASHFUN
 #define LPHT_HASHFUN hash_FNV1A
 #endif /* LPHT_HASHFUN */
 
+/* Hash function used by hash-table for binary keys */
+#ifndef LPHT_BIN_HASHFUN
+#define LPHT_BIN_HASHFUN hash_FNV1A_buf
+#endif /* LPHT_BIN_HASHFUN */
+
+/* Time source used to measure resizes when LPHT_STATS is defined, default is nanoseconds from timespec_get */
+#ifndef LPHT_STATS_CLOCK
+#define LPHT_STATS_CLOCK() lpHashTableStatsClock()
+#endif /* LPHT_STATS_CLOCK */
+
+/* Round size up to 8 bytes, so that slots and values stay aligned */
+#define LPHT_ALIGN(x)       (((x) + 7) & ~((size_t)7))
+
+/* Size of inline key storage (at least a pointer to overflow storage), rounded so that value is aligned */
+#define LPHT_KEY_SIZE                                                                                                                      \
+    (LPHT_ALIGN(sizeof(lpHashTableEntry_t) + ((LPHT_INLINE_KEY_SIZE > sizeof(char*)) ? LPHT_INLINE_KEY_SIZE : sizeof(char*)))              \
+     - sizeof(lpHashTableEntry_t))
+
+/* Size of slots holding items of given size */
+#define LPHT_SLOT_SIZE(itemSize) LPHT_ALIGN(sizeof(lpHashTableEntry_t) + LPHT_KEY_SIZE + (itemSize))
+
+/* Pointer to slot ii of given slots array */
+#define LPHT_SLOT_IN(lpht, slots, ii) ((lpHashTableEntry_t*)((slots) + (size_t)(ii) * (lpht)->_slotSize))
+
+/* Pointer to slot ii */
+#define LPHT_SLOT(lpht, ii)           LPHT_SLOT_IN(lpht, (lpht)->entries, ii)
+
+/* Hint to load the memory at given address in cache, as it will be accessed soon */
+#if defined(__GNUC__) || defined(__clang__)
+#define LPHT_PREFETCH(addr) __builtin_prefetch(addr)
+#else
+#define LPHT_PREFETCH(addr) ((void)(addr))
+#endif /* defined(__GNUC__) || defined(__clang__) */
+
+#ifdef LPHT_USE_SNAPSHOT
+/* Snapshot file identification */
+#define LPHT_SNAPSHOT_MAGIC      "ADVLPHT"
+#define LPHT_SNAPSHOT_VERSION    1
+#define LPHT_SNAPSHOT_ENDIANNESS 0x01020304UL
+
+/* Typedefs ------------------------------------------------------------------*/
+
+/*
+ * Snapshot file header, followed by slots and by keys that don't fit inline. Its size keeps slots aligned
+ */
+typedef struct {
+    char magic[8];
+    uint32_t endianness, version;
+    uint32_t size, items;
+    uint32_t pointerSize, _reserved;
+    uint64_t itemSize, slotSize, keySize;
+    uint64_t keysBytes; /* size of keys area after slots */
+} lpHashTableSnapshotHeader_t;
+#endif /* LPHT_USE_SNAPSHOT */
+
 /* Function prototypes -------------------------------------------------------*/
 
-static utilsStatus_t lpHashTableSetEntry(lpHashTable_t* lpht, char* key, void* value);
-static utilsStatus_t lpHashTableUpdateEntry(lpHashTable_t* lpht, char* key, void* value);
-static void lpHashTableReplaceEntries(lpHashTable_t* lpht, uint32_t startIndex);
+static utilsStatus_t lpHashTablePutKey(lpHashTable_t* lpht, const void* key, uint32_t keyLen, uint32_t hash, void* value);
+static utilsStatus_t lpHashTableGetKey(lpHashTable_t* lpht, const void* key, uint32_t keyLen, uint32_t hash, void* value, lpHashTableRemoval_t remove);
+static utilsStatus_t lpHashTableGetRefKey(lpHashTable_t* lpht, const void* key, uint32_t keyLen, uint32_t hash, void** value);
+static utilsStatus_t lpHashTableGetOrInsertKey(lpHashTable_t* lpht, const void* key, uint32_t keyLen, uint32_t hash, void** value, uint8_t* inserted);
+static utilsStatus_t lpHashTableFindOrAdd(lpHashTable_t* lpht, const void* key, uint32_t keyLen, uint32_t hash, void** value, uint8_t* inserted);
+static lpHashTableEntry_t* lpHashTableSetEntry(lpHashTable_t* lpht, const void* key, uint32_t keyLen, uint32_t hash);
+static lpHashTableEntry_t* lpHashTableFindEntry(lpHashTable_t* lpht, uint8_t* slots, uint32_t size, const void* key, uint32_t keyLen, uint32_t hash,
+                                                uint32_t* index);
+static lpHashTableEntry_t* lpHashTableMakeRoom(lpHashTable_t* lpht, uint32_t hash);
+static void lpHashTableMoveEntry(lpHashTable_t* lpht, lpHashTableEntry_t* entry);
+static void lpHashTableShiftBack(lpHashTable_t* lpht, uint8_t* slots, uint32_t size, uint32_t index);
+static void lpHashTableMigrate(lpHashTable_t* lpht, uint32_t steps);
 static utilsStatus_t lpHashTableXpand(lpHashTable_t* lpht, uint8_t increase);
+static utilsStatus_t lpHashTableRehash(lpHashTable_t* lpht, uint32_t size);
+static void lpHashTableArenaReclaim(lpHashTable_t* lpht);
 
 /* Private Functions ---------------------------------------------------------*/
 
-static inline char* lpHashTableStrdup(const char* s) {
-    size_t bufsize = strlen(s) + 1;
-    char* retval = ADVUTILS_MALLOC(bufsize);
-    ADVUTILS_ASSERT(retval != NULL);
-    if (retval) {
-        memcpy(retval, s, bufsize);
+#ifdef LPHT_STATS
+static inline uint64_t lpHashTableStatsClock(void) {
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+#endif /* LPHT_STATS */
+
+static inline char* lpHashTableEntryKey(lpHashTable_t* lpht, lpHashTableEntry_t* entry) {
+    char* key = (char*)(entry + 1);
+    if (entry->keyLen > lpht->_keySize) {
+        memcpy(&key, entry + 1, sizeof(char*));
+        /* Snapshots store file offsets instead of pointers */
+        if (lpht->_mapBase != NULL) {
+            key = (char*)lpht->_mapBase + (uintptr_t)key;
+        }
+    }
+    return key;
+}
+
+static inline void* lpHashTableEntryValue(lpHashTable_t* lpht, lpHashTableEntry_t* entry) {
+    return (uint8_t*)(entry + 1) + lpht->_keySize;
+}
+
+static inline uint8_t lpHashTableEntryMatch(lpHashTable_t* lpht, lpHashTableEntry_t* entry, const void* key, uint32_t keyLen, uint32_t hash) {
+    return (entry->hash == hash) && (entry->keyLen == keyLen) && !memcmp(key, lpHashTableEntryKey(lpht, entry), keyLen);
+}
+
+static inline void lpHashTablePrefetch(lpHashTable_t* lpht, uint32_t hash) {
+    uint8_t* entry = (uint8_t*)LPHT_SLOT(lpht, hash & (lpht->size - 1));
+
+    /* Slot can span two cache lines */
+    LPHT_PREFETCH(entry);
+    LPHT_PREFETCH(entry + lpht->_slotSize - 1);
+}
+
+#ifdef ADVUTILS_USE_DYNAMIC_ALLOCATION
+static char* lpHashTableArenaAlloc(lpHashTable_t* lpht, size_t len) {
+    lpHashTableArena_t* chunk = lpht->_arena;
+
+    if ((chunk == NULL) || ((chunk->size - chunk->used) < len)) {
+        size_t size = (len > LPHT_ARENA_CHUNK_SIZE) ? len : LPHT_ARENA_CHUNK_SIZE;
+        chunk = ADVUTILS_MALLOC(sizeof(lpHashTableArena_t) + size);
+        ADVUTILS_ASSERT(chunk != NULL);
+        if (chunk == NULL) {
+            return NULL;
+        }
+        chunk->size = size;
+        chunk->used = 0;
+        chunk->next = lpht->_arena;
+        lpht->_arena = chunk;
     }
+
+    char* retval = (char*)(chunk + 1) + chunk->used;
+    chunk->used += len;
+    lpht->_arenaUsed += len;
     return retval;
 }
 
+static void lpHashTableArenaFree(lpHashTable_t* lpht) {
+    lpHashTableArena_t* chunk;
+    while (lpht->_arena != NULL) {
+        chunk = lpht->_arena;
+        lpht->_arena = chunk->next;
+        ADVUTILS_FREE(chunk);
+    }
+    while (lpht->_oldArena != NULL) {
+        chunk = lpht->_oldArena;
+        lpht->_oldArena = chunk->next;
+        ADVUTILS_FREE(chunk);
+    }
+    lpht->_arenaUsed = 0;
+    lpht->_arenaLive = 0;
+}
+
+/* Overflow storage is worth compacting only when removed keys take more space than the live ones */
+static inline uint8_t lpHashTableArenaWasted(lpHashTable_t* lpht) {
+    size_t waste = lpht->_arenaUsed - lpht->_arenaLive;
+    return (waste > LPHT_ARENA_CHUNK_SIZE) && (waste > lpht->_arenaLive);
+}
+
+/* Current overflow storage becomes the old one, released by migration once no slot refers to it */
+static inline void lpHashTableArenaRotate(lpHashTable_t* lpht) {
+    lpht->_oldArena = lpht->_arena;
+    lpht->_arena = NULL;
+    lpht->_arenaUsed = 0;
+    lpht->_arenaLive = 0;
+}
+#endif /* ADVUTILS_USE_DYNAMIC_ALLOCATION */
+
 /* Functions -----------------------------------------------------------------*/
 
 #ifdef ADVUTILS_USE_DYNAMIC_ALLOCATION
@@ -113,8 +294,27 @@ utilsStatus_t lpHashTableInit(lpHashTable_t* lpht, size_t itemSize, uint32_t ini
     lpht->size = init_items;
     lpht->itemSize = itemSize;
     lpht->resizable = resizable;
+    lpht->_keySize = LPHT_KEY_SIZE;
+    lpht->_slotSize = LPHT_SLOT_SIZE(itemSize);
+    lpht->_arena = NULL;
+    lpht->_arenaUsed = 0;
+    lpht->_arenaLive = 0;
+    lpht->_oldArena = NULL;
+    lpht->_oldEntries = NULL;
+    lpht->_oldSize = 0;
+    lpht->_oldItems = 0;
+    lpht->_migrateIdx = 0;
+    lpht->_migrateStep = LPHT_MIGRATION_STEP;
+    lpht->_mapBase = NULL;
+    lpht->_mapSize = 0;
+#ifdef LPHT_STATS
+    lpht->_xpandCount = 0;
+    lpht->_compactCount = 0;
+    lpht->_xpandTime = 0;
+    lpht->_shifts = 0;
+#endif /* LPHT_STATS */
 
-    lpht->entries = ADVUTILS_CALLOC(lpht->size, sizeof(lpHashTableEntry_t));
+    lpht->entries = ADVUTILS_CALLOC(lpht->size, lpht->_slotSize);
     ADVUTILS_ASSERT(lpht->entries != NULL);
     if (lpht->entries == NULL) {
         return UTILS_STATUS_ERROR;
@@ -128,87 +328,319 @@ utilsStatus_t lpHashTablePut(lpHashTable_t* lpht, char* key, void* value) {
         return UTILS_STATUS_ERROR;
     }
 
-    /* Try to update the entry and go on if it doesn't exist already */
-    if (lpHashTableUpdateEntry(lpht, key, value) == UTILS_STATUS_SUCCESS) {
-        return UTILS_STATUS_SUCCESS;
+    return lpHashTablePutKey(lpht, key, strlen(key) + 1, LPHT_HASHFUN(key), value);
+}
+
+utilsStatus_t lpHashTableGet(lpHashTable_t* lpht, char* key, void* value, lpHashTableRemoval_t remove) {
+
+    if (!lpht->items) {
+        return UTILS_STATUS_EMPTY;
     }
 
-    /* If length will exceed defined quota of current capacity, expand it. */
-    if (((lpht->items + 1) >= (lpht->size * LPHT_MAX_SATURATION)) && (lpht->resizable == LPHT_RESIZABLE)) {
-        if (lpHashTableXpand(lpht, 1) == UTILS_STATUS_ERROR) {
-            return UTILS_STATUS_ERROR;
-        }
+    return lpHashTableGetKey(lpht, key, strlen(key) + 1, LPHT_HASHFUN(key), value, remove);
+}
+
+utilsStatus_t lpHashTablePutBin(lpHashTable_t* lpht, const void* key, size_t keyLen, void* value) {
+    if ((value == NULL) || (key == NULL) || !keyLen || (keyLen > UINT32_MAX)) {
+        return UTILS_STATUS_ERROR;
     }
 
-    /* If table is full, return */
-    if (lpht->items >= lpht->size) {
-        return UTILS_STATUS_FULL;
+    return lpHashTablePutKey(lpht, key, (uint32_t)keyLen, LPHT_BIN_HASHFUN(key, keyLen), value);
+}
+
+utilsStatus_t lpHashTableGetBin(lpHashTable_t* lpht, const void* key, size_t keyLen, void* value, lpHashTableRemoval_t remove) {
+
+    if (!lpht->items) {
+        return UTILS_STATUS_EMPTY;
     }
 
-    /* Set entry and update length. */
-    if (lpHashTableSetEntry(lpht, key, value) == UTILS_STATUS_SUCCESS) {
-        return UTILS_STATUS_SUCCESS;
+    if ((key == NULL) || !keyLen || (keyLen > UINT32_MAX)) {
+        return UTILS_STATUS_ERROR;
     }
 
-    return UTILS_STATUS_ERROR;
+    return lpHashTableGetKey(lpht, key, (uint32_t)keyLen, LPHT_BIN_HASHFUN(key, keyLen), value, remove);
 }
 
-utilsStatus_t lpHashTableGet(lpHashTable_t* lpht, char* key, void* value, lpHashTableRemoval_t remove) {
+utilsStatus_t lpHashTablePutHashed(lpHashTable_t* lpht, const void* key, size_t keyLen, uint32_t hash, void* value) {
+    if ((value == NULL) || (key == NULL) || !keyLen || (keyLen > UINT32_MAX)) {
+        return UTILS_STATUS_ERROR;
+    }
+
+    return lpHashTablePutKey(lpht, key, (uint32_t)keyLen, hash, value);
+}
+
+utilsStatus_t lpHashTableGetHashed(lpHashTable_t* lpht, const void* key, size_t keyLen, uint32_t hash, void* value, lpHashTableRemoval_t remove) {
 
     if (!lpht->items) {
         return UTILS_STATUS_EMPTY;
     }
 
-    uint32_t ii = LPHT_HASHFUN(key) & (lpht->size - 1);
-    uint32_t cnt = 0;
-
-    while (lpht->entries[ii].key != NULL) {
-        if (!strcmp(key, lpht->entries[ii].key)) {
-            memcpy(value, lpht->entries[ii].value, lpht->itemSize);
-
-            if (remove == LPHT_REMOVE_ITEM) {
-                ADVUTILS_FREE(lpht->entries[ii].key);
-                ADVUTILS_FREE(lpht->entries[ii].value);
-                lpht->entries[ii].key = NULL;
-                lpht->entries[ii].value = NULL;
-                if ((--lpht->items <= (lpht->size * LPHT_MIN_SATURATION)) && (lpht->resizable == LPHT_RESIZABLE)) {
-                    if (lpHashTableXpand(lpht, 0) == UTILS_STATUS_ERROR) {
-                        lpHashTableReplaceEntries(lpht, ii);
-                        return UTILS_STATUS_WARNING;
-                    }
-                } else {
-                    lpHashTableReplaceEntries(lpht, ii);
-                }
+    if ((key == NULL) || !keyLen || (keyLen > UINT32_MAX)) {
+        return UTILS_STATUS_ERROR;
+    }
+
+    return lpHashTableGetKey(lpht, key, (uint32_t)keyLen, hash, value, remove);
+}
+
+utilsStatus_t lpHashTablePutU32(lpHashTable_t* lpht, uint32_t key, void* value) {
+    if (value == NULL) {
+        return UTILS_STATUS_ERROR;
+    }
+
+    return lpHashTablePutKey(lpht, &key, sizeof(key), hash_mix32(key), value);
+}
+
+utilsStatus_t lpHashTableGetU32(lpHashTable_t* lpht, uint32_t key, void* value, lpHashTableRemoval_t remove) {
+
+    if (!lpht->items) {
+        return UTILS_STATUS_EMPTY;
+    }
+
+    return lpHashTableGetKey(lpht, &key, sizeof(key), hash_mix32(key), value, remove);
+}
+
+utilsStatus_t lpHashTablePutU64(lpHashTable_t* lpht, uint64_t key, void* value) {
+    if (value == NULL) {
+        return UTILS_STATUS_ERROR;
+    }
+
+    return lpHashTablePutKey(lpht, &key, sizeof(key), hash_mix64(key), value);
+}
+
+utilsStatus_t lpHashTableGetU64(lpHashTable_t* lpht, uint64_t key, void* value, lpHashTableRemoval_t remove) {
+
+    if (!lpht->items) {
+        return UTILS_STATUS_EMPTY;
+    }
+
+    return lpHashTableGetKey(lpht, &key, sizeof(key), hash_mix64(key), value, remove);
+}
+
+utilsStatus_t lpHashTableGetRef(lpHashTable_t* lpht, char* key, void** value) {
+
+    if (!lpht->items) {
+        return UTILS_STATUS_EMPTY;
+    }
+
+    return lpHashTableGetRefKey(lpht, key, strlen(key) + 1, LPHT_HASHFUN(key), value);
+}
+
+utilsStatus_t lpHashTableGetOrInsert(lpHashTable_t* lpht, char* key, void** value, uint8_t* inserted) {
+    if ((value == NULL) || (key == NULL)) {
+        return UTILS_STATUS_ERROR;
+    }
+
+    return lpHashTableGetOrInsertKey(lpht, key, strlen(key) + 1, LPHT_HASHFUN(key), value, inserted);
+}
+
+utilsStatus_t lpHashTableGetRefBin(lpHashTable_t* lpht, const void* key, size_t keyLen, void** value) {
+
+    if (!lpht->items) {
+        return UTILS_STATUS_EMPTY;
+    }
+
+    if ((key == NULL) || !keyLen || (keyLen > UINT32_MAX)) {
+        return UTILS_STATUS_ERROR;
+    }
+
+    return lpHashTableGetRefKey(lpht, key, (uint32_t)keyLen, LPHT_BIN_HASHFUN(key, keyLen), value);
+}
+
+utilsStatus_t lpHashTableGetOrInsertBin(lpHashTable_t* lpht, const void* key, size_t keyLen, void** value, uint8_t* inserted) {
+    if ((value == NULL) || (key == NULL) || !keyLen || (keyLen > UINT32_MAX)) {
+        return UTILS_STATUS_ERROR;
+    }
+
+    return lpHashTableGetOrInsertKey(lpht, key, (uint32_t)keyLen, LPHT_BIN_HASHFUN(key, keyLen), value, inserted);
+}
+
+utilsStatus_t lpHashTableGetOrInsertHashed(lpHashTable_t* lpht, const void* key, size_t keyLen, uint32_t hash, void** value, uint8_t* inserted) {
+    if ((value == NULL) || (key == NULL) || !keyLen || (keyLen > UINT32_MAX)) {
+        return UTILS_STATUS_ERROR;
+    }
+
+    return lpHashTableGetOrInsertKey(lpht, key, (uint32_t)keyLen, hash, value, inserted);
+}
+
+utilsStatus_t lpHashTableGetRefU32(lpHashTable_t* lpht, uint32_t key, void** value) {
+
+    if (!lpht->items) {
+        return UTILS_STATUS_EMPTY;
+    }
+
+    return lpHashTableGetRefKey(lpht, &key, sizeof(key), hash_mix32(key), value);
+}
+
+utilsStatus_t lpHashTableGetOrInsertU32(lpHashTable_t* lpht, uint32_t key, void** value, uint8_t* inserted) {
+    if (value == NULL) {
+        return UTILS_STATUS_ERROR;
+    }
+
+    return lpHashTableGetOrInsertKey(lpht, &key, sizeof(key), hash_mix32(key), value, inserted);
+}
+
+utilsStatus_t lpHashTableGetRefU64(lpHashTable_t* lpht, uint64_t key, void** value) {
+
+    if (!lpht->items) {
+        return UTILS_STATUS_EMPTY;
+    }
+
+    return lpHashTableGetRefKey(lpht, &key, sizeof(key), hash_mix64(key), value);
+}
+
+utilsStatus_t lpHashTableGetOrInsertU64(lpHashTable_t* lpht, uint64_t key, void** value, uint8_t* inserted) {
+    if (value == NULL) {
+        return UTILS_STATUS_ERROR;
+    }
+
+    return lpHashTableGetOrInsertKey(lpht, &key, sizeof(key), hash_mix64(key), value, inserted);
+}
+
+utilsStatus_t lpHashTableGetBatch(lpHashTable_t* lpht, char** keys, uint32_t count, void* values, utilsStatus_t* results) {
+    uint32_t hashes[LPHT_BATCH_SIZE], keyLens[LPHT_BATCH_SIZE];
+    uint32_t ii, jj, n;
+    utilsStatus_t status, retval = UTILS_STATUS_SUCCESS;
+    void* ref;
+
+    if ((keys == NULL) || (values == NULL)) {
+        return UTILS_STATUS_ERROR;
+    }
+
+    if (!lpht->items) {
+        for (ii = 0; (results != NULL) && (ii < count); ii++) {
+            results[ii] = UTILS_STATUS_EMPTY;
+        }
+        return UTILS_STATUS_EMPTY;
+    }
+
+    for (ii = 0; ii < count; ii += n) {
+        n = ((count - ii) < LPHT_BATCH_SIZE) ? (count - ii) : LPHT_BATCH_SIZE;
+
+        /* Hash the whole group first and prefetch home slots, so that their cache misses overlap */
+        for (jj = 0; jj < n; jj++) {
+            if (keys[ii + jj] != NULL) {
+                hashes[jj] = LPHT_HASHFUN(keys[ii + jj]);
+                keyLens[jj] = strlen(keys[ii + jj]) + 1;
+                lpHashTablePrefetch(lpht, hashes[jj]);
             }
-            return UTILS_STATUS_SUCCESS;
         }
 
-        if (++ii >= lpht->size) {
-            ii = 0;
+        for (jj = 0; jj < n; jj++) {
+            if (keys[ii + jj] != NULL) {
+                status = lpHashTableGetRefKey(lpht, keys[ii + jj], keyLens[jj], hashes[jj], &ref);
+            } else {
+                status = UTILS_STATUS_ERROR;
+            }
+            if (status == UTILS_STATUS_SUCCESS) {
+                memcpy((uint8_t*)values + (size_t)(ii + jj) * lpht->itemSize, ref, lpht->itemSize);
+            } else {
+                retval = UTILS_STATUS_ERROR;
+            }
+            if (results != NULL) {
+                results[ii + jj] = status;
+            }
         }
+    }
 
-        /* Check to avoid infinite loop in case of full not-resizable list */
-        if (++cnt >= lpht->items) {
-            return UTILS_STATUS_ERROR;
+    return retval;
+}
+
+utilsStatus_t lpHashTablePutBatch(lpHashTable_t* lpht, char** keys, uint32_t count, void* values, utilsStatus_t* results) {
+    uint32_t hashes[LPHT_BATCH_SIZE], keyLens[LPHT_BATCH_SIZE];
+    uint32_t ii, jj, n;
+    utilsStatus_t status, retval = UTILS_STATUS_SUCCESS;
+
+    if ((keys == NULL) || (values == NULL)) {
+        return UTILS_STATUS_ERROR;
+    }
+
+    for (ii = 0; ii < count; ii += n) {
+        n = ((count - ii) < LPHT_BATCH_SIZE) ? (count - ii) : LPHT_BATCH_SIZE;
+
+        /* Same as lpHashTableGetBatch, a resize in the middle of the group only makes some prefetches useless */
+        for (jj = 0; jj < n; jj++) {
+            if (keys[ii + jj] != NULL) {
+                hashes[jj] = LPHT_HASHFUN(keys[ii + jj]);
+                keyLens[jj] = strlen(keys[ii + jj]) + 1;
+                lpHashTablePrefetch(lpht, hashes[jj]);
+            }
+        }
+
+        for (jj = 0; jj < n; jj++) {
+            if (keys[ii + jj] != NULL) {
+                status = lpHashTablePutKey(lpht, keys[ii + jj], keyLens[jj], hashes[jj], (uint8_t*)values + (size_t)(ii + jj) * lpht->itemSize);
+            } else {
+                status = UTILS_STATUS_ERROR;
+            }
+            if (status != UTILS_STATUS_SUCCESS) {
+                retval = UTILS_STATUS_ERROR;
+            }
+            if (results != NULL) {
+                results[ii + jj] = status;
+            }
         }
     }
-    return UTILS_STATUS_ERROR;
+
+    return retval;
 }
 
-utilsStatus_t lpHashTableFlush(lpHashTable_t* lpht) {
+#ifdef LPHT_STATS
+void lpHashTableStats(lpHashTable_t* lpht, lpHashTableStats_t* stats) {
+    uint8_t* slots = lpht->entries;
+    uint32_t size = lpht->size;
+    uint64_t sum = 0;
     uint32_t ii;
 
+    memset(stats, 0, sizeof(lpHashTableStats_t));
+
+    /* During an incremental resize, items not migrated yet are still in old slots */
+    while (slots != NULL) {
+        for (ii = 0; ii < size; ii++) {
+            lpHashTableEntry_t* entry = LPHT_SLOT_IN(lpht, slots, ii);
+            if (entry->keyLen) {
+                stats->probeHist[(entry->dist < LPHT_STATS_HIST_SIZE) ? entry->dist : (LPHT_STATS_HIST_SIZE - 1)]++;
+                if (entry->dist > stats->maxProbe) {
+                    stats->maxProbe = entry->dist;
+                }
+                sum += entry->dist;
+            }
+        }
+        if (slots == lpht->_oldEntries) {
+            break;
+        }
+        slots = lpht->_oldEntries;
+        size = lpht->_oldSize;
+    }
+
+    if (lpht->items) {
+        stats->avgProbe = (float)sum / lpht->items;
+    }
+    stats->xpandCount = lpht->_xpandCount;
+    stats->xpandTime = lpht->_xpandTime;
+    stats->compactCount = lpht->_compactCount;
+    stats->shifts = lpht->_shifts;
+}
+#endif /* LPHT_STATS */
+
+utilsStatus_t lpHashTableFlush(lpHashTable_t* lpht) {
+
     if (!lpht->items) {
         return UTILS_STATUS_EMPTY;
     }
 
-    for (ii = 0; ii < lpht->size; ii++) {
-        ADVUTILS_FREE(lpht->entries[ii].key);
-        ADVUTILS_FREE(lpht->entries[ii].value);
-        lpht->entries[ii].key = NULL;
-        lpht->entries[ii].value = NULL;
+    if (lpht->_mapBase != NULL) {
+        return UTILS_STATUS_ERROR;
     }
 
+    memset(lpht->entries, 0, (size_t)lpht->size * lpht->_slotSize);
+    lpHashTableArenaFree(lpht);
+
+    /* Items not migrated yet are dropped together with old slots */
+    ADVUTILS_FREE(lpht->_oldEntries);
+    lpht->_oldEntries = NULL;
+    lpht->_oldSize = 0;
+    lpht->_oldItems = 0;
+
     lpht->items = 0;
 
     return UTILS_STATUS_SUCCESS;
@@ -220,150 +652,657 @@ utilsStatus_t lpHashTableDelete(lpHashTable_t* lpht) {
         return UTILS_STATUS_ERROR;
     }
 
+#ifdef LPHT_USE_SNAPSHOT
+    if (lpht->_mapBase != NULL) {
+        munmap(lpht->_mapBase, lpht->_mapSize);
+        lpht->_mapBase = NULL;
+        lpht->entries = NULL;
+        lpht->items = 0;
+        return UTILS_STATUS_SUCCESS;
+    }
+#endif /* LPHT_USE_SNAPSHOT */
+
     lpHashTableFlush(lpht);
+    lpHashTableArenaFree(lpht);
 
+    ADVUTILS_FREE(lpht->_oldEntries);
+    lpht->_oldEntries = NULL;
     ADVUTILS_FREE(lpht->entries);
     lpht->entries = NULL;
 
     return UTILS_STATUS_SUCCESS;
 }
 
-static utilsStatus_t lpHashTableSetEntry(lpHashTable_t* lpht, char* key, void* value) {
-    /* limit hash to current memory size */
-    uint32_t ii = LPHT_HASHFUN(key) & (lpht->size - 1);
+#ifdef LPHT_USE_SNAPSHOT
+utilsStatus_t lpHashTableSave(lpHashTable_t* lpht, const char* path) {
+    lpHashTableSnapshotHeader_t header;
+    lpHashTableEntry_t* entry;
+    uint8_t* slot;
+    uintptr_t offset;
+    uint32_t ii;
+    uint8_t ok;
+    FILE* file;
 
-    /* Loop till we find an empty entry. */
-    while (lpht->entries[ii].key != NULL) {
-        if (++ii >= lpht->size) {
-            ii = 0;
+    if ((lpht->entries == NULL) || (path == NULL)) {
+        return UTILS_STATUS_ERROR;
+    }
+
+    /* Snapshot holds a single slots array */
+    lpHashTableMigrate(lpht, UINT32_MAX);
+    if (lpht->_oldEntries != NULL) {
+        return UTILS_STATUS_ERROR;
+    }
+
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, LPHT_SNAPSHOT_MAGIC, sizeof(header.magic));
+    header.endianness = LPHT_SNAPSHOT_ENDIANNESS;
+    header.version = LPHT_SNAPSHOT_VERSION;
+    header.size = lpht->size;
+    header.items = lpht->items;
+    header.pointerSize = sizeof(char*);
+    header.itemSize = lpht->itemSize;
+    header.slotSize = lpht->_slotSize;
+    header.keySize = lpht->_keySize;
+    for (ii = 0; ii < lpht->size; ii++) {
+        entry = LPHT_SLOT(lpht, ii);
+        if (entry->keyLen > lpht->_keySize) {
+            header.keysBytes += entry->keyLen;
+        }
+    }
+
+    slot = ADVUTILS_MALLOC(lpht->_slotSize);
+    ADVUTILS_ASSERT(slot != NULL);
+    if (slot == NULL) {
+        return UTILS_STATUS_ERROR;
+    }
+    file = fopen(path, "wb");
+    if (file == NULL) {
+        ADVUTILS_FREE(slot);
+        return UTILS_STATUS_ERROR;
+    }
+
+    /* Pointers to long keys are replaced by their offset in file, keys are then written in the same order */
+    ok = (fwrite(&header, sizeof(header), 1, file) == 1);
+    offset = sizeof(header) + (uintptr_t)lpht->size * lpht->_slotSize;
+    for (ii = 0; ok && (ii < lpht->size); ii++) {
+        entry = LPHT_SLOT(lpht, ii);
+        memcpy(slot, entry, lpht->_slotSize);
+        if (entry->keyLen > lpht->_keySize) {
+            memcpy((lpHashTableEntry_t*)slot + 1, &offset, sizeof(char*));
+            offset += entry->keyLen;
+        }
+        ok = (fwrite(slot, lpht->_slotSize, 1, file) == 1);
+    }
+    for (ii = 0; ok && (ii < lpht->size); ii++) {
+        entry = LPHT_SLOT(lpht, ii);
+        if (entry->keyLen > lpht->_keySize) {
+            ok = (fwrite(lpHashTableEntryKey(lpht, entry), entry->keyLen, 1, file) == 1);
         }
     }
+    ok = (fclose(file) == 0) && ok;
+    ADVUTILS_FREE(slot);
+
+    if (!ok) {
+        remove(path);
+        return UTILS_STATUS_ERROR;
+    }
+
+    return UTILS_STATUS_SUCCESS;
+}
+
+utilsStatus_t lpHashTableLoad(lpHashTable_t* lpht, const char* path, size_t itemSize) {
+    lpHashTableSnapshotHeader_t* header;
+    lpHashTableEntry_t* entry;
+    struct stat st;
+    uintptr_t offset;
+    uint64_t keysStart;
+    uint32_t ii, items = 0;
+    uint8_t ok;
+    void* map;
+    int fd;
+
+    lpht->entries = NULL;
+    lpht->_mapBase = NULL;
 
-    /* Empty slot found, insert item. */
-    lpht->entries[ii].key = lpHashTableStrdup(key);
-    lpht->entries[ii].value = ADVUTILS_CALLOC(1, lpht->itemSize);
-    ADVUTILS_ASSERT(lpht->entries[ii].value != NULL);
+    if (path == NULL) {
+        return UTILS_STATUS_ERROR;
+    }
 
-    if ((lpht->entries[ii].key == NULL) || (lpht->entries[ii].value == NULL)) {
-        ADVUTILS_FREE(lpht->entries[ii].key);
-        ADVUTILS_FREE(lpht->entries[ii].value);
-        lpht->entries[ii].key = NULL;
-        lpht->entries[ii].value = NULL;
+    fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return UTILS_STATUS_ERROR;
+    }
+    map = MAP_FAILED;
+    if (!fstat(fd, &st) && ((size_t)st.st_size >= sizeof(lpHashTableSnapshotHeader_t))) {
+        map = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    }
+    close(fd);
+    if (map == MAP_FAILED) {
         return UTILS_STATUS_ERROR;
     }
 
-    memcpy(lpht->entries[ii].value, value, lpht->itemSize);
+    /* Slots are used as they are, so their layout must be the same of this build */
+    header = (lpHashTableSnapshotHeader_t*)map;
+    if (memcmp(header->magic, LPHT_SNAPSHOT_MAGIC, sizeof(header->magic)) || (header->endianness != LPHT_SNAPSHOT_ENDIANNESS)
+        || (header->version != LPHT_SNAPSHOT_VERSION) || (header->pointerSize != sizeof(char*)) || (header->itemSize != itemSize)
+        || (header->keySize != LPHT_KEY_SIZE) || (header->slotSize != LPHT_SLOT_SIZE(itemSize)) || !header->size
+        || (header->items > header->size)
+        || ((uint64_t)st.st_size != (sizeof(lpHashTableSnapshotHeader_t) + (uint64_t)header->size * header->slotSize + header->keysBytes))) {
+        munmap(map, (size_t)st.st_size);
+        return UTILS_STATUS_ERROR;
+    }
 
-    lpht->items++;
+    /* Slots are trusted by every lookup, so distances and long keys offsets must stay within the table and the keys area */
+    keysStart = sizeof(lpHashTableSnapshotHeader_t) + (uint64_t)header->size * header->slotSize;
+    ok = 1;
+    for (ii = 0; ok && (ii < header->size); ii++) {
+        entry = (lpHashTableEntry_t*)((uint8_t*)map + sizeof(lpHashTableSnapshotHeader_t) + (size_t)ii * header->slotSize);
+        if (!entry->keyLen) {
+            continue;
+        }
+        items++;
+        ok = (entry->dist < header->size);
+        if (ok && (entry->keyLen > header->keySize)) {
+            memcpy(&offset, entry + 1, sizeof(char*));
+            ok = (offset >= keysStart) && (offset <= (uint64_t)st.st_size) && (entry->keyLen <= ((uint64_t)st.st_size - offset));
+        }
+    }
+    if (!ok || (items != header->items)) {
+        munmap(map, (size_t)st.st_size);
+        return UTILS_STATUS_ERROR;
+    }
+
+    lpht->items = header->items;
+    lpht->size = header->size;
+    lpht->itemSize = itemSize;
+    lpht->resizable = LPHT_NOT_RESIZABLE;
+    lpht->_keySize = header->keySize;
+    lpht->_slotSize = header->slotSize;
+    lpht->_arena = NULL;
+    lpht->_arenaUsed = 0;
+    lpht->_arenaLive = 0;
+    lpht->_oldArena = NULL;
+    lpht->_oldEntries = NULL;
+    lpht->_oldSize = 0;
+    lpht->_oldItems = 0;
+    lpht->_migrateIdx = 0;
+    lpht->_migrateStep = LPHT_MIGRATION_STEP;
+    lpht->_mapBase = (uint8_t*)map;
+    lpht->_mapSize = (size_t)st.st_size;
+    lpht->entries = lpht->_mapBase + sizeof(lpHashTableSnapshotHeader_t);
+#ifdef LPHT_STATS
+    lpht->_xpandCount = 0;
+    lpht->_compactCount = 0;
+    lpht->_xpandTime = 0;
+    lpht->_shifts = 0;
+#endif /* LPHT_STATS */
 
     return UTILS_STATUS_SUCCESS;
 }
+#endif /* LPHT_USE_SNAPSHOT */
 
-static utilsStatus_t lpHashTableUpdateEntry(lpHashTable_t* lpht, char* key, void* value) {
-    /* limit hash to current memory size */
-    uint32_t ii = LPHT_HASHFUN(key) & (lpht->size - 1);
-    uint32_t cnt = 0;
-
-    /* Loop to search the entry to be updated */
-    while (lpht->entries[ii].key != NULL) {
-        if (!strcmp(key, lpht->entries[ii].key)) {
-            /* Found entry, now update it */
-            memcpy(lpht->entries[ii].value, value, lpht->itemSize);
-            return UTILS_STATUS_SUCCESS;
+static utilsStatus_t lpHashTablePutKey(lpHashTable_t* lpht, const void* key, uint32_t keyLen, uint32_t hash, void* value) {
+    void* ref;
+    utilsStatus_t retval = lpHashTableFindOrAdd(lpht, key, keyLen, hash, &ref, NULL);
+
+    if (retval == UTILS_STATUS_SUCCESS) {
+        memcpy(ref, value, lpht->itemSize);
+    }
+
+    return retval;
+}
+
+static utilsStatus_t lpHashTableFindOrAdd(lpHashTable_t* lpht, const void* key, uint32_t keyLen, uint32_t hash, void** value, uint8_t* inserted) {
+    /* Snapshots are mapped read-only */
+    if (lpht->_mapBase != NULL) {
+        return UTILS_STATUS_ERROR;
+    }
+
+    lpHashTableMigrate(lpht, lpht->_migrateStep);
+
+    /* Try to find the entry and go on if it doesn't exist already */
+    lpHashTableEntry_t* entry = lpHashTableFindEntry(lpht, lpht->entries, lpht->size, key, keyLen, hash, NULL);
+    if ((entry == NULL) && (lpht->_oldEntries != NULL)) {
+        entry = lpHashTableFindEntry(lpht, lpht->_oldEntries, lpht->_oldSize, key, keyLen, hash, NULL);
+    }
+    if (entry != NULL) {
+        *value = lpHashTableEntryValue(lpht, entry);
+        if (inserted != NULL) {
+            *inserted = 0;
         }
+        return UTILS_STATUS_SUCCESS;
+    }
+
+    /* If length will exceed defined quota of current capacity, expand it. */
+    if (((lpht->items + 1) >= (lpht->size * LPHT_MAX_SATURATION)) && (lpht->resizable != LPHT_NOT_RESIZABLE)) {
+        if (lpHashTableXpand(lpht, 1) == UTILS_STATUS_ERROR) {
+            return UTILS_STATUS_ERROR;
+        }
+    }
+
+    /* If table is full, return */
+    if ((lpht->items - lpht->_oldItems) >= lpht->size) {
+        return UTILS_STATUS_FULL;
+    }
+
+    /* Set entry and update length. */
+    entry = lpHashTableSetEntry(lpht, key, keyLen, hash);
+    if (entry == NULL) {
+        return UTILS_STATUS_ERROR;
+    }
+
+    *value = lpHashTableEntryValue(lpht, entry);
+    if (inserted != NULL) {
+        *inserted = 1;
+    }
+    return UTILS_STATUS_SUCCESS;
+}
+
+static utilsStatus_t lpHashTableGetOrInsertKey(lpHashTable_t* lpht, const void* key, uint32_t keyLen, uint32_t hash, void** value, uint8_t* inserted) {
+    uint8_t isNew;
+    utilsStatus_t retval = lpHashTableFindOrAdd(lpht, key, keyLen, hash, value, &isNew);
+
+    if (retval == UTILS_STATUS_SUCCESS) {
+        if (isNew) {
+            memset(*value, 0, lpht->itemSize);
+        }
+        if (inserted != NULL) {
+            *inserted = isNew;
+        }
+    }
+
+    return retval;
+}
+
+static utilsStatus_t lpHashTableGetRefKey(lpHashTable_t* lpht, const void* key, uint32_t keyLen, uint32_t hash, void** value) {
+    lpHashTableMigrate(lpht, lpht->_migrateStep);
+
+    lpHashTableEntry_t* entry = lpHashTableFindEntry(lpht, lpht->entries, lpht->size, key, keyLen, hash, NULL);
+    if ((entry == NULL) && (lpht->_oldEntries != NULL)) {
+        entry = lpHashTableFindEntry(lpht, lpht->_oldEntries, lpht->_oldSize, key, keyLen, hash, NULL);
+    }
+
+    if (entry == NULL) {
+        return UTILS_STATUS_ERROR;
+    }
+
+    *value = lpHashTableEntryValue(lpht, entry);
+    return UTILS_STATUS_SUCCESS;
+}
+
+static utilsStatus_t lpHashTableGetKey(lpHashTable_t* lpht, const void* key, uint32_t keyLen, uint32_t hash, void* value, lpHashTableRemoval_t remove) {
+    uint32_t ii;
+    uint8_t* slots = lpht->entries;
+    uint32_t size = lpht->size;
+
+    /* Snapshots are mapped read-only */
+    if ((remove == LPHT_REMOVE_ITEM) && (lpht->_mapBase != NULL)) {
+        return UTILS_STATUS_ERROR;
+    }
+
+    lpHashTableMigrate(lpht, lpht->_migrateStep);
+
+    /* During an incremental resize, items not migrated yet are still in old slots */
+    lpHashTableEntry_t* entry = lpHashTableFindEntry(lpht, slots, size, key, keyLen, hash, &ii);
+    if ((entry == NULL) && (lpht->_oldEntries != NULL)) {
+        slots = lpht->_oldEntries;
+        size = lpht->_oldSize;
+        entry = lpHashTableFindEntry(lpht, slots, size, key, keyLen, hash, &ii);
+    }
+
+    if (entry == NULL) {
+        return UTILS_STATUS_ERROR;
+    }
+
+    memcpy(value, lpHashTableEntryValue(lpht, entry), lpht->itemSize);
+
+    if (remove == LPHT_REMOVE_ITEM) {
+        /* Keys of old slots being compacted are in the old overflow storage, that is not accounted for */
+        if ((entry->keyLen > lpht->_keySize) && ((slots != lpht->_oldEntries) || (lpht->_oldArena == NULL))) {
+            lpht->_arenaLive -= entry->keyLen;
+        }
+        lpHashTableShiftBack(lpht, slots, size, ii);
+        if (slots == lpht->_oldEntries) {
+            lpht->_oldItems--;
+            lpHashTableMigrate(lpht, 0);
+        }
+        if (lpht->resizable != LPHT_RESIZABLE_INCREMENTAL) {
+            lpHashTableArenaReclaim(lpht);
+        }
+        if ((--lpht->items <= (lpht->size * LPHT_MIN_SATURATION)) && (lpht->resizable != LPHT_NOT_RESIZABLE)) {
+            if (lpHashTableXpand(lpht, 0) == UTILS_STATUS_ERROR) {
+                return UTILS_STATUS_WARNING;
+            }
+        }
+        /*
+         * Incremental tables compact overflow storage without walking all slots at once: a same-size rehash copies long keys
+         * while moving their entries, and old chunks are then released a few per operation
+         */
+        if ((lpht->resizable == LPHT_RESIZABLE_INCREMENTAL) && (lpht->_oldEntries == NULL) && (lpht->_oldArena == NULL)
+            && lpHashTableArenaWasted(lpht)) {
+            if (!lpht->_arenaLive) {
+                lpHashTableArenaRotate(lpht);
+            } else if (lpHashTableRehash(lpht, lpht->size) == UTILS_STATUS_ERROR) {
+                return UTILS_STATUS_WARNING;
+            }
+        }
+    }
+    return UTILS_STATUS_SUCCESS;
+}
+
+static lpHashTableEntry_t* lpHashTableSetEntry(lpHashTable_t* lpht, const void* key, uint32_t keyLen, uint32_t hash) {
+    char* keyCopy = NULL;
+
+    /* Long keys are copied to overflow storage and the slot keeps a pointer to them */
+    if (keyLen > lpht->_keySize) {
+        keyCopy = lpHashTableArenaAlloc(lpht, keyLen);
+        if (keyCopy == NULL) {
+            return NULL;
+        }
+        memcpy(keyCopy, key, keyLen);
+        lpht->_arenaLive += keyLen;
+    }
+
+    lpHashTableEntry_t* entry = lpHashTableMakeRoom(lpht, hash);
+    if (keyCopy != NULL) {
+        memcpy(entry + 1, &keyCopy, sizeof(char*));
+    } else {
+        memcpy(entry + 1, key, keyLen);
+    }
+    entry->keyLen = keyLen;
+
+    lpht->items++;
+
+    return entry;
+}
+
+static lpHashTableEntry_t* lpHashTableFindEntry(lpHashTable_t* lpht, uint8_t* slots, uint32_t size, const void* key, uint32_t keyLen, uint32_t hash,
+                                                uint32_t* index) {
+    /* limit hash to slots size */
+    uint32_t ii = hash & (size - 1);
+    uint32_t dist;
+    lpHashTableEntry_t* entry;
+
+    /* Entries are sorted by distance from their home slot, so search can stop as soon as a closer one is found */
+    for (dist = 0; dist < size; dist++) {
+        entry = LPHT_SLOT_IN(lpht, slots, ii);
+        if (!entry->keyLen || (entry->dist < dist)) {
+            return NULL;
+        }
+        if (lpHashTableEntryMatch(lpht, entry, key, keyLen, hash)) {
+            if (index != NULL) {
+                *index = ii;
+            }
+            return entry;
+        }
+        if (++ii >= size) {
+            ii = 0;
+        }
+    }
+
+    return NULL;
+}
+
+static lpHashTableEntry_t* lpHashTableMakeRoom(lpHashTable_t* lpht, uint32_t hash) {
+    /* limit hash to current memory size */
+    uint32_t ii = hash & (lpht->size - 1);
+    uint32_t jj, prev, dist = 0;
+    lpHashTableEntry_t* entry;
+
+    /* Robin Hood: new entry takes the first slot that is empty or holds an entry closer to its home than the new one */
+    while ((entry = LPHT_SLOT(lpht, ii))->keyLen && (entry->dist >= dist)) {
+        dist++;
         if (++ii >= lpht->size) {
             ii = 0;
         }
-        /* Check to avoid infinite loop in case of full list */
-        if (++cnt >= lpht->size) {
-            return UTILS_STATUS_FULL;
+    }
+
+    /* Move the rest of the cluster one slot forward, up to the first empty slot */
+    jj = ii;
+    while (LPHT_SLOT(lpht, jj)->keyLen) {
+        if (++jj >= lpht->size) {
+            jj = 0;
         }
     }
+    while (jj != ii) {
+        prev = (jj == 0) ? (lpht->size - 1) : (jj - 1);
+        memcpy(LPHT_SLOT(lpht, jj), LPHT_SLOT(lpht, prev), lpht->_slotSize);
+        LPHT_SLOT(lpht, jj)->dist++;
+        jj = prev;
+#ifdef LPHT_STATS
+        lpht->_shifts++;
+#endif /* LPHT_STATS */
+    }
 
-    return UTILS_STATUS_ERROR;
+    entry->hash = hash;
+    entry->dist = dist;
+    return entry;
 }
 
-static void lpHashTableReplaceEntries(lpHashTable_t* lpht, uint32_t startIndex) {
-    if (++startIndex >= lpht->size) {
-        startIndex = 0;
+static void lpHashTableMoveEntry(lpHashTable_t* lpht, lpHashTableEntry_t* entry) {
+    lpHashTableEntry_t* newEntry = lpHashTableMakeRoom(lpht, entry->hash);
+    uint32_t dist = newEntry->dist;
+    memcpy(newEntry, entry, lpht->_slotSize);
+    newEntry->dist = dist;
+}
+
+static void lpHashTableShiftBack(lpHashTable_t* lpht, uint8_t* slots, uint32_t size, uint32_t index) {
+    uint32_t next = index;
+    lpHashTableEntry_t* entry;
+
+    /* Backward-shift deletion: following entries that are not in their home slot move one slot back */
+    while (1) {
+        if (++next >= size) {
+            next = 0;
+        }
+        entry = LPHT_SLOT_IN(lpht, slots, next);
+        if (!entry->keyLen || !entry->dist || (next == index)) {
+            break;
+        }
+        memcpy(LPHT_SLOT_IN(lpht, slots, index), entry, lpht->_slotSize);
+        LPHT_SLOT_IN(lpht, slots, index)->dist--;
+        index = next;
+#ifdef LPHT_STATS
+        lpht->_shifts++;
+#endif /* LPHT_STATS */
     }
-    uint32_t cnt = lpht->items;
-    while ((lpht->entries[startIndex].key != NULL) && cnt--) {
-        /* limit hash to current memory size */
-        uint32_t ii = LPHT_HASHFUN(lpht->entries[startIndex].key) & (lpht->size - 1);
-        if (startIndex != ii) {
-            while (lpht->entries[ii].key != NULL) {
-                if (++ii >= lpht->size) {
-                    ii = 0;
+    LPHT_SLOT_IN(lpht, slots, index)->keyLen = 0;
+}
+
+static void lpHashTableMigrate(lpHashTable_t* lpht, uint32_t steps) {
+    lpHashTableEntry_t* entry;
+    lpHashTableArena_t* chunk;
+    char* keyCopy;
+    uint32_t visits = (steps > (UINT32_MAX / LPHT_MIGRATION_EMPTY_VISITS)) ? UINT32_MAX : (steps * LPHT_MIGRATION_EMPTY_VISITS);
+
+    /* 
+     * Old slots are emptied in order with backward-shift deletion, so that slots before _migrateIdx are always empty
+     * and searches in old slots keep working until the last item is moved. Empty slots have their own budget, as after
+     * a shrink most of them are empty
+     */
+    while ((lpht->_oldEntries != NULL) && lpht->_oldItems && steps && visits) {
+        entry = LPHT_SLOT_IN(lpht, lpht->_oldEntries, lpht->_migrateIdx);
+        if (entry->keyLen) {
+            /* When overflow storage is being compacted, long keys are copied to the new one */
+            if ((lpht->_oldArena != NULL) && (entry->keyLen > lpht->_keySize)) {
+                keyCopy = lpHashTableArenaAlloc(lpht, entry->keyLen);
+                if (keyCopy == NULL) {
+                    return;
                 }
+                memcpy(keyCopy, lpHashTableEntryKey(lpht, entry), entry->keyLen);
+                memcpy(entry + 1, &keyCopy, sizeof(char*));
+                lpht->_arenaLive += entry->keyLen;
             }
-            lpht->entries[ii].key = lpht->entries[startIndex].key;
-            lpht->entries[ii].value = lpht->entries[startIndex].value;
-            lpht->entries[startIndex].key = NULL;
-            lpht->entries[startIndex].value = NULL;
-        }
-        if (++startIndex >= lpht->size) {
-            startIndex = 0;
+            lpHashTableMoveEntry(lpht, entry);
+            lpHashTableShiftBack(lpht, lpht->_oldEntries, lpht->_oldSize, lpht->_migrateIdx);
+            lpht->_oldItems--;
+            steps--;
+        } else {
+            lpht->_migrateIdx++;
+            visits--;
         }
     }
+
+    if ((lpht->_oldEntries != NULL) && !lpht->_oldItems) {
+        ADVUTILS_FREE(lpht->_oldEntries);
+        lpht->_oldEntries = NULL;
+        lpht->_oldSize = 0;
+    }
+
+    /* Once no old slot refers to it, old overflow storage is released one chunk per step */
+    while ((lpht->_oldEntries == NULL) && (lpht->_oldArena != NULL) && steps--) {
+        chunk = lpht->_oldArena;
+        lpht->_oldArena = chunk->next;
+        ADVUTILS_FREE(chunk);
+    }
 }
 
 static utilsStatus_t lpHashTableXpand(lpHashTable_t* lpht, uint8_t increase) {
-    /* Allocate new entries array. */
-    uint32_t ii;
-    uint32_t old_size = lpht->size;
+    uint32_t size = lpht->size;
+
+    /*
+     * A resize can be needed again before the previous incremental one is over: it is postponed to a following operation and
+     * migration gets an extra step meanwhile, so that no single operation moves all old slots
+     */
+    if (lpht->_oldEntries != NULL) {
+        lpHashTableMigrate(lpht, lpht->_migrateStep);
+        return UTILS_STATUS_SUCCESS;
+    }
 
     /* hash is currently a uint32_t so Hash-table size should not exceed that */
     if (increase) {
         /* increase table size */
-        if (lpht->size >= LPHT_MAX_SIZE) {
+        if (size >= LPHT_MAX_SIZE) {
             return UTILS_STATUS_SUCCESS;
-        } else if (lpht->size >= (LPHT_MAX_SIZE >> 1)) {
-            lpht->size = LPHT_MAX_SIZE;
+        } else if (size >= (LPHT_MAX_SIZE >> 1)) {
+            size = LPHT_MAX_SIZE;
         } else {
-            lpht->size *= 2;
+            size *= 2;
         }
     } else {
         /* decrease table size */
-        if (lpht->size <= LPHT_MIN_SIZE) {
+        if (size <= LPHT_MIN_SIZE) {
             return UTILS_STATUS_SUCCESS;
-        } else if (lpht->size >= (LPHT_MIN_SIZE * 2)) {
-            lpht->size = (lpht->size >> 1);
+        } else if (size >= (LPHT_MIN_SIZE * 2)) {
+            size = (size >> 1);
         } else {
-            lpht->size = LPHT_MIN_SIZE;
+            size = LPHT_MIN_SIZE;
         }
     }
 
-    lpHashTableEntry_t* old_entries = lpht->entries;
-    lpht->entries = ADVUTILS_CALLOC(lpht->size, sizeof(lpHashTableEntry_t));
+    return lpHashTableRehash(lpht, size);
+}
+
+static utilsStatus_t lpHashTableRehash(lpHashTable_t* lpht, uint32_t size) {
+    /* Allocate new entries array. */
+    uint32_t ii, room;
+    uint32_t old_size = lpht->size;
+    uint64_t steps;
+#ifdef LPHT_STATS
+    uint64_t start = LPHT_STATS_CLOCK();
+#endif /* LPHT_STATS */
+
+    uint8_t* old_entries = lpht->entries;
+    lpht->entries = ADVUTILS_CALLOC(size, lpht->_slotSize);
     ADVUTILS_ASSERT(lpht->entries != NULL);
     if (lpht->entries == NULL) {
-        lpht->size = old_size;
         lpht->entries = old_entries;
         return UTILS_STATUS_ERROR;
     }
+    lpht->size = size;
 
-    /* Iterate entries, move all non-empty ones to new table's entries. */
-    lpht->items = 0;
+    /* Incremental resize keeps old entries, that are moved by the following operations */
+    if ((lpht->resizable == LPHT_RESIZABLE_INCREMENTAL) && lpht->items) {
+        lpht->_oldEntries = old_entries;
+        lpht->_oldSize = old_size;
+        lpht->_oldItems = lpht->items;
+        lpht->_migrateIdx = 0;
+        /*
+         * Migration must be over before new slots fill up, as the table cannot grow meanwhile: each old slot and each item
+         * takes a step, and each operation adds at most one item
+         */
+        room = (size > lpht->items) ? (size - lpht->items) : 1;
+        steps = ((uint64_t)old_size + lpht->items + room - 1) / room;
+        steps = (steps > UINT32_MAX) ? UINT32_MAX : steps;
+        lpht->_migrateStep = (steps > LPHT_MIGRATION_STEP) ? (uint32_t)steps : LPHT_MIGRATION_STEP;
+        /* Overflow storage is compacted along, by copying long keys of moved entries to a new one */
+        if ((lpht->_oldArena == NULL) && lpHashTableArenaWasted(lpht)) {
+            lpHashTableArenaRotate(lpht);
+        }
+#ifdef LPHT_STATS
+        /* Same-size rehash is only used to compact overflow storage. Time of the migration itself is spread among operations */
+        if (size == old_size) {
+            lpht->_compactCount++;
+        } else {
+            lpht->_xpandCount++;
+            lpht->_xpandTime += LPHT_STATS_CLOCK() - start;
+        }
+#endif /* LPHT_STATS */
+        return UTILS_STATUS_SUCCESS;
+    }
 
+    /* Iterate entries, move all non-empty ones to new table's entries. */
     for (ii = 0; ii < old_size; ii++) {
-        if (old_entries[ii].key != NULL) {
-            /* limit hash to current memory size */
-            uint32_t jj = LPHT_HASHFUN(old_entries[ii].key) & (lpht->size - 1);
-            while (lpht->entries[jj].key != NULL) {
-                if (++jj >= lpht->size) {
-                    jj = 0;
-                }
-            }
-            lpht->entries[jj].key = old_entries[ii].key;
-            lpht->entries[jj].value = old_entries[ii].value;
-            lpht->items++;
+        lpHashTableEntry_t* entry = LPHT_SLOT_IN(lpht, old_entries, ii);
+        if (entry->keyLen) {
+            lpHashTableMoveEntry(lpht, entry);
         }
     }
 
     ADVUTILS_FREE(old_entries);
 
+#ifdef LPHT_STATS
+    lpht->_xpandCount++;
+    lpht->_xpandTime += LPHT_STATS_CLOCK() - start;
+#endif /* LPHT_STATS */
+
     return UTILS_STATUS_SUCCESS;
 }
 
+static void lpHashTableArenaMoveKeys(lpHashTable_t* lpht, uint8_t* slots, uint32_t size, lpHashTableArena_t* chunk) {
+    uint32_t ii;
+
+    for (ii = 0; ii < size; ii++) {
+        lpHashTableEntry_t* entry = LPHT_SLOT_IN(lpht, slots, ii);
+        if (entry->keyLen > lpht->_keySize) {
+            char* keyCopy = (char*)(chunk + 1) + chunk->used;
+            memcpy(keyCopy, lpHashTableEntryKey(lpht, entry), entry->keyLen);
+            memcpy(entry + 1, &keyCopy, sizeof(char*));
+            chunk->used += entry->keyLen;
+        }
+    }
+}
+
+static void lpHashTableArenaReclaim(lpHashTable_t* lpht) {
+    if (!lpht->_arenaLive) {
+        lpHashTableArenaFree(lpht);
+        return;
+    }
+
+    if (!lpHashTableArenaWasted(lpht)) {
+        return;
+    }
+
+    /* Compaction is only an optimization, so keep current storage if it cannot be allocated */
+    lpHashTableArena_t* chunk = ADVUTILS_MALLOC(sizeof(lpHashTableArena_t) + lpht->_arenaLive);
+    if (chunk == NULL) {
+        return;
+    }
+    chunk->size = lpht->_arenaLive;
+    chunk->used = 0;
+    chunk->next = NULL;
+
+    /* Incremental tables compact by rehashing instead, so there are no old slots here */
+    lpHashTableArenaMoveKeys(lpht, lpht->entries, lpht->size, chunk);
+
+    size_t live = lpht->_arenaLive;
+    lpHashTableArenaFree(lpht);
+    lpht->_arena = chunk;
+    lpht->_arenaUsed = live;
+    lpht->_arenaLive = live;
+#ifdef LPHT_STATS
+    lpht->_compactCount++;
+#endif /* LPHT_STATS */
+}
+
 #endif /* ADVUTILS_USE_DYNAMIC_ALLOCATION */
@@ -0,0 +1,421 @@
+/* BEGIN Header */
+/**
+ ******************************************************************************
+ * \file            MPHashTable.c
+ * \author          Andrea Vivani
+ * \brief           Minimal perfect hash-table, built once from a static set of keys
+ ******************************************************************************
+ * \copyright
+ *
+ * Copyright 2024 Andrea Vivani
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the “Software”), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ ******************************************************************************
+ */
+/* END Header */
+
+/* Configuration check -------------------------------------------------------*/
+#if !defined(ADVUTILS_USE_DYNAMIC_ALLOCATION) && !defined(ADVUTILS_USE_STATIC_ALLOCATION)
+#error Either ADVUTILS_USE_DYNAMIC_ALLOCATION or ADVUTILS_USE_STATIC_ALLOCATION must be set for ADVUtils to work
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+
+#include "MPHashTable.h"
+#include <string.h>
+#include "ADVUtilsAssert.h"
+#include "hashFunctions.h"
+#ifdef ADVUTILS_MEMORY_MGMT_HEADER
+#if !defined(ADVUTILS_MALLOC) || !defined(ADVUTILS_CALLOC) || !defined(ADVUTILS_FREE)
+#error ADVUTILS_MALLOC, ADVUTILS_CALLOC and ADVUTILS_FREE must be defined by the user!
+#else
+#include ADVUTILS_MEMORY_MGMT_HEADER
+#endif /* !defined(ADVUTILS_MALLOC) || !defined(ADVUTILS_CALLOC) || !defined(ADVUTILS_FREE) */
+#else
+#include <stdlib.h>
+#endif /* ADVUTILS_MEMORY_MGMT_HEADER */
+
+/* Macros --------------------------------------------------------------------*/
+
+#ifndef ADVUTILS_MEMORY_MGMT_HEADER
+#define ADVUTILS_MALLOC malloc
+#define ADVUTILS_CALLOC calloc
+#define ADVUTILS_FREE   free
+#endif /* ADVUTILS_MEMORY_MGMT_HEADER */
+
+/* Average number of keys per bucket (i.e. per pilot): larger buckets take less memory but longer to build */
+#ifndef MPHT_BUCKET_SIZE
+#define MPHT_BUCKET_SIZE 4
+#endif /* MPHT_BUCKET_SIZE */
+
+/* Pilots tried for each bucket, per item in the hash-table, before giving up with the current seed */
+#ifndef MPHT_PILOT_TRIES
+#define MPHT_PILOT_TRIES 32
+#endif /* MPHT_PILOT_TRIES */
+
+/* Seeds tried by the builder before giving up */
+#ifndef MPHT_MAX_SEEDS
+#define MPHT_MAX_SEEDS 8
+#endif /* MPHT_MAX_SEEDS */
+
+/* Hash function for keys, 64 bits are needed to tell apart all keys of large sets */
+#ifndef MPHT_HASHFUN
+#define MPHT_HASHFUN hash_FNV1A64_buf
+#endif /* MPHT_HASHFUN */
+
+#define MPHT_MAGIC       "ADVMPHT"
+#define MPHT_VERSION     1
+#define MPHT_ENDIANNESS  0x01020304UL
+#define MPHT_SEED_STEP   0xD6E8FEB86659FD93ULL
+#define MPHT_PILOT_STEP  0x9E3779B97F4A7C15ULL
+#define MPHT_FREE_SLOT   UINT32_MAX
+#define MPHT_ALIGN(size) (((size) + 7) & ~(uint64_t)7)
+
+/* Typedefs ------------------------------------------------------------------*/
+
+/*
+ * Hash-table block header, followed by pilots, key offsets, values and keys, each area aligned to 8 bytes
+ */
+typedef struct {
+    char magic[8];
+    uint32_t endianness, version;
+    uint32_t items, buckets;
+    uint64_t itemSize, keysBytes, seed;
+} mpHashTableHeader_t;
+
+/* Function prototypes -------------------------------------------------------*/
+
+static utilsStatus_t mpHashTableAttach(mpHashTable_t* mpht, const void* data, size_t dataSize);
+static size_t mpHashTableBlockSize(uint32_t items, uint32_t buckets, uint64_t itemSize, uint64_t keysBytes);
+
+/* Private Functions ---------------------------------------------------------*/
+
+/*
+ * Map a 32-bit hash to [0, n) with a multiplication, cheaper than a modulo
+ */
+static inline uint32_t mpHashTableRange(uint32_t hash, uint32_t n) { return (uint32_t)(((uint64_t)hash * n) >> 32); }
+
+static inline uint32_t mpHashTableBucket(uint64_t hash, uint32_t buckets) { return mpHashTableRange(hash_mix64(hash), buckets); }
+
+static inline uint32_t mpHashTableSlot(uint64_t hash, uint32_t pilot, uint32_t items) {
+    return mpHashTableRange(hash_mix64(hash ^ (((uint64_t)pilot + 1) * MPHT_PILOT_STEP)), items);
+}
+
+/*
+ * Size of the block in 64 bits, so that it can be checked against size_t on 32-bit targets. Returns 0 if the block can't be addressed
+ */
+static size_t mpHashTableBlockSize(uint32_t items, uint32_t buckets, uint64_t itemSize, uint64_t keysBytes) {
+    uint64_t size, valuesSize;
+
+    if ((itemSize > UINT32_MAX) || (keysBytes > UINT32_MAX)) {
+        return 0;
+    }
+    size = sizeof(mpHashTableHeader_t) + MPHT_ALIGN((uint64_t)buckets * sizeof(uint32_t)) + MPHT_ALIGN(((uint64_t)items + 1) * sizeof(uint32_t))
+           + keysBytes;
+    valuesSize = MPHT_ALIGN((uint64_t)items * itemSize);
+
+    return ((size > SIZE_MAX) || (valuesSize > (SIZE_MAX - size))) ? 0 : (size_t)(size + valuesSize);
+}
+
+static utilsStatus_t mpHashTableAttach(mpHashTable_t* mpht, const void* data, size_t dataSize) {
+    const mpHashTableHeader_t* header = (const mpHashTableHeader_t*)data;
+    const uint8_t* area = (const uint8_t*)data + sizeof(mpHashTableHeader_t);
+    uint32_t ii;
+
+    if ((data == NULL) || ((uintptr_t)data & 7) || (dataSize < sizeof(mpHashTableHeader_t))) {
+        return UTILS_STATUS_ERROR;
+    }
+    if (memcmp(header->magic, MPHT_MAGIC, sizeof(header->magic)) || (header->endianness != MPHT_ENDIANNESS) || (header->version != MPHT_VERSION)
+        || !header->items || !header->buckets || (mpHashTableBlockSize(header->items, header->buckets, header->itemSize, header->keysBytes) != dataSize)) {
+        return UTILS_STATUS_ERROR;
+    }
+
+    mpht->items = header->items;
+    mpht->itemSize = (size_t)header->itemSize;
+    mpht->_buckets = header->buckets;
+    mpht->_seed = header->seed;
+    mpht->_pilots = (const uint32_t*)area;
+    area += MPHT_ALIGN((size_t)mpht->_buckets * sizeof(uint32_t));
+    mpht->_keyOffsets = (const uint32_t*)area;
+    area += MPHT_ALIGN(((size_t)mpht->items + 1) * sizeof(uint32_t));
+    mpht->_values = area;
+    area += MPHT_ALIGN((size_t)mpht->items * mpht->itemSize);
+    mpht->_keys = area;
+
+    /* Lookups compare keys at these offsets, so they must not go past the keys area */
+    if (mpht->_keyOffsets[mpht->items] != header->keysBytes) {
+        return UTILS_STATUS_ERROR;
+    }
+    for (ii = 0; ii < mpht->items; ii++) {
+        if (mpht->_keyOffsets[ii] > mpht->_keyOffsets[ii + 1]) {
+            return UTILS_STATUS_ERROR;
+        }
+    }
+
+    mpht->data = (const uint8_t*)data;
+    mpht->dataSize = dataSize;
+
+    return UTILS_STATUS_SUCCESS;
+}
+
+#ifdef ADVUTILS_USE_DYNAMIC_ALLOCATION
+/*
+ * Look for a pilot for each bucket, so that all keys land in different slots. Buckets are placed from the largest one, while the table is
+ * still mostly empty, down to single keys that only need a free slot. Returns UTILS_STATUS_WARNING if a bucket can't be placed with this seed.
+ */
+static utilsStatus_t mpHashTableSearch(const uint64_t* hashes, uint32_t items, uint32_t buckets, uint64_t seed, uint32_t* pilots,
+                                       uint32_t* bucketStart, uint32_t* bucketKeys, uint32_t* order, uint32_t* slotKey, uint32_t* bucketSlots) {
+    uint32_t ii, jj, kk, slot, size, maxSize = 0, placed = 0;
+    uint64_t maxPilot, pilot;
+
+    maxPilot = (uint64_t)items * MPHT_PILOT_TRIES + 1024;
+    maxPilot = (maxPilot > UINT32_MAX) ? UINT32_MAX : maxPilot;
+
+    /* Group keys by bucket, slotKey holds the bucket of each key for now */
+    memset(bucketStart, 0, ((size_t)buckets + 1) * sizeof(uint32_t));
+    for (ii = 0; ii < items; ii++) {
+        slotKey[ii] = mpHashTableBucket(hashes[ii] ^ seed, buckets);
+        bucketStart[slotKey[ii] + 1]++;
+    }
+    for (ii = 0; ii < buckets; ii++) {
+        size = bucketStart[ii + 1];
+        if (size > maxSize) {
+            maxSize = size;
+        }
+        bucketStart[ii + 1] += bucketStart[ii];
+        order[ii] = bucketStart[ii];
+    }
+    for (ii = 0; ii < items; ii++) {
+        bucketKeys[order[slotKey[ii]]++] = ii;
+    }
+
+    /* Sort buckets by decreasing size, sizes are small so a pass per size is enough */
+    for (size = maxSize; size > 0; size--) {
+        for (ii = 0; ii < buckets; ii++) {
+            if ((bucketStart[ii + 1] - bucketStart[ii]) == size) {
+                order[placed++] = ii;
+            }
+        }
+    }
+
+    memset(slotKey, 0xFF, (size_t)items * sizeof(uint32_t));
+    memset(pilots, 0, (size_t)buckets * sizeof(uint32_t));
+
+    for (ii = 0; ii < placed; ii++) {
+        const uint32_t* keys = bucketKeys + bucketStart[order[ii]];
+        size = bucketStart[order[ii] + 1] - bucketStart[order[ii]];
+
+        /* Keys with the same hash collide with any seed and pilot */
+        for (jj = 1; jj < size; jj++) {
+            for (kk = 0; kk < jj; kk++) {
+                if (hashes[keys[jj]] == hashes[keys[kk]]) {
+                    return UTILS_STATUS_ERROR;
+                }
+            }
+        }
+
+        for (pilot = 0; pilot < maxPilot; pilot++) {
+            for (jj = 0; jj < size; jj++) {
+                slot = mpHashTableSlot(hashes[keys[jj]] ^ seed, (uint32_t)pilot, items);
+                if (slotKey[slot] != MPHT_FREE_SLOT) {
+                    break;
+                }
+                for (kk = 0; (kk < jj) && (bucketSlots[kk] != slot); kk++) {}
+                if (kk < jj) {
+                    break;
+                }
+                bucketSlots[jj] = slot;
+            }
+            if (jj == size) {
+                break;
+            }
+        }
+        if (pilot == maxPilot) {
+            return UTILS_STATUS_WARNING;
+        }
+
+        pilots[order[ii]] = (uint32_t)pilot;
+        for (jj = 0; jj < size; jj++) {
+            slotKey[bucketSlots[jj]] = keys[jj];
+        }
+    }
+
+    return UTILS_STATUS_SUCCESS;
+}
+#endif /* ADVUTILS_USE_DYNAMIC_ALLOCATION */
+
+/* Functions -----------------------------------------------------------------*/
+
+#ifdef ADVUTILS_USE_DYNAMIC_ALLOCATION
+utilsStatus_t mpHashTableBuild(mpHashTable_t* mpht, const void* const* keys, const size_t* keyLens, const void* values, uint32_t items,
+                               size_t itemSize) {
+    uint32_t ii, buckets, offset;
+    uint64_t seed = 0, keysBytes = 0, *hashes;
+    uint32_t *bucketStart, *bucketKeys, *order, *slotKey, *bucketSlots, *pilots, *keyOffsets;
+    mpHashTableHeader_t* header;
+    uint8_t *scratch, *block, *area, *blockValues, *blockKeys;
+    size_t keyLen, blockSize;
+    utilsStatus_t status = UTILS_STATUS_WARNING;
+
+    mpht->data = NULL;
+    mpht->_owned = 0;
+    if ((keys == NULL) || (values == NULL) || !items) {
+        return UTILS_STATUS_ERROR;
+    }
+
+    for (ii = 0; ii < items; ii++) {
+        keysBytes += (keyLens != NULL) ? keyLens[ii] : strlen((const char*)keys[ii]);
+    }
+    buckets = (uint32_t)(((uint64_t)items + MPHT_BUCKET_SIZE - 1) / MPHT_BUCKET_SIZE);
+    blockSize = mpHashTableBlockSize(items, buckets, itemSize, keysBytes);
+
+    /* Scratch takes less than 32 bytes per item */
+    if (!blockSize || (((uint64_t)items * 32) > SIZE_MAX)) {
+        return UTILS_STATUS_ERROR;
+    }
+
+    /* Build scratch: key hashes, bucket boundaries, keys grouped by bucket, buckets order, slot owners, slots of current bucket */
+    scratch = ADVUTILS_MALLOC((size_t)items * sizeof(uint64_t) + ((size_t)buckets * 2 + 1) * sizeof(uint32_t) + (size_t)items * 3 * sizeof(uint32_t));
+    ADVUTILS_ASSERT(scratch != NULL);
+    if (scratch == NULL) {
+        return UTILS_STATUS_ERROR;
+    }
+    block = ADVUTILS_CALLOC(1, blockSize);
+    ADVUTILS_ASSERT(block != NULL);
+    if (block == NULL) {
+        ADVUTILS_FREE(scratch);
+        return UTILS_STATUS_ERROR;
+    }
+
+    hashes = (uint64_t*)scratch;
+    bucketStart = (uint32_t*)(hashes + items);
+    order = bucketStart + buckets + 1;
+    bucketKeys = order + buckets;
+    slotKey = bucketKeys + items;
+    bucketSlots = slotKey + items;
+
+    header = (mpHashTableHeader_t*)block;
+    area = block + sizeof(mpHashTableHeader_t);
+    pilots = (uint32_t*)area;
+    area += MPHT_ALIGN((size_t)buckets * sizeof(uint32_t));
+    keyOffsets = (uint32_t*)area;
+    area += MPHT_ALIGN(((size_t)items + 1) * sizeof(uint32_t));
+    blockValues = area;
+    area += MPHT_ALIGN((size_t)items * itemSize);
+    blockKeys = area;
+
+    for (ii = 0; ii < items; ii++) {
+        keyLen = (keyLens != NULL) ? keyLens[ii] : strlen((const char*)keys[ii]);
+        hashes[ii] = MPHT_HASHFUN(keys[ii], keyLen);
+    }
+
+    for (ii = 0; (ii < MPHT_MAX_SEEDS) && (status == UTILS_STATUS_WARNING); ii++) {
+        seed = (uint64_t)ii * MPHT_SEED_STEP;
+        status = mpHashTableSearch(hashes, items, buckets, seed, pilots, bucketStart, bucketKeys, order, slotKey, bucketSlots);
+    }
+    if (status != UTILS_STATUS_SUCCESS) {
+        ADVUTILS_FREE(scratch);
+        ADVUTILS_FREE(block);
+        return UTILS_STATUS_ERROR;
+    }
+
+    /* Lay out values and keys by slot */
+    offset = 0;
+    for (ii = 0; ii < items; ii++) {
+        const uint32_t key = slotKey[ii];
+        keyLen = (keyLens != NULL) ? keyLens[key] : strlen((const char*)keys[key]);
+        keyOffsets[ii] = offset;
+        memcpy(blockKeys + offset, keys[key], keyLen);
+        memcpy(blockValues + (size_t)ii * itemSize, (const uint8_t*)values + (size_t)key * itemSize, itemSize);
+        offset += (uint32_t)keyLen;
+    }
+    keyOffsets[items] = offset;
+    ADVUTILS_FREE(scratch);
+
+    memcpy(header->magic, MPHT_MAGIC, sizeof(header->magic));
+    header->endianness = MPHT_ENDIANNESS;
+    header->version = MPHT_VERSION;
+    header->items = items;
+    header->buckets = buckets;
+    header->itemSize = itemSize;
+    header->keysBytes = keysBytes;
+    header->seed = seed;
+
+    mpHashTableAttach(mpht, block, blockSize);
+    mpht->_owned = 1;
+
+    return UTILS_STATUS_SUCCESS;
+}
+#endif /* ADVUTILS_USE_DYNAMIC_ALLOCATION */
+
+#ifdef ADVUTILS_USE_STATIC_ALLOCATION
+utilsStatus_t mpHashTableInitStatic(mpHashTable_t* mpht, const void* data, size_t dataSize) {
+    mpht->data = NULL;
+    mpht->_owned = 0;
+
+    return mpHashTableAttach(mpht, data, dataSize);
+}
+#endif /* ADVUTILS_USE_STATIC_ALLOCATION */
+
+utilsStatus_t mpHashTableGet(const mpHashTable_t* mpht, const char* key, void* value) {
+    if (key == NULL) {
+        return UTILS_STATUS_ERROR;
+    }
+
+    return mpHashTableGetBin(mpht, key, strlen(key), value);
+}
+
+utilsStatus_t mpHashTableGetBin(const mpHashTable_t* mpht, const void* key, size_t keyLen, void* value) {
+    uint64_t hash;
+    uint32_t slot, start;
+
+    if ((mpht->data == NULL) || (key == NULL) || (value == NULL)) {
+        return UTILS_STATUS_ERROR;
+    }
+
+    /* Every possible key lands in a slot, the single key comparison tells whether it belongs to the set */
+    hash = MPHT_HASHFUN(key, keyLen) ^ mpht->_seed;
+    slot = mpHashTableSlot(hash, mpht->_pilots[mpHashTableBucket(hash, mpht->_buckets)], mpht->items);
+    start = mpht->_keyOffsets[slot];
+    if (((mpht->_keyOffsets[slot + 1] - start) != keyLen) || memcmp(mpht->_keys + start, key, keyLen)) {
+        return UTILS_STATUS_ERROR;
+    }
+    memcpy(value, mpht->_values + (size_t)slot * mpht->itemSize, mpht->itemSize);
+
+    return UTILS_STATUS_SUCCESS;
+}
+
+utilsStatus_t mpHashTableDelete(mpHashTable_t* mpht) {
+    if (mpht->data == NULL) {
+        return UTILS_STATUS_ERROR;
+    }
+
+#ifdef ADVUTILS_USE_DYNAMIC_ALLOCATION
+    if (mpht->_owned) {
+        ADVUTILS_FREE((void*)mpht->data);
+    }
+#endif /* ADVUTILS_USE_DYNAMIC_ALLOCATION */
+    mpht->data = NULL;
+    mpht->dataSize = 0;
+    mpht->items = 0;
+    mpht->_owned = 0;
+
+    return UTILS_STATUS_SUCCESS;
+}
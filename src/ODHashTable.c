@@ -0,0 +1,425 @@
+/* BEGIN Header */
+/**
+ ******************************************************************************
+ * \file            ODHashTable.c
+ * \author          Andrea Vivani
+ * \brief           Insertion-ordered compact hash-table
+ ******************************************************************************
+ * \copyright
+ *
+ * Copyright 2024 Andrea Vivani
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the “Software”), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ ******************************************************************************
+ */
+/* END Header */
+
+/* Configuration check -------------------------------------------------------*/
+#if !defined(ADVUTILS_USE_DYNAMIC_ALLOCATION) && !defined(ADVUTILS_USE_STATIC_ALLOCATION)
+#error Either ADVUTILS_USE_DYNAMIC_ALLOCATION or ADVUTILS_USE_STATIC_ALLOCATION must be set for ADVUtils to work
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+
+#include "ODHashTable.h"
+#include <string.h>
+#include "ADVUtilsAssert.h"
+#include "hashFunctions.h"
+#ifdef ADVUTILS_MEMORY_MGMT_HEADER
+#if !defined(ADVUTILS_MALLOC) || !defined(ADVUTILS_CALLOC) || !defined(ADVUTILS_FREE)
+#error ADVUTILS_MALLOC, ADVUTILS_CALLOC and ADVUTILS_FREE must be defined by the user!
+#else
+#include ADVUTILS_MEMORY_MGMT_HEADER
+#endif /* !defined(ADVUTILS_MALLOC) || !defined(ADVUTILS_CALLOC) || !defined(ADVUTILS_FREE) */
+#else
+#include <stdlib.h>
+#endif /* ADVUTILS_MEMORY_MGMT_HEADER */
+
+/* Macros --------------------------------------------------------------------*/
+
+#ifndef ADVUTILS_MEMORY_MGMT_HEADER
+#define ADVUTILS_MALLOC malloc
+#define ADVUTILS_CALLOC calloc
+#define ADVUTILS_FREE   free
+#endif /* ADVUTILS_MEMORY_MGMT_HEADER */
+
+/* Minimum size of hash-table (index slots) when resizing, must be a power of 2 */
+#ifndef ODHT_MIN_SIZE
+#define ODHT_MIN_SIZE 8
+#endif /* ODHT_MIN_SIZE */
+
+/* Maximum size of hash-table (index slots) when resizing, must be a power of 2 */
+#ifndef ODHT_MAX_SIZE
+#define ODHT_MAX_SIZE 0x80000000UL
+#endif /* ODHT_MAX_SIZE */
+
+/* Minimum saturation of hash-table, that triggers a down-sizing */
+#ifndef ODHT_MIN_SATURATION
+#define ODHT_MIN_SATURATION 0.2
+#endif /* ODHT_MIN_SATURATION */
+
+/* Maximum saturation of index (removed entries included), that sets the size of entries array */
+#ifndef ODHT_MAX_SATURATION
+#define ODHT_MAX_SATURATION 0.67
+#endif /* ODHT_MAX_SATURATION */
+
+/* Size of key storage inside each entry (terminator included), longer keys are allocated on their own */
+#ifndef ODHT_INLINE_KEY_SIZE
+#define ODHT_INLINE_KEY_SIZE 16
+#endif /* ODHT_INLINE_KEY_SIZE */
+
+/* Hash function used by hash-table */
+#ifndef ODHT_HASHFUN
+#define ODHT_HASHFUN hash_FNV1A
+#endif /* ODHT_HASHFUN */
+
+/* Hash function used by hash-table for binary keys */
+#ifndef ODHT_BIN_HASHFUN
+#define ODHT_BIN_HASHFUN hash_FNV1A_buf
+#endif /* ODHT_BIN_HASHFUN */
+
+/* Index slot values of empty slots and of slots whose entry was removed, used slots store entry number + 1 */
+#define ODHT_INDEX_EMPTY        0
+#define ODHT_INDEX_REMOVED(odht) (UINT32_MAX >> (32 - 8 * (odht)->_indexWidth))
+
+#define ODHT_ALIGN(size) (((size) + 7) & ~((size_t)7))
+
+/* Pointer to entry ii */
+#define ODHT_ENTRY(odht, ii) ((odHashTableEntry_t*)((odht)->entries + (size_t)(ii) * (odht)->_entrySize))
+
+/* Function prototypes -------------------------------------------------------*/
+
+#ifdef ADVUTILS_USE_DYNAMIC_ALLOCATION
+static utilsStatus_t odHashTablePutKey(odHashTable_t* odht, const void* key, uint32_t keyLen, uint32_t hash, void* value);
+static utilsStatus_t odHashTableGetKey(odHashTable_t* odht, const void* key, uint32_t keyLen, uint32_t hash, void* value, odHashTableRemoval_t remove);
+static odHashTableEntry_t* odHashTableFind(odHashTable_t* odht, const void* key, uint32_t keyLen, uint32_t hash, uint32_t* slot);
+static utilsStatus_t odHashTableRebuild(odHashTable_t* odht, uint32_t newSize);
+#endif /* ADVUTILS_USE_DYNAMIC_ALLOCATION */
+
+/* Private Functions ---------------------------------------------------------*/
+
+static inline uint32_t odHashTableIndexGet(const odHashTable_t* odht, uint32_t slot) {
+    switch (odht->_indexWidth) {
+        case 1: return ((const uint8_t*)odht->_index)[slot];
+        case 2: return ((const uint16_t*)odht->_index)[slot];
+        default: return ((const uint32_t*)odht->_index)[slot];
+    }
+}
+
+static inline void odHashTableIndexSet(odHashTable_t* odht, uint32_t slot, uint32_t value) {
+    switch (odht->_indexWidth) {
+        case 1: ((uint8_t*)odht->_index)[slot] = (uint8_t)value; break;
+        case 2: ((uint16_t*)odht->_index)[slot] = (uint16_t)value; break;
+        default: ((uint32_t*)odht->_index)[slot] = value; break;
+    }
+}
+
+/* First empty index slot for hash, index always has empty slots as entries array is smaller */
+static inline uint32_t odHashTableFindEmpty(const odHashTable_t* odht, uint32_t hash) {
+    uint32_t slot = hash & (odht->size - 1);
+
+    while (odHashTableIndexGet(odht, slot) != ODHT_INDEX_EMPTY) {
+        slot = (slot + 1) & (odht->size - 1);
+    }
+    return slot;
+}
+
+static inline uint8_t* odHashTableEntryKey(const odHashTable_t* odht, odHashTableEntry_t* entry) {
+    uint8_t* key = (uint8_t*)(entry + 1);
+
+    if (entry->keyLen > odht->_keySize) {
+        memcpy(&key, entry + 1, sizeof(uint8_t*));
+    }
+    return key;
+}
+
+static inline void* odHashTableEntryValue(const odHashTable_t* odht, odHashTableEntry_t* entry) { return (uint8_t*)(entry + 1) + odht->_keySize; }
+
+static inline void odHashTableFreeKey(odHashTable_t* odht, odHashTableEntry_t* entry) {
+    if (entry->keyLen > odht->_keySize) {
+        ADVUTILS_FREE(odHashTableEntryKey(odht, entry));
+    }
+    entry->keyLen = 0;
+}
+
+/* Functions -----------------------------------------------------------------*/
+
+#ifdef ADVUTILS_USE_DYNAMIC_ALLOCATION
+
+utilsStatus_t odHashTableInit(odHashTable_t* odht, size_t itemSize, uint32_t init_items, odHashTableResizable_t resizable) {
+    uint32_t size = ODHT_MIN_SIZE;
+
+    while (((size * ODHT_MAX_SATURATION) < init_items) && (size < ODHT_MAX_SIZE)) {
+        size <<= 1;
+    }
+
+    odht->items = 0;
+    odht->itemSize = itemSize;
+    odht->resizable = resizable;
+    odht->_keySize = ODHT_ALIGN(ODHT_INLINE_KEY_SIZE > sizeof(uint8_t*) ? ODHT_INLINE_KEY_SIZE : sizeof(uint8_t*));
+    odht->_entrySize = sizeof(odHashTableEntry_t) + odht->_keySize + ODHT_ALIGN(itemSize);
+    odht->size = 0;
+    odht->_used = 0;
+    odht->_index = NULL;
+    odht->entries = NULL;
+
+    return odHashTableRebuild(odht, size);
+}
+
+utilsStatus_t odHashTablePut(odHashTable_t* odht, char* key, void* value) {
+    if ((value == NULL) || (key == NULL)) {
+        return UTILS_STATUS_ERROR;
+    }
+
+    return odHashTablePutKey(odht, key, strlen(key) + 1, ODHT_HASHFUN(key), value);
+}
+
+utilsStatus_t odHashTableGet(odHashTable_t* odht, char* key, void* value, odHashTableRemoval_t remove) {
+
+    if (!odht->items) {
+        return UTILS_STATUS_EMPTY;
+    }
+
+    return odHashTableGetKey(odht, key, strlen(key) + 1, ODHT_HASHFUN(key), value, remove);
+}
+
+utilsStatus_t odHashTablePutBin(odHashTable_t* odht, const void* key, size_t keyLen, void* value) {
+    if ((value == NULL) || (key == NULL) || !keyLen || (keyLen > UINT32_MAX)) {
+        return UTILS_STATUS_ERROR;
+    }
+
+    return odHashTablePutKey(odht, key, (uint32_t)keyLen, ODHT_BIN_HASHFUN(key, keyLen), value);
+}
+
+utilsStatus_t odHashTableGetBin(odHashTable_t* odht, const void* key, size_t keyLen, void* value, odHashTableRemoval_t remove) {
+
+    if (!odht->items) {
+        return UTILS_STATUS_EMPTY;
+    }
+
+    if ((key == NULL) || !keyLen || (keyLen > UINT32_MAX)) {
+        return UTILS_STATUS_ERROR;
+    }
+
+    return odHashTableGetKey(odht, key, (uint32_t)keyLen, ODHT_BIN_HASHFUN(key, keyLen), value, remove);
+}
+
+utilsStatus_t odHashTableFlush(odHashTable_t* odht) {
+    uint32_t ii;
+
+    if (!odht->items) {
+        return UTILS_STATUS_EMPTY;
+    }
+
+    for (ii = 0; ii < odht->_used; ii++) {
+        odHashTableFreeKey(odht, ODHT_ENTRY(odht, ii));
+    }
+    memset(odht->_index, 0, (size_t)odht->size * odht->_indexWidth);
+
+    odht->items = 0;
+    odht->_used = 0;
+
+    return UTILS_STATUS_SUCCESS;
+}
+
+utilsStatus_t odHashTableDelete(odHashTable_t* odht) {
+
+    if (odht->_index == NULL) {
+        return UTILS_STATUS_ERROR;
+    }
+
+    odHashTableFlush(odht);
+
+    ADVUTILS_FREE(odht->_index);
+    odht->_index = NULL;
+    odht->entries = NULL;
+
+    return UTILS_STATUS_SUCCESS;
+}
+
+void odHashTableIt(odHashTableIterator_t* it, odHashTable_t* odht) {
+    it->_odht = odht;
+    it->_index = 0;
+    it->key = NULL;
+    it->keyLen = 0;
+    it->value = NULL;
+}
+
+utilsStatus_t odHashTableItNext(odHashTableIterator_t* it) {
+    odHashTable_t* odht = it->_odht;
+
+    /* Entries are contiguous and in insertion order, only removed ones are skipped */
+    while (it->_index < odht->_used) {
+        odHashTableEntry_t* entry = ODHT_ENTRY(odht, it->_index++);
+        if (entry->keyLen) {
+            it->key = (char*)odHashTableEntryKey(odht, entry);
+            it->keyLen = entry->keyLen;
+            it->value = odHashTableEntryValue(odht, entry);
+            return UTILS_STATUS_SUCCESS;
+        }
+    }
+    return UTILS_STATUS_ERROR;
+}
+
+static utilsStatus_t odHashTablePutKey(odHashTable_t* odht, const void* key, uint32_t keyLen, uint32_t hash, void* value) {
+    odHashTableEntry_t* entry;
+    uint32_t slot;
+    uint8_t* keyCopy;
+
+    /* Update the entry if it exists already */
+    entry = odHashTableFind(odht, key, keyLen, hash, &slot);
+    if (entry != NULL) {
+        memcpy(odHashTableEntryValue(odht, entry), value, odht->itemSize);
+        return UTILS_STATUS_SUCCESS;
+    }
+
+    /* If entries array is full, rebuild it without removed entries. Size is doubled unless most of them are removed */
+    if (odht->_used == odht->_capacity) {
+        uint32_t newSize = odht->size;
+        if (((odht->items + 1) > (odht->_capacity * 0.5)) && (odht->resizable == ODHT_RESIZABLE) && (odht->size < ODHT_MAX_SIZE)) {
+            newSize <<= 1;
+        }
+        if ((newSize == odht->size) && (odht->items == odht->_used)) {
+            return UTILS_STATUS_FULL;
+        }
+        if (odHashTableRebuild(odht, newSize) == UTILS_STATUS_ERROR) {
+            return UTILS_STATUS_ERROR;
+        }
+        slot = odHashTableFindEmpty(odht, hash);
+    }
+
+    /* Keys that don't fit inline are allocated, the entry stores their pointer */
+    entry = ODHT_ENTRY(odht, odht->_used);
+    if (keyLen > odht->_keySize) {
+        keyCopy = ADVUTILS_MALLOC(keyLen);
+        ADVUTILS_ASSERT(keyCopy != NULL);
+        if (keyCopy == NULL) {
+            return UTILS_STATUS_ERROR;
+        }
+        memcpy(keyCopy, key, keyLen);
+        memcpy(entry + 1, &keyCopy, sizeof(uint8_t*));
+    } else {
+        memcpy(entry + 1, key, keyLen);
+    }
+    entry->hash = hash;
+    entry->keyLen = keyLen;
+    memcpy(odHashTableEntryValue(odht, entry), value, odht->itemSize);
+
+    odHashTableIndexSet(odht, slot, ++odht->_used);
+    odht->items++;
+
+    return UTILS_STATUS_SUCCESS;
+}
+
+static utilsStatus_t odHashTableGetKey(odHashTable_t* odht, const void* key, uint32_t keyLen, uint32_t hash, void* value, odHashTableRemoval_t remove) {
+    uint32_t slot;
+    odHashTableEntry_t* entry = odHashTableFind(odht, key, keyLen, hash, &slot);
+
+    if (entry == NULL) {
+        return UTILS_STATUS_ERROR;
+    }
+
+    memcpy(value, odHashTableEntryValue(odht, entry), odht->itemSize);
+
+    if (remove == ODHT_REMOVE_ITEM) {
+        /* Entry stays in place to keep the order of the following ones, its slot can't be emptied as it could be part of other probe sequences */
+        odHashTableFreeKey(odht, entry);
+        odHashTableIndexSet(odht, slot, ODHT_INDEX_REMOVED(odht));
+
+        if ((--odht->items <= (odht->size * ODHT_MIN_SATURATION)) && (odht->resizable == ODHT_RESIZABLE) && (odht->size > ODHT_MIN_SIZE)) {
+            if (odHashTableRebuild(odht, odht->size >> 1) == UTILS_STATUS_ERROR) {
+                return UTILS_STATUS_WARNING;
+            }
+        }
+    }
+
+    return UTILS_STATUS_SUCCESS;
+}
+
+/*
+ * Return the entry with given key, or NULL if key is not present. slot is set to the index slot of the entry, or to the first empty one
+ */
+static odHashTableEntry_t* odHashTableFind(odHashTable_t* odht, const void* key, uint32_t keyLen, uint32_t hash, uint32_t* slot) {
+    uint32_t mask = odht->size - 1;
+    uint32_t removed = ODHT_INDEX_REMOVED(odht);
+    uint32_t ii = hash & mask;
+    uint32_t idx;
+    odHashTableEntry_t* entry;
+
+    while ((idx = odHashTableIndexGet(odht, ii)) != ODHT_INDEX_EMPTY) {
+        if (idx != removed) {
+            entry = ODHT_ENTRY(odht, idx - 1);
+            if ((entry->hash == hash) && (entry->keyLen == keyLen) && !memcmp(key, odHashTableEntryKey(odht, entry), keyLen)) {
+                *slot = ii;
+                return entry;
+            }
+        }
+        ii = (ii + 1) & mask;
+    }
+
+    *slot = ii;
+    return NULL;
+}
+
+static utilsStatus_t odHashTableRebuild(odHashTable_t* odht, uint32_t newSize) {
+    void* oldIndex = odht->_index;
+    uint8_t* oldEntries = odht->entries;
+    uint32_t oldUsed = odht->_used;
+    uint32_t capacity = (uint32_t)(newSize * ODHT_MAX_SATURATION);
+    uint8_t width = 4;
+    uint8_t* block;
+    uint32_t ii;
+
+    /* Index slots are as narrow as possible, entry numbers + 1 and the removed marker must fit */
+    if (capacity < UINT8_MAX) {
+        width = 1;
+    } else if (capacity < UINT16_MAX) {
+        width = 2;
+    }
+
+    /* Index slots and entries share a single allocation, entries start right after index slots */
+    block = ADVUTILS_CALLOC(1, ODHT_ALIGN((size_t)newSize * width) + (size_t)capacity * odht->_entrySize);
+    ADVUTILS_ASSERT(block != NULL);
+    if (block == NULL) {
+        return UTILS_STATUS_ERROR;
+    }
+
+    odht->_index = block;
+    odht->entries = block + ODHT_ALIGN((size_t)newSize * width);
+    odht->_indexWidth = width;
+    odht->size = newSize;
+    odht->_capacity = capacity;
+    odht->_used = 0;
+
+    /* Live entries are compacted keeping their order, long keys are moved with their pointer */
+    for (ii = 0; ii < oldUsed; ii++) {
+        odHashTableEntry_t* entry = (odHashTableEntry_t*)(oldEntries + (size_t)ii * odht->_entrySize);
+        if (entry->keyLen) {
+            memcpy(ODHT_ENTRY(odht, odht->_used), entry, odht->_entrySize);
+            odHashTableIndexSet(odht, odHashTableFindEmpty(odht, entry->hash), ++odht->_used);
+        }
+    }
+
+    ADVUTILS_FREE(oldIndex);
+
+    return UTILS_STATUS_SUCCESS;
+}
+
+#endif /* ADVUTILS_USE_DYNAMIC_ALLOCATION */
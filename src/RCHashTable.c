@@ -0,0 +1,518 @@
+/* BEGIN Header */
+/**
+ ******************************************************************************
+ * \file            RCHashTable.c
+ * \author          Andrea Vivani
+ * \brief           Implementation of a read-copy-update hash-table, with lock-free readers and epoch-based memory reclamation
+ ******************************************************************************
+ * \copyright
+ *
+ * Copyright 2024 Andrea Vivani
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the “Software”), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ ******************************************************************************
+ */
+/* END Header */
+
+/* Configuration check -------------------------------------------------------*/
+#if !defined(ADVUTILS_USE_DYNAMIC_ALLOCATION) && !defined(ADVUTILS_USE_STATIC_ALLOCATION)
+#error Either ADVUTILS_USE_DYNAMIC_ALLOCATION or ADVUTILS_USE_STATIC_ALLOCATION must be set for ADVUtils to work
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+
+#include "RCHashTable.h"
+#include <string.h>
+#include "ADVUtilsAssert.h"
+#include "hashFunctions.h"
+#ifdef ADVUTILS_MEMORY_MGMT_HEADER
+#if !defined(ADVUTILS_MALLOC) || !defined(ADVUTILS_CALLOC) || !defined(ADVUTILS_FREE)
+#error ADVUTILS_MALLOC, ADVUTILS_CALLOC and ADVUTILS_FREE must be defined by the user!
+#else
+#include ADVUTILS_MEMORY_MGMT_HEADER
+#endif /* !defined(ADVUTILS_MALLOC) || !defined(ADVUTILS_CALLOC) || !defined(ADVUTILS_FREE) */
+#else
+#include <stdlib.h>
+#endif /* ADVUTILS_MEMORY_MGMT_HEADER */
+
+#if defined(ADVUTILS_USE_DYNAMIC_ALLOCATION) && defined(ADVUTILS_USE_PTHREADS)
+/* Macros --------------------------------------------------------------------*/
+
+#ifndef ADVUTILS_MEMORY_MGMT_HEADER
+#define ADVUTILS_MALLOC malloc
+#define ADVUTILS_CALLOC calloc
+#define ADVUTILS_FREE   free
+#endif /* ADVUTILS_MEMORY_MGMT_HEADER */
+
+/* Minimum size of hash-table when resizing, must be a power of 2 */
+#ifndef RCHT_MIN_SIZE
+#define RCHT_MIN_SIZE 8
+#endif /* RCHT_MIN_SIZE */
+
+/* Maximum size of hash-table when resizing, must be a power of 2 */
+#ifndef RCHT_MAX_SIZE
+#define RCHT_MAX_SIZE 0x80000000UL
+#endif /* RCHT_MAX_SIZE */
+
+/* Minimum saturation of hash-table, that triggers a down-sizing */
+#ifndef RCHT_MIN_SATURATION
+#define RCHT_MIN_SATURATION 0.2
+#endif /* RCHT_MIN_SATURATION */
+
+/* Maximum saturation of hash-table (removed items slots included), that triggers an up-sizing */
+#ifndef RCHT_MAX_SATURATION
+#define RCHT_MAX_SATURATION 0.7
+#endif /* RCHT_MAX_SATURATION */
+
+/* Cache line size, reader records are aligned to it so that readers never write to the same line */
+#ifndef RCHT_CACHE_LINE
+#define RCHT_CACHE_LINE 64
+#endif /* RCHT_CACHE_LINE */
+
+/* Hash function used by hash-table */
+#ifndef RCHT_HASHFUN
+#define RCHT_HASHFUN hash_FNV1A
+#endif /* RCHT_HASHFUN */
+
+/* Epoch tag of retired blocks not yet assigned to a grace period */
+#define RCHT_EPOCH_PENDING UINT64_MAX
+
+/* Marker of slots whose item was removed, probing must go past them */
+#define RCHT_TOMBSTONE ((rcHashTableEntry_t*)&rcHashTableTombstone)
+
+/* Pointer to reader record ii */
+#define RCHT_READER(rcht, ii) ((rcHashTableReader_t*)((rcht)->_readers + (size_t)(ii) * (rcht)->_readerStride))
+
+/* Private variables ---------------------------------------------------------*/
+
+static const rcHashTableEntry_t rcHashTableTombstone;
+
+/* Function prototypes -------------------------------------------------------*/
+
+static rcHashTableArray_t* rcHashTableNewArray(uint32_t size);
+static rcHashTableEntry_t* rcHashTableFind(rcHashTable_t* rcht, rcHashTableArray_t* arr, char* key, uint32_t keyLen, uint32_t hash, uint32_t* index);
+static void rcHashTableInsert(rcHashTable_t* rcht, rcHashTableArray_t* arr, rcHashTableEntry_t* entry);
+static utilsStatus_t rcHashTableResize(rcHashTable_t* rcht, uint32_t size);
+static utilsStatus_t rcHashTableRemove(rcHashTable_t* rcht, char* key, void* value);
+static void rcHashTableRetire(rcHashTable_t* rcht, rcHashTableRetired_t* block);
+static void rcHashTableSync(rcHashTable_t* rcht);
+
+/* Private Functions ---------------------------------------------------------*/
+
+static inline void* rcHashTableEntryValue(rcHashTableEntry_t* entry) { return (void*)(entry + 1); }
+
+static inline char* rcHashTableEntryKey(rcHashTable_t* rcht, rcHashTableEntry_t* entry) { return (char*)(entry + 1) + rcht->_valueSize; }
+
+/* Functions -----------------------------------------------------------------*/
+
+utilsStatus_t rcHashTableInit(rcHashTable_t* rcht, size_t itemSize, uint32_t init_items, uint32_t readersNum) {
+    uint32_t ii, size = RCHT_MIN_SIZE;
+    rcHashTableArray_t* arr;
+
+    while ((size < init_items) && (size < RCHT_MAX_SIZE)) {
+        size <<= 1;
+    }
+
+    rcht->items = 0;
+    rcht->itemSize = itemSize;
+    rcht->readersNum = readersNum;
+    rcht->_tombstones = 0;
+    rcht->_valueSize = (itemSize + 7) & ~((size_t)7);
+    rcht->_retired = NULL;
+    rcht->_readersMem = NULL;
+    atomic_init(&rcht->_epoch, 1);
+    atomic_init(&rcht->table, NULL);
+
+    /* Allocate one more cache line so that the first reader record can be aligned to it */
+    rcht->_readerStride = (sizeof(rcHashTableReader_t) + RCHT_CACHE_LINE - 1) & ~((size_t)RCHT_CACHE_LINE - 1);
+    rcht->_readersMem = ADVUTILS_MALLOC((size_t)readersNum * rcht->_readerStride + RCHT_CACHE_LINE);
+    ADVUTILS_ASSERT(rcht->_readersMem != NULL);
+    if (rcht->_readersMem == NULL) {
+        return UTILS_STATUS_ERROR;
+    }
+    rcht->_readers = (uint8_t*)(((uintptr_t)rcht->_readersMem + RCHT_CACHE_LINE - 1) & ~((uintptr_t)RCHT_CACHE_LINE - 1));
+    for (ii = 0; ii < readersNum; ii++) {
+        atomic_init(&RCHT_READER(rcht, ii)->epoch, 0);
+        atomic_init(&RCHT_READER(rcht, ii)->used, 0);
+    }
+
+    arr = rcHashTableNewArray(size);
+    if ((arr == NULL) || pthread_mutex_init(&rcht->_writeLock, NULL)) {
+        ADVUTILS_FREE(arr);
+        ADVUTILS_FREE(rcht->_readersMem);
+        rcht->_readersMem = NULL;
+        return UTILS_STATUS_ERROR;
+    }
+    atomic_store(&rcht->table, arr);
+
+    return UTILS_STATUS_SUCCESS;
+}
+
+utilsStatus_t rcHashTableReaderRegister(rcHashTable_t* rcht, rcHashTableReader_t** reader) {
+    uint32_t ii;
+    unsigned int expected;
+
+    for (ii = 0; ii < rcht->readersNum; ii++) {
+        expected = 0;
+        if (atomic_compare_exchange_strong(&RCHT_READER(rcht, ii)->used, &expected, 1)) {
+            *reader = RCHT_READER(rcht, ii);
+            return UTILS_STATUS_SUCCESS;
+        }
+    }
+
+    return UTILS_STATUS_FULL;
+}
+
+void rcHashTableReaderUnregister(rcHashTable_t* rcht, rcHashTableReader_t* reader) {
+    atomic_store_explicit(&reader->epoch, 0, memory_order_release);
+    atomic_store_explicit(&reader->used, 0, memory_order_release);
+}
+
+utilsStatus_t rcHashTablePut(rcHashTable_t* rcht, char* key, void* value) {
+    rcHashTableArray_t* arr;
+    rcHashTableEntry_t *entry, *old;
+    uint32_t ii, newSize, keyLen, hash;
+
+    if ((value == NULL) || (key == NULL)) {
+        return UTILS_STATUS_ERROR;
+    }
+
+    keyLen = strlen(key) + 1;
+    hash = RCHT_HASHFUN(key);
+
+    /* Entries are immutable once published, so a new one is prepared in any case */
+    entry = ADVUTILS_MALLOC(sizeof(rcHashTableEntry_t) + rcht->_valueSize + keyLen);
+    ADVUTILS_ASSERT(entry != NULL);
+    if (entry == NULL) {
+        return UTILS_STATUS_ERROR;
+    }
+    entry->hash = hash;
+    entry->keyLen = keyLen;
+    memcpy(rcHashTableEntryValue(entry), value, rcht->itemSize);
+    memcpy(rcHashTableEntryKey(rcht, entry), key, keyLen);
+
+    pthread_mutex_lock(&rcht->_writeLock);
+    arr = atomic_load_explicit(&rcht->table, memory_order_relaxed);
+
+    /* Replace the entry if it exists already, readers see either the old or the new one */
+    old = rcHashTableFind(rcht, arr, key, keyLen, hash, &ii);
+    if (old != NULL) {
+        atomic_store_explicit(&arr->slots[ii], entry, memory_order_release);
+        rcHashTableRetire(rcht, &old->_retired);
+        rcHashTableSync(rcht);
+        pthread_mutex_unlock(&rcht->_writeLock);
+        return UTILS_STATUS_SUCCESS;
+    }
+
+    /* If used slots (removed ones included) will exceed defined quota of current capacity, resize. Size is doubled unless most of them are removed */
+    if ((rcht->items + rcht->_tombstones + 1) > (arr->size * RCHT_MAX_SATURATION)) {
+        newSize = arr->size;
+        if (((rcht->items + 1) > (arr->size * RCHT_MAX_SATURATION * 0.5)) && (arr->size < RCHT_MAX_SIZE)) {
+            newSize <<= 1;
+        }
+        if ((newSize == arr->size) && !rcht->_tombstones) {
+            /* At maximum size, one empty slot must always be left to end searches */
+            if ((rcht->items + 1) >= arr->size) {
+                pthread_mutex_unlock(&rcht->_writeLock);
+                ADVUTILS_FREE(entry);
+                return UTILS_STATUS_FULL;
+            }
+        } else if (rcHashTableResize(rcht, newSize) != UTILS_STATUS_SUCCESS) {
+            pthread_mutex_unlock(&rcht->_writeLock);
+            ADVUTILS_FREE(entry);
+            return UTILS_STATUS_ERROR;
+        }
+        arr = atomic_load_explicit(&rcht->table, memory_order_relaxed);
+    }
+
+    rcHashTableInsert(rcht, arr, entry);
+    rcht->items++;
+    rcHashTableSync(rcht);
+    pthread_mutex_unlock(&rcht->_writeLock);
+
+    return UTILS_STATUS_SUCCESS;
+}
+
+utilsStatus_t rcHashTableGet(rcHashTable_t* rcht, rcHashTableReader_t* reader, char* key, void* value, rcHashTableRemoval_t remove) {
+    rcHashTableArray_t* arr;
+    rcHashTableEntry_t* entry;
+
+    if ((value == NULL) || (key == NULL)) {
+        return UTILS_STATUS_ERROR;
+    }
+
+    if (remove == RCHT_REMOVE_ITEM) {
+        return rcHashTableRemove(rcht, key, value);
+    }
+
+    if (reader == NULL) {
+        return UTILS_STATUS_ERROR;
+    }
+
+    /* 
+     * Announce the epoch before loading any pointer: writers won't free blocks unlinked after it until the reader is done. The fence
+     * pairs with the one in rcHashTableSync, so either the writer sees the announcement or the reader sees the unlinked block gone
+     */
+    atomic_store_explicit(&reader->epoch, atomic_load_explicit(&rcht->_epoch, memory_order_relaxed), memory_order_relaxed);
+    atomic_thread_fence(memory_order_seq_cst);
+
+    arr = atomic_load_explicit(&rcht->table, memory_order_acquire);
+    entry = rcHashTableFind(rcht, arr, key, strlen(key) + 1, RCHT_HASHFUN(key), NULL);
+    if (entry != NULL) {
+        memcpy(value, rcHashTableEntryValue(entry), rcht->itemSize);
+    }
+
+    atomic_store_explicit(&reader->epoch, 0, memory_order_release);
+
+    return (entry != NULL) ? UTILS_STATUS_SUCCESS : UTILS_STATUS_ERROR;
+}
+
+void rcHashTableReclaim(rcHashTable_t* rcht) {
+    pthread_mutex_lock(&rcht->_writeLock);
+    rcHashTableSync(rcht);
+    pthread_mutex_unlock(&rcht->_writeLock);
+}
+
+void rcHashTableInfo(rcHashTable_t* rcht, uint32_t* size, uint32_t* items) {
+    pthread_mutex_lock(&rcht->_writeLock);
+    *size = atomic_load_explicit(&rcht->table, memory_order_relaxed)->size;
+    *items = rcht->items;
+    pthread_mutex_unlock(&rcht->_writeLock);
+}
+
+utilsStatus_t rcHashTableFlush(rcHashTable_t* rcht) {
+    rcHashTableArray_t *arr, *newArr;
+    rcHashTableEntry_t* entry;
+    uint32_t ii;
+
+    pthread_mutex_lock(&rcht->_writeLock);
+    if (!rcht->items) {
+        pthread_mutex_unlock(&rcht->_writeLock);
+        return UTILS_STATUS_EMPTY;
+    }
+
+    /* Readers may still be probing old slots, so they are replaced by an empty array instead of being cleared */
+    arr = atomic_load_explicit(&rcht->table, memory_order_relaxed);
+    newArr = rcHashTableNewArray(arr->size);
+    if (newArr == NULL) {
+        pthread_mutex_unlock(&rcht->_writeLock);
+        return UTILS_STATUS_ERROR;
+    }
+    atomic_store_explicit(&rcht->table, newArr, memory_order_release);
+
+    for (ii = 0; ii < arr->size; ii++) {
+        entry = atomic_load_explicit(&arr->slots[ii], memory_order_relaxed);
+        if ((entry != NULL) && (entry != RCHT_TOMBSTONE)) {
+            rcHashTableRetire(rcht, &entry->_retired);
+        }
+    }
+    rcHashTableRetire(rcht, &arr->_retired);
+    rcht->items = 0;
+    rcht->_tombstones = 0;
+    rcHashTableSync(rcht);
+    pthread_mutex_unlock(&rcht->_writeLock);
+
+    return UTILS_STATUS_SUCCESS;
+}
+
+utilsStatus_t rcHashTableDelete(rcHashTable_t* rcht) {
+    rcHashTableArray_t* arr = atomic_load(&rcht->table);
+    rcHashTableEntry_t* entry;
+    rcHashTableRetired_t* block;
+    uint32_t ii;
+
+    if (arr == NULL) {
+        return UTILS_STATUS_ERROR;
+    }
+
+    /* No reader is left, so every block can be freed */
+    for (ii = 0; ii < arr->size; ii++) {
+        entry = atomic_load_explicit(&arr->slots[ii], memory_order_relaxed);
+        if ((entry != NULL) && (entry != RCHT_TOMBSTONE)) {
+            ADVUTILS_FREE(entry);
+        }
+    }
+    ADVUTILS_FREE(arr);
+    while (rcht->_retired != NULL) {
+        block = rcht->_retired;
+        rcht->_retired = block->next;
+        ADVUTILS_FREE(block);
+    }
+    ADVUTILS_FREE(rcht->_readersMem);
+    rcht->_readersMem = NULL;
+    pthread_mutex_destroy(&rcht->_writeLock);
+    atomic_store(&rcht->table, NULL);
+    rcht->items = 0;
+
+    return UTILS_STATUS_SUCCESS;
+}
+
+static rcHashTableArray_t* rcHashTableNewArray(uint32_t size) {
+    rcHashTableArray_t* arr = ADVUTILS_CALLOC(1, sizeof(rcHashTableArray_t) + (size_t)size * sizeof(arr->slots[0]));
+    ADVUTILS_ASSERT(arr != NULL);
+    if (arr != NULL) {
+        arr->size = size;
+    }
+    return arr;
+}
+
+static rcHashTableEntry_t* rcHashTableFind(rcHashTable_t* rcht, rcHashTableArray_t* arr, char* key, uint32_t keyLen, uint32_t hash, uint32_t* index) {
+    rcHashTableEntry_t* entry;
+    uint32_t ii, probes;
+    uint32_t mask = arr->size - 1;
+
+    /* Linear probing, searches end at the first never used slot */
+    for (ii = hash & mask, probes = 0; probes < arr->size; ii = (ii + 1) & mask, probes++) {
+        entry = atomic_load_explicit(&arr->slots[ii], memory_order_acquire);
+        if (entry == NULL) {
+            break;
+        }
+        if ((entry != RCHT_TOMBSTONE) && (entry->hash == hash) && (entry->keyLen == keyLen)
+            && !memcmp(rcHashTableEntryKey(rcht, entry), key, keyLen)) {
+            if (index != NULL) {
+                *index = ii;
+            }
+            return entry;
+        }
+    }
+
+    return NULL;
+}
+
+static void rcHashTableInsert(rcHashTable_t* rcht, rcHashTableArray_t* arr, rcHashTableEntry_t* entry) {
+    rcHashTableEntry_t* slot;
+    uint32_t mask = arr->size - 1;
+    uint32_t ii = entry->hash & mask;
+
+    /* Caller makes sure that the key is not in the table, so the first free slot can be used */
+    for (;;) {
+        slot = atomic_load_explicit(&arr->slots[ii], memory_order_relaxed);
+        if ((slot == NULL) || (slot == RCHT_TOMBSTONE)) {
+            break;
+        }
+        ii = (ii + 1) & mask;
+    }
+    if (slot == RCHT_TOMBSTONE) {
+        rcht->_tombstones--;
+    }
+
+    /* Release store publishes entry content together with the pointer */
+    atomic_store_explicit(&arr->slots[ii], entry, memory_order_release);
+}
+
+static utilsStatus_t rcHashTableResize(rcHashTable_t* rcht, uint32_t size) {
+    rcHashTableArray_t* arr = atomic_load_explicit(&rcht->table, memory_order_relaxed);
+    rcHashTableArray_t* newArr = rcHashTableNewArray(size);
+    rcHashTableEntry_t* entry;
+    uint32_t ii;
+
+    if (newArr == NULL) {
+        return UTILS_STATUS_ERROR;
+    }
+
+    /* Entries are moved by pointer, readers still using the old array keep finding them there */
+    rcht->_tombstones = 0;
+    for (ii = 0; ii < arr->size; ii++) {
+        entry = atomic_load_explicit(&arr->slots[ii], memory_order_relaxed);
+        if ((entry != NULL) && (entry != RCHT_TOMBSTONE)) {
+            rcHashTableInsert(rcht, newArr, entry);
+        }
+    }
+
+    atomic_store_explicit(&rcht->table, newArr, memory_order_release);
+    rcHashTableRetire(rcht, &arr->_retired);
+
+    return UTILS_STATUS_SUCCESS;
+}
+
+static utilsStatus_t rcHashTableRemove(rcHashTable_t* rcht, char* key, void* value) {
+    rcHashTableArray_t* arr;
+    rcHashTableEntry_t* entry;
+    utilsStatus_t retval = UTILS_STATUS_SUCCESS;
+    uint32_t ii;
+
+    pthread_mutex_lock(&rcht->_writeLock);
+    arr = atomic_load_explicit(&rcht->table, memory_order_relaxed);
+    entry = rcHashTableFind(rcht, arr, key, strlen(key) + 1, RCHT_HASHFUN(key), &ii);
+    if (entry == NULL) {
+        pthread_mutex_unlock(&rcht->_writeLock);
+        return UTILS_STATUS_ERROR;
+    }
+    memcpy(value, rcHashTableEntryValue(entry), rcht->itemSize);
+
+    /* Slot can be emptied only if no probe sequence goes past it, otherwise it is marked as removed */
+    if (atomic_load_explicit(&arr->slots[(ii + 1) & (arr->size - 1)], memory_order_relaxed) == NULL) {
+        atomic_store_explicit(&arr->slots[ii], NULL, memory_order_release);
+    } else {
+        atomic_store_explicit(&arr->slots[ii], RCHT_TOMBSTONE, memory_order_release);
+        rcht->_tombstones++;
+    }
+    rcht->items--;
+    rcHashTableRetire(rcht, &entry->_retired);
+
+    /* If items are below defined quota of current capacity, down-size */
+    if ((rcht->items < (arr->size * RCHT_MIN_SATURATION)) && (arr->size > RCHT_MIN_SIZE)
+        && (rcHashTableResize(rcht, arr->size >> 1) != UTILS_STATUS_SUCCESS)) {
+        retval = UTILS_STATUS_WARNING;
+    }
+
+    rcHashTableSync(rcht);
+    pthread_mutex_unlock(&rcht->_writeLock);
+
+    return retval;
+}
+
+static void rcHashTableRetire(rcHashTable_t* rcht, rcHashTableRetired_t* block) {
+    block->epoch = RCHT_EPOCH_PENDING;
+    block->next = rcht->_retired;
+    rcht->_retired = block;
+}
+
+static void rcHashTableSync(rcHashTable_t* rcht) {
+    rcHashTableRetired_t *block, **prev;
+    uint64_t epoch, readerEpoch, minEpoch = UINT64_MAX;
+    uint32_t ii;
+
+    /* Pairs with the fence in rcHashTableGet: readers announcing an epoch after this point can't reach blocks retired so far */
+    atomic_thread_fence(memory_order_seq_cst);
+    epoch = atomic_fetch_add(&rcht->_epoch, 1) + 1;
+
+    for (ii = 0; ii < rcht->readersNum; ii++) {
+        readerEpoch = atomic_load_explicit(&RCHT_READER(rcht, ii)->epoch, memory_order_acquire);
+        if (readerEpoch && (readerEpoch < minEpoch)) {
+            minEpoch = readerEpoch;
+        }
+    }
+
+    /* A block can be freed once every active reader announced an epoch not older than the one it was retired in */
+    prev = &rcht->_retired;
+    while ((block = *prev) != NULL) {
+        if (block->epoch == RCHT_EPOCH_PENDING) {
+            block->epoch = epoch;
+        }
+        if (block->epoch <= minEpoch) {
+            *prev = block->next;
+            ADVUTILS_FREE(block);
+        } else {
+            prev = &block->next;
+        }
+    }
+}
+#endif /* defined(ADVUTILS_USE_DYNAMIC_ALLOCATION) && defined(ADVUTILS_USE_PTHREADS) */
@@ -0,0 +1,154 @@
+/* BEGIN Header */
+/**
+ ******************************************************************************
+ * \file            RLS.c
+ * \author          Andrea Vivani
+ * \brief           Implementation of recursive least squares estimator with exponential forgetting
+ ******************************************************************************
+ * \copyright
+ *
+ * Copyright 2024 Andrea Vivani
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the “Software”), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ ******************************************************************************
+ */
+/* END Header */
+
+/* Configuration check -------------------------------------------------------*/
+#if !defined(ADVUTILS_USE_DYNAMIC_ALLOCATION) && !defined(ADVUTILS_USE_STATIC_ALLOCATION)
+#error Either ADVUTILS_USE_DYNAMIC_ALLOCATION or ADVUTILS_USE_STATIC_ALLOCATION must be set for ADVUtils to work
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+
+#include "RLS.h"
+#include "ADVUtilsAssert.h"
+
+/* Functions -----------------------------------------------------------------*/
+
+#ifdef ADVUTILS_USE_DYNAMIC_ALLOCATION
+
+utilsStatus_t rlsInit(rls_t* rls, uint8_t n, float lambda, float delta) {
+    ADVUTILS_ASSERT((lambda > 0.0f) && (lambda <= 1.0f));
+    rls->theta.data = NULL;
+    rls->P.data = NULL;
+    rls->_Px.data = NULL;
+
+    if ((matrixInit(&rls->theta, n, 1) == UTILS_STATUS_ERROR) || (matrixInit(&rls->P, n, n) == UTILS_STATUS_ERROR)
+        || (matrixInit(&rls->_Px, n, 1) == UTILS_STATUS_ERROR)) {
+        rlsDelete(rls);
+        return UTILS_STATUS_ERROR;
+    }
+
+    rlsSetLambda(rls, lambda);
+    rlsReset(rls, delta);
+    return UTILS_STATUS_SUCCESS;
+}
+
+#endif /* ADVUTILS_USE_DYNAMIC_ALLOCATION */
+
+#ifdef ADVUTILS_USE_STATIC_ALLOCATION
+
+void rlsInitStatic(rls_t* rls, float* thetaData, float* PData, float* workData, uint8_t n, float lambda, float delta) {
+    ADVUTILS_ASSERT((lambda > 0.0f) && (lambda <= 1.0f));
+    matrixInitStatic(&rls->theta, thetaData, n, 1);
+    matrixInitStatic(&rls->P, PData, n, n);
+    matrixInitStatic(&rls->_Px, workData, n, 1);
+    rlsSetLambda(rls, lambda);
+    rlsReset(rls, delta);
+    return;
+}
+
+#endif /* ADVUTILS_USE_STATIC_ALLOCATION */
+
+void rlsReset(rls_t* rls, float delta) {
+    matrixZeros(&rls->theta);
+    matrixIdentity(&rls->P);
+    matrixMultScalar(&rls->P, delta, &rls->P);
+    return;
+}
+
+float rlsUpdate(rls_t* rls, float* x, float y) {
+    uint8_t n = rls->theta.rows;
+    uint8_t ii, jj;
+    float* Px = rls->_Px.data;
+    float den = rls->lambda;
+    float err = y;
+    float k, tmp;
+
+    /* Px = P * x, den = lambda + x' * P * x, err = y - x' * theta */
+    for (ii = 0; ii < n; ii++) {
+        tmp = 0.0f;
+        for (jj = 0; jj < n; jj++) {
+            tmp += ELEM(rls->P, ii, jj) * x[jj];
+        }
+        Px[ii] = tmp;
+        den += x[ii] * tmp;
+        err -= x[ii] * rls->theta.data[ii];
+    }
+
+    /* Gain is Px / den, skip the update if P has lost positive-definiteness */
+    if (den <= 0.0f) {
+        return err;
+    }
+    k = 1.0f / den;
+
+    /* theta = theta + K * err */
+    tmp = err * k;
+    for (ii = 0; ii < n; ii++) {
+        rls->theta.data[ii] += Px[ii] * tmp;
+    }
+
+    /* Rank-1 update P = (P - Px * Px' / den) / lambda, computed on upper triangle and mirrored to keep P symmetric */
+    for (ii = 0; ii < n; ii++) {
+        tmp = Px[ii] * k;
+        for (jj = ii; jj < n; jj++) {
+            ELEM(rls->P, ii, jj) = (ELEM(rls->P, ii, jj) - tmp * Px[jj]) * rls->_invLambda;
+            ELEM(rls->P, jj, ii) = ELEM(rls->P, ii, jj);
+        }
+    }
+
+    return err;
+}
+
+float rlsPredict(rls_t* rls, float* x) {
+    float result = 0.0f;
+    uint8_t ii;
+    for (ii = 0; ii < rls->theta.rows; ii++) {
+        result += x[ii] * rls->theta.data[ii];
+    }
+    return result;
+}
+
+#ifdef ADVUTILS_USE_DYNAMIC_ALLOCATION
+
+utilsStatus_t rlsDelete(rls_t* rls) {
+    if (rls->theta.data == NULL) {
+        return UTILS_STATUS_ERROR;
+    }
+
+    matrixDelete(&rls->theta);
+    matrixDelete(&rls->P);
+    matrixDelete(&rls->_Px);
+
+    return UTILS_STATUS_SUCCESS;
+}
+
+#endif /* ADVUTILS_USE_DYNAMIC_ALLOCATION */
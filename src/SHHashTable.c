@@ -0,0 +1,316 @@
+/* BEGIN Header */
+/**
+ ******************************************************************************
+ * \file            SHHashTable.c
+ * \author          Andrea Vivani
+ * \brief           Implementation of a lock-striped sharded hash-table, safe to be used concurrently by multiple threads
+ ******************************************************************************
+ * \copyright
+ *
+ * Copyright 2024 Andrea Vivani
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the “Software”), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ ******************************************************************************
+ */
+/* END Header */
+
+/* Configuration check -------------------------------------------------------*/
+#if !defined(ADVUTILS_USE_DYNAMIC_ALLOCATION) && !defined(ADVUTILS_USE_STATIC_ALLOCATION)
+#error Either ADVUTILS_USE_DYNAMIC_ALLOCATION or ADVUTILS_USE_STATIC_ALLOCATION must be set for ADVUtils to work
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+
+#include "SHHashTable.h"
+#include <string.h>
+#include "ADVUtilsAssert.h"
+#include "hashFunctions.h"
+#ifdef ADVUTILS_MEMORY_MGMT_HEADER
+#if !defined(ADVUTILS_MALLOC) || !defined(ADVUTILS_CALLOC) || !defined(ADVUTILS_FREE)
+#error ADVUTILS_MALLOC, ADVUTILS_CALLOC and ADVUTILS_FREE must be defined by the user!
+#else
+#include ADVUTILS_MEMORY_MGMT_HEADER
+#endif /* !defined(ADVUTILS_MALLOC) || !defined(ADVUTILS_CALLOC) || !defined(ADVUTILS_FREE) */
+#else
+#include <stdlib.h>
+#endif /* ADVUTILS_MEMORY_MGMT_HEADER */
+
+#if defined(ADVUTILS_USE_DYNAMIC_ALLOCATION) && defined(ADVUTILS_USE_PTHREADS)
+/* Macros --------------------------------------------------------------------*/
+
+#ifndef ADVUTILS_MEMORY_MGMT_HEADER
+#define ADVUTILS_MALLOC malloc
+#define ADVUTILS_CALLOC calloc
+#define ADVUTILS_FREE   free
+#endif /* ADVUTILS_MEMORY_MGMT_HEADER */
+
+/* Maximum number of hash bits used to select the shard */
+#ifndef SHHT_MAX_SHARD_BITS
+#define SHHT_MAX_SHARD_BITS 16
+#endif /* SHHT_MAX_SHARD_BITS */
+
+/* Cache line size, shards are aligned to it to avoid false sharing between their locks */
+#ifndef SHHT_CACHE_LINE
+#define SHHT_CACHE_LINE 64
+#endif /* SHHT_CACHE_LINE */
+
+/* Hash function used by hash-table for string keys */
+#ifndef SHHT_HASHFUN
+#define SHHT_HASHFUN hash_FNV1A
+#endif /* SHHT_HASHFUN */
+
+/* Hash function used by hash-table for binary keys */
+#ifndef SHHT_BIN_HASHFUN
+#define SHHT_BIN_HASHFUN hash_FNV1A_buf
+#endif /* SHHT_BIN_HASHFUN */
+
+/* Multiplier used to spread all hash bits into the high ones before selecting the shard (2^32 / golden ratio) */
+#define SHHT_SHARD_MULT 0x9E3779B9UL
+
+/* Pointer to shard ii */
+#define SHHT_SHARD(shht, ii) ((shHashTableShard_t*)((shht)->shards + (size_t)(ii) * (shht)->_shardStride))
+
+/* Function prototypes -------------------------------------------------------*/
+
+static utilsStatus_t shHashTablePutKey(shHashTable_t* shht, const void* key, size_t keyLen, uint32_t hash, void* value);
+static utilsStatus_t shHashTableGetKey(shHashTable_t* shht, const void* key, size_t keyLen, uint32_t hash, void* value, shHashTableRemoval_t remove);
+
+/* Private Functions ---------------------------------------------------------*/
+
+static inline shHashTableShard_t* shHashTableShard(shHashTable_t* shht, uint32_t hash) {
+    /* 
+     * High bits select the shard, so that they are independent from the low bits used to select the slot inside it. Hash is 
+     * scrambled first (Fibonacci hashing), since high bits of string hashes like FNV-1a change little between similar keys
+     */
+    return shht->_shardBits ? SHHT_SHARD(shht, (uint32_t)(hash * SHHT_SHARD_MULT) >> (32 - shht->_shardBits)) : SHHT_SHARD(shht, 0);
+}
+
+/* Functions -----------------------------------------------------------------*/
+
+utilsStatus_t shHashTableInit(shHashTable_t* shht, size_t itemSize, uint32_t init_items, uint8_t shardBits) {
+    uint32_t ii, shardItems;
+    shHashTableShard_t* shard;
+
+    shht->shards = NULL;
+    shht->_mem = NULL;
+    shht->shardCount = 0;
+
+    if (shardBits > SHHT_MAX_SHARD_BITS) {
+        return UTILS_STATUS_ERROR;
+    }
+
+    shht->itemSize = itemSize;
+    shht->_shardBits = shardBits;
+    shht->_shardStride = (sizeof(shHashTableShard_t) + SHHT_CACHE_LINE - 1) & ~((size_t)SHHT_CACHE_LINE - 1);
+
+    /* Allocate one more cache line so that the first shard can be aligned to it */
+    shht->_mem = ADVUTILS_MALLOC(((size_t)1 << shardBits) * shht->_shardStride + SHHT_CACHE_LINE);
+    ADVUTILS_ASSERT(shht->_mem != NULL);
+    if (shht->_mem == NULL) {
+        return UTILS_STATUS_ERROR;
+    }
+    shht->shards = (uint8_t*)(((uintptr_t)shht->_mem + SHHT_CACHE_LINE - 1) & ~((uintptr_t)SHHT_CACHE_LINE - 1));
+
+    /* Linear-probing shards need a power of 2 size */
+    shardItems = 1;
+    while (((uint64_t)shardItems << shardBits) < init_items) {
+        shardItems <<= 1;
+    }
+    for (ii = 0; ii < ((uint32_t)1 << shardBits); ii++) {
+        shard = SHHT_SHARD(shht, ii);
+        if (lpHashTableInit(&shard->lpht, itemSize, shardItems, LPHT_RESIZABLE) != UTILS_STATUS_SUCCESS) {
+            break;
+        }
+        if (pthread_rwlock_init(&shard->lock, NULL)) {
+            lpHashTableDelete(&shard->lpht);
+            break;
+        }
+        shht->shardCount++;
+    }
+
+    /* Free shards initialized so far on failure */
+    if (shht->shardCount != ((uint32_t)1 << shardBits)) {
+        shHashTableDelete(shht);
+        return UTILS_STATUS_ERROR;
+    }
+
+    return UTILS_STATUS_SUCCESS;
+}
+
+utilsStatus_t shHashTablePut(shHashTable_t* shht, char* key, void* value) {
+    if ((value == NULL) || (key == NULL)) {
+        return UTILS_STATUS_ERROR;
+    }
+
+    return shHashTablePutKey(shht, key, strlen(key) + 1, SHHT_HASHFUN(key), value);
+}
+
+utilsStatus_t shHashTableGet(shHashTable_t* shht, char* key, void* value, shHashTableRemoval_t remove) {
+    if ((value == NULL) || (key == NULL)) {
+        return UTILS_STATUS_ERROR;
+    }
+
+    return shHashTableGetKey(shht, key, strlen(key) + 1, SHHT_HASHFUN(key), value, remove);
+}
+
+utilsStatus_t shHashTableUpdate(shHashTable_t* shht, char* key, shHashTableUpdateFun_t fun, void* ctx) {
+    utilsStatus_t retval;
+    shHashTableShard_t* shard;
+    void* ref;
+    uint8_t inserted;
+    uint32_t hash;
+
+    if ((fun == NULL) || (key == NULL)) {
+        return UTILS_STATUS_ERROR;
+    }
+
+    hash = SHHT_HASHFUN(key);
+    shard = shHashTableShard(shht, hash);
+    if (pthread_rwlock_wrlock(&shard->lock)) {
+        return UTILS_STATUS_ERROR;
+    }
+
+    /* Reference is only valid while the lock is held, so callback is run inside the critical section */
+    retval = lpHashTableGetOrInsertHashed(&shard->lpht, key, strlen(key) + 1, hash, &ref, &inserted);
+    if (retval == UTILS_STATUS_SUCCESS) {
+        fun(ref, inserted, ctx);
+    }
+
+    pthread_rwlock_unlock(&shard->lock);
+
+    return retval;
+}
+
+utilsStatus_t shHashTablePutBin(shHashTable_t* shht, const void* key, size_t keyLen, void* value) {
+    if ((value == NULL) || (key == NULL) || !keyLen) {
+        return UTILS_STATUS_ERROR;
+    }
+
+    return shHashTablePutKey(shht, key, keyLen, SHHT_BIN_HASHFUN(key, keyLen), value);
+}
+
+utilsStatus_t shHashTableGetBin(shHashTable_t* shht, const void* key, size_t keyLen, void* value, shHashTableRemoval_t remove) {
+    if ((value == NULL) || (key == NULL) || !keyLen) {
+        return UTILS_STATUS_ERROR;
+    }
+
+    return shHashTableGetKey(shht, key, keyLen, SHHT_BIN_HASHFUN(key, keyLen), value, remove);
+}
+
+utilsStatus_t shHashTablePutU64(shHashTable_t* shht, uint64_t key, void* value) {
+    if (value == NULL) {
+        return UTILS_STATUS_ERROR;
+    }
+
+    return shHashTablePutKey(shht, &key, sizeof(key), hash_mix64(key), value);
+}
+
+utilsStatus_t shHashTableGetU64(shHashTable_t* shht, uint64_t key, void* value, shHashTableRemoval_t remove) {
+    if (value == NULL) {
+        return UTILS_STATUS_ERROR;
+    }
+
+    return shHashTableGetKey(shht, &key, sizeof(key), hash_mix64(key), value, remove);
+}
+
+void shHashTableInfo(shHashTable_t* shht, uint32_t* size, uint32_t* items) {
+    uint32_t ii, shardSize, shardItems;
+    shHashTableShard_t* shard;
+
+    *size = 0;
+    *items = 0;
+    for (ii = 0; ii < shht->shardCount; ii++) {
+        shard = SHHT_SHARD(shht, ii);
+        pthread_rwlock_rdlock(&shard->lock);
+        lpHashTableInfo(&shard->lpht, &shardSize, &shardItems);
+        pthread_rwlock_unlock(&shard->lock);
+        *size += shardSize;
+        *items += shardItems;
+    }
+}
+
+utilsStatus_t shHashTableFlush(shHashTable_t* shht) {
+    uint32_t ii;
+    shHashTableShard_t* shard;
+    utilsStatus_t retval = UTILS_STATUS_EMPTY;
+
+    for (ii = 0; ii < shht->shardCount; ii++) {
+        shard = SHHT_SHARD(shht, ii);
+        pthread_rwlock_wrlock(&shard->lock);
+        if (lpHashTableFlush(&shard->lpht) == UTILS_STATUS_SUCCESS) {
+            retval = UTILS_STATUS_SUCCESS;
+        }
+        pthread_rwlock_unlock(&shard->lock);
+    }
+
+    return retval;
+}
+
+utilsStatus_t shHashTableDelete(shHashTable_t* shht) {
+    uint32_t ii;
+    shHashTableShard_t* shard;
+
+    if (shht->_mem == NULL) {
+        return UTILS_STATUS_ERROR;
+    }
+
+    for (ii = 0; ii < shht->shardCount; ii++) {
+        shard = SHHT_SHARD(shht, ii);
+        lpHashTableDelete(&shard->lpht);
+        pthread_rwlock_destroy(&shard->lock);
+    }
+
+    ADVUTILS_FREE(shht->_mem);
+    shht->_mem = NULL;
+    shht->shards = NULL;
+    shht->shardCount = 0;
+
+    return UTILS_STATUS_SUCCESS;
+}
+
+static utilsStatus_t shHashTablePutKey(shHashTable_t* shht, const void* key, size_t keyLen, uint32_t hash, void* value) {
+    utilsStatus_t retval;
+    shHashTableShard_t* shard = shHashTableShard(shht, hash);
+
+    if (pthread_rwlock_wrlock(&shard->lock)) {
+        return UTILS_STATUS_ERROR;
+    }
+    retval = lpHashTablePutHashed(&shard->lpht, key, keyLen, hash, value);
+    pthread_rwlock_unlock(&shard->lock);
+
+    return retval;
+}
+
+static utilsStatus_t shHashTableGetKey(shHashTable_t* shht, const void* key, size_t keyLen, uint32_t hash, void* value, shHashTableRemoval_t remove) {
+    utilsStatus_t retval;
+    shHashTableShard_t* shard = shHashTableShard(shht, hash);
+
+    /* Shards are not incrementally resized, so a lookup without removal doesn't modify them and a read lock is enough */
+    if ((remove == SHHT_DO_NOT_REMOVE_ITEM) ? pthread_rwlock_rdlock(&shard->lock) : pthread_rwlock_wrlock(&shard->lock)) {
+        return UTILS_STATUS_ERROR;
+    }
+    retval = lpHashTableGetHashed(&shard->lpht, key, keyLen, hash, value,
+                                  (remove == SHHT_DO_NOT_REMOVE_ITEM) ? LPHT_DO_NOT_REMOVE_ITEM : LPHT_REMOVE_ITEM);
+    pthread_rwlock_unlock(&shard->lock);
+
+    /* An empty shard doesn't mean that the whole hash-table is empty */
+    return (retval == UTILS_STATUS_EMPTY) ? UTILS_STATUS_ERROR : retval;
+}
+#endif /* defined(ADVUTILS_USE_DYNAMIC_ALLOCATION) && defined(ADVUTILS_USE_PTHREADS) */
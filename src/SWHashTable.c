@@ -0,0 +1,413 @@
+/* BEGIN Header */
+/**
+ ******************************************************************************
+ * \file            SWHashTable.c
+ * \author          Andrea Vivani
+ * \brief           Implementation of an open-addressing hash-table with SIMD group probing
+ ******************************************************************************
+ * \copyright
+ *
+ * Copyright 2024 Andrea Vivani
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the “Software”), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ ******************************************************************************
+ */
+/* END Header */
+
+/* Configuration check -------------------------------------------------------*/
+#if !defined(ADVUTILS_USE_DYNAMIC_ALLOCATION) && !defined(ADVUTILS_USE_STATIC_ALLOCATION)
+#error Either ADVUTILS_USE_DYNAMIC_ALLOCATION or ADVUTILS_USE_STATIC_ALLOCATION must be set for ADVUtils to work
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+
+#include "SWHashTable.h"
+#include <string.h>
+#include "ADVUtilsAssert.h"
+#include "hashFunctions.h"
+#ifdef ADVUTILS_MEMORY_MGMT_HEADER
+#if !defined(ADVUTILS_MALLOC) || !defined(ADVUTILS_CALLOC) || !defined(ADVUTILS_FREE)
+#error ADVUTILS_MALLOC, ADVUTILS_CALLOC and ADVUTILS_FREE must be defined by the user!
+#else
+#include ADVUTILS_MEMORY_MGMT_HEADER
+#endif /* !defined(ADVUTILS_MALLOC) || !defined(ADVUTILS_CALLOC) || !defined(ADVUTILS_FREE) */
+#else
+#include <stdlib.h>
+#endif /* ADVUTILS_MEMORY_MGMT_HEADER */
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define SWHT_USE_SSE2
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#define SWHT_USE_NEON
+#endif
+
+/* Macros --------------------------------------------------------------------*/
+
+#ifndef ADVUTILS_MEMORY_MGMT_HEADER
+#define ADVUTILS_MALLOC malloc
+#define ADVUTILS_CALLOC calloc
+#define ADVUTILS_FREE   free
+#endif /* ADVUTILS_MEMORY_MGMT_HEADER */
+
+/* Number of slots probed together */
+#define SWHT_GROUP_SIZE     16
+
+/* Control byte values of empty and deleted slots, full slots store the 7 lowest bits of the hash */
+#define SWHT_CTRL_EMPTY     ((int8_t)-128)
+#define SWHT_CTRL_DELETED   ((int8_t)-2)
+
+/* Minimum size of hash-table when resizing, must be a power of 2 not smaller than SWHT_GROUP_SIZE */
+#ifndef SWHT_MIN_SIZE
+#define SWHT_MIN_SIZE 16
+#endif /* SWHT_MIN_SIZE */
+
+/* Maximum size of hash-table when resizing, must be a power of 2 */
+#ifndef SWHT_MAX_SIZE
+#define SWHT_MAX_SIZE 0x80000000UL
+#endif /* SWHT_MAX_SIZE */
+
+/* Minimum saturation of hash-table, that triggers a down-sizing */
+#ifndef SWHT_MIN_SATURATION
+#define SWHT_MIN_SATURATION 0.2
+#endif /* SWHT_MIN_SATURATION */
+
+/* Maximum saturation of hash-table (deleted slots included), that triggers an up-sizing */
+#ifndef SWHT_MAX_SATURATION
+#define SWHT_MAX_SATURATION 0.875
+#endif /* SWHT_MAX_SATURATION */
+
+/* Hash function used by hash-table */
+#ifndef SWHT_HASHFUN
+#define SWHT_HASHFUN hash_FNV1A
+#endif /* SWHT_HASHFUN */
+
+/* Pointer to slot ii */
+#define SWHT_SLOT(swht, ii) ((swHashTableEntry_t*)((swht)->entries + (size_t)(ii) * (swht)->_slotSize))
+
+/* Function prototypes -------------------------------------------------------*/
+
+static int32_t swHashTableFind(swHashTable_t* swht, char* key, uint32_t hash);
+static int32_t swHashTableFindFree(swHashTable_t* swht, uint32_t hash);
+static utilsStatus_t swHashTableRehash(swHashTable_t* swht, uint32_t newSize);
+
+/* Private Functions ---------------------------------------------------------*/
+
+/* Bitmask of the slots in group whose control byte is equal to ctrl */
+static inline uint32_t swHashTableGroupMatch(const int8_t* group, int8_t ctrl) {
+#if defined(SWHT_USE_SSE2)
+    __m128i data = _mm_loadu_si128((const __m128i*)group);
+    return (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(ctrl), data));
+#elif defined(SWHT_USE_NEON)
+    static const uint8_t bits[SWHT_GROUP_SIZE] = {1, 2, 4, 8, 16, 32, 64, 128, 1, 2, 4, 8, 16, 32, 64, 128};
+    uint8x16_t eq = vandq_u8(vceqq_s8(vld1q_s8(group), vdupq_n_s8(ctrl)), vld1q_u8(bits));
+    return (uint32_t)vaddv_u8(vget_low_u8(eq)) | ((uint32_t)vaddv_u8(vget_high_u8(eq)) << 8);
+#else
+    uint32_t mask = 0;
+    uint8_t ii;
+    for (ii = 0; ii < SWHT_GROUP_SIZE; ii++) {
+        mask |= (uint32_t)(group[ii] == ctrl) << ii;
+    }
+    return mask;
+#endif
+}
+
+/* Bitmask of the slots in group that are empty or deleted */
+static inline uint32_t swHashTableGroupMatchFree(const int8_t* group) {
+#if defined(SWHT_USE_SSE2)
+    return (uint32_t)_mm_movemask_epi8(_mm_loadu_si128((const __m128i*)group));
+#elif defined(SWHT_USE_NEON)
+    static const uint8_t bits[SWHT_GROUP_SIZE] = {1, 2, 4, 8, 16, 32, 64, 128, 1, 2, 4, 8, 16, 32, 64, 128};
+    uint8x16_t neg = vandq_u8(vcltzq_s8(vld1q_s8(group)), vld1q_u8(bits));
+    return (uint32_t)vaddv_u8(vget_low_u8(neg)) | ((uint32_t)vaddv_u8(vget_high_u8(neg)) << 8);
+#else
+    uint32_t mask = 0;
+    uint8_t ii;
+    for (ii = 0; ii < SWHT_GROUP_SIZE; ii++) {
+        mask |= (uint32_t)(group[ii] < 0) << ii;
+    }
+    return mask;
+#endif
+}
+
+/* Index of lowest set bit, mask must not be 0 */
+static inline uint8_t swHashTableLowestBit(uint32_t mask) {
+#if defined(__GNUC__)
+    return (uint8_t)__builtin_ctz(mask);
+#else
+    uint8_t ii = 0;
+    while (!(mask & 1)) {
+        mask >>= 1;
+        ii++;
+    }
+    return ii;
+#endif
+}
+
+static inline char* swHashTableStrdup(const char* s) {
+    size_t bufsize = strlen(s) + 1;
+    char* retval = ADVUTILS_MALLOC(bufsize);
+    ADVUTILS_ASSERT(retval != NULL);
+    if (retval) {
+        memcpy(retval, s, bufsize);
+    }
+    return retval;
+}
+
+static inline void* swHashTableEntryValue(swHashTableEntry_t* entry) { return (uint8_t*)entry + ((sizeof(swHashTableEntry_t) + 7) & ~((size_t)7)); }
+
+/* Functions -----------------------------------------------------------------*/
+
+#ifdef ADVUTILS_USE_DYNAMIC_ALLOCATION
+
+utilsStatus_t swHashTableInit(swHashTable_t* swht, size_t itemSize, uint32_t init_items, swHashTableResizable_t resizable) {
+    uint32_t size = SWHT_GROUP_SIZE;
+
+    while ((size < init_items) && (size < SWHT_MAX_SIZE)) {
+        size <<= 1;
+    }
+
+    swht->items = 0;
+    swht->_deleted = 0;
+    swht->itemSize = itemSize;
+    swht->resizable = resizable;
+    swht->_slotSize = ((sizeof(swHashTableEntry_t) + 7) & ~((size_t)7)) + ((itemSize + 7) & ~((size_t)7));
+    swht->size = 0;
+    swht->ctrl = NULL;
+
+    return swHashTableRehash(swht, size);
+}
+
+utilsStatus_t swHashTablePut(swHashTable_t* swht, char* key, void* value) {
+    if ((value == NULL) || (key == NULL)) {
+        return UTILS_STATUS_ERROR;
+    }
+
+    uint32_t hash = SWHT_HASHFUN(key);
+    int32_t idx = swHashTableFind(swht, key, hash);
+
+    /* Update the entry if it exists already */
+    if (idx >= 0) {
+        memcpy(swHashTableEntryValue(SWHT_SLOT(swht, idx)), value, swht->itemSize);
+        return UTILS_STATUS_SUCCESS;
+    }
+
+    /* If used slots (deleted ones included) will exceed defined quota of current capacity, rehash. Size is doubled unless most of them are deleted */
+    if (((swht->items + swht->_deleted + 1) > (swht->size * SWHT_MAX_SATURATION)) && (swht->resizable == SWHT_RESIZABLE)) {
+        uint32_t newSize = swht->size;
+        if (((swht->items + 1) > (swht->size * SWHT_MAX_SATURATION * 0.5)) && (swht->size < SWHT_MAX_SIZE)) {
+            newSize <<= 1;
+        }
+        if (((newSize != swht->size) || swht->_deleted) && (swHashTableRehash(swht, newSize) == UTILS_STATUS_ERROR)) {
+            return UTILS_STATUS_ERROR;
+        }
+    }
+
+    idx = swHashTableFindFree(swht, hash);
+
+    /* If table is full, return */
+    if (idx < 0) {
+        return UTILS_STATUS_FULL;
+    }
+
+    swHashTableEntry_t* entry = SWHT_SLOT(swht, idx);
+    entry->key = swHashTableStrdup(key);
+    if (entry->key == NULL) {
+        return UTILS_STATUS_ERROR;
+    }
+    entry->hash = hash;
+    memcpy(swHashTableEntryValue(entry), value, swht->itemSize);
+
+    if (swht->ctrl[idx] == SWHT_CTRL_DELETED) {
+        swht->_deleted--;
+    }
+    swht->ctrl[idx] = (int8_t)(hash & 0x7F);
+    swht->items++;
+
+    return UTILS_STATUS_SUCCESS;
+}
+
+utilsStatus_t swHashTableGet(swHashTable_t* swht, char* key, void* value, swHashTableRemoval_t remove) {
+
+    if (!swht->items) {
+        return UTILS_STATUS_EMPTY;
+    }
+
+    int32_t idx = swHashTableFind(swht, key, SWHT_HASHFUN(key));
+
+    if (idx < 0) {
+        return UTILS_STATUS_ERROR;
+    }
+
+    swHashTableEntry_t* entry = SWHT_SLOT(swht, idx);
+    memcpy(value, swHashTableEntryValue(entry), swht->itemSize);
+
+    if (remove == SWHT_REMOVE_ITEM) {
+        ADVUTILS_FREE(entry->key);
+        entry->key = NULL;
+
+        /* Probing stops at groups with an empty slot, so slot can be marked as empty if its group already has one */
+        if (swHashTableGroupMatch(&swht->ctrl[idx & ~(SWHT_GROUP_SIZE - 1)], SWHT_CTRL_EMPTY)) {
+            swht->ctrl[idx] = SWHT_CTRL_EMPTY;
+        } else {
+            swht->ctrl[idx] = SWHT_CTRL_DELETED;
+            swht->_deleted++;
+        }
+
+        if ((--swht->items <= (swht->size * SWHT_MIN_SATURATION)) && (swht->resizable == SWHT_RESIZABLE) && (swht->size > SWHT_MIN_SIZE)) {
+            if (swHashTableRehash(swht, swht->size >> 1) == UTILS_STATUS_ERROR) {
+                return UTILS_STATUS_WARNING;
+            }
+        }
+    }
+
+    return UTILS_STATUS_SUCCESS;
+}
+
+utilsStatus_t swHashTableFlush(swHashTable_t* swht) {
+    uint32_t ii;
+
+    if (!swht->items) {
+        return UTILS_STATUS_EMPTY;
+    }
+
+    for (ii = 0; ii < swht->size; ii++) {
+        if (swht->ctrl[ii] >= 0) {
+            ADVUTILS_FREE(SWHT_SLOT(swht, ii)->key);
+            SWHT_SLOT(swht, ii)->key = NULL;
+        }
+    }
+    memset(swht->ctrl, SWHT_CTRL_EMPTY, swht->size);
+
+    swht->items = 0;
+    swht->_deleted = 0;
+
+    return UTILS_STATUS_SUCCESS;
+}
+
+utilsStatus_t swHashTableDelete(swHashTable_t* swht) {
+
+    if (swht->ctrl == NULL) {
+        return UTILS_STATUS_ERROR;
+    }
+
+    swHashTableFlush(swht);
+
+    ADVUTILS_FREE(swht->ctrl);
+    swht->ctrl = NULL;
+    swht->entries = NULL;
+
+    return UTILS_STATUS_SUCCESS;
+}
+
+void swHashTableIt(swHashTableIterator_t* it, swHashTable_t* swht) {
+    it->_swht = swht;
+    it->_index = 0;
+    it->key = NULL;
+    it->value = NULL;
+}
+
+utilsStatus_t swHashTableItNext(swHashTableIterator_t* it) {
+    swHashTable_t* swht = it->_swht;
+
+    while (it->_index < swht->size) {
+        uint32_t ii = it->_index++;
+        if (swht->ctrl[ii] >= 0) {
+            it->key = SWHT_SLOT(swht, ii)->key;
+            it->value = swHashTableEntryValue(SWHT_SLOT(swht, ii));
+            return UTILS_STATUS_SUCCESS;
+        }
+    }
+    return UTILS_STATUS_ERROR;
+}
+
+static int32_t swHashTableFind(swHashTable_t* swht, char* key, uint32_t hash) {
+    uint32_t groupMask = (swht->size / SWHT_GROUP_SIZE) - 1;
+    uint32_t group = (hash >> 7) & groupMask;
+    uint32_t probe, mask, idx;
+
+    /* Triangular probing over groups visits each group once */
+    for (probe = 0; probe <= groupMask; probe++) {
+        int8_t* ctrl = &swht->ctrl[group * SWHT_GROUP_SIZE];
+        mask = swHashTableGroupMatch(ctrl, (int8_t)(hash & 0x7F));
+        while (mask) {
+            idx = group * SWHT_GROUP_SIZE + swHashTableLowestBit(mask);
+            if ((SWHT_SLOT(swht, idx)->hash == hash) && !strcmp(key, SWHT_SLOT(swht, idx)->key)) {
+                return (int32_t)idx;
+            }
+            mask &= mask - 1;
+        }
+        if (swHashTableGroupMatch(ctrl, SWHT_CTRL_EMPTY)) {
+            return -1;
+        }
+        group = (group + probe + 1) & groupMask;
+    }
+    return -1;
+}
+
+static int32_t swHashTableFindFree(swHashTable_t* swht, uint32_t hash) {
+    uint32_t groupMask = (swht->size / SWHT_GROUP_SIZE) - 1;
+    uint32_t group = (hash >> 7) & groupMask;
+    uint32_t probe, mask;
+
+    for (probe = 0; probe <= groupMask; probe++) {
+        mask = swHashTableGroupMatchFree(&swht->ctrl[group * SWHT_GROUP_SIZE]);
+        if (mask) {
+            return (int32_t)(group * SWHT_GROUP_SIZE + swHashTableLowestBit(mask));
+        }
+        group = (group + probe + 1) & groupMask;
+    }
+    return -1;
+}
+
+static utilsStatus_t swHashTableRehash(swHashTable_t* swht, uint32_t newSize) {
+    int8_t* old_ctrl = swht->ctrl;
+    uint8_t* old_entries = swht->entries;
+    uint32_t old_size = swht->size;
+    uint32_t ii;
+
+    /* Control bytes and slots share a single allocation, slots start right after control bytes */
+    int8_t* ctrl = ADVUTILS_CALLOC(newSize, 1 + swht->_slotSize);
+    ADVUTILS_ASSERT(ctrl != NULL);
+    if (ctrl == NULL) {
+        return UTILS_STATUS_ERROR;
+    }
+    memset(ctrl, SWHT_CTRL_EMPTY, newSize);
+
+    swht->ctrl = ctrl;
+    swht->entries = (uint8_t*)ctrl + newSize;
+    swht->size = newSize;
+    swht->_deleted = 0;
+
+    for (ii = 0; ii < old_size; ii++) {
+        if (old_ctrl[ii] >= 0) {
+            swHashTableEntry_t* entry = (swHashTableEntry_t*)(old_entries + (size_t)ii * swht->_slotSize);
+            int32_t idx = swHashTableFindFree(swht, entry->hash);
+            memcpy(SWHT_SLOT(swht, idx), entry, swht->_slotSize);
+            swht->ctrl[idx] = old_ctrl[ii];
+        }
+    }
+
+    ADVUTILS_FREE(old_ctrl);
+
+    return UTILS_STATUS_SUCCESS;
+}
+
+#endif /* ADVUTILS_USE_DYNAMIC_ALLOCATION */
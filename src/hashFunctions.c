@@ -36,6 +36,7 @@
 #include "hashFunctions.h"
 #include "ADVUtilsAssert.h"
 #include "stddef.h"
+#include <string.h>
 
 /* Functions -----------------------------------------------------------------*/
 
@@ -100,3 +101,208 @@ uint32_t hash_sdbm(char* key) {
 
     return hash;
 }
+
+/* 
+ * Same as hash_FNV1A, but for keys of given length that can contain any byte
+ */
+uint32_t hash_FNV1A_buf(const void* key, size_t len) {
+
+    uint64_t hash = FNV_OFFSET;
+    const uint8_t* p = (const uint8_t*)key;
+
+    ADVUTILS_ASSERT(key != NULL);
+
+    while (len--) {
+        hash ^= (uint64_t)*p++;
+        hash *= FNV_PRIME;
+    }
+
+    /* limit to 32 bit */
+
+    hash &= UINT32_MAX;
+
+    return (uint32_t)hash;
+}
+
+/* 
+ * Same as hash_FNV1A_buf, without limiting the hash to 32 bit. Used where 32 bit are not enough to tell keys apart, e.g. minimal perfect hashing
+ */
+uint64_t hash_FNV1A64_buf(const void* key, size_t len) {
+
+    uint64_t hash = FNV_OFFSET;
+    const uint8_t* p = (const uint8_t*)key;
+
+    ADVUTILS_ASSERT(key != NULL);
+
+    while (len--) {
+        hash ^= (uint64_t)*p++;
+        hash *= FNV_PRIME;
+    }
+
+    return hash;
+}
+
+/*
+ * Hash-tables use the lowest bits of the hash as index, so a plain Fibonacci multiplication (whose good bits are the highest ones) 
+ * is not enough: the MurmurHash3 finalizer spreads every input bit to every output bit with a couple of multiply-xorshift rounds.
+ */
+uint32_t hash_mix32(uint32_t key) {
+    key ^= key >> 16;
+    key *= 0x85EBCA6BUL;
+    key ^= key >> 13;
+    key *= 0xC2B2AE35UL;
+    key ^= key >> 16;
+
+    return key;
+}
+
+uint32_t hash_mix64(uint64_t key) {
+    key ^= key >> 33;
+    key *= 0xFF51AFD7ED558CCDULL;
+    key ^= key >> 33;
+    key *= 0xC4CEB9FE1A85EC53ULL;
+    key ^= key >> 33;
+
+    return (uint32_t)(key ^ (key >> 32));
+}
+
+/*
+ * Unaligned little-endian reads, compilers turn the memcpy into a single load. On big-endian targets the hashes below differ from
+ * the reference ones, but are still well distributed
+ */
+static inline uint32_t hash_read32(const uint8_t* p) {
+    uint32_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+static inline uint64_t hash_read64(const uint8_t* p) {
+    uint64_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+static inline uint32_t hash_rotl32(uint32_t x, uint8_t r) { return (x << r) | (x >> (32 - r)); }
+
+/*
+ * MurmurHash3_x86_32 by Austin Appleby (public domain), with seed 0. Consumes 4 bytes per step using 32-bit multiplications only,
+ * so it is the fast choice on 32-bit micro-controllers
+ */
+uint32_t hash_murmur3_buf(const void* key, size_t len) {
+    const uint8_t* p = (const uint8_t*)key;
+    uint32_t hash = 0;
+    uint32_t k = 0;
+    size_t ii;
+
+    ADVUTILS_ASSERT(key != NULL);
+
+    for (ii = len >> 2; ii; ii--, p += 4) {
+        k = hash_read32(p) * 0xCC9E2D51UL;
+        hash ^= hash_rotl32(k, 15) * 0x1B873593UL;
+        hash = hash_rotl32(hash, 13) * 5 + 0xE6546B64UL;
+    }
+
+    k = 0;
+    switch (len & 3) {
+        case 3: k ^= (uint32_t)p[2] << 16; /* fall through */
+        case 2: k ^= (uint32_t)p[1] << 8;  /* fall through */
+        case 1:
+            k ^= p[0];
+            k *= 0xCC9E2D51UL;
+            hash ^= hash_rotl32(k, 15) * 0x1B873593UL;
+            break;
+        default: break;
+    }
+
+    return hash_mix32(hash ^ (uint32_t)len);
+}
+
+uint32_t hash_murmur3(char* key) {
+    ADVUTILS_ASSERT(key != NULL);
+
+    return hash_murmur3_buf(key, strlen(key));
+}
+
+/* 64x64 -> 128 bit multiplication, low half is returned in a and high half in b */
+static inline void hash_wymum(uint64_t* a, uint64_t* b) {
+#ifdef __SIZEOF_INT128__
+    __uint128_t r = (__uint128_t)*a * *b;
+    *a = (uint64_t)r;
+    *b = (uint64_t)(r >> 64);
+#else
+    uint64_t ha = *a >> 32, hb = *b >> 32, la = (uint32_t)*a, lb = (uint32_t)*b;
+    uint64_t rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb;
+    uint64_t t = rl + (rm0 << 32), c = t < rl;
+    uint64_t lo = t + (rm1 << 32);
+    c += lo < t;
+    *a = lo;
+    *b = rh + (rm0 >> 32) + (rm1 >> 32) + c;
+#endif /* __SIZEOF_INT128__ */
+}
+
+static inline uint64_t hash_wymix(uint64_t a, uint64_t b) {
+    hash_wymum(&a, &b);
+    return a ^ b;
+}
+
+/*
+ * wyhash (final version 3) by Wang Yi (public domain), with seed 0 and default secret. Consumes 48 bytes per step on long keys, and
+ * keys up to 16 bytes are read with at most four overlapping loads, without any loop
+ */
+uint64_t hash_wy64_buf(const void* key, size_t len) {
+    static const uint64_t secret[4] = {0xA0761D6478BD642FULL, 0xE7037ED1A0B428DBULL, 0x8EBC6AF09C88C6E3ULL, 0x589965CC75374CC3ULL};
+    const uint8_t* p = (const uint8_t*)key;
+    uint64_t seed = secret[0];
+    uint64_t a, b;
+    size_t ii = len;
+
+    ADVUTILS_ASSERT(key != NULL);
+
+    if (len <= 16) {
+        if (len >= 4) {
+            a = ((uint64_t)hash_read32(p) << 32) | hash_read32(p + ((len >> 3) << 2));
+            b = ((uint64_t)hash_read32(p + len - 4) << 32) | hash_read32(p + len - 4 - ((len >> 3) << 2));
+        } else if (len > 0) {
+            a = ((uint64_t)p[0] << 16) | ((uint64_t)p[len >> 1] << 8) | p[len - 1];
+            b = 0;
+        } else {
+            a = b = 0;
+        }
+    } else {
+        if (ii > 48) {
+            uint64_t see1 = seed, see2 = seed;
+            do {
+                seed = hash_wymix(hash_read64(p) ^ secret[1], hash_read64(p + 8) ^ seed);
+                see1 = hash_wymix(hash_read64(p + 16) ^ secret[2], hash_read64(p + 24) ^ see1);
+                see2 = hash_wymix(hash_read64(p + 32) ^ secret[3], hash_read64(p + 40) ^ see2);
+                p += 48;
+                ii -= 48;
+            } while (ii > 48);
+            seed ^= see1 ^ see2;
+        }
+        while (ii > 16) {
+            seed = hash_wymix(hash_read64(p) ^ secret[1], hash_read64(p + 8) ^ seed);
+            p += 16;
+            ii -= 16;
+        }
+        a = hash_read64(p + ii - 16);
+        b = hash_read64(p + ii - 8);
+    }
+
+    return hash_wymix(secret[1] ^ len, hash_wymix(a ^ secret[1], b ^ seed));
+}
+
+/*
+ * Same as hash_wy64_buf, folded to 32 bit
+ */
+uint32_t hash_wy_buf(const void* key, size_t len) {
+    uint64_t hash = hash_wy64_buf(key, len);
+
+    return (uint32_t)(hash ^ (hash >> 32));
+}
+
+uint32_t hash_wy(char* key) {
+    ADVUTILS_ASSERT(key != NULL);
+
+    return hash_wy_buf(key, strlen(key));
+}
@@ -79,8 +79,15 @@ utilsStatus_t listPush(list_t* list, void* value) {
     listNode_t* ptr;
     ptr = ADVUTILS_MALLOC(sizeof(listNode_t));
     ADVUTILS_ASSERT(ptr != NULL);
+    if (ptr == NULL) {
+        return UTILS_STATUS_ERROR;
+    }
     ptr->data = ADVUTILS_CALLOC(1, list->itemSize);
     ADVUTILS_ASSERT(ptr->data != NULL);
+    if (ptr->data == NULL) {
+        ADVUTILS_FREE(ptr);
+        return UTILS_STATUS_ERROR;
+    }
     memcpy(ptr->data, value, list->itemSize);
     ptr->next = NULL;
 
@@ -102,8 +109,15 @@ utilsStatus_t listPushFront(list_t* list, void* value) {
     listNode_t* ptr;
     ptr = ADVUTILS_MALLOC(sizeof(listNode_t));
     ADVUTILS_ASSERT(ptr != NULL);
+    if (ptr == NULL) {
+        return UTILS_STATUS_ERROR;
+    }
     ptr->data = ADVUTILS_CALLOC(1, list->itemSize);
     ADVUTILS_ASSERT(ptr->data != NULL);
+    if (ptr->data == NULL) {
+        ADVUTILS_FREE(ptr);
+        return UTILS_STATUS_ERROR;
+    }
     memcpy(ptr->data, value, list->itemSize);
     ptr->next = NULL;
 
@@ -132,8 +146,15 @@ utilsStatus_t listInsert(list_t* list, void* value, LIST_STYPE position) {
     listNode_t* ptr;
     ptr = ADVUTILS_MALLOC(sizeof(listNode_t));
     ADVUTILS_ASSERT(ptr != NULL);
+    if (ptr == NULL) {
+        return UTILS_STATUS_ERROR;
+    }
     ptr->data = ADVUTILS_CALLOC(1, list->itemSize);
     ADVUTILS_ASSERT(ptr->data != NULL);
+    if (ptr->data == NULL) {
+        ADVUTILS_FREE(ptr);
+        return UTILS_STATUS_ERROR;
+    }
     memcpy(ptr->data, value, list->itemSize);
     ptr->next = NULL;
 
@@ -61,6 +61,332 @@
 #define ADVUTILS_FREE   free
 #endif /* ADVUTILS_MEMORY_MGMT_HEADER */
 
+/* Size below which matrixMultStrassen falls back to the direct kernel */
+#ifndef MATRIX_STRASSEN_CUTOFF
+#define MATRIX_STRASSEN_CUTOFF 64
+#endif /* MATRIX_STRASSEN_CUTOFF */
+
+/* Private Functions ---------------------------------------------------------*/
+
+/* Closed-form determinant of matrices up to 4x4 */
+static float matrixDetSmall(float* a, uint8_t n) {
+    switch (n) {
+        case 1: return a[0];
+        case 2: return a[0] * a[3] - a[1] * a[2];
+        case 3: return a[0] * (a[4] * a[8] - a[5] * a[7]) + a[1] * (a[5] * a[6] - a[3] * a[8]) + a[2] * (a[3] * a[7] - a[4] * a[6]);
+        default: {
+            /* Laplace expansion along the first two rows */
+            float s0 = a[0] * a[5] - a[4] * a[1], s1 = a[0] * a[6] - a[4] * a[2], s2 = a[0] * a[7] - a[4] * a[3];
+            float s3 = a[1] * a[6] - a[5] * a[2], s4 = a[1] * a[7] - a[5] * a[3], s5 = a[2] * a[7] - a[6] * a[3];
+            float c5 = a[10] * a[15] - a[14] * a[11], c4 = a[9] * a[15] - a[13] * a[11], c3 = a[9] * a[14] - a[13] * a[10];
+            float c2 = a[8] * a[15] - a[12] * a[11], c1 = a[8] * a[14] - a[12] * a[10], c0 = a[8] * a[13] - a[12] * a[9];
+            return s0 * c5 - s1 * c4 + s2 * c3 + s3 * c2 - s4 * c1 + s5 * c0;
+        }
+    }
+}
+
+/* Closed-form inverse (adjugate / determinant) of matrices up to 4x4, b must not overlap a */
+static utilsStatus_t matrixInvSmall(float* a, float* b, uint8_t n) {
+    float det, invDet;
+    switch (n) {
+        case 1:
+            if (a[0] == 0.0f) {
+                return UTILS_STATUS_ERROR;
+            }
+            b[0] = 1.0f / a[0];
+            break;
+        case 2:
+            det = a[0] * a[3] - a[1] * a[2];
+            if (det == 0.0f) {
+                return UTILS_STATUS_ERROR;
+            }
+            invDet = 1.0f / det;
+            b[0] = a[3] * invDet;
+            b[1] = -a[1] * invDet;
+            b[2] = -a[2] * invDet;
+            b[3] = a[0] * invDet;
+            break;
+        case 3: {
+            float c0 = a[4] * a[8] - a[5] * a[7], c1 = a[5] * a[6] - a[3] * a[8], c2 = a[3] * a[7] - a[4] * a[6];
+            det = a[0] * c0 + a[1] * c1 + a[2] * c2;
+            if (det == 0.0f) {
+                return UTILS_STATUS_ERROR;
+            }
+            invDet = 1.0f / det;
+            b[0] = c0 * invDet;
+            b[1] = (a[2] * a[7] - a[1] * a[8]) * invDet;
+            b[2] = (a[1] * a[5] - a[2] * a[4]) * invDet;
+            b[3] = c1 * invDet;
+            b[4] = (a[0] * a[8] - a[2] * a[6]) * invDet;
+            b[5] = (a[2] * a[3] - a[0] * a[5]) * invDet;
+            b[6] = c2 * invDet;
+            b[7] = (a[1] * a[6] - a[0] * a[7]) * invDet;
+            b[8] = (a[0] * a[4] - a[1] * a[3]) * invDet;
+            break;
+        }
+        default: {
+            /* 2x2 sub-determinants of the first two (s) and last two (c) rows */
+            float s0 = a[0] * a[5] - a[4] * a[1], s1 = a[0] * a[6] - a[4] * a[2], s2 = a[0] * a[7] - a[4] * a[3];
+            float s3 = a[1] * a[6] - a[5] * a[2], s4 = a[1] * a[7] - a[5] * a[3], s5 = a[2] * a[7] - a[6] * a[3];
+            float c5 = a[10] * a[15] - a[14] * a[11], c4 = a[9] * a[15] - a[13] * a[11], c3 = a[9] * a[14] - a[13] * a[10];
+            float c2 = a[8] * a[15] - a[12] * a[11], c1 = a[8] * a[14] - a[12] * a[10], c0 = a[8] * a[13] - a[12] * a[9];
+            det = s0 * c5 - s1 * c4 + s2 * c3 + s3 * c2 - s4 * c1 + s5 * c0;
+            if (det == 0.0f) {
+                return UTILS_STATUS_ERROR;
+            }
+            invDet = 1.0f / det;
+            b[0] = (a[5] * c5 - a[6] * c4 + a[7] * c3) * invDet;
+            b[1] = (-a[1] * c5 + a[2] * c4 - a[3] * c3) * invDet;
+            b[2] = (a[13] * s5 - a[14] * s4 + a[15] * s3) * invDet;
+            b[3] = (-a[9] * s5 + a[10] * s4 - a[11] * s3) * invDet;
+            b[4] = (-a[4] * c5 + a[6] * c2 - a[7] * c1) * invDet;
+            b[5] = (a[0] * c5 - a[2] * c2 + a[3] * c1) * invDet;
+            b[6] = (-a[12] * s5 + a[14] * s2 - a[15] * s1) * invDet;
+            b[7] = (a[8] * s5 - a[10] * s2 + a[11] * s1) * invDet;
+            b[8] = (a[4] * c4 - a[5] * c2 + a[7] * c0) * invDet;
+            b[9] = (-a[0] * c4 + a[1] * c2 - a[3] * c0) * invDet;
+            b[10] = (a[12] * s4 - a[13] * s2 + a[15] * s0) * invDet;
+            b[11] = (-a[8] * s4 + a[9] * s2 - a[11] * s0) * invDet;
+            b[12] = (-a[4] * c3 + a[5] * c1 - a[6] * c0) * invDet;
+            b[13] = (a[0] * c3 - a[1] * c1 + a[2] * c0) * invDet;
+            b[14] = (-a[12] * s3 + a[13] * s1 - a[14] * s0) * invDet;
+            b[15] = (a[8] * s3 - a[9] * s1 + a[10] * s0) * invDet;
+            break;
+        }
+    }
+    return UTILS_STATUS_SUCCESS;
+}
+
+/* In-place Gauss-Jordan inversion with partial pivoting */
+static utilsStatus_t matrixInvGaussJordan(matrix_t* matrix) {
+    uint8_t n = matrix->rows;
+    uint8_t piv[n];
+    int16_t ii, jj, kk;
+    uint8_t pivrow;
+    float tmp, tmp2;
+
+    for (kk = 0; kk < n; kk++) {
+        /* find pivot row, the row with biggest entry in current column */
+        pivrow = kk;
+        tmp = fabsf(ELEMP(matrix, kk, kk));
+        for (ii = kk + 1; ii < n; ii++) {
+            tmp2 = fabsf(ELEMP(matrix, ii, kk));
+            if (tmp2 > tmp) {
+                tmp = tmp2;
+                pivrow = ii;
+            }
+        }
+        if (tmp == 0.0f) {
+            return UTILS_STATUS_ERROR;
+        }
+        piv[kk] = pivrow;
+
+        /* swap rows */
+        if (pivrow != kk) {
+            for (jj = 0; jj < n; jj++) {
+                tmp = ELEMP(matrix, kk, jj);
+                ELEMP(matrix, kk, jj) = ELEMP(matrix, pivrow, jj);
+                ELEMP(matrix, pivrow, jj) = tmp;
+            }
+        }
+
+        /* normalize pivot row, the pivot element is replaced by its inverse */
+        tmp = 1.0f / ELEMP(matrix, kk, kk);
+        ELEMP(matrix, kk, kk) = 1.0f;
+        for (jj = 0; jj < n; jj++) {
+            ELEMP(matrix, kk, jj) *= tmp;
+        }
+
+        /* eliminate current column from all other rows */
+        for (ii = 0; ii < n; ii++) {
+            if (ii != kk) {
+                tmp = ELEMP(matrix, ii, kk);
+                ELEMP(matrix, ii, kk) = 0.0f;
+                for (jj = 0; jj < n; jj++) {
+                    ELEMP(matrix, ii, jj) -= tmp * ELEMP(matrix, kk, jj);
+                }
+            }
+        }
+    }
+
+    /* undo row permutations by swapping columns in reverse order */
+    for (kk = n - 1; kk >= 0; kk--) {
+        if (piv[kk] != kk) {
+            for (ii = 0; ii < n; ii++) {
+                tmp = ELEMP(matrix, ii, kk);
+                ELEMP(matrix, ii, kk) = ELEMP(matrix, ii, piv[kk]);
+                ELEMP(matrix, ii, piv[kk]) = tmp;
+            }
+        }
+    }
+    return UTILS_STATUS_SUCCESS;
+}
+
+/* Matrix inversion without Eye or L/U temporaries, result is set to zero if lhs is singular */
+static void matrixInvNoAlloc(matrix_t* lhs, matrix_t* result) {
+    utilsStatus_t status;
+    if (lhs->rows <= 4) {
+        float tmp[16];
+        status = matrixInvSmall(lhs->data, tmp, lhs->rows);
+        if (status == UTILS_STATUS_SUCCESS) {
+            memcpy(result->data, tmp, lhs->rows * lhs->cols * sizeof(float));
+        }
+    } else {
+        if (result->data != lhs->data) {
+            matrixCopy(lhs, result);
+        }
+        status = matrixInvGaussJordan(result);
+    }
+    if (status == UTILS_STATUS_ERROR) {
+        matrixZeros(result);
+    }
+    return;
+}
+
+/* Determinant by Gauss elimination with partial pivoting, data is overwritten */
+static float matrixDetGauss(float* data, uint8_t n) {
+    matrix_t A = {data, n, n};
+    int16_t ii, jj, kk;
+    uint8_t pivrow;
+    float tmp, tmp2;
+    float determinant = 1.0f;
+
+    for (kk = 0; kk < n; kk++) {
+        pivrow = kk;
+        tmp = fabsf(ELEM(A, kk, kk));
+        for (ii = kk + 1; ii < n; ii++) {
+            tmp2 = fabsf(ELEM(A, ii, kk));
+            if (tmp2 > tmp) {
+                tmp = tmp2;
+                pivrow = ii;
+            }
+        }
+        if (tmp == 0.0f) {
+            return 0.0f;
+        }
+        if (pivrow != kk) {
+            for (jj = kk; jj < n; jj++) {
+                tmp = ELEM(A, kk, jj);
+                ELEM(A, kk, jj) = ELEM(A, pivrow, jj);
+                ELEM(A, pivrow, jj) = tmp;
+            }
+            determinant = -determinant;
+        }
+        determinant *= ELEM(A, kk, kk);
+        tmp = 1.0f / ELEM(A, kk, kk);
+        for (ii = kk + 1; ii < n; ii++) {
+            tmp2 = ELEM(A, ii, kk) * tmp;
+            for (jj = kk + 1; jj < n; jj++) {
+                ELEM(A, ii, jj) -= tmp2 * ELEM(A, kk, jj);
+            }
+        }
+    }
+    return determinant;
+}
+
+/* Strided direct multiplication C = A * B of n x n blocks, i-k-j loop order */
+static void matrixMultKernel(float* A, uint16_t lda, float* B, uint16_t ldb, float* C, uint16_t ldc, uint16_t n) {
+    uint16_t ii, jj, kk;
+    float a;
+    for (ii = 0; ii < n; ii++) {
+        float* c = C + ii * ldc;
+        for (jj = 0; jj < n; jj++) {
+            c[jj] = 0.0f;
+        }
+        for (kk = 0; kk < n; kk++) {
+            float* b = B + kk * ldb;
+            a = A[ii * lda + kk];
+            for (jj = 0; jj < n; jj++) {
+                c[jj] += a * b[jj];
+            }
+        }
+    }
+}
+
+/* Strided Z = X + sign * Y of n x n blocks */
+static void matrixAddBlock(float* X, uint16_t ldx, float* Y, uint16_t ldy, float* Z, uint16_t ldz, uint16_t n, float sign) {
+    uint16_t ii, jj;
+    for (ii = 0; ii < n; ii++) {
+        for (jj = 0; jj < n; jj++) {
+            Z[ii * ldz + jj] = X[ii * ldx + jj] + sign * Y[ii * ldy + jj];
+        }
+    }
+}
+
+/* Strassen-Winograd recursion (7 multiplications, 15 additions) on n x n blocks, needs n * n floats of workspace */
+static void matrixMultStrassenRec(float* A, uint16_t lda, float* B, uint16_t ldb, float* C, uint16_t ldc, uint16_t n, float* work) {
+    uint16_t ii, jj, kk, h;
+
+    if (n <= MATRIX_STRASSEN_CUTOFF) {
+        matrixMultKernel(A, lda, B, ldb, C, ldc, n);
+        return;
+    }
+
+    /* Odd size: recurse on the even leading block and fix up last row and column directly (dynamic peeling) */
+    if (n & 1) {
+        uint16_t m = n - 1;
+        float sum;
+        matrixMultStrassenRec(A, lda, B, ldb, C, ldc, m, work);
+        for (ii = 0; ii < m; ii++) {
+            for (jj = 0; jj < m; jj++) {
+                C[ii * ldc + jj] += A[ii * lda + m] * B[m * ldb + jj];
+            }
+        }
+        for (ii = 0; ii < n; ii++) {
+            sum = 0.0f;
+            for (kk = 0; kk < n; kk++) {
+                sum += A[ii * lda + kk] * B[kk * ldb + m];
+            }
+            C[ii * ldc + m] = sum;
+        }
+        for (jj = 0; jj < m; jj++) {
+            sum = 0.0f;
+            for (kk = 0; kk < n; kk++) {
+                sum += A[m * lda + kk] * B[kk * ldb + jj];
+            }
+            C[m * ldc + jj] = sum;
+        }
+        return;
+    }
+
+    h = n >> 1;
+    float *A11 = A, *A12 = A + h, *A21 = A + h * lda, *A22 = A + h * lda + h;
+    float *B11 = B, *B12 = B + h, *B21 = B + h * ldb, *B22 = B + h * ldb + h;
+    float *C11 = C, *C12 = C + h, *C21 = C + h * ldc, *C22 = C + h * ldc + h;
+    float *X = work, *Y = work + h * h, *Z = work + 2 * h * h, *next = work + 3 * h * h;
+
+    /* C21 = P7 = (A11 - A21) * (B22 - B12) */
+    matrixAddBlock(A11, lda, A21, lda, X, h, h, -1.0f);
+    matrixAddBlock(B22, ldb, B12, ldb, Y, h, h, -1.0f);
+    matrixMultStrassenRec(X, h, Y, h, C21, ldc, h, next);
+    /* C22 = P5 = (A21 + A22) * (B12 - B11) */
+    matrixAddBlock(A21, lda, A22, lda, X, h, h, 1.0f);
+    matrixAddBlock(B12, ldb, B11, ldb, Y, h, h, -1.0f);
+    matrixMultStrassenRec(X, h, Y, h, C22, ldc, h, next);
+    /* C12 = P6 = (S1 - A11) * (B22 - T1) */
+    matrixAddBlock(X, h, A11, lda, X, h, h, -1.0f);
+    matrixAddBlock(B22, ldb, Y, h, Y, h, h, -1.0f);
+    matrixMultStrassenRec(X, h, Y, h, C12, ldc, h, next);
+    /* C11 = P3 = (A12 - S2) * B22 */
+    matrixAddBlock(A12, lda, X, h, X, h, h, -1.0f);
+    matrixMultStrassenRec(X, h, B22, ldb, C11, ldc, h, next);
+    /* Z = P1 = A11 * B11 */
+    matrixMultStrassenRec(A11, lda, B11, ldb, Z, h, h, next);
+    /* U2 = P1 + P6, U3 = U2 + P7, U4 = U2 + P5, C22 = U3 + P5, C12 = U4 + P3 */
+    matrixAddBlock(C12, ldc, Z, h, C12, ldc, h, 1.0f);
+    matrixAddBlock(C21, ldc, C12, ldc, C21, ldc, h, 1.0f);
+    matrixAddBlock(C12, ldc, C22, ldc, C12, ldc, h, 1.0f);
+    matrixAddBlock(C22, ldc, C21, ldc, C22, ldc, h, 1.0f);
+    matrixAddBlock(C12, ldc, C11, ldc, C12, ldc, h, 1.0f);
+    /* C21 = U3 - P4, with P4 = A22 * (T2 - B21) */
+    matrixAddBlock(Y, h, B21, ldb, Y, h, h, -1.0f);
+    matrixMultStrassenRec(A22, lda, Y, h, C11, ldc, h, next);
+    matrixAddBlock(C21, ldc, C11, ldc, C21, ldc, h, -1.0f);
+    /* C11 = P1 + P2, with P2 = A12 * B21 */
+    matrixMultStrassenRec(A12, lda, B21, ldb, C11, ldc, h, next);
+    matrixAddBlock(C11, ldc, Z, h, C11, ldc, h, 1.0f);
+}
+
 /* ==========================================Assignment============================================= */
 
 #ifdef ADVUTILS_USE_DYNAMIC_ALLOCATION
@@ -285,6 +611,15 @@ void matrixMult_rhsT(matrix_t* lhs, matrix_t* rhs, matrix_t* result) {
     return;
 }
 
+/* ---------Strassen-Winograd multiplication----------- */
+void matrixMultStrassen(matrix_t* lhs, matrix_t* rhs, matrix_t* result, float* workspace) {
+    ADVUTILS_ASSERT(lhs->rows == lhs->cols);
+    ADVUTILS_ASSERT((rhs->rows == lhs->rows) && (rhs->cols == lhs->cols));
+    ADVUTILS_ASSERT((result->rows == lhs->rows) && (result->cols == lhs->cols));
+    matrixMultStrassenRec(lhs->data, lhs->cols, rhs->data, rhs->cols, result->data, result->cols, lhs->rows, workspace);
+    return;
+}
+
 /* ---------------Scalar multiplication------------------ */
 void matrixMultScalar(matrix_t* lhs, float sc, matrix_t* result) {
     ADVUTILS_ASSERT(result->rows == lhs->rows);
@@ -298,16 +633,12 @@ void matrixMultScalar(matrix_t* lhs, float sc, matrix_t* result) {
 
 #ifdef ADVUTILS_USE_DYNAMIC_ALLOCATION
 
-/* --------------------Inverse LU------------------------ */
+/* ----------------------Inverse------------------------- */
 void matrixInversed(matrix_t* lhs, matrix_t* result) {
     ADVUTILS_ASSERT(lhs->rows == lhs->cols);
     ADVUTILS_ASSERT(result->rows == lhs->rows);
     ADVUTILS_ASSERT(result->cols == lhs->cols);
-    matrix_t Eye;
-    matrixInit(&Eye, lhs->rows, lhs->cols);
-    matrixIdentity(&Eye);
-    LinSolveLU(lhs, &Eye, result);
-    matrixDelete(&Eye);
+    matrixInvNoAlloc(lhs, result);
     return;
 }
 
@@ -328,16 +659,12 @@ void matrixInversed_rob(matrix_t* lhs, matrix_t* result) {
 
 #ifdef ADVUTILS_USE_STATIC_ALLOCATION
 
-/* -----------------Static Inverse LU-------------------- */
+/* -------------------Static Inverse--------------------- */
 void matrixInversedStatic(matrix_t* lhs, matrix_t* result) {
     ADVUTILS_ASSERT(lhs->rows == lhs->cols);
     ADVUTILS_ASSERT(result->rows == lhs->rows);
     ADVUTILS_ASSERT(result->cols == lhs->cols);
-    float _eyeData[lhs->rows * lhs->cols];
-    matrix_t Eye;
-    matrixInitStatic(&Eye, _eyeData, lhs->rows, lhs->cols);
-    matrixIdentity(&Eye);
-    LinSolveLUStatic(lhs, &Eye, result);
+    matrixInvNoAlloc(lhs, result);
     return;
 }
 
@@ -416,6 +743,74 @@ void matrixPseudoInvStatic(matrix_t* lhs, matrix_t* result) {
 
 #endif /* ADVUTILS_USE_STATIC_ALLOCATION */
 
+/* ------------Matrix exponential--------------- */
+/* scaling and squaring of [6/6] Pade approximant (Golub & Van Loan, alg. 11.3.1) */
+utilsStatus_t matrixExpm(matrix_t* lhs, matrix_t* result, float* workspace) {
+    ADVUTILS_ASSERT(lhs->rows == lhs->cols);
+    ADVUTILS_ASSERT(result->rows == lhs->rows);
+    ADVUTILS_ASSERT(result->cols == lhs->cols);
+    const uint8_t q = 6;
+    uint16_t n2 = lhs->rows * lhs->cols;
+    uint16_t ii, jj;
+    uint8_t kk;
+    int exponent;
+    int16_t s;
+    float norm = 0.0f, rowSum, c = 0.5f;
+    matrix_t As = {workspace, lhs->rows, lhs->cols};
+    matrix_t X = {workspace + n2, lhs->rows, lhs->cols};
+    matrix_t D = {workspace + 2 * n2, lhs->rows, lhs->cols};
+    matrix_t tmp = {workspace + 3 * n2, lhs->rows, lhs->cols};
+
+    /* Scale A by 2^-s so that its infinity norm is below 0.5 */
+    for (ii = 0; ii < lhs->rows; ii++) {
+        rowSum = 0.0f;
+        for (jj = 0; jj < lhs->cols; jj++) {
+            rowSum += fabsf(ELEMP(lhs, ii, jj));
+        }
+        if (rowSum > norm) {
+            norm = rowSum;
+        }
+    }
+    frexpf(norm, &exponent);
+    s = (exponent + 1) > 0 ? (exponent + 1) : 0;
+    matrixMultScalar(lhs, ldexpf(1.0f, -s), &As);
+
+    /* E = I + c * A, D = I - c * A */
+    matrixCopy(&As, &X);
+    for (ii = 0; ii < n2; ii++) {
+        result->data[ii] = c * As.data[ii];
+        D.data[ii] = -result->data[ii];
+    }
+    for (ii = 0; ii < lhs->rows; ii++) {
+        ELEMP(result, ii, ii) += 1.0f;
+        ELEM(D, ii, ii) += 1.0f;
+    }
+
+    /* Accumulate Pade numerator in E (result) and denominator in D */
+    for (kk = 2; kk <= q; kk++) {
+        c *= (float)(q - kk + 1) / (float)(kk * (2 * q - kk + 1));
+        matrixMult(&As, &X, &tmp);
+        matrixCopy(&tmp, &X);
+        for (ii = 0; ii < n2; ii++) {
+            result->data[ii] += c * X.data[ii];
+            D.data[ii] += (kk & 1) ? -c * X.data[ii] : c * X.data[ii];
+        }
+    }
+
+    /* E = D \ E */
+    if (LinSolveGaussInPlace(&D, result) == UTILS_STATUS_ERROR) {
+        return UTILS_STATUS_ERROR;
+    }
+
+    /* Undo scaling by repeated squaring */
+    for (; s > 0; s--) {
+        matrixMult(result, result, &tmp);
+        matrixCopy(&tmp, result);
+    }
+
+    return UTILS_STATUS_SUCCESS;
+}
+
 /* =======================================matrix_t Data========================================= */
 
 #ifdef ADVUTILS_USE_DYNAMIC_ALLOCATION
@@ -425,32 +820,18 @@ float matrixDet(matrix_t* matrix) {
     if (matrix->rows != matrix->cols) {
         return 0.0f;
     }
-    matrix_t L, U, P;
-    matrixInit(&L, matrix->rows, matrix->rows);
-    matrixInit(&U, matrix->rows, matrix->rows);
-    matrixInit(&P, matrix->rows, 1);
-    int16_t ii;
-    int8_t det_f;
-    float determinant = 1.0f;
-
-    if (LU_Cormen(matrix, &L, &U) == UTILS_STATUS_SUCCESS) {
-        for (ii = 0; ii < matrix->rows; ii++) {
-            determinant *= ELEM(U, ii, ii);
-        }
+    if (matrix->rows <= 4) {
+        return matrixDetSmall(matrix->data, matrix->rows);
     }
-
-    else {
-        det_f = LUP_Cormen(matrix, &L, &U, &P);
-        for (ii = 0; ii < matrix->rows; ii++) {
-            determinant *= ELEM(U, ii, ii);
-        }
-        determinant *= det_f;
+    float determinant;
+    float* _data = ADVUTILS_MALLOC(matrix->rows * matrix->cols * sizeof(float));
+    ADVUTILS_ASSERT(_data != NULL);
+    if (_data == NULL) {
+        return 0.0f;
     }
-
-    matrixDelete(&L);
-    matrixDelete(&U);
-    matrixDelete(&P);
-
+    memcpy(_data, matrix->data, matrix->rows * matrix->cols * sizeof(float));
+    determinant = matrixDetGauss(_data, matrix->rows);
+    ADVUTILS_FREE(_data);
     return determinant;
 }
 
@@ -463,31 +844,12 @@ float matrixDetStatic(matrix_t* matrix) {
     if (matrix->rows != matrix->cols) {
         return 0.0f;
     }
-    float _LData[matrix->rows * matrix->rows];
-    float _UData[matrix->rows * matrix->rows];
-    float _PData[matrix->rows];
-    matrix_t L, U, P;
-    matrixInitStatic(&L, _LData, matrix->rows, matrix->rows);
-    matrixInitStatic(&U, _UData, matrix->rows, matrix->rows);
-    matrixInitStatic(&P, _PData, matrix->rows, 1);
-    int16_t ii;
-    int8_t det_f;
-    float determinant = 1.0f;
-
-    if (LU_CormenStatic(matrix, &L, &U) == UTILS_STATUS_SUCCESS) {
-        for (ii = 0; ii < matrix->rows; ii++) {
-            determinant *= ELEM(U, ii, ii);
-        }
+    if (matrix->rows <= 4) {
+        return matrixDetSmall(matrix->data, matrix->rows);
     }
-
-    else {
-        det_f = LUP_CormenStatic(matrix, &L, &U, &P);
-        for (ii = 0; ii < matrix->rows; ii++) {
-            determinant *= ELEM(U, ii, ii);
-        }
-        determinant *= det_f;
-    }
-    return determinant;
+    float _data[matrix->rows * matrix->cols];
+    memcpy(_data, matrix->data, matrix->rows * matrix->cols * sizeof(float));
+    return matrixDetGauss(_data, matrix->rows);
 }
 
 #endif /* ADVUTILS_USE_STATIC_ALLOCATION */
@@ -42,6 +42,16 @@
 #include "ADVUtilsAssert.h"
 #include "math.h"
 
+/* Macros --------------------------------------------------------------------*/
+
+/* Number of systems processed together by LinSolveLUPBatch, inner loops over them are meant to map to SIMD lanes */
+#ifndef LINSOLVE_BATCH_LANES
+#define LINSOLVE_BATCH_LANES 16
+#endif /* LINSOLVE_BATCH_LANES */
+
+/* Pointer to element (i, j) of system s0 in SoA batch storage of count systems with cols columns */
+#define LINSOLVE_BATCH_ELEM(M, cols, i, j, count, s0) ((M) + ((uint32_t)(i) * (cols) + (j)) * (count) + (s0))
+
 /* -------------------Forward substitution---------------------- */
 /* assumes that the matrix A is already a lower triangular one. No check! */
 
@@ -195,6 +205,285 @@ utilsStatus_t LU_Crout(matrix_t* A, matrix_t* L, matrix_t* U) {
     return UTILS_STATUS_SUCCESS;
 }
 
+/* ----------In-place linear system solver using Gauss elimination with partial pivoting----------- */
+/* solves the linear system A*X=B, where A is a n-by-n matrix and B an n-by-m matrix, overwriting B with the n-by-m matrix X and destroying A */
+
+utilsStatus_t LinSolveGaussInPlace(matrix_t* A, matrix_t* B) {
+    ADVUTILS_ASSERT(A->rows == A->cols);
+    ADVUTILS_ASSERT(A->rows == B->rows);
+    int16_t pivrow;  /* keeps track of current pivot row */
+    int16_t k, i, j; /* k: overall index along diagonals; i: row index; j: col index */
+    float tmp, tmp2;
+
+    for (k = 0; k < A->rows; k++) {
+        /* find pivot row, the row with biggest entry in current column */
+        tmp = fabsf(ELEMP(A, k, k));
+        pivrow = k;
+        for (i = k + 1; i < A->rows; i++) {
+            tmp2 = fabsf(ELEMP(A, i, k));
+            if (tmp2 > tmp) {
+                tmp = tmp2;
+                pivrow = i;
+            }
+        }
+
+        /* check for singular Matrix */
+        if (tmp == 0.0f) {
+            return UTILS_STATUS_ERROR;
+        }
+
+        /* Execute pivot (row swap) if needed */
+        if (pivrow != k) {
+            for (j = k; j < A->cols; j++) {
+                tmp = ELEMP(A, k, j);
+                ELEMP(A, k, j) = ELEMP(A, pivrow, j);
+                ELEMP(A, pivrow, j) = tmp;
+            }
+            for (j = 0; j < B->cols; j++) {
+                tmp = ELEMP(B, k, j);
+                ELEMP(B, k, j) = ELEMP(B, pivrow, j);
+                ELEMP(B, pivrow, j) = tmp;
+            }
+        }
+
+        /* Row reduction */
+        tmp = 1.0f / ELEMP(A, k, k);
+        for (i = k + 1; i < A->rows; i++) {
+            tmp2 = ELEMP(A, i, k) * tmp;
+            for (j = k + 1; j < A->cols; j++) {
+                ELEMP(A, i, j) -= tmp2 * ELEMP(A, k, j);
+            }
+            for (j = 0; j < B->cols; j++) {
+                ELEMP(B, i, j) -= tmp2 * ELEMP(B, k, j);
+            }
+        }
+    }
+
+    /* In-place backward substitution, rows below i are already solved */
+    for (i = A->rows - 1; i >= 0; i--) {
+        tmp = 1.0f / ELEMP(A, i, i);
+        for (j = 0; j < B->cols; j++) {
+            tmp2 = ELEMP(B, i, j);
+            for (k = i + 1; k < A->cols; k++) {
+                tmp2 -= ELEMP(A, i, k) * ELEMP(B, k, j);
+            }
+            ELEMP(B, i, j) = tmp2 * tmp;
+        }
+    }
+    return UTILS_STATUS_SUCCESS;
+}
+
+/* -------------------Batched linear system solver using LUP factorization----------------------- */
+/* Pivoting is done per system with branch-free selects, so that the same instruction stream works on all lanes */
+
+utilsStatus_t LinSolveLUPBatch(float* A, float* B, uint8_t n, uint8_t m, uint16_t count, uint8_t* singular) {
+    ADVUTILS_ASSERT(n > 0);
+    utilsStatus_t status = UTILS_STATUS_SUCCESS;
+    uint8_t piv[LINSOLVE_BATCH_LANES], sing[LINSOLVE_BATCH_LANES], sel;
+    float inv[LINSOLVE_BATCH_LANES];
+    float *pk, *pi, *px, x;
+    uint32_t s0;
+    uint16_t lanes, l;
+    int16_t i, j, k;
+
+    for (s0 = 0; s0 < count; s0 += LINSOLVE_BATCH_LANES) {
+        lanes = (count - s0) < LINSOLVE_BATCH_LANES ? (count - s0) : LINSOLVE_BATCH_LANES;
+        for (l = 0; l < lanes; l++) {
+            sing[l] = 0;
+        }
+
+        for (k = 0; k < n; k++) {
+            /* Pivot search: per-lane index of the row with biggest entry in column k, selected without branches */
+            pk = LINSOLVE_BATCH_ELEM(A, n, k, k, count, s0);
+            for (l = 0; l < lanes; l++) {
+                piv[l] = k;
+                inv[l] = fabsf(pk[l]);
+            }
+            for (i = k + 1; i < n; i++) {
+                pi = LINSOLVE_BATCH_ELEM(A, n, i, k, count, s0);
+                for (l = 0; l < lanes; l++) {
+                    x = fabsf(pi[l]);
+                    piv[l] = x > inv[l] ? i : piv[l];
+                    inv[l] = x > inv[l] ? x : inv[l];
+                }
+            }
+
+            /*
+             * Execute pivot (row swap): every candidate row is exchanged with row k on the lanes that selected it, with selects.
+             * Rows selected by no lane are skipped as a whole
+             */
+            for (i = k + 1; i < n; i++) {
+                sel = 0;
+                for (l = 0; l < lanes; l++) {
+                    sel |= (piv[l] == i);
+                }
+                if (!sel) {
+                    continue;
+                }
+                for (j = k; j < n; j++) {
+                    pk = LINSOLVE_BATCH_ELEM(A, n, k, j, count, s0);
+                    pi = LINSOLVE_BATCH_ELEM(A, n, i, j, count, s0);
+                    for (l = 0; l < lanes; l++) {
+                        x = pk[l];
+                        pk[l] = piv[l] == i ? pi[l] : x;
+                        pi[l] = piv[l] == i ? x : pi[l];
+                    }
+                }
+                for (j = 0; j < m; j++) {
+                    pk = LINSOLVE_BATCH_ELEM(B, m, k, j, count, s0);
+                    pi = LINSOLVE_BATCH_ELEM(B, m, i, j, count, s0);
+                    for (l = 0; l < lanes; l++) {
+                        x = pk[l];
+                        pk[l] = piv[l] == i ? pi[l] : x;
+                        pi[l] = piv[l] == i ? x : pi[l];
+                    }
+                }
+            }
+
+            /* Singular lanes get a unit pivot, so that they don't spread NaNs and the others keep going */
+            pk = LINSOLVE_BATCH_ELEM(A, n, k, k, count, s0);
+            for (l = 0; l < lanes; l++) {
+                sing[l] |= (pk[l] == 0.0f);
+                inv[l] = 1.0f / (pk[l] == 0.0f ? 1.0f : pk[l]);
+            }
+
+            /* Row reduction, multipliers are stored in the lower triangle of A */
+            for (i = k + 1; i < n; i++) {
+                pi = LINSOLVE_BATCH_ELEM(A, n, i, k, count, s0);
+                for (l = 0; l < lanes; l++) {
+                    pi[l] *= inv[l];
+                }
+                for (j = k + 1; j < n; j++) {
+                    pk = LINSOLVE_BATCH_ELEM(A, n, k, j, count, s0);
+                    px = LINSOLVE_BATCH_ELEM(A, n, i, j, count, s0);
+                    for (l = 0; l < lanes; l++) {
+                        px[l] -= pi[l] * pk[l];
+                    }
+                }
+                for (j = 0; j < m; j++) {
+                    pk = LINSOLVE_BATCH_ELEM(B, m, k, j, count, s0);
+                    px = LINSOLVE_BATCH_ELEM(B, m, i, j, count, s0);
+                    for (l = 0; l < lanes; l++) {
+                        px[l] -= pi[l] * pk[l];
+                    }
+                }
+            }
+        }
+
+        /* In-place backward substitution */
+        for (i = n - 1; i >= 0; i--) {
+            pi = LINSOLVE_BATCH_ELEM(A, n, i, i, count, s0);
+            for (l = 0; l < lanes; l++) {
+                inv[l] = 1.0f / (pi[l] == 0.0f ? 1.0f : pi[l]);
+            }
+            for (j = 0; j < m; j++) {
+                px = LINSOLVE_BATCH_ELEM(B, m, i, j, count, s0);
+                for (k = i + 1; k < n; k++) {
+                    pi = LINSOLVE_BATCH_ELEM(A, n, i, k, count, s0);
+                    pk = LINSOLVE_BATCH_ELEM(B, m, k, j, count, s0);
+                    for (l = 0; l < lanes; l++) {
+                        px[l] -= pi[l] * pk[l];
+                    }
+                }
+                for (l = 0; l < lanes; l++) {
+                    px[l] *= inv[l];
+                }
+            }
+        }
+
+        for (l = 0; l < lanes; l++) {
+            if (sing[l]) {
+                status = UTILS_STATUS_ERROR;
+            }
+            if (singular != NULL) {
+                singular[s0 + l] = sing[l];
+            }
+        }
+    }
+    return status;
+}
+
+/* --------------------Zero-order hold discretization of state-space model----------------------- */
+/* expm([A B; 0 0] * dT) = [Ad Bd; 0 I] */
+
+utilsStatus_t DiscretizeZOH(matrix_t* A, matrix_t* B, float dT_ms, matrix_t* Ad, matrix_t* Bd, float* workspace) {
+    ADVUTILS_ASSERT(A->rows == A->cols);
+    ADVUTILS_ASSERT(B->rows == A->rows);
+    ADVUTILS_ASSERT((Ad->rows == A->rows) && (Ad->cols == A->cols));
+    ADVUTILS_ASSERT((Bd->rows == B->rows) && (Bd->cols == B->cols));
+    ADVUTILS_ASSERT((A->cols + B->cols) <= UINT8_MAX);
+    uint8_t N = A->cols + B->cols;
+    uint8_t i, j;
+    float dT = dT_ms * 1e-3f;
+    matrix_t M = {workspace, N, N};
+
+    /* Build augmented matrix [A B; 0 0] * dT */
+    matrixZeros(&M);
+    for (i = 0; i < A->rows; i++) {
+        for (j = 0; j < A->cols; j++) {
+            ELEM(M, i, j) = ELEMP(A, i, j) * dT;
+        }
+        for (j = 0; j < B->cols; j++) {
+            ELEM(M, i, A->cols + j) = ELEMP(B, i, j) * dT;
+        }
+    }
+
+    if (matrixExpm(&M, &M, workspace + N * N) == UTILS_STATUS_ERROR) {
+        return UTILS_STATUS_ERROR;
+    }
+
+    for (i = 0; i < A->rows; i++) {
+        for (j = 0; j < A->cols; j++) {
+            ELEMP(Ad, i, j) = ELEM(M, i, j);
+        }
+        for (j = 0; j < B->cols; j++) {
+            ELEMP(Bd, i, j) = ELEM(M, i, A->cols + j);
+        }
+    }
+    return UTILS_STATUS_SUCCESS;
+}
+
+/* ------------------------Tustin discretization of state-space model---------------------------- */
+/* [Ad Bd] = (I - A * dT / 2) \ [I + A * dT / 2, B * dT] */
+
+utilsStatus_t DiscretizeTustin(matrix_t* A, matrix_t* B, float dT_ms, matrix_t* Ad, matrix_t* Bd, float* workspace) {
+    ADVUTILS_ASSERT(A->rows == A->cols);
+    ADVUTILS_ASSERT(B->rows == A->rows);
+    ADVUTILS_ASSERT((Ad->rows == A->rows) && (Ad->cols == A->cols));
+    ADVUTILS_ASSERT((Bd->rows == B->rows) && (Bd->cols == B->cols));
+    uint8_t i, j;
+    float dT = dT_ms * 1e-3f;
+    float halfdT = 0.5f * dT;
+    matrix_t M = {workspace, A->rows, A->cols};
+    matrix_t R = {workspace + A->rows * A->cols, A->rows, A->cols + B->cols};
+
+    for (i = 0; i < A->rows; i++) {
+        for (j = 0; j < A->cols; j++) {
+            ELEM(M, i, j) = -ELEMP(A, i, j) * halfdT;
+            ELEM(R, i, j) = ELEMP(A, i, j) * halfdT;
+        }
+        ELEM(M, i, i) += 1.0f;
+        ELEM(R, i, i) += 1.0f;
+        for (j = 0; j < B->cols; j++) {
+            ELEM(R, i, A->cols + j) = ELEMP(B, i, j) * dT;
+        }
+    }
+
+    if (LinSolveGaussInPlace(&M, &R) == UTILS_STATUS_ERROR) {
+        return UTILS_STATUS_ERROR;
+    }
+
+    for (i = 0; i < A->rows; i++) {
+        for (j = 0; j < A->cols; j++) {
+            ELEMP(Ad, i, j) = ELEM(R, i, j);
+        }
+        for (j = 0; j < B->cols; j++) {
+            ELEMP(Bd, i, j) = ELEM(R, i, A->cols + j);
+        }
+    }
+    return UTILS_STATUS_SUCCESS;
+}
+
 #ifdef ADVUTILS_USE_DYNAMIC_ALLOCATION
 
 /* -------------------------LU factorization using Cormen's Method-------------------------------- */
@@ -0,0 +1,145 @@
+/* BEGIN Header */
+/**
+ ******************************************************************************
+ * \file            test_CRC.c
+ * \author          Andrea Vivani
+ * \brief           Unit tests for CRC.c
+ ******************************************************************************
+ * \copyright
+ *
+ * Copyright 2024 Andrea Vivani
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the “Software”), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ ******************************************************************************
+ */
+/* END Header */
+
+/* Includes ------------------------------------------------------------------*/
+
+#include <setjmp.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "CRC.h"
+
+#include <cmocka.h>
+
+/* Support functions ---------------------------------------------------------*/
+
+static uint8_t skipAssert = 0;
+
+void ADVUtils_testAssert(const int result, const char* const expression, const char* const file, const int line) {
+    if (skipAssert) {
+        return;
+    } else {
+        mock_assert(result, expression, file, line);
+    }
+}
+
+/* Bit-wise reflected CRC-32, reference for table-driven and hardware implementations */
+static uint32_t crcBitwise(uint32_t poly, const uint8_t* p, size_t len) {
+    uint32_t crc = 0xFFFFFFFFUL;
+    while (len--) {
+        crc ^= *p++;
+        for (uint8_t ii = 0; ii < 8; ii++) {
+            crc = (crc & 1) ? ((crc >> 1) ^ poly) : (crc >> 1);
+        }
+    }
+    return ~crc;
+}
+
+static const char check[] = "123456789";
+
+/* Functions -----------------------------------------------------------------*/
+
+static void test_crc8(void** state) {
+    (void)state; /* unused */
+    assert_int_equal(crc8Calc(check, 9, CRC8_INIT), 0xF4);
+    assert_int_equal(crc8Calc(check, 0, CRC8_INIT), CRC8_INIT);
+    assert_int_equal(crc8Calc(check + 4, 5, crc8Calc(check, 4, CRC8_INIT)), 0xF4);
+    expect_assert_failure(crc8Calc(NULL, 0, CRC8_INIT));
+}
+
+static void test_crc16(void** state) {
+    (void)state; /* unused */
+    assert_int_equal(crc16Calc(check, 9, CRC16_INIT), 0x29B1);
+    assert_int_equal(crc16Calc(check, 0, CRC16_INIT), CRC16_INIT);
+    assert_int_equal(crc16Calc(check + 4, 5, crc16Calc(check, 4, CRC16_INIT)), 0x29B1);
+    expect_assert_failure(crc16Calc(NULL, 0, CRC16_INIT));
+}
+
+static void test_crc32(void** state) {
+    (void)state; /* unused */
+    uint8_t data[300];
+    assert_int_equal(crc32Calc(check, 9, CRC32_INIT), 0xCBF43926);
+    assert_int_equal(crc32Calc(check, 0, CRC32_INIT), 0);
+    assert_int_equal(crc32Calc(check + 4, 5, crc32Calc(check, 4, CRC32_INIT)), 0xCBF43926);
+    /* Slicing-by-8 against bit-wise CRC, for all lengths and misalignments */
+    for (uint16_t ii = 0; ii < sizeof(data); ii++) {
+        data[ii] = (uint8_t)(ii * 31 + 7);
+    }
+    for (uint8_t offset = 0; offset < 8; offset++) {
+        for (size_t len = 0; len < 40; len++) {
+            assert_int_equal(crc32Calc(data + offset, len, CRC32_INIT), crcBitwise(0xEDB88320UL, data + offset, len));
+        }
+    }
+    assert_int_equal(crc32Calc(data, sizeof(data), CRC32_INIT), crcBitwise(0xEDB88320UL, data, sizeof(data)));
+    expect_assert_failure(crc32Calc(NULL, 0, CRC32_INIT));
+}
+
+static void test_crc32c(void** state) {
+    (void)state; /* unused */
+    uint8_t data[300];
+    assert_int_equal(crc32cCalc(check, 9, CRC32C_INIT), 0xE3069283);
+    assert_int_equal(crc32cCalc(check, 0, CRC32C_INIT), 0);
+    assert_int_equal(crc32cCalc(check + 4, 5, crc32cCalc(check, 4, CRC32C_INIT)), 0xE3069283);
+    /* Hardware or slicing-by-8 CRC against bit-wise CRC, for all lengths and misalignments */
+    for (uint16_t ii = 0; ii < sizeof(data); ii++) {
+        data[ii] = (uint8_t)(ii * 31 + 7);
+    }
+    for (uint8_t offset = 0; offset < 8; offset++) {
+        for (size_t len = 0; len < 40; len++) {
+            assert_int_equal(crc32cCalc(data + offset, len, CRC32C_INIT), crcBitwise(0x82F63B78UL, data + offset, len));
+        }
+    }
+    assert_int_equal(crc32cCalc(data, sizeof(data), CRC32C_INIT), crcBitwise(0x82F63B78UL, data, sizeof(data)));
+    expect_assert_failure(crc32cCalc(NULL, 0, CRC32C_INIT));
+}
+
+static void test_hash_crc32c(void** state) {
+    (void)state; /* unused */
+    assert_int_equal(hash_crc32c("123456789"), 0xE3069283);
+    assert_int_equal(hash_crc32c_buf("123456789", 9), 0xE3069283);
+    assert_int_equal(hash_crc32c(""), 0);
+    expect_assert_failure(hash_crc32c(NULL));
+    expect_assert_failure(hash_crc32c_buf(NULL, 0));
+}
+
+int main(void) {
+    const struct CMUnitTest test_CRC[] = {
+        cmocka_unit_test(test_crc8),
+        cmocka_unit_test(test_crc16),
+        cmocka_unit_test(test_crc32),
+        cmocka_unit_test(test_crc32c),
+        cmocka_unit_test(test_hash_crc32c),
+    };
+
+    return cmocka_run_group_tests(test_CRC, NULL, NULL);
+}
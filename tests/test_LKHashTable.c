@@ -38,6 +38,7 @@
 #include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
+#include <stdio.h>
 #include "LKHashTable.h"
 #include "hashFunctions.h"
 
@@ -90,27 +91,27 @@ uint32_t ADVUtils_testHash(char* key) {
 static void test_lkHashTableInit(void** state) {
     (void)state; /* unused */
     lkHashTable_t lkht;
-    assert_int_equal(lkHashTableInit(&lkht, sizeof(int), 10), UTILS_STATUS_SUCCESS);
-    assert_int_equal(lkht.size, 10);
+    assert_int_equal(lkHashTableInit(&lkht, sizeof(int), 10, LKHT_NOT_RESIZABLE), UTILS_STATUS_SUCCESS);
+    assert_int_equal(lkht.size, 16);
     assert_int_equal(lkht.items, 0);
     assert_non_null(lkht.entries);
+    assert_null(lkht._pool);
     for (uint32_t i = 0; i < lkht.size; i++) {
-        assert_int_equal(lkht.entries[i].size, LKHT_LIST_SIZE);
-        assert_int_equal(lkht.entries[i].items, 0);
+        assert_null(lkht.entries[i]);
     }
     test_free(lkht.entries);
     /* Check null initialization */
     skipAssert = 0;
-    expect_assert_failure(lkHashTableInit(&lkht, 0, 0));
+    expect_assert_failure(lkHashTableInit(&lkht, 0, 0, LKHT_NOT_RESIZABLE));
     skipAssert = 1;
-    assert_int_equal(lkHashTableInit(&lkht, 0, 0), UTILS_STATUS_ERROR);
+    assert_int_equal(lkHashTableInit(&lkht, 0, 0, LKHT_NOT_RESIZABLE), UTILS_STATUS_ERROR);
     skipAssert = 0;
 }
 
 static void test_lkHashTablePutAndGet(void** state) {
     (void)state; /* unused */
     lkHashTable_t lkht;
-    assert_int_equal(lkHashTableInit(&lkht, sizeof(int), 3), UTILS_STATUS_SUCCESS);
+    assert_int_equal(lkHashTableInit(&lkht, sizeof(int), 3, LKHT_NOT_RESIZABLE), UTILS_STATUS_SUCCESS);
     int value1 = 42;
     int value2 = 43;
     int value3 = 44;
@@ -120,7 +121,11 @@ static void test_lkHashTablePutAndGet(void** state) {
     assert_int_equal(lkHashTablePut(&lkht, "key1", &value1), UTILS_STATUS_SUCCESS);
     assert_int_equal(lkHashTablePut(&lkht, "key2", &value2), UTILS_STATUS_SUCCESS);
     assert_int_equal(lkHashTablePut(&lkht, "key3", &value3), UTILS_STATUS_SUCCESS);
-    assert_int_equal(lkHashTablePut(&lkht, "key4", &value3), UTILS_STATUS_FULL);
+    /* Chains hold more items than buckets */
+    assert_int_equal(lkHashTablePut(&lkht, "key4", &value3), UTILS_STATUS_SUCCESS);
+    assert_int_equal(lkht.items, 4);
+    assert_int_equal(lkht.size, 4);
+    assert_int_equal(lkHashTableGet(&lkht, "key4", &out_value, LKHT_REMOVE_ITEM), UTILS_STATUS_SUCCESS);
     assert_int_equal(lkht.items, 3);
     assert_int_equal(lkHashTableGet(&lkht, "key1", &out_value, LKHT_REMOVE_ITEM), UTILS_STATUS_SUCCESS);
     assert_int_equal(out_value, value1);
@@ -134,39 +139,254 @@ static void test_lkHashTablePutAndGet(void** state) {
     assert_int_equal(out_value, value3);
     assert_int_equal(lkht.items, 1);
     assert_int_equal(lkHashTableGet(&lkht, "key2", &out_value, LKHT_DO_NOT_REMOVE_ITEM), UTILS_STATUS_BUCKET_EMPTY);
-    assert_int_equal(lkHashTableGet(&lkht, "key4", &out_value, LKHT_DO_NOT_REMOVE_ITEM), UTILS_STATUS_ERROR);
+    assert_int_not_equal(lkHashTableGet(&lkht, "key4", &out_value, LKHT_DO_NOT_REMOVE_ITEM), UTILS_STATUS_SUCCESS);
     assert_int_equal(lkHashTableGet(&lkht, "key3", &out_value, LKHT_REMOVE_ITEM), UTILS_STATUS_SUCCESS);
     assert_int_equal(out_value, value3);
     assert_int_equal(lkht.items, 0);
     assert_int_equal(lkHashTableGet(&lkht, "key3", &out_value, LKHT_REMOVE_ITEM), UTILS_STATUS_EMPTY);
-    /* Check malloc / calloc fail  */
-    callocFail = 0;
+    /* Check malloc fail of keys that don't fit pooled entries, removed entries are reused */
     skipAssert = 1;
     mallocFail = 1;
-    assert_int_equal(lkHashTablePut(&lkht, "key2", &value3), UTILS_STATUS_ERROR);
+    assert_int_equal(lkHashTablePut(&lkht, "a key longer than pooled entries", &value3), UTILS_STATUS_ERROR);
+    assert_int_equal(lkHashTablePut(&lkht, "key2", &value3), UTILS_STATUS_SUCCESS);
     mallocFail = 0;
-    callocFail = 1;
-    assert_int_equal(lkHashTablePut(&lkht, "key2", &value3), UTILS_STATUS_ERROR);
-    callocFail = 0;
     skipAssert = 0;
-    /* Check listPush error */
+    assert_int_equal(lkHashTableGet(&lkht, "key2", &out_value, LKHT_REMOVE_ITEM), UTILS_STATUS_SUCCESS);
+    /* Check chained entries */
     mockHash = 1;
-    assert_int_equal(lkHashTablePut(&lkht, "key2", &value3), UTILS_STATUS_SUCCESS);
-    assert_int_equal(lkHashTablePut(&lkht, "key3", &value3), UTILS_STATUS_SUCCESS);
-    assert_int_equal(lkHashTablePut(&lkht, "key4", &value3), UTILS_STATUS_ERROR);
+    assert_int_equal(lkHashTablePut(&lkht, "key2", &value1), UTILS_STATUS_SUCCESS);
+    assert_int_equal(lkHashTablePut(&lkht, "a key longer than pooled entries", &value2), UTILS_STATUS_SUCCESS);
+    assert_int_equal(lkHashTablePut(&lkht, "key4", &value3), UTILS_STATUS_SUCCESS);
+    assert_int_equal(lkHashTableGet(&lkht, "a key longer than pooled entries", &out_value, LKHT_REMOVE_ITEM), UTILS_STATUS_SUCCESS);
+    assert_int_equal(out_value, value2);
+    assert_int_equal(lkHashTableGet(&lkht, "key4", &out_value, LKHT_DO_NOT_REMOVE_ITEM), UTILS_STATUS_SUCCESS);
+    assert_int_equal(out_value, value3);
     assert_int_equal(lkHashTableGet(&lkht, "key2", &out_value, LKHT_REMOVE_ITEM), UTILS_STATUS_SUCCESS);
-    assert_int_equal(lkHashTableGet(&lkht, "key3", &out_value, LKHT_REMOVE_ITEM), UTILS_STATUS_SUCCESS);
+    assert_int_equal(out_value, value1);
+    assert_int_equal(lkHashTableGet(&lkht, "key3", &out_value, LKHT_DO_NOT_REMOVE_ITEM), UTILS_STATUS_ERROR);
+    assert_int_equal(lkHashTableGet(&lkht, "key4", &out_value, LKHT_REMOVE_ITEM), UTILS_STATUS_SUCCESS);
     mockHash = 0;
-    test_free(lkht.entries);
+    assert_int_equal(lkHashTableDelete(&lkht), UTILS_STATUS_SUCCESS);
+    /* Check malloc fail of pool chunks */
+    assert_int_equal(lkHashTableInit(&lkht, sizeof(int), 4, LKHT_NOT_RESIZABLE), UTILS_STATUS_SUCCESS);
+    skipAssert = 1;
+    mallocFail = 1;
+    assert_int_equal(lkHashTablePut(&lkht, "key1", &value1), UTILS_STATUS_ERROR);
+    mallocFail = 0;
+    skipAssert = 0;
+    assert_int_equal(lkht.items, 0);
+    assert_int_equal(lkHashTableDelete(&lkht), UTILS_STATUS_SUCCESS);
+}
+
+static void test_lkHashTableIntegerAndBinaryKeys(void** state) {
+    (void)state; /* unused */
+    lkHashTable_t lkht;
+    int value, out_value;
+    uint8_t binKey1[] = {0x00, 0x01, 0x02}, binKey2[] = {0x00, 0x01, 0x03}, longKey[32] = {0};
+    assert_int_equal(lkHashTableInit(&lkht, sizeof(int), 64, LKHT_RESIZABLE), UTILS_STATUS_SUCCESS);
+    assert_int_equal(lkHashTableGetU32(&lkht, 1, &out_value, LKHT_DO_NOT_REMOVE_ITEM), UTILS_STATUS_EMPTY);
+    assert_int_equal(lkHashTableGetU64(&lkht, 1, &out_value, LKHT_DO_NOT_REMOVE_ITEM), UTILS_STATUS_EMPTY);
+    assert_int_equal(lkHashTableGetBin(&lkht, binKey1, sizeof(binKey1), &out_value, LKHT_DO_NOT_REMOVE_ITEM), UTILS_STATUS_EMPTY);
+    assert_int_equal(lkHashTablePutU32(&lkht, 1, NULL), UTILS_STATUS_ERROR);
+    assert_int_equal(lkHashTablePutU64(&lkht, 1, NULL), UTILS_STATUS_ERROR);
+    /* Integer keys */
+    for (uint32_t ii = 0; ii < 4; ii++) {
+        value = ii * 3;
+        assert_int_equal(lkHashTablePutU32(&lkht, ii, &value), UTILS_STATUS_SUCCESS);
+        value = ii * 5;
+        assert_int_equal(lkHashTablePutU64(&lkht, ((uint64_t)ii << 40) | 7, &value), UTILS_STATUS_SUCCESS);
+    }
+    assert_int_equal(lkht.items, 8);
+    for (uint32_t ii = 0; ii < 4; ii++) {
+        assert_int_equal(lkHashTableGetU32(&lkht, ii, &out_value, LKHT_DO_NOT_REMOVE_ITEM), UTILS_STATUS_SUCCESS);
+        assert_int_equal(out_value, ii * 3);
+        assert_int_equal(lkHashTableGetU64(&lkht, ((uint64_t)ii << 40) | 7, &out_value, LKHT_DO_NOT_REMOVE_ITEM), UTILS_STATUS_SUCCESS);
+        assert_int_equal(out_value, ii * 5);
+    }
+    value = 100;
+    assert_int_equal(lkHashTablePutU32(&lkht, 2, &value), UTILS_STATUS_SUCCESS);
+    assert_int_equal(lkHashTableGetU32(&lkht, 2, &out_value, LKHT_REMOVE_ITEM), UTILS_STATUS_SUCCESS);
+    assert_int_equal(out_value, 100);
+    assert_int_not_equal(lkHashTableGetU32(&lkht, 2, &out_value, LKHT_REMOVE_ITEM), UTILS_STATUS_SUCCESS);
+    assert_int_equal(lkHashTableGetU64(&lkht, 7, &out_value, LKHT_REMOVE_ITEM), UTILS_STATUS_SUCCESS);
+    assert_int_equal(out_value, 0);
+    assert_int_equal(lkht.items, 6);
+    assert_int_equal(lkHashTableFlush(&lkht), UTILS_STATUS_SUCCESS);
+    /* Binary keys can contain NUL bytes, longer keys are allocated */
+    value = 1;
+    assert_int_equal(lkHashTablePutBin(&lkht, NULL, 3, &value), UTILS_STATUS_ERROR);
+    assert_int_equal(lkHashTablePutBin(&lkht, binKey1, 0, &value), UTILS_STATUS_ERROR);
+    assert_int_equal(lkHashTablePutBin(&lkht, binKey1, sizeof(binKey1), NULL), UTILS_STATUS_ERROR);
+    assert_int_equal(lkHashTablePutBin(&lkht, binKey1, sizeof(binKey1), &value), UTILS_STATUS_SUCCESS);
+    value = 2;
+    assert_int_equal(lkHashTablePutBin(&lkht, binKey2, sizeof(binKey2), &value), UTILS_STATUS_SUCCESS);
+    value = 3;
+    assert_int_equal(lkHashTablePutBin(&lkht, longKey, sizeof(longKey), &value), UTILS_STATUS_SUCCESS);
+    skipAssert = 1;
+    mallocFail = 1;
+    longKey[31] = 1;
+    assert_int_equal(lkHashTablePutBin(&lkht, longKey, sizeof(longKey), &value), UTILS_STATUS_ERROR);
+    mallocFail = 0;
+    skipAssert = 0;
+    assert_int_equal(lkht.items, 3);
+    assert_int_equal(lkHashTableGetBin(&lkht, NULL, 3, &out_value, LKHT_DO_NOT_REMOVE_ITEM), UTILS_STATUS_ERROR);
+    assert_int_equal(lkHashTableGetBin(&lkht, binKey1, 0, &out_value, LKHT_DO_NOT_REMOVE_ITEM), UTILS_STATUS_ERROR);
+    assert_int_not_equal(lkHashTableGetBin(&lkht, longKey, sizeof(longKey), &out_value, LKHT_DO_NOT_REMOVE_ITEM), UTILS_STATUS_SUCCESS);
+    longKey[31] = 0;
+    assert_int_equal(lkHashTableGetBin(&lkht, longKey, sizeof(longKey), &out_value, LKHT_REMOVE_ITEM), UTILS_STATUS_SUCCESS);
+    assert_int_equal(out_value, 3);
+    assert_int_equal(lkHashTableGetBin(&lkht, binKey1, sizeof(binKey1), &out_value, LKHT_DO_NOT_REMOVE_ITEM), UTILS_STATUS_SUCCESS);
+    assert_int_equal(out_value, 1);
+    assert_int_equal(lkHashTableGetBin(&lkht, binKey2, sizeof(binKey2), &out_value, LKHT_REMOVE_ITEM), UTILS_STATUS_SUCCESS);
+    assert_int_equal(out_value, 2);
+    assert_int_equal(lkht.items, 1);
+    lkHashTableDelete(&lkht);
+}
+
+static void test_lkHashTableGetRefAndGetOrInsert(void** state) {
+    (void)state; /* unused */
+    lkHashTable_t lkht;
+    int out_value;
+    void* ref;
+    void* ref2;
+    uint8_t inserted;
+    char* words[] = {"a", "b", "a", "c", "a", "b"};
+    uint8_t binKey[] = {0x00, 0x01};
+    assert_int_equal(lkHashTableInit(&lkht, sizeof(int), 64, LKHT_RESIZABLE), UTILS_STATUS_SUCCESS);
+    assert_int_equal(lkHashTableGetRef(&lkht, "a", &ref), UTILS_STATUS_EMPTY);
+    assert_int_equal(lkHashTableGetRefBin(&lkht, binKey, sizeof(binKey), &ref), UTILS_STATUS_EMPTY);
+    assert_int_equal(lkHashTableGetRefU32(&lkht, 1, &ref), UTILS_STATUS_EMPTY);
+    assert_int_equal(lkHashTableGetRefU64(&lkht, 1, &ref), UTILS_STATUS_EMPTY);
+    assert_int_equal(lkHashTableGetOrInsert(&lkht, NULL, &ref, NULL), UTILS_STATUS_ERROR);
+    assert_int_equal(lkHashTableGetOrInsert(&lkht, "a", NULL, NULL), UTILS_STATUS_ERROR);
+    /* Counters are updated in place */
+    for (uint8_t ii = 0; ii < 6; ii++) {
+        assert_int_equal(lkHashTableGetOrInsert(&lkht, words[ii], &ref, &inserted), UTILS_STATUS_SUCCESS);
+        assert_int_equal(inserted, (ii < 2) || (ii == 3));
+        (*(int*)ref)++;
+    }
+    assert_int_equal(lkht.items, 3);
+    assert_int_equal(lkHashTableGet(&lkht, "a", &out_value, LKHT_DO_NOT_REMOVE_ITEM), UTILS_STATUS_SUCCESS);
+    assert_int_equal(out_value, 3);
+    assert_int_equal(lkHashTableGetRef(&lkht, "b", &ref), UTILS_STATUS_SUCCESS);
+    assert_int_equal(*(int*)ref, 2);
+    assert_int_not_equal(lkHashTableGetRef(&lkht, "d", &ref2), UTILS_STATUS_SUCCESS);
+    /* Values are never moved, so references survive other insertions */
+    assert_int_equal(lkHashTableGetOrInsertU32(&lkht, 1, NULL, NULL), UTILS_STATUS_ERROR);
+    assert_int_equal(lkHashTableGetOrInsertU32(&lkht, 1, &ref2, &inserted), UTILS_STATUS_SUCCESS);
+    assert_int_equal(inserted, 1);
+    *(int*)ref2 = 10;
+    assert_int_equal(lkHashTableGetOrInsertU64(&lkht, 1, NULL, NULL), UTILS_STATUS_ERROR);
+    assert_int_equal(lkHashTableGetOrInsertU64(&lkht, 1ULL << 40, &ref2, &inserted), UTILS_STATUS_SUCCESS);
+    assert_int_equal(*(int*)ref2, 0);
+    *(int*)ref2 = 20;
+    assert_int_equal(lkHashTableGetOrInsertBin(&lkht, binKey, 0, &ref2, NULL), UTILS_STATUS_ERROR);
+    assert_int_equal(lkHashTableGetOrInsertBin(&lkht, binKey, sizeof(binKey), &ref2, NULL), UTILS_STATUS_SUCCESS);
+    *(int*)ref2 = 30;
+    assert_int_equal(*(int*)ref, 2);
+    assert_int_equal(lkHashTableGetRefU32(&lkht, 1, &ref), UTILS_STATUS_SUCCESS);
+    assert_int_equal(*(int*)ref, 10);
+    assert_int_equal(lkHashTableGetRefU64(&lkht, 1ULL << 40, &ref), UTILS_STATUS_SUCCESS);
+    assert_int_equal(*(int*)ref, 20);
+    assert_int_equal(lkHashTableGetRefBin(&lkht, NULL, sizeof(binKey), &ref), UTILS_STATUS_ERROR);
+    assert_int_equal(lkHashTableGetRefBin(&lkht, binKey, sizeof(binKey), &ref), UTILS_STATUS_SUCCESS);
+    assert_int_equal(*(int*)ref, 30);
+    assert_int_equal(lkHashTableGetOrInsertBin(&lkht, binKey, sizeof(binKey), &ref, &inserted), UTILS_STATUS_SUCCESS);
+    assert_int_equal(inserted, 0);
+    lkHashTableDelete(&lkht);
+    /* Single bucket */
+    assert_int_equal(lkHashTableInit(&lkht, sizeof(int), 1, LKHT_NOT_RESIZABLE), UTILS_STATUS_SUCCESS);
+    assert_int_equal(lkHashTableGetOrInsert(&lkht, "a", &ref, NULL), UTILS_STATUS_SUCCESS);
+    assert_int_equal(lkHashTableGetOrInsert(&lkht, "a", &ref, NULL), UTILS_STATUS_SUCCESS);
+    assert_int_equal(lkHashTableGetOrInsert(&lkht, "b", &ref, NULL), UTILS_STATUS_SUCCESS);
+    assert_int_equal(lkht.items, 2);
+    assert_int_equal(lkht.size, 1);
+    /* Entries found are moved to the head of the bucket (keys have different lengths to tell entries apart) */
+    assert_int_equal(lkHashTablePut(&lkht, "ccc", &out_value), UTILS_STATUS_SUCCESS);
+    assert_int_equal(lkht.entries[0]->keyLen, 2);
+    assert_int_equal(lkHashTableGetRef(&lkht, "ccc", &ref), UTILS_STATUS_SUCCESS);
+    assert_int_equal(lkht.entries[0]->keyLen, 4);
+    assert_int_equal(lkHashTablePut(&lkht, "b", &out_value), UTILS_STATUS_SUCCESS);
+    assert_int_equal(lkht.entries[0]->keyLen, 2);
+    assert_int_equal(lkht.entries[0]->next->keyLen, 4);
+    assert_int_equal(lkHashTableGet(&lkht, "a", &out_value, LKHT_REMOVE_ITEM), UTILS_STATUS_SUCCESS);
+    assert_int_equal(lkht.entries[0]->keyLen, 2);
+    assert_int_equal(lkht.entries[0]->next->keyLen, 4);
+    assert_null(lkht.entries[0]->next->next);
+    assert_int_equal(lkHashTableGetRef(&lkht, "d", &ref), UTILS_STATUS_ERROR);
+    lkHashTableDelete(&lkht);
+}
+
+static void test_lkHashTableResize(void** state) {
+    (void)state; /* unused */
+    lkHashTable_t lkht;
+    char key[16];
+    int value, out_value;
+    assert_int_equal(lkHashTableInit(&lkht, sizeof(int), 2, LKHT_RESIZABLE), UTILS_STATUS_SUCCESS);
+    /* Buckets grow with items, so that chains stay short */
+    for (value = 0; value < 100; value++) {
+        snprintf(key, sizeof(key), "key%d", value);
+        assert_int_equal(lkHashTablePut(&lkht, key, &value), UTILS_STATUS_SUCCESS);
+        assert_true(lkht.items <= lkht.size);
+    }
+    assert_int_equal(lkht.size, 128);
+    for (value = 0; value < 100; value++) {
+        snprintf(key, sizeof(key), "key%d", value);
+        assert_int_equal(lkHashTableGet(&lkht, key, &out_value, LKHT_DO_NOT_REMOVE_ITEM), UTILS_STATUS_SUCCESS);
+        assert_int_equal(out_value, value);
+    }
+    /* Failed resizes leave longer chains */
+    skipAssert = 1;
+    callocFail = 1;
+    for (value = 100; value < 129; value++) {
+        snprintf(key, sizeof(key), "key%d", value);
+        assert_int_equal(lkHashTablePut(&lkht, key, &value), (value < 128) ? UTILS_STATUS_SUCCESS : UTILS_STATUS_WARNING);
+    }
+    assert_int_equal(lkht.size, 128);
+    for (value = 128; value >= 25; value--) {
+        snprintf(key, sizeof(key), "key%d", value);
+        assert_int_equal(lkHashTableGet(&lkht, key, &out_value, LKHT_REMOVE_ITEM), (value > 25) ? UTILS_STATUS_SUCCESS : UTILS_STATUS_WARNING);
+        assert_int_equal(out_value, value);
+    }
+    callocFail = 0;
+    skipAssert = 0;
+    /* Buckets shrink with items, down to LKHT_MIN_SIZE */
+    for (value = 24; value >= 0; value--) {
+        snprintf(key, sizeof(key), "key%d", value);
+        assert_int_equal(lkHashTableGet(&lkht, key, &out_value, LKHT_REMOVE_ITEM), UTILS_STATUS_SUCCESS);
+        assert_int_equal(out_value, value);
+        assert_true((lkht.items >= (lkht.size / 8)) || (lkht.size == 2));
+    }
+    assert_int_equal(lkht.size, 2);
+    assert_int_equal(lkht.items, 0);
+    value = 0;
+    assert_int_equal(lkHashTablePut(&lkht, "key0", &value), UTILS_STATUS_SUCCESS);
+    assert_int_equal(lkHashTableGet(&lkht, "key0", &out_value, LKHT_REMOVE_ITEM), UTILS_STATUS_SUCCESS);
+    assert_int_equal(lkht.size, 2);
+    assert_int_equal(lkHashTableDelete(&lkht), UTILS_STATUS_SUCCESS);
+    /* Buckets don't grow past LKHT_MAX_SIZE */
+    assert_int_equal(lkHashTableInit(&lkht, sizeof(int), 1000, LKHT_RESIZABLE), UTILS_STATUS_SUCCESS);
+    assert_int_equal(lkht.size, 256);
+    for (value = 0; value < 300; value++) {
+        snprintf(key, sizeof(key), "key%d", value);
+        assert_int_equal(lkHashTablePut(&lkht, key, &value), UTILS_STATUS_SUCCESS);
+    }
+    assert_int_equal(lkht.size, 256);
+    for (value = 0; value < 300; value++) {
+        snprintf(key, sizeof(key), "key%d", value);
+        assert_int_equal(lkHashTableGet(&lkht, key, &out_value, LKHT_DO_NOT_REMOVE_ITEM), UTILS_STATUS_SUCCESS);
+        assert_int_equal(out_value, value);
+    }
+    assert_int_equal(lkHashTableDelete(&lkht), UTILS_STATUS_SUCCESS);
 }
 
 static void test_lkHashTableInfo(void** state) {
     (void)state; /* unused */
     lkHashTable_t lkht;
-    assert_int_equal(lkHashTableInit(&lkht, sizeof(int), 10), UTILS_STATUS_SUCCESS);
+    assert_int_equal(lkHashTableInit(&lkht, sizeof(int), 10, LKHT_RESIZABLE), UTILS_STATUS_SUCCESS);
     uint32_t size, items;
     lkHashTableInfo(&lkht, &size, &items);
-    assert_int_equal(size, 10);
+    assert_int_equal(size, 16);
     assert_int_equal(items, 0);
     int value = 42;
     lkHashTablePut(&lkht, "key1", &value);
@@ -175,10 +395,39 @@ static void test_lkHashTableInfo(void** state) {
     lkHashTableDelete(&lkht);
 }
 
+static void test_lkHashTableStats(void** state) {
+    (void)state; /* unused */
+    lkHashTable_t lkht;
+    lkHashTableStats_t stats;
+    int value = 42;
+    assert_int_equal(lkHashTableInit(&lkht, sizeof(int), 4, LKHT_NOT_RESIZABLE), UTILS_STATUS_SUCCESS);
+    lkHashTableStats(&lkht, &stats);
+    assert_int_equal(stats.chainHist[0], 4);
+    assert_int_equal(stats.maxChain, 0);
+    assert_float_equal(stats.avgChain, 0.0, 1e-5);
+    /* Three keys in bucket 1 and one in bucket 2 */
+    mockHash = 1;
+    assert_int_equal(lkHashTablePut(&lkht, "a", &value), UTILS_STATUS_SUCCESS);
+    assert_int_equal(lkHashTablePut(&lkht, "b", &value), UTILS_STATUS_SUCCESS);
+    assert_int_equal(lkHashTablePut(&lkht, "c", &value), UTILS_STATUS_SUCCESS);
+    mockHash = 2;
+    assert_int_equal(lkHashTablePut(&lkht, "d", &value), UTILS_STATUS_SUCCESS);
+    mockHash = 0;
+    lkHashTableStats(&lkht, &stats);
+    assert_int_equal(stats.chainHist[0], 2);
+    assert_int_equal(stats.chainHist[1], 1);
+    assert_int_equal(stats.chainHist[2], 0);
+    assert_int_equal(stats.chainHist[3], 1);
+    assert_int_equal(stats.maxChain, 3);
+    assert_float_equal(stats.avgChain, 2.0, 1e-5);
+    assert_float_equal(stats.avgProbe, 1.75, 1e-5);
+    assert_int_equal(lkHashTableDelete(&lkht), UTILS_STATUS_SUCCESS);
+}
+
 static void test_lkHashTableFlush(void** state) {
     (void)state; /* unused */
     lkHashTable_t lkht;
-    assert_int_equal(lkHashTableInit(&lkht, sizeof(int), 10), UTILS_STATUS_SUCCESS);
+    assert_int_equal(lkHashTableInit(&lkht, sizeof(int), 10, LKHT_RESIZABLE), UTILS_STATUS_SUCCESS);
     int value1 = 42;
     int value2 = 43;
     assert_int_equal(lkHashTablePut(&lkht, "key1", &value1), UTILS_STATUS_SUCCESS);
@@ -187,15 +436,16 @@ static void test_lkHashTableFlush(void** state) {
     assert_int_equal(lkHashTableFlush(&lkht), UTILS_STATUS_SUCCESS);
     assert_int_equal(lkht.items, 0);
     for (uint32_t i = 0; i < lkht.size; i++) {
-        assert_int_equal(lkht.entries[i].items, 0);
+        assert_null(lkht.entries[i]);
     }
-    test_free(lkht.entries);
+    assert_int_equal(lkHashTablePut(&lkht, "key1", &value1), UTILS_STATUS_SUCCESS);
+    assert_int_equal(lkHashTableDelete(&lkht), UTILS_STATUS_SUCCESS);
 }
 
 static void test_lkHashTableDelete(void** state) {
     (void)state; /* unused */
     lkHashTable_t lkht;
-    assert_int_equal(lkHashTableInit(&lkht, sizeof(int), 10), UTILS_STATUS_SUCCESS);
+    assert_int_equal(lkHashTableInit(&lkht, sizeof(int), 10, LKHT_RESIZABLE), UTILS_STATUS_SUCCESS);
     assert_int_equal(lkHashTableDelete(&lkht), UTILS_STATUS_SUCCESS);
     /* Check null deletion */
     lkht.entries = NULL;
@@ -204,7 +454,10 @@ static void test_lkHashTableDelete(void** state) {
 
 int main(void) {
     const struct CMUnitTest test_LKHashTable[] = {cmocka_unit_test(test_lkHashTableInit), cmocka_unit_test(test_lkHashTablePutAndGet),
-                                                  cmocka_unit_test(test_lkHashTableInfo), cmocka_unit_test(test_lkHashTableFlush),
+                                                  cmocka_unit_test(test_lkHashTableIntegerAndBinaryKeys),
+                                                  cmocka_unit_test(test_lkHashTableGetRefAndGetOrInsert), cmocka_unit_test(test_lkHashTableResize),
+                                                  cmocka_unit_test(test_lkHashTableInfo), cmocka_unit_test(test_lkHashTableStats),
+                                                  cmocka_unit_test(test_lkHashTableFlush),
                                                   cmocka_unit_test(test_lkHashTableDelete)};
 
     return cmocka_run_group_tests(test_LKHashTable, NULL, NULL);
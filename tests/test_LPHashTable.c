@@ -34,11 +34,14 @@
 /* Includes ------------------------------------------------------------------*/
 
 #include <setjmp.h>
+#include <signal.h>
 #include <stdarg.h>
 #include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
 #include <stdio.h>
+#include <string.h>
+#include <sys/resource.h>
 #include "LPHashTable.h"
 #include "hashFunctions.h"
 
@@ -47,8 +50,10 @@
 /* Support functions ---------------------------------------------------------*/
 
 static uint8_t callocFail = 0;
+static uint32_t allocCalls = 0;
 
 void* ADVUtils_testCalloc(const size_t number_of_elements, const size_t size) {
+    allocCalls++;
     if ((number_of_elements > 0) && !callocFail) {
         return test_calloc(number_of_elements, size);
     } else {
@@ -59,6 +64,7 @@ void* ADVUtils_testCalloc(const size_t number_of_elements, const size_t size) {
 static uint8_t mallocFail = 0;
 
 void* ADVUtils_testMalloc(const size_t size) {
+    allocCalls++;
     if (!mallocFail) {
         return test_malloc(size);
     } else {
@@ -77,8 +83,10 @@ void ADVUtils_testAssert(const int result, const char* const expression, const c
 }
 
 static uint16_t mockHash = 0;
+static uint32_t hashCalls = 0;
 
 uint32_t ADVUtils_testHash(char* key) {
+    hashCalls++;
     if (!mockHash) {
         return hash_FNV1A(key);
     } else {
@@ -86,6 +94,19 @@ uint32_t ADVUtils_testHash(char* key) {
     }
 }
 
+static lpHashTableEntry_t* slot(lpHashTable_t* lpht, uint32_t ii) { return (lpHashTableEntry_t*)(lpht->entries + ii * lpht->_slotSize); }
+
+static char* slotKey(lpHashTable_t* lpht, uint32_t ii) {
+    lpHashTableEntry_t* entry = slot(lpht, ii);
+    char* key = (char*)(entry + 1);
+    if (!entry->keyLen) {
+        return NULL;
+    } else if (entry->keyLen > lpht->_keySize) {
+        memcpy(&key, entry + 1, sizeof(char*));
+    }
+    return key;
+}
+
 /* Functions -----------------------------------------------------------------*/
 
 static void test_lpHashTableInit(void** state) {
@@ -169,10 +190,13 @@ static void test_lpHashTablePutAndGetResizeable(void** state) {
     assert_int_equal(lpht.size, LPHT_MIN_SIZE << 1);
     mockHash = 7;
     assert_int_equal(lpHashTablePut(&lpht, "key3", &value1), UTILS_STATUS_SUCCESS);
+    /* Keys are compared only if hash matches, so each key must be searched with its own hash */
+    mockHash = 0;
     assert_int_equal(lpHashTableGet(&lpht, "key1", &out_value, LPHT_REMOVE_ITEM), UTILS_STATUS_SUCCESS);
     assert_int_equal(out_value, value1);
     assert_int_equal(lpHashTableGet(&lpht, "key2", &out_value, LPHT_REMOVE_ITEM), UTILS_STATUS_SUCCESS);
     assert_int_equal(out_value, value1);
+    mockHash = 7;
     assert_int_equal(lpHashTableGet(&lpht, "key3", &out_value, LPHT_REMOVE_ITEM), UTILS_STATUS_SUCCESS);
     assert_int_equal(out_value, value1);
     mockHash = 0;
@@ -244,19 +268,19 @@ static void test_lpHashTablePutAndGetNotResizeable(void** state) {
     assert_int_equal(lpHashTablePut(&lpht, "key2", &value2), UTILS_STATUS_SUCCESS);
     assert_int_equal(lpHashTablePut(&lpht, "key3", &value2), UTILS_STATUS_SUCCESS);
     assert_int_equal(lpHashTablePut(&lpht, "key4", &value2), UTILS_STATUS_SUCCESS);
-    assert_string_equal(lpht.entries[2].key, "key1");
-    assert_string_equal(lpht.entries[3].key, "key2");
-    assert_string_equal(lpht.entries[0].key, "key3");
-    assert_string_equal(lpht.entries[1].key, "key4");
+    assert_string_equal(slotKey(&lpht, 2), "key1");
+    assert_string_equal(slotKey(&lpht, 3), "key2");
+    assert_string_equal(slotKey(&lpht, 0), "key3");
+    assert_string_equal(slotKey(&lpht, 1), "key4");
     /* Check that setEntry works in case of same hash when the first item with the same hash has been removed */
     assert_int_equal(lpHashTableGet(&lpht, "key1", &out_value, LPHT_REMOVE_ITEM), UTILS_STATUS_SUCCESS);
     assert_int_equal(out_value, value1);
     assert_int_equal(lpHashTablePut(&lpht, "key2", &value1), UTILS_STATUS_SUCCESS);
     assert_int_equal(lpht.items, 3);
-    assert_string_equal(lpht.entries[0].key, "key4");
-    assert_null(lpht.entries[1].key);
-    assert_string_equal(lpht.entries[2].key, "key2");
-    assert_string_equal(lpht.entries[3].key, "key3");
+    assert_string_equal(slotKey(&lpht, 0), "key4");
+    assert_null(slotKey(&lpht, 1));
+    assert_string_equal(slotKey(&lpht, 2), "key2");
+    assert_string_equal(slotKey(&lpht, 3), "key3");
     assert_int_equal(lpHashTableGet(&lpht, "key2", &out_value, LPHT_REMOVE_ITEM), UTILS_STATUS_SUCCESS);
     assert_int_equal(out_value, value1);
     assert_int_equal(lpHashTableGet(&lpht, "key3", &out_value, LPHT_REMOVE_ITEM), UTILS_STATUS_SUCCESS);
@@ -265,19 +289,802 @@ static void test_lpHashTablePutAndGetNotResizeable(void** state) {
     assert_int_equal(out_value, value2);
     mockHash = 0;
     assert_int_equal(lpht.items, 0);
-    /* Check malloc / calloc fail  */
-    callocFail = 0;
+    /* Check malloc fail for keys that need overflow storage, short keys need no allocation */
     skipAssert = 1;
     mallocFail = 1;
-    assert_int_equal(lpHashTablePut(&lpht, "key2", &value1), UTILS_STATUS_ERROR);
-    mallocFail = 0;
     callocFail = 1;
-    assert_int_equal(lpHashTablePut(&lpht, "key2", &value1), UTILS_STATUS_ERROR);
+    assert_int_equal(lpHashTablePut(&lpht, "key2_with_a_long_name_for_overflow", &value1), UTILS_STATUS_ERROR);
+    assert_int_equal(lpht.items, 0);
+    assert_int_equal(lpHashTablePut(&lpht, "key2", &value1), UTILS_STATUS_SUCCESS);
+    mallocFail = 0;
     callocFail = 0;
     skipAssert = 0;
+    assert_int_equal(lpHashTableGet(&lpht, "key2", &out_value, LPHT_REMOVE_ITEM), UTILS_STATUS_SUCCESS);
     test_free(lpht.entries);
 }
 
+static void test_lpHashTableHashCaching(void** state) {
+    (void)state; /* unused */
+    lpHashTable_t lpht;
+    int value1 = 42, value2 = 43;
+    int out_value;
+    assert_int_equal(lpHashTableInit(&lpht, sizeof(int), 4, LPHT_RESIZABLE), UTILS_STATUS_SUCCESS);
+    /* Each operation hashes the key once, resizing and entries replacement reuse the stored hash */
+    hashCalls = 0;
+    assert_int_equal(lpHashTablePut(&lpht, "key1", &value1), UTILS_STATUS_SUCCESS);
+    assert_int_equal(lpHashTablePut(&lpht, "key2", &value2), UTILS_STATUS_SUCCESS);
+    assert_int_equal(lpHashTablePut(&lpht, "key3", &value2), UTILS_STATUS_SUCCESS);
+    assert_int_equal(lpht.size, 8);
+    assert_int_equal(hashCalls, 3);
+    for (uint32_t ii = 0; ii < lpht.size; ii++) {
+        if (slotKey(&lpht, ii) != NULL) {
+            assert_int_equal(slot(&lpht, ii)->hash, hash_FNV1A(slotKey(&lpht, ii)));
+        }
+    }
+    hashCalls = 0;
+    assert_int_equal(lpHashTableGet(&lpht, "key1", &out_value, LPHT_REMOVE_ITEM), UTILS_STATUS_SUCCESS);
+    assert_int_equal(out_value, value1);
+    assert_int_equal(lpHashTableGet(&lpht, "key2", &out_value, LPHT_REMOVE_ITEM), UTILS_STATUS_SUCCESS);
+    assert_int_equal(out_value, value2);
+    assert_int_equal(lpht.size, 4);
+    assert_int_equal(hashCalls, 2);
+    /* Same hash but different keys are told apart by the key comparison */
+    mockHash = 1;
+    assert_int_equal(lpHashTablePut(&lpht, "key4", &value1), UTILS_STATUS_SUCCESS);
+    assert_int_equal(lpHashTablePut(&lpht, "key5", &value2), UTILS_STATUS_SUCCESS);
+    assert_int_equal(lpHashTableGet(&lpht, "key5", &out_value, LPHT_DO_NOT_REMOVE_ITEM), UTILS_STATUS_SUCCESS);
+    assert_int_equal(out_value, value2);
+    assert_int_equal(lpHashTableGet(&lpht, "key6", &out_value, LPHT_DO_NOT_REMOVE_ITEM), UTILS_STATUS_ERROR);
+    mockHash = 0;
+    assert_int_equal(lpHashTableGet(&lpht, "key3", &out_value, LPHT_DO_NOT_REMOVE_ITEM), UTILS_STATUS_SUCCESS);
+    assert_int_equal(out_value, value2);
+    lpHashTableDelete(&lpht);
+}
+
+static void test_lpHashTableInlineStorage(void** state) {
+    (void)state; /* unused */
+    lpHashTable_t lpht;
+    lpHashTableStats_t stats;
+    int value[8] = {1, 2, 3, 4, 5, 6, 7, 8};
+    int out_value[8];
+    char key[48];
+    assert_int_equal(lpHashTableInit(&lpht, sizeof(value), 64, LPHT_NOT_RESIZABLE), UTILS_STATUS_SUCCESS);
+    /* Short keys and values are stored inside the slots */
+    allocCalls = 0;
+    for (uint8_t ii = 0; ii < 8; ii++) {
+        snprintf(key, sizeof(key), "key%d", ii);
+        value[0] = ii;
+        assert_int_equal(lpHashTablePut(&lpht, key, value), UTILS_STATUS_SUCCESS);
+    }
+    assert_int_equal(allocCalls, 0);
+    assert_null(lpht._arena);
+    for (uint8_t ii = 0; ii < 8; ii++) {
+        snprintf(key, sizeof(key), "key%d", ii);
+        assert_int_equal(lpHashTableGet(&lpht, key, out_value, LPHT_DO_NOT_REMOVE_ITEM), UTILS_STATUS_SUCCESS);
+        assert_int_equal(out_value[0], ii);
+        assert_int_equal(out_value[7], 8);
+    }
+    /* Long keys share overflow storage chunks */
+    for (uint8_t ii = 0; ii < 30; ii++) {
+        snprintf(key, sizeof(key), "a_key_long_enough_to_go_to_overflow_%d", ii);
+        value[0] = 100 + ii;
+        assert_int_equal(lpHashTablePut(&lpht, key, value), UTILS_STATUS_SUCCESS);
+    }
+    assert_int_equal(lpht.items, 38);
+    assert_int_equal(allocCalls, 2);
+    assert_int_equal(lpht._arenaUsed, lpht._arenaLive);
+    /* Update of a long key doesn't allocate */
+    value[0] = 42;
+    assert_int_equal(lpHashTablePut(&lpht, "a_key_long_enough_to_go_to_overflow_7", value), UTILS_STATUS_SUCCESS);
+    assert_int_equal(allocCalls, 2);
+    assert_int_equal(lpHashTableGet(&lpht, "a_key_long_enough_to_go_to_overflow_7", out_value, LPHT_DO_NOT_REMOVE_ITEM), UTILS_STATUS_SUCCESS);
+    assert_int_equal(out_value[0], 42);
+    /* Overflow storage is kept as it is if compaction cannot allocate */
+    mallocFail = 1;
+    for (uint8_t ii = 1; ii < 28; ii++) {
+        snprintf(key, sizeof(key), "a_key_long_enough_to_go_to_overflow_%d", ii);
+        assert_int_equal(lpHashTableGet(&lpht, key, out_value, LPHT_REMOVE_ITEM), UTILS_STATUS_SUCCESS);
+        assert_int_equal(out_value[0], ii == 7 ? 42 : 100 + ii);
+    }
+    mallocFail = 0;
+    assert_non_null(lpht._arena->next);
+    assert_true((lpht._arenaUsed - lpht._arenaLive) > lpht._arenaLive);
+    lpHashTableStats(&lpht, &stats);
+    assert_int_equal(stats.compactCount, 0);
+    /* Removing most long keys compacts the overflow storage in a single chunk */
+    for (uint8_t ii = 28; ii < 30; ii++) {
+        snprintf(key, sizeof(key), "a_key_long_enough_to_go_to_overflow_%d", ii);
+        assert_int_equal(lpHashTableGet(&lpht, key, out_value, LPHT_REMOVE_ITEM), UTILS_STATUS_SUCCESS);
+        assert_int_equal(out_value[0], 100 + ii);
+    }
+    assert_non_null(lpht._arena);
+    assert_null(lpht._arena->next);
+    assert_int_equal(lpht._arenaLive, strlen("a_key_long_enough_to_go_to_overflow_0") + 1);
+    assert_true(lpht._arena->size < 1024);
+    lpHashTableStats(&lpht, &stats);
+    assert_true(stats.compactCount > 0);
+    assert_int_equal(lpHashTableGet(&lpht, "a_key_long_enough_to_go_to_overflow_0", out_value, LPHT_DO_NOT_REMOVE_ITEM), UTILS_STATUS_SUCCESS);
+    assert_int_equal(out_value[0], 100);
+    /* Overflow storage is released once the last long key is removed */
+    assert_int_equal(lpHashTableGet(&lpht, "a_key_long_enough_to_go_to_overflow_0", out_value, LPHT_REMOVE_ITEM), UTILS_STATUS_SUCCESS);
+    assert_null(lpht._arena);
+    assert_int_equal(lpht._arenaUsed, 0);
+    assert_int_equal(lpHashTablePut(&lpht, "a_key_long_enough_to_go_to_overflow_0", value), UTILS_STATUS_SUCCESS);
+    assert_int_equal(lpht.items, 9);
+    lpHashTableDelete(&lpht);
+}
+
+static void test_lpHashTableRobinHood(void** state) {
+    (void)state; /* unused */
+    lpHashTable_t lpht;
+    int value = 42;
+    int out_value;
+    assert_int_equal(lpHashTableInit(&lpht, sizeof(int), 8, LPHT_NOT_RESIZABLE), UTILS_STATUS_SUCCESS);
+    /* Entry farther from its home slot takes the place of the closer one */
+    mockHash = 1;
+    assert_int_equal(lpHashTablePut(&lpht, "a", &value), UTILS_STATUS_SUCCESS);
+    assert_int_equal(lpHashTablePut(&lpht, "b", &value), UTILS_STATUS_SUCCESS);
+    mockHash = 2;
+    assert_int_equal(lpHashTablePut(&lpht, "c", &value), UTILS_STATUS_SUCCESS);
+    mockHash = 1;
+    assert_int_equal(lpHashTablePut(&lpht, "d", &value), UTILS_STATUS_SUCCESS);
+    assert_string_equal(slotKey(&lpht, 1), "a");
+    assert_string_equal(slotKey(&lpht, 2), "b");
+    assert_string_equal(slotKey(&lpht, 3), "d");
+    assert_string_equal(slotKey(&lpht, 4), "c");
+    assert_int_equal(slot(&lpht, 1)->dist, 0);
+    assert_int_equal(slot(&lpht, 2)->dist, 1);
+    assert_int_equal(slot(&lpht, 3)->dist, 2);
+    assert_int_equal(slot(&lpht, 4)->dist, 2);
+    /* Lookup miss */
+    assert_int_equal(lpHashTableGet(&lpht, "e", &out_value, LPHT_DO_NOT_REMOVE_ITEM), UTILS_STATUS_ERROR);
+    /* Backward-shift deletion */
+    assert_int_equal(lpHashTableGet(&lpht, "a", &out_value, LPHT_REMOVE_ITEM), UTILS_STATUS_SUCCESS);
+    assert_string_equal(slotKey(&lpht, 1), "b");
+    assert_string_equal(slotKey(&lpht, 2), "d");
+    assert_string_equal(slotKey(&lpht, 3), "c");
+    assert_null(slotKey(&lpht, 4));
+    assert_int_equal(slot(&lpht, 1)->dist, 0);
+    assert_int_equal(slot(&lpht, 2)->dist, 1);
+    assert_int_equal(slot(&lpht, 3)->dist, 1);
+    mockHash = 2;
+    assert_int_equal(lpHashTableGet(&lpht, "c", &out_value, LPHT_REMOVE_ITEM), UTILS_STATUS_SUCCESS);
+    mockHash = 1;
+    assert_int_equal(lpHashTableGet(&lpht, "d", &out_value, LPHT_REMOVE_ITEM), UTILS_STATUS_SUCCESS);
+    assert_int_equal(lpHashTableGet(&lpht, "b", &out_value, LPHT_REMOVE_ITEM), UTILS_STATUS_SUCCESS);
+    mockHash = 0;
+    assert_int_equal(lpht.items, 0);
+    test_free(lpht.entries);
+
+    /* Random operations, checking stored distances and contents against a reference */
+    int reference[12];
+    uint32_t seed = 1;
+    char key[4];
+    assert_int_equal(lpHashTableInit(&lpht, sizeof(int), 4, LPHT_RESIZABLE), UTILS_STATUS_SUCCESS);
+    for (uint8_t ii = 0; ii < 12; ii++) {
+        reference[ii] = -1;
+    }
+    for (uint16_t op = 0; op < 500; op++) {
+        seed = seed * 1664525u + 1013904223u;
+        uint8_t idx = (seed >> 16) % 12;
+        snprintf(key, sizeof(key), "k%d", idx);
+        if ((seed >> 28) & 1) {
+            value = op;
+            assert_int_equal(lpHashTablePut(&lpht, key, &value), UTILS_STATUS_SUCCESS);
+            reference[idx] = op;
+        } else if (reference[idx] >= 0) {
+            assert_int_equal(lpHashTableGet(&lpht, key, &out_value, LPHT_REMOVE_ITEM), UTILS_STATUS_SUCCESS);
+            assert_int_equal(out_value, reference[idx]);
+            reference[idx] = -1;
+        } else {
+            assert_int_not_equal(lpHashTableGet(&lpht, key, &out_value, LPHT_REMOVE_ITEM), UTILS_STATUS_SUCCESS);
+        }
+        for (uint32_t jj = 0; jj < lpht.size; jj++) {
+            if (slot(&lpht, jj)->keyLen) {
+                uint32_t home = slot(&lpht, jj)->hash & (lpht.size - 1);
+                assert_int_equal(slot(&lpht, jj)->dist, (jj + lpht.size - home) % lpht.size);
+            }
+        }
+    }
+    for (uint8_t ii = 0; ii < 12; ii++) {
+        snprintf(key, sizeof(key), "k%d", ii);
+        if (reference[ii] >= 0) {
+            assert_int_equal(lpHashTableGet(&lpht, key, &out_value, LPHT_DO_NOT_REMOVE_ITEM), UTILS_STATUS_SUCCESS);
+            assert_int_equal(out_value, reference[ii]);
+        }
+    }
+    lpHashTableDelete(&lpht);
+}
+
+static void test_lpHashTableIntegerAndBinaryKeys(void** state) {
+    (void)state; /* unused */
+    lpHashTable_t lpht;
+    int value, out_value;
+    uint8_t binKey1[] = {0x00, 0x01, 0x02}, binKey2[] = {0x00, 0x01, 0x03}, longKey[40] = {0};
+    /* Integer keys are stored inline and never hashed as strings */
+    assert_int_equal(lpHashTableInit(&lpht, sizeof(int), 8, LPHT_RESIZABLE), UTILS_STATUS_SUCCESS);
+    assert_int_equal(lpHashTableGetU32(&lpht, 1, &out_value, LPHT_DO_NOT_REMOVE_ITEM), UTILS_STATUS_EMPTY);
+    assert_int_equal(lpHashTablePutU32(&lpht, 1, NULL), UTILS_STATUS_ERROR);
+    allocCalls = 0;
+    hashCalls = 0;
+    for (uint32_t ii = 0; ii < 16; ii++) {
+        value = ii * 3;
+        assert_int_equal(lpHashTablePutU32(&lpht, ii, &value), UTILS_STATUS_SUCCESS);
+    }
+    assert_int_equal(lpht.items, 16);
+    assert_null(lpht._arena);
+    assert_int_equal(hashCalls, 0);
+    for (uint32_t ii = 0; ii < 16; ii++) {
+        assert_int_equal(lpHashTableGetU32(&lpht, ii, &out_value, LPHT_DO_NOT_REMOVE_ITEM), UTILS_STATUS_SUCCESS);
+        assert_int_equal(out_value, ii * 3);
+    }
+    assert_int_equal(lpHashTableGetU32(&lpht, 16, &out_value, LPHT_DO_NOT_REMOVE_ITEM), UTILS_STATUS_ERROR);
+    value = 100;
+    assert_int_equal(lpHashTablePutU32(&lpht, 5, &value), UTILS_STATUS_SUCCESS);
+    assert_int_equal(lpHashTableGetU32(&lpht, 5, &out_value, LPHT_REMOVE_ITEM), UTILS_STATUS_SUCCESS);
+    assert_int_equal(out_value, 100);
+    assert_int_equal(lpHashTableGetU32(&lpht, 5, &out_value, LPHT_DO_NOT_REMOVE_ITEM), UTILS_STATUS_ERROR);
+    assert_int_equal(lpht.items, 15);
+    lpHashTableDelete(&lpht);
+    /* 64-bit keys differing only in their upper half */
+    assert_int_equal(lpHashTableInit(&lpht, sizeof(int), 8, LPHT_RESIZABLE), UTILS_STATUS_SUCCESS);
+    assert_int_equal(lpHashTableGetU64(&lpht, 1, &out_value, LPHT_DO_NOT_REMOVE_ITEM), UTILS_STATUS_EMPTY);
+    assert_int_equal(lpHashTablePutU64(&lpht, 1, NULL), UTILS_STATUS_ERROR);
+    for (uint64_t ii = 0; ii < 16; ii++) {
+        value = (int)ii;
+        assert_int_equal(lpHashTablePutU64(&lpht, (ii << 40) | 7, &value), UTILS_STATUS_SUCCESS);
+    }
+    assert_int_equal(lpht.items, 16);
+    for (uint64_t ii = 0; ii < 16; ii++) {
+        assert_int_equal(lpHashTableGetU64(&lpht, (ii << 40) | 7, &out_value, LPHT_DO_NOT_REMOVE_ITEM), UTILS_STATUS_SUCCESS);
+        assert_int_equal(out_value, ii);
+    }
+    assert_int_equal(lpHashTableGetU64(&lpht, 7, &out_value, LPHT_REMOVE_ITEM), UTILS_STATUS_SUCCESS);
+    assert_int_equal(out_value, 0);
+    assert_int_equal(lpHashTableGetU64(&lpht, 7, &out_value, LPHT_REMOVE_ITEM), UTILS_STATUS_ERROR);
+    lpHashTableDelete(&lpht);
+    /* Binary keys can contain NUL bytes */
+    assert_int_equal(lpHashTableInit(&lpht, sizeof(int), 8, LPHT_NOT_RESIZABLE), UTILS_STATUS_SUCCESS);
+    assert_int_equal(lpHashTableGetBin(&lpht, binKey1, sizeof(binKey1), &out_value, LPHT_DO_NOT_REMOVE_ITEM), UTILS_STATUS_EMPTY);
+    value = 1;
+    assert_int_equal(lpHashTablePutBin(&lpht, NULL, 3, &value), UTILS_STATUS_ERROR);
+    assert_int_equal(lpHashTablePutBin(&lpht, binKey1, 0, &value), UTILS_STATUS_ERROR);
+    assert_int_equal(lpHashTablePutBin(&lpht, binKey1, sizeof(binKey1), NULL), UTILS_STATUS_ERROR);
+    assert_int_equal(lpHashTablePutBin(&lpht, binKey1, sizeof(binKey1), &value), UTILS_STATUS_SUCCESS);
+    value = 2;
+    assert_int_equal(lpHashTablePutBin(&lpht, binKey2, sizeof(binKey2), &value), UTILS_STATUS_SUCCESS);
+    value = 3;
+    assert_int_equal(lpHashTablePutBin(&lpht, binKey1, 2, &value), UTILS_STATUS_SUCCESS);
+    value = 4;
+    longKey[39] = 1;
+    assert_int_equal(lpHashTablePutBin(&lpht, longKey, sizeof(longKey), &value), UTILS_STATUS_SUCCESS);
+    assert_int_equal(lpht.items, 4);
+    assert_int_equal(lpht._arenaLive, sizeof(longKey));
+    assert_int_equal(lpHashTableGetBin(&lpht, NULL, 3, &out_value, LPHT_DO_NOT_REMOVE_ITEM), UTILS_STATUS_ERROR);
+    assert_int_equal(lpHashTableGetBin(&lpht, binKey1, 0, &out_value, LPHT_DO_NOT_REMOVE_ITEM), UTILS_STATUS_ERROR);
+    assert_int_equal(lpHashTableGetBin(&lpht, binKey1, sizeof(binKey1), &out_value, LPHT_DO_NOT_REMOVE_ITEM), UTILS_STATUS_SUCCESS);
+    assert_int_equal(out_value, 1);
+    assert_int_equal(lpHashTableGetBin(&lpht, binKey2, sizeof(binKey2), &out_value, LPHT_DO_NOT_REMOVE_ITEM), UTILS_STATUS_SUCCESS);
+    assert_int_equal(out_value, 2);
+    assert_int_equal(lpHashTableGetBin(&lpht, binKey1, 2, &out_value, LPHT_REMOVE_ITEM), UTILS_STATUS_SUCCESS);
+    assert_int_equal(out_value, 3);
+    assert_int_equal(lpHashTableGetBin(&lpht, longKey, sizeof(longKey), &out_value, LPHT_REMOVE_ITEM), UTILS_STATUS_SUCCESS);
+    assert_int_equal(out_value, 4);
+    longKey[39] = 0;
+    assert_int_equal(lpHashTableGetBin(&lpht, longKey, sizeof(longKey), &out_value, LPHT_DO_NOT_REMOVE_ITEM), UTILS_STATUS_ERROR);
+    assert_null(lpht._arena);
+    assert_int_equal(lpht.items, 2);
+    /* Keys hashed by the caller */
+    void* ref;
+    uint8_t inserted;
+    value = 5;
+    assert_int_equal(lpHashTablePutHashed(&lpht, NULL, 3, 1, &value), UTILS_STATUS_ERROR);
+    assert_int_equal(lpHashTablePutHashed(&lpht, binKey1, 0, 1, &value), UTILS_STATUS_ERROR);
+    assert_int_equal(lpHashTablePutHashed(&lpht, binKey1, sizeof(binKey1), 1, NULL), UTILS_STATUS_ERROR);
+    assert_int_equal(lpHashTablePutHashed(&lpht, binKey1, sizeof(binKey1), 1, &value), UTILS_STATUS_SUCCESS);
+    assert_int_equal(lpHashTableGetHashed(&lpht, NULL, 3, 1, &out_value, LPHT_DO_NOT_REMOVE_ITEM), UTILS_STATUS_ERROR);
+    assert_int_equal(lpHashTableGetHashed(&lpht, binKey1, 0, 1, &out_value, LPHT_DO_NOT_REMOVE_ITEM), UTILS_STATUS_ERROR);
+    assert_int_equal(lpHashTableGetHashed(&lpht, binKey1, sizeof(binKey1), 1, &out_value, LPHT_DO_NOT_REMOVE_ITEM), UTILS_STATUS_SUCCESS);
+    assert_int_equal(out_value, 5);
+    assert_int_equal(lpHashTableGetOrInsertHashed(&lpht, NULL, 3, 1, &ref, &inserted), UTILS_STATUS_ERROR);
+    assert_int_equal(lpHashTableGetOrInsertHashed(&lpht, binKey1, 0, 1, &ref, &inserted), UTILS_STATUS_ERROR);
+    assert_int_equal(lpHashTableGetOrInsertHashed(&lpht, binKey1, sizeof(binKey1), 1, NULL, &inserted), UTILS_STATUS_ERROR);
+    assert_int_equal(lpHashTableGetOrInsertHashed(&lpht, binKey1, sizeof(binKey1), 1, &ref, &inserted), UTILS_STATUS_SUCCESS);
+    assert_int_equal(inserted, 0);
+    assert_int_equal(*(int*)ref, 5);
+    assert_int_equal(lpht.items, 3);
+    lpHashTableDelete(&lpht);
+}
+
+static void test_lpHashTableIncrementalResize(void** state) {
+    (void)state; /* unused */
+    lpHashTable_t lpht;
+    int value, out_value;
+    uint32_t ii, n, steps;
+    uint8_t present[16] = {0};
+    int values[16];
+    uint16_t migrations = 0, shrinks = 0, deferred = 0;
+    uint32_t seed = 7, prevIdx = 0;
+    uint8_t* prevOld = NULL;
+    assert_int_equal(lpHashTableInit(&lpht, sizeof(int), 4, LPHT_RESIZABLE_INCREMENTAL), UTILS_STATUS_SUCCESS);
+    /* Resize only allocates new slots, old ones are kept until all items are moved */
+    for (n = 0; lpht._oldEntries == NULL; n++) {
+        value = n;
+        assert_int_equal(lpHashTablePutU32(&lpht, n, &value), UTILS_STATUS_SUCCESS);
+    }
+    assert_int_equal(lpht.size, 8);
+    assert_int_equal(lpht._oldSize, 4);
+    assert_int_equal(lpht._oldItems, n - 1);
+    assert_int_equal(lpht.items, n);
+    /* References to items not migrated yet point to old slots */
+    for (ii = n - 1; ii-- > 0;) {
+        int* ref;
+        assert_int_equal(lpHashTableGetRefU32(&lpht, ii, (void**)&ref), UTILS_STATUS_SUCCESS);
+        assert_int_equal(*ref, ii);
+        if (((uint8_t*)ref >= lpht._oldEntries) && ((uint8_t*)ref < (lpht._oldEntries + lpht._oldSize * lpht._slotSize))) {
+            break;
+        }
+    }
+    assert_non_null(lpht._oldEntries);
+    assert_int_not_equal(ii, UINT32_MAX);
+    /* Items are found, updated and removed wherever they are, one old slot is migrated per operation */
+    value = 100;
+    assert_int_equal(lpHashTablePutU32(&lpht, 0, &value), UTILS_STATUS_SUCCESS);
+    assert_int_equal(lpHashTableGetU32(&lpht, 1, &out_value, LPHT_REMOVE_ITEM), UTILS_STATUS_SUCCESS);
+    assert_int_equal(out_value, 1);
+    assert_int_equal(lpHashTableGetU32(&lpht, 1, &out_value, LPHT_DO_NOT_REMOVE_ITEM), UTILS_STATUS_ERROR);
+    for (steps = 0; lpht._oldEntries != NULL; steps++) {
+        assert_int_equal(lpHashTableGetU32(&lpht, 0, &out_value, LPHT_DO_NOT_REMOVE_ITEM), UTILS_STATUS_SUCCESS);
+        assert_int_equal(out_value, 100);
+        assert_true(steps < 8);
+    }
+    assert_int_equal(lpht.items, n - 1);
+    for (ii = 2; ii < n; ii++) {
+        assert_int_equal(lpHashTableGetU32(&lpht, ii, &out_value, LPHT_DO_NOT_REMOVE_ITEM), UTILS_STATUS_SUCCESS);
+        assert_int_equal(out_value, ii);
+    }
+    /* Flush and delete release old slots too */
+    value = n;
+    assert_int_equal(lpHashTablePutU32(&lpht, n, &value), UTILS_STATUS_SUCCESS);
+    while (lpht._oldEntries == NULL) {
+        value = ++n;
+        assert_int_equal(lpHashTablePutU32(&lpht, n, &value), UTILS_STATUS_SUCCESS);
+    }
+    assert_int_equal(lpHashTableFlush(&lpht), UTILS_STATUS_SUCCESS);
+    assert_null(lpht._oldEntries);
+    assert_int_equal(lpht.items, 0);
+    /* Random operations, checked against a reference, alternating phases that grow and shrink the table */
+    for (uint16_t op = 0; op < 3000; op++) {
+        seed = seed * 1664525u + 1013904223u;
+        ii = (seed >> 16) % 16;
+        value = op;
+        if ((((seed >> 28) & 3) != 0) == (((op / 200) & 1) == 0)) {
+            assert_int_equal(lpHashTablePutU32(&lpht, ii, &value), UTILS_STATUS_SUCCESS);
+            present[ii] = 1;
+            values[ii] = value;
+        } else if (present[ii]) {
+            assert_int_equal(lpHashTableGetU32(&lpht, ii, &out_value, LPHT_REMOVE_ITEM), UTILS_STATUS_SUCCESS);
+            assert_int_equal(out_value, values[ii]);
+            present[ii] = 0;
+        } else {
+            assert_int_not_equal(lpHashTableGetU32(&lpht, ii, &out_value, LPHT_REMOVE_ITEM), UTILS_STATUS_SUCCESS);
+        }
+        if (lpht._oldEntries != NULL) {
+            migrations++;
+            shrinks += (lpht._oldSize > lpht.size);
+            /* A resize needed during a migration is postponed, and each operation skips a bounded number of empty old slots */
+            deferred += (lpht.items <= (lpht.size * LPHT_MIN_SATURATION)) || ((lpht.items + 1) >= (lpht.size * LPHT_MAX_SATURATION));
+            if (lpht._oldEntries == prevOld) {
+                assert_true((lpht._migrateIdx - prevIdx) <= (2 * lpht._migrateStep * LPHT_MIGRATION_EMPTY_VISITS));
+            }
+            /* Old slots keep Robin Hood ordering, and the ones already visited are empty */
+            for (uint32_t jj = 0; jj < lpht._oldSize; jj++) {
+                lpHashTableEntry_t* entry = (lpHashTableEntry_t*)(lpht._oldEntries + jj * lpht._slotSize);
+                if (entry->keyLen) {
+                    assert_true(jj >= lpht._migrateIdx);
+                    assert_int_equal(entry->dist, (jj + lpht._oldSize - (entry->hash & (lpht._oldSize - 1))) % lpht._oldSize);
+                }
+            }
+        }
+        for (uint32_t jj = 0; jj < lpht.size; jj++) {
+            if (slot(&lpht, jj)->keyLen) {
+                uint32_t home = slot(&lpht, jj)->hash & (lpht.size - 1);
+                assert_int_equal(slot(&lpht, jj)->dist, (jj + lpht.size - home) % lpht.size);
+            }
+        }
+        if (!(op % 16)) {
+            n = 0;
+            for (ii = 0; ii < 16; ii++) {
+                if (present[ii]) {
+                    n++;
+                    assert_int_equal(lpHashTableGetU32(&lpht, ii, &out_value, LPHT_DO_NOT_REMOVE_ITEM), UTILS_STATUS_SUCCESS);
+                    assert_int_equal(out_value, values[ii]);
+                }
+            }
+            assert_int_equal(lpht.items, n);
+        }
+        prevOld = lpht._oldEntries;
+        prevIdx = lpht._migrateIdx;
+    }
+    assert_true(migrations > 0);
+    assert_true(shrinks > 0);
+    assert_true(deferred > 0);
+    lpHashTableDelete(&lpht);
+}
+
+static void test_lpHashTableIncrementalCompaction(void** state) {
+    (void)state; /* unused */
+    lpHashTable_t lpht;
+    lpHashTableStats_t stats;
+    char key[48];
+    int value, out_value;
+    uint16_t compactions = 0;
+    assert_int_equal(lpHashTableInit(&lpht, sizeof(int), 16, LPHT_RESIZABLE_INCREMENTAL), UTILS_STATUS_SUCCESS);
+    /* Long keys are replaced continuously, overflow storage is compacted by moving entries, without walking all slots at once */
+    for (int ii = 0; ii < 400; ii++) {
+        snprintf(key, sizeof(key), "a_key_long_enough_to_go_to_overflow_%d", ii);
+        value = ii;
+        assert_int_equal(lpHashTablePut(&lpht, key, &value), UTILS_STATUS_SUCCESS);
+        if (ii >= 8) {
+            snprintf(key, sizeof(key), "a_key_long_enough_to_go_to_overflow_%d", ii - 8);
+            assert_int_equal(lpHashTableGet(&lpht, key, &out_value, LPHT_REMOVE_ITEM), UTILS_STATUS_SUCCESS);
+            assert_int_equal(out_value, ii - 8);
+        }
+        compactions += (lpht._oldArena != NULL);
+        assert_true((lpht._arenaUsed - lpht._arenaLive) <= (lpht._arenaLive + 2048));
+    }
+    assert_true(compactions > 0);
+    assert_int_equal(lpht.items, 8);
+    /* Compactions are not counted as resizes */
+    lpHashTableStats(&lpht, &stats);
+    assert_int_equal(stats.xpandCount, 0);
+    assert_true(stats.compactCount > 0);
+    for (int ii = 392; ii < 400; ii++) {
+        snprintf(key, sizeof(key), "a_key_long_enough_to_go_to_overflow_%d", ii);
+        assert_int_equal(lpHashTableGet(&lpht, key, &out_value, LPHT_DO_NOT_REMOVE_ITEM), UTILS_STATUS_SUCCESS);
+        assert_int_equal(out_value, ii);
+    }
+    /* Once no long key is left, overflow storage is released a chunk per operation */
+    for (int ii = 392; ii < 400; ii++) {
+        snprintf(key, sizeof(key), "a_key_long_enough_to_go_to_overflow_%d", ii);
+        assert_int_equal(lpHashTableGet(&lpht, key, &out_value, LPHT_REMOVE_ITEM), UTILS_STATUS_SUCCESS);
+    }
+    assert_int_equal(lpht._arenaLive, 0);
+    for (int ii = 0; lpht._oldArena != NULL; ii++) {
+        assert_true(ii < 16);
+        assert_int_equal(lpHashTableGet(&lpht, "missing", &out_value, LPHT_DO_NOT_REMOVE_ITEM), UTILS_STATUS_ERROR);
+    }
+    /* Old overflow storage is released with old slots */
+    for (int ii = 0; lpht._oldArena == NULL; ii++) {
+        snprintf(key, sizeof(key), "a_key_long_enough_to_go_to_overflow_%d", ii);
+        value = ii;
+        assert_int_equal(lpHashTablePut(&lpht, key, &value), UTILS_STATUS_SUCCESS);
+        assert_int_equal(lpHashTableGet(&lpht, key, &out_value, LPHT_REMOVE_ITEM), UTILS_STATUS_SUCCESS);
+    }
+    assert_int_equal(lpHashTableFlush(&lpht), UTILS_STATUS_EMPTY);
+    lpHashTableDelete(&lpht);
+    assert_null(lpht._oldArena);
+    /* Compaction is skipped with a warning if new slots cannot be allocated, and stops if new overflow storage cannot be allocated */
+    assert_int_equal(lpHashTableInit(&lpht, sizeof(int), 16, LPHT_RESIZABLE_INCREMENTAL), UTILS_STATUS_SUCCESS);
+    utilsStatus_t status = UTILS_STATUS_SUCCESS;
+    int ii;
+    for (ii = 0; status != UTILS_STATUS_WARNING; ii++) {
+        assert_true(ii < 400);
+        snprintf(key, sizeof(key), "a_key_long_enough_to_go_to_overflow_%d", ii);
+        value = ii;
+        assert_int_equal(lpHashTablePut(&lpht, key, &value), UTILS_STATUS_SUCCESS);
+        if (ii >= 8) {
+            snprintf(key, sizeof(key), "a_key_long_enough_to_go_to_overflow_%d", ii - 8);
+            skipAssert = 1;
+            callocFail = 1;
+            status = lpHashTableGet(&lpht, key, &out_value, LPHT_REMOVE_ITEM);
+            skipAssert = 0;
+            callocFail = 0;
+            assert_int_equal(out_value, ii - 8);
+        }
+    }
+    assert_null(lpht._oldEntries);
+    assert_null(lpht._oldArena);
+    assert_int_equal(lpht.items, 8);
+    snprintf(key, sizeof(key), "a_key_long_enough_to_go_to_overflow_%d", ii - 8);
+    assert_int_equal(lpHashTableGet(&lpht, key, &out_value, LPHT_REMOVE_ITEM), UTILS_STATUS_SUCCESS);
+    assert_non_null(lpht._oldArena);
+    assert_null(lpht._arena);
+    skipAssert = 1;
+    mallocFail = 1;
+    assert_int_equal(lpHashTableSave(&lpht, "lpht_snapshot_fail.bin"), UTILS_STATUS_ERROR);
+    skipAssert = 0;
+    mallocFail = 0;
+    assert_non_null(lpht._oldEntries);
+    for (int jj = ii - 7; jj < ii; jj++) {
+        snprintf(key, sizeof(key), "a_key_long_enough_to_go_to_overflow_%d", jj);
+        assert_int_equal(lpHashTableGet(&lpht, key, &out_value, LPHT_DO_NOT_REMOVE_ITEM), UTILS_STATUS_SUCCESS);
+        assert_int_equal(out_value, jj);
+    }
+    lpHashTableDelete(&lpht);
+}
+
+static void test_lpHashTableGetRefAndGetOrInsert(void** state) {
+    (void)state; /* unused */
+    lpHashTable_t lpht;
+    int value, out_value;
+    void* ref;
+    uint8_t inserted;
+    char* words[] = {"a", "b", "a", "c", "a", "b"};
+    uint8_t binKey[] = {0x00, 0x01};
+    assert_int_equal(lpHashTableInit(&lpht, sizeof(int), 8, LPHT_RESIZABLE), UTILS_STATUS_SUCCESS);
+    assert_int_equal(lpHashTableGetRef(&lpht, "a", &ref), UTILS_STATUS_EMPTY);
+    assert_int_equal(lpHashTableGetOrInsert(&lpht, NULL, &ref, NULL), UTILS_STATUS_ERROR);
+    assert_int_equal(lpHashTableGetOrInsert(&lpht, "a", NULL, NULL), UTILS_STATUS_ERROR);
+    /* Counters are updated in place, hashing each key once */
+    hashCalls = 0;
+    for (uint8_t ii = 0; ii < 6; ii++) {
+        assert_int_equal(lpHashTableGetOrInsert(&lpht, words[ii], &ref, &inserted), UTILS_STATUS_SUCCESS);
+        assert_int_equal(inserted, (ii < 2) || (ii == 3));
+        (*(int*)ref)++;
+    }
+    assert_int_equal(hashCalls, 6);
+    assert_int_equal(lpht.items, 3);
+    assert_int_equal(lpHashTableGet(&lpht, "a", &out_value, LPHT_DO_NOT_REMOVE_ITEM), UTILS_STATUS_SUCCESS);
+    assert_int_equal(out_value, 3);
+    assert_int_equal(lpHashTableGet(&lpht, "b", &out_value, LPHT_DO_NOT_REMOVE_ITEM), UTILS_STATUS_SUCCESS);
+    assert_int_equal(out_value, 2);
+    assert_int_equal(lpHashTableGetRef(&lpht, "c", &ref), UTILS_STATUS_SUCCESS);
+    assert_int_equal(*(int*)ref, 1);
+    *(int*)ref = 42;
+    assert_int_equal(lpHashTableGet(&lpht, "c", &out_value, LPHT_DO_NOT_REMOVE_ITEM), UTILS_STATUS_SUCCESS);
+    assert_int_equal(out_value, 42);
+    assert_int_equal(lpHashTableGetRef(&lpht, "d", &ref), UTILS_STATUS_ERROR);
+    /* Values survive resizes, where slots move */
+    for (uint32_t ii = 0; ii < 16; ii++) {
+        assert_int_equal(lpHashTableGetOrInsertU32(&lpht, ii, &ref, NULL), UTILS_STATUS_SUCCESS);
+        *(int*)ref += ii;
+    }
+    assert_int_equal(lpHashTableGetOrInsertU32(&lpht, 3, NULL, NULL), UTILS_STATUS_ERROR);
+    assert_int_equal(lpHashTableGetOrInsertU32(&lpht, 3, &ref, &inserted), UTILS_STATUS_SUCCESS);
+    assert_int_equal(inserted, 0);
+    assert_int_equal(*(int*)ref, 3);
+    assert_int_equal(lpHashTableGetRefU32(&lpht, 15, &ref), UTILS_STATUS_SUCCESS);
+    assert_int_equal(*(int*)ref, 15);
+    assert_int_equal(lpHashTableGetRefU32(&lpht, 16, &ref), UTILS_STATUS_ERROR);
+    assert_int_equal(lpHashTableGet(&lpht, "c", &out_value, LPHT_DO_NOT_REMOVE_ITEM), UTILS_STATUS_SUCCESS);
+    assert_int_equal(out_value, 42);
+    lpHashTableDelete(&lpht);
+    /* Binary and 64-bit keys, full table */
+    assert_int_equal(lpHashTableInit(&lpht, sizeof(int), 2, LPHT_NOT_RESIZABLE), UTILS_STATUS_SUCCESS);
+    assert_int_equal(lpHashTableGetRefU32(&lpht, 1, &ref), UTILS_STATUS_EMPTY);
+    assert_int_equal(lpHashTableGetRefU64(&lpht, 1, &ref), UTILS_STATUS_EMPTY);
+    assert_int_equal(lpHashTableGetRefBin(&lpht, binKey, sizeof(binKey), &ref), UTILS_STATUS_EMPTY);
+    assert_int_equal(lpHashTableGetOrInsertBin(&lpht, binKey, 0, &ref, NULL), UTILS_STATUS_ERROR);
+    assert_int_equal(lpHashTableGetOrInsertBin(&lpht, binKey, sizeof(binKey), &ref, &inserted), UTILS_STATUS_SUCCESS);
+    assert_int_equal(inserted, 1);
+    *(int*)ref = 5;
+    assert_int_equal(lpHashTableGetOrInsertU64(&lpht, 1ULL << 40, NULL, NULL), UTILS_STATUS_ERROR);
+    assert_int_equal(lpHashTableGetOrInsertU64(&lpht, 1ULL << 40, &ref, &inserted), UTILS_STATUS_SUCCESS);
+    assert_int_equal(inserted, 1);
+    assert_int_equal(*(int*)ref, 0);
+    *(int*)ref = 6;
+    assert_int_equal(lpHashTableGetOrInsertU64(&lpht, 1, &ref, &inserted), UTILS_STATUS_FULL);
+    assert_int_equal(lpHashTableGetOrInsertBin(&lpht, binKey, sizeof(binKey), &ref, &inserted), UTILS_STATUS_SUCCESS);
+    assert_int_equal(inserted, 0);
+    assert_int_equal(*(int*)ref, 5);
+    assert_int_equal(lpHashTableGetRefBin(&lpht, NULL, sizeof(binKey), &ref), UTILS_STATUS_ERROR);
+    assert_int_equal(lpHashTableGetRefBin(&lpht, binKey, 1, &ref), UTILS_STATUS_ERROR);
+    assert_int_equal(lpHashTableGetRefU64(&lpht, 1ULL << 40, &ref), UTILS_STATUS_SUCCESS);
+    assert_int_equal(*(int*)ref, 6);
+    assert_int_equal(lpHashTableGetRefU64(&lpht, 1, &ref), UTILS_STATUS_ERROR);
+    value = 7;
+    assert_int_equal(lpHashTablePutU64(&lpht, 1ULL << 40, &value), UTILS_STATUS_SUCCESS);
+    assert_int_equal(*(int*)ref, 7);
+    lpHashTableDelete(&lpht);
+}
+
+static void test_lpHashTableBatch(void** state) {
+    (void)state; /* unused */
+    lpHashTable_t lpht;
+    char* keys[10] = {"k0", "k1", "k2", "k3", "k4", "k5", "k6", "k7", "k8", "k9"};
+    char* getKeys[7] = {"k9", "missing", "k0", NULL, "k5", "k5", "k3"};
+    int values[10], out_values[7];
+    utilsStatus_t results[10];
+    for (uint8_t ii = 0; ii < 10; ii++) {
+        values[ii] = 10 * ii;
+    }
+    assert_int_equal(lpHashTableInit(&lpht, sizeof(int), 4, LPHT_RESIZABLE), UTILS_STATUS_SUCCESS);
+    assert_int_equal(lpHashTableGetBatch(&lpht, getKeys, 7, out_values, results), UTILS_STATUS_EMPTY);
+    assert_int_equal(results[6], UTILS_STATUS_EMPTY);
+    assert_int_equal(lpHashTablePutBatch(&lpht, NULL, 10, values, results), UTILS_STATUS_ERROR);
+    assert_int_equal(lpHashTablePutBatch(&lpht, keys, 10, NULL, results), UTILS_STATUS_ERROR);
+    /* Every key is hashed once, table is resized in the middle of the batch */
+    hashCalls = 0;
+    assert_int_equal(lpHashTablePutBatch(&lpht, keys, 10, values, results), UTILS_STATUS_SUCCESS);
+    assert_int_equal(hashCalls, 10);
+    assert_int_equal(lpht.items, 10);
+    for (uint8_t ii = 0; ii < 10; ii++) {
+        assert_int_equal(results[ii], UTILS_STATUS_SUCCESS);
+    }
+    hashCalls = 0;
+    assert_int_equal(lpHashTableGetBatch(&lpht, getKeys, 7, out_values, results), UTILS_STATUS_ERROR);
+    assert_int_equal(lpHashTableGetBatch(&lpht, NULL, 7, out_values, results), UTILS_STATUS_ERROR);
+    assert_int_equal(hashCalls, 6);
+    assert_int_equal(results[0], UTILS_STATUS_SUCCESS);
+    assert_int_equal(out_values[0], 90);
+    assert_int_equal(results[1], UTILS_STATUS_ERROR);
+    assert_int_equal(results[2], UTILS_STATUS_SUCCESS);
+    assert_int_equal(out_values[2], 0);
+    assert_int_equal(results[3], UTILS_STATUS_ERROR);
+    assert_int_equal(out_values[4], 50);
+    assert_int_equal(out_values[5], 50);
+    assert_int_equal(results[6], UTILS_STATUS_SUCCESS);
+    assert_int_equal(out_values[6], 30);
+    assert_int_equal(lpHashTableGetBatch(&lpht, keys, 10, values, NULL), UTILS_STATUS_SUCCESS);
+    assert_int_equal(values[7], 70);
+    /* NULL keys are reported without stopping the batch */
+    assert_int_equal(lpHashTablePutBatch(&lpht, getKeys, 7, values, results), UTILS_STATUS_ERROR);
+    assert_int_equal(results[2], UTILS_STATUS_SUCCESS);
+    assert_int_equal(results[3], UTILS_STATUS_ERROR);
+    assert_int_equal(results[4], UTILS_STATUS_SUCCESS);
+    assert_int_equal(lpht.items, 11);
+    lpHashTableDelete(&lpht);
+    /* Failed items are reported one by one */
+    assert_int_equal(lpHashTableInit(&lpht, sizeof(int), 3, LPHT_NOT_RESIZABLE), UTILS_STATUS_SUCCESS);
+    getKeys[3] = "k1";
+    assert_int_equal(lpHashTablePutBatch(&lpht, getKeys, 7, values, results), UTILS_STATUS_ERROR);
+    assert_int_equal(results[0], UTILS_STATUS_SUCCESS);
+    assert_int_equal(results[2], UTILS_STATUS_SUCCESS);
+    assert_int_equal(results[3], UTILS_STATUS_FULL);
+    assert_int_equal(results[6], UTILS_STATUS_FULL);
+    assert_int_equal(lpht.items, 3);
+    lpHashTableDelete(&lpht);
+}
+
+static void test_lpHashTableSnapshot(void** state) {
+    (void)state; /* unused */
+    lpHashTable_t lpht, snap;
+    char* longKey = "a key much longer than inline storage of each slot";
+    char key[8];
+    int value, *ref;
+    uint8_t inserted;
+    FILE* file;
+    static uint8_t buffer[4096];
+    size_t len, pos;
+    uintptr_t offset;
+    assert_int_equal(lpHashTableInit(&lpht, sizeof(int), 4, LPHT_RESIZABLE_INCREMENTAL), UTILS_STATUS_SUCCESS);
+    for (int ii = 0; ii < 8; ii++) {
+        snprintf(key, sizeof(key), "k%d", ii);
+        assert_int_equal(lpHashTablePut(&lpht, key, &ii), UTILS_STATUS_SUCCESS);
+    }
+    value = 100;
+    assert_int_equal(lpHashTablePut(&lpht, longKey, &value), UTILS_STATUS_SUCCESS);
+    value = 101;
+    assert_int_equal(lpHashTablePutU64(&lpht, 0x123456789ULL, &value), UTILS_STATUS_SUCCESS);
+    /* Pending incremental resize is completed before saving */
+    assert_non_null(lpht._oldEntries);
+    assert_int_equal(lpHashTableSave(&lpht, "lpht_snapshot.bin"), UTILS_STATUS_SUCCESS);
+    assert_null(lpht._oldEntries);
+    assert_int_equal(lpHashTableSave(&lpht, "missing_dir/lpht_snapshot.bin"), UTILS_STATUS_ERROR);
+    mallocFail = 1;
+    expect_assert_failure(lpHashTableSave(&lpht, "lpht_snapshot_fail.bin"));
+    skipAssert = 1;
+    assert_int_equal(lpHashTableSave(&lpht, "lpht_snapshot_fail.bin"), UTILS_STATUS_ERROR);
+    skipAssert = 0;
+    mallocFail = 0;
+    /* Partially written file is removed */
+    struct rlimit fsize, fsizeLimit;
+    void (*xfszHandler)(int) = signal(SIGXFSZ, SIG_IGN);
+    getrlimit(RLIMIT_FSIZE, &fsize);
+    fsizeLimit = fsize;
+    fsizeLimit.rlim_cur = 16;
+    assert_int_equal(setrlimit(RLIMIT_FSIZE, &fsizeLimit), 0);
+    assert_int_equal(lpHashTableSave(&lpht, "lpht_snapshot_fail.bin"), UTILS_STATUS_ERROR);
+    setrlimit(RLIMIT_FSIZE, &fsize);
+    signal(SIGXFSZ, xfszHandler);
+    assert_null(fopen("lpht_snapshot_fail.bin", "rb"));
+    assert_int_equal(lpHashTableDelete(&lpht), UTILS_STATUS_SUCCESS);
+    assert_int_equal(lpHashTableSave(&lpht, "lpht_snapshot_fail.bin"), UTILS_STATUS_ERROR);
+
+    /* Loaded table finds every item without allocating */
+    assert_int_equal(lpHashTableLoad(&snap, NULL, sizeof(int)), UTILS_STATUS_ERROR);
+    assert_int_equal(lpHashTableLoad(&snap, "missing.bin", sizeof(int)), UTILS_STATUS_ERROR);
+    assert_int_equal(lpHashTableLoad(&snap, ".", sizeof(int)), UTILS_STATUS_ERROR);
+    assert_int_equal(lpHashTableLoad(&snap, "lpht_snapshot.bin", sizeof(double)), UTILS_STATUS_ERROR);
+    assert_int_equal(lpHashTableDelete(&snap), UTILS_STATUS_ERROR);
+    allocCalls = 0;
+    assert_int_equal(lpHashTableLoad(&snap, "lpht_snapshot.bin", sizeof(int)), UTILS_STATUS_SUCCESS);
+    assert_int_equal(snap.items, 10);
+    assert_int_equal(snap.resizable, LPHT_NOT_RESIZABLE);
+    for (int ii = 0; ii < 8; ii++) {
+        snprintf(key, sizeof(key), "k%d", ii);
+        assert_int_equal(lpHashTableGet(&snap, key, &value, LPHT_DO_NOT_REMOVE_ITEM), UTILS_STATUS_SUCCESS);
+        assert_int_equal(value, ii);
+    }
+    assert_int_equal(lpHashTableGet(&snap, longKey, &value, LPHT_DO_NOT_REMOVE_ITEM), UTILS_STATUS_SUCCESS);
+    assert_int_equal(value, 100);
+    assert_int_equal(lpHashTableGetU64(&snap, 0x123456789ULL, &value, LPHT_DO_NOT_REMOVE_ITEM), UTILS_STATUS_SUCCESS);
+    assert_int_equal(value, 101);
+    assert_int_equal(lpHashTableGet(&snap, "k8", &value, LPHT_DO_NOT_REMOVE_ITEM), UTILS_STATUS_ERROR);
+    assert_int_equal(lpHashTableGetRef(&snap, "k3", (void**)&ref), UTILS_STATUS_SUCCESS);
+    assert_int_equal(*ref, 3);
+    assert_int_equal(allocCalls, 0);
+    /* It is read-only */
+    assert_int_equal(lpHashTablePut(&snap, "k8", &value), UTILS_STATUS_ERROR);
+    assert_int_equal(lpHashTablePut(&snap, "k1", &value), UTILS_STATUS_ERROR);
+    assert_int_equal(lpHashTableGetOrInsert(&snap, "k1", (void**)&ref, &inserted), UTILS_STATUS_ERROR);
+    assert_int_equal(lpHashTableGet(&snap, "k1", &value, LPHT_REMOVE_ITEM), UTILS_STATUS_ERROR);
+    assert_int_equal(lpHashTableFlush(&snap), UTILS_STATUS_ERROR);
+    assert_int_equal(snap.items, 10);
+    /* Snapshot of a snapshot is the same file */
+    assert_int_equal(lpHashTableSave(&snap, "lpht_snapshot_copy.bin"), UTILS_STATUS_SUCCESS);
+    assert_int_equal(lpHashTableDelete(&snap), UTILS_STATUS_SUCCESS);
+    assert_int_equal(lpHashTableDelete(&snap), UTILS_STATUS_ERROR);
+    assert_int_equal(lpHashTableLoad(&snap, "lpht_snapshot_copy.bin", sizeof(int)), UTILS_STATUS_SUCCESS);
+    assert_int_equal(lpHashTableGet(&snap, longKey, &value, LPHT_DO_NOT_REMOVE_ITEM), UTILS_STATUS_SUCCESS);
+    assert_int_equal(value, 100);
+    assert_int_equal(lpHashTableDelete(&snap), UTILS_STATUS_SUCCESS);
+
+    /* Corrupted files are rejected */
+    file = fopen("lpht_snapshot.bin", "rb");
+    assert_non_null(file);
+    len = fread(buffer, 1, sizeof(buffer), file);
+    fclose(file);
+    assert_true(len < sizeof(buffer));
+    file = fopen("lpht_snapshot_copy.bin", "wb");
+    assert_int_equal(fwrite(buffer, 1, len - 1, file), len - 1);
+    fclose(file);
+    assert_int_equal(lpHashTableLoad(&snap, "lpht_snapshot_copy.bin", sizeof(int)), UTILS_STATUS_ERROR);
+    file = fopen("lpht_snapshot_copy.bin", "wb");
+    assert_int_equal(fwrite(buffer, 1, 10, file), 10);
+    fclose(file);
+    assert_int_equal(lpHashTableLoad(&snap, "lpht_snapshot_copy.bin", sizeof(int)), UTILS_STATUS_ERROR);
+    buffer[0] = 'X';
+    file = fopen("lpht_snapshot_copy.bin", "wb");
+    assert_int_equal(fwrite(buffer, 1, len, file), len);
+    fclose(file);
+    assert_int_equal(lpHashTableLoad(&snap, "lpht_snapshot_copy.bin", sizeof(int)), UTILS_STATUS_ERROR);
+    buffer[0] = 'A';
+    file = fopen("lpht_snapshot_copy.bin", "wb");
+    assert_int_equal(fwrite(buffer, 1, len, file), len);
+    fclose(file);
+    assert_int_equal(lpHashTableLoad(&snap, "lpht_snapshot_copy.bin", sizeof(int)), UTILS_STATUS_SUCCESS);
+    assert_int_equal(lpHashTableDelete(&snap), UTILS_STATUS_SUCCESS);
+    /* Long key offsets pointing outside of the keys area are rejected */
+    offset = len - (strlen(longKey) + 1);
+    for (pos = 0; memcmp(buffer + pos, &offset, sizeof(offset)); pos++) {
+        assert_true(pos < len);
+    }
+    offset = len - 2;
+    memcpy(buffer + pos, &offset, sizeof(offset));
+    file = fopen("lpht_snapshot_copy.bin", "wb");
+    assert_int_equal(fwrite(buffer, 1, len, file), len);
+    fclose(file);
+    assert_int_equal(lpHashTableLoad(&snap, "lpht_snapshot_copy.bin", sizeof(int)), UTILS_STATUS_ERROR);
+    offset = 0;
+    memcpy(buffer + pos, &offset, sizeof(offset));
+    file = fopen("lpht_snapshot_copy.bin", "wb");
+    assert_int_equal(fwrite(buffer, 1, len, file), len);
+    fclose(file);
+    assert_int_equal(lpHashTableLoad(&snap, "lpht_snapshot_copy.bin", sizeof(int)), UTILS_STATUS_ERROR);
+
+    /* Sizes that are not a power of 2 are saved and loaded as well */
+    assert_int_equal(lpHashTableInit(&lpht, sizeof(int), 5, LPHT_NOT_RESIZABLE), UTILS_STATUS_SUCCESS);
+    for (int ii = 0; ii < 4; ii++) {
+        snprintf(key, sizeof(key), "k%d", ii);
+        assert_int_equal(lpHashTablePut(&lpht, key, &ii), UTILS_STATUS_SUCCESS);
+    }
+    assert_int_equal(lpHashTableSave(&lpht, "lpht_snapshot.bin"), UTILS_STATUS_SUCCESS);
+    assert_int_equal(lpHashTableDelete(&lpht), UTILS_STATUS_SUCCESS);
+    assert_int_equal(lpHashTableLoad(&snap, "lpht_snapshot.bin", sizeof(int)), UTILS_STATUS_SUCCESS);
+    assert_int_equal(snap.size, 5);
+    for (int ii = 0; ii < 4; ii++) {
+        snprintf(key, sizeof(key), "k%d", ii);
+        assert_int_equal(lpHashTableGet(&snap, key, &value, LPHT_DO_NOT_REMOVE_ITEM), UTILS_STATUS_SUCCESS);
+        assert_int_equal(value, ii);
+    }
+    assert_int_equal(lpHashTableGet(&snap, "k4", &value, LPHT_DO_NOT_REMOVE_ITEM), UTILS_STATUS_ERROR);
+    assert_int_equal(lpHashTableDelete(&snap), UTILS_STATUS_SUCCESS);
+    remove("lpht_snapshot.bin");
+    remove("lpht_snapshot_copy.bin");
+}
+
 static void test_lpHashTableInfo(void** state) {
     (void)state; /* unused */
     lpHashTable_t lpht;
@@ -293,6 +1100,61 @@ static void test_lpHashTableInfo(void** state) {
     lpHashTableDelete(&lpht);
 }
 
+static void test_lpHashTableStats(void** state) {
+    (void)state; /* unused */
+    lpHashTable_t lpht;
+    lpHashTableStats_t stats;
+    int value = 42;
+    int out_value;
+    uint32_t count;
+    char key[4];
+    assert_int_equal(lpHashTableInit(&lpht, sizeof(int), 8, LPHT_NOT_RESIZABLE), UTILS_STATUS_SUCCESS);
+    lpHashTableStats(&lpht, &stats);
+    assert_int_equal(stats.probeHist[0], 0);
+    assert_int_equal(stats.maxProbe, 0);
+    assert_float_equal(stats.avgProbe, 0.0, 1e-5);
+    /* Same layout of Robin Hood test: "d" moves "c" one slot forward */
+    mockHash = 1;
+    assert_int_equal(lpHashTablePut(&lpht, "a", &value), UTILS_STATUS_SUCCESS);
+    assert_int_equal(lpHashTablePut(&lpht, "b", &value), UTILS_STATUS_SUCCESS);
+    mockHash = 2;
+    assert_int_equal(lpHashTablePut(&lpht, "c", &value), UTILS_STATUS_SUCCESS);
+    mockHash = 1;
+    assert_int_equal(lpHashTablePut(&lpht, "d", &value), UTILS_STATUS_SUCCESS);
+    lpHashTableStats(&lpht, &stats);
+    assert_int_equal(stats.probeHist[0], 1);
+    assert_int_equal(stats.probeHist[1], 1);
+    assert_int_equal(stats.probeHist[2], 2);
+    assert_int_equal(stats.maxProbe, 2);
+    assert_float_equal(stats.avgProbe, 1.25, 1e-5);
+    assert_int_equal(stats.shifts, 1);
+    assert_int_equal(stats.xpandCount, 0);
+    assert_int_equal(stats.compactCount, 0);
+    /* Backward-shift deletion moves the three following entries */
+    assert_int_equal(lpHashTableGet(&lpht, "a", &out_value, LPHT_REMOVE_ITEM), UTILS_STATUS_SUCCESS);
+    mockHash = 0;
+    lpHashTableStats(&lpht, &stats);
+    assert_int_equal(stats.shifts, 4);
+    assert_int_equal(stats.maxProbe, 1);
+    lpHashTableDelete(&lpht);
+
+    /* Resizes are counted, items still in old slots during an incremental resize are included */
+    assert_int_equal(lpHashTableInit(&lpht, sizeof(int), 4, LPHT_RESIZABLE_INCREMENTAL), UTILS_STATUS_SUCCESS);
+    for (int ii = 0; ii < 3; ii++) {
+        snprintf(key, sizeof(key), "k%d", ii);
+        assert_int_equal(lpHashTablePut(&lpht, key, &ii), UTILS_STATUS_SUCCESS);
+    }
+    assert_non_null(lpht._oldEntries);
+    lpHashTableStats(&lpht, &stats);
+    assert_int_equal(stats.xpandCount, 1);
+    count = 0;
+    for (uint32_t ii = 0; ii < LPHT_STATS_HIST_SIZE; ii++) {
+        count += stats.probeHist[ii];
+    }
+    assert_int_equal(count, 3);
+    lpHashTableDelete(&lpht);
+}
+
 static void test_lpHashTableFlush(void** state) {
     (void)state; /* unused */
     lpHashTable_t lpht;
@@ -304,8 +1166,7 @@ static void test_lpHashTableFlush(void** state) {
     assert_int_equal(lpHashTableFlush(&lpht), UTILS_STATUS_SUCCESS);
     assert_int_equal(lpht.items, 0);
     for (uint32_t ii = 0; ii < lpht.size; ii++) {
-        assert_null(lpht.entries[ii].key);
-        assert_null(lpht.entries[ii].value);
+        assert_int_equal(slot(&lpht, ii)->keyLen, 0);
     }
     test_free(lpht.entries);
 }
@@ -325,7 +1186,17 @@ int main(void) {
         cmocka_unit_test(test_lpHashTableInit),
         cmocka_unit_test(test_lpHashTablePutAndGetResizeable),
         cmocka_unit_test(test_lpHashTablePutAndGetNotResizeable),
+        cmocka_unit_test(test_lpHashTableHashCaching),
+        cmocka_unit_test(test_lpHashTableInlineStorage),
+        cmocka_unit_test(test_lpHashTableRobinHood),
+        cmocka_unit_test(test_lpHashTableIntegerAndBinaryKeys),
+        cmocka_unit_test(test_lpHashTableIncrementalResize),
+        cmocka_unit_test(test_lpHashTableIncrementalCompaction),
+        cmocka_unit_test(test_lpHashTableGetRefAndGetOrInsert),
+        cmocka_unit_test(test_lpHashTableBatch),
+        cmocka_unit_test(test_lpHashTableSnapshot),
         cmocka_unit_test(test_lpHashTableInfo),
+        cmocka_unit_test(test_lpHashTableStats),
         cmocka_unit_test(test_lpHashTableFlush),
         cmocka_unit_test(test_lpHashTableDelete),
     };
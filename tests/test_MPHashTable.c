@@ -0,0 +1,250 @@
+/* BEGIN Header */
+/**
+ ******************************************************************************
+ * \file            test_MPHashTable.c
+ * \author          Andrea Vivani
+ * \brief           Unit tests for MPHashTable.c
+ ******************************************************************************
+ * \copyright
+ *
+ * Copyright 2024 Andrea Vivani
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the “Software”), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ ******************************************************************************
+ */
+/* END Header */
+
+/* Includes ------------------------------------------------------------------*/
+
+#include <setjmp.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include "MPHashTable.h"
+
+#include <cmocka.h>
+
+/* Macros --------------------------------------------------------------------*/
+
+#define KEYS_NUM      5000
+#define KEY_MAX_LEN   16
+
+/* Support functions ---------------------------------------------------------*/
+
+static uint8_t callocFail = 0;
+
+void* ADVUtils_testCalloc(const size_t number_of_elements, const size_t size) {
+    if ((number_of_elements > 0) && !callocFail) {
+        return test_calloc(number_of_elements, size);
+    } else {
+        return NULL;
+    }
+}
+
+static uint8_t mallocFail = 0;
+
+void* ADVUtils_testMalloc(const size_t size) {
+    if (!mallocFail) {
+        return test_malloc(size);
+    } else {
+        return NULL;
+    }
+}
+
+static uint8_t skipAssert = 0;
+
+void ADVUtils_testAssert(const int result, const char* const expression, const char* const file, const int line) {
+    if (skipAssert) {
+        return;
+    } else {
+        mock_assert(result, expression, file, line);
+    }
+}
+
+static char keysBuf[KEYS_NUM][KEY_MAX_LEN];
+static const void* keys[KEYS_NUM];
+static uint32_t values[KEYS_NUM];
+
+static void fillKeys(uint32_t num) {
+    for (uint32_t ii = 0; ii < num; ii++) {
+        snprintf(keysBuf[ii], KEY_MAX_LEN, "key%u", ii);
+        keys[ii] = keysBuf[ii];
+        values[ii] = ii * 3 + 1;
+    }
+}
+
+/* Functions -----------------------------------------------------------------*/
+
+static void test_mpHashTableBuildAndGet(void** state) {
+    (void)state; // unused
+    mpHashTable_t mpht;
+    char key[KEY_MAX_LEN];
+    uint32_t value, ii;
+
+    fillKeys(KEYS_NUM);
+    assert_int_equal(mpHashTableBuild(&mpht, keys, NULL, values, KEYS_NUM, sizeof(uint32_t)), UTILS_STATUS_SUCCESS);
+    assert_int_equal(mpht.items, KEYS_NUM);
+    assert_int_equal(mpht.itemSize, sizeof(uint32_t));
+    assert_non_null(mpht.data);
+    /* Tests use MPHT_PILOT_TRIES=2, too few to place all buckets with the first seed, so the builder moved to the next one */
+    assert_int_not_equal(mpht._seed, 0);
+
+    /* Every key has its own slot */
+    for (ii = 0; ii < KEYS_NUM; ii++) {
+        assert_int_equal(mpHashTableGet(&mpht, keysBuf[ii], &value), UTILS_STATUS_SUCCESS);
+        assert_int_equal(value, ii * 3 + 1);
+    }
+
+    /* Keys outside the set land on a slot too, but fail the key comparison */
+    for (ii = KEYS_NUM; ii < 2 * KEYS_NUM; ii++) {
+        snprintf(key, KEY_MAX_LEN, "key%u", ii);
+        assert_int_equal(mpHashTableGet(&mpht, key, &value), UTILS_STATUS_ERROR);
+    }
+    assert_int_equal(mpHashTableGet(&mpht, "key1 ", &value), UTILS_STATUS_ERROR);
+    assert_int_equal(mpHashTableGet(&mpht, "key", &value), UTILS_STATUS_ERROR);
+    assert_int_equal(mpHashTableGet(&mpht, NULL, &value), UTILS_STATUS_ERROR);
+    assert_int_equal(mpHashTableGet(&mpht, "key1", NULL), UTILS_STATUS_ERROR);
+
+    assert_int_equal(mpHashTableDelete(&mpht), UTILS_STATUS_SUCCESS);
+    assert_int_equal(mpHashTableDelete(&mpht), UTILS_STATUS_ERROR);
+    assert_int_equal(mpHashTableGet(&mpht, "key1", &value), UTILS_STATUS_ERROR);
+}
+
+static void test_mpHashTableBinaryKeys(void** state) {
+    (void)state; // unused
+    mpHashTable_t mpht;
+    const uint8_t key0[] = {0x00};
+    const uint8_t key1[] = {0x00, 0x00};
+    const uint8_t key2[] = {'a', 0x00, 'b'};
+    const uint8_t key3[] = {'a', 0x00, 'c'};
+    const void* binKeys[] = {key0, key1, key2, key3, key0};
+    const size_t binLens[] = {sizeof(key0), sizeof(key1), sizeof(key2), sizeof(key3), 0};
+    const uint64_t binValues[] = {10, 11, 12, 13, 14};
+    uint64_t value;
+
+    assert_int_equal(mpHashTableBuild(&mpht, binKeys, binLens, binValues, 5, sizeof(uint64_t)), UTILS_STATUS_SUCCESS);
+    for (uint32_t ii = 0; ii < 5; ii++) {
+        assert_int_equal(mpHashTableGetBin(&mpht, binKeys[ii], binLens[ii], &value), UTILS_STATUS_SUCCESS);
+        assert_int_equal(value, binValues[ii]);
+    }
+    assert_int_equal(mpHashTableGetBin(&mpht, key2, 1, &value), UTILS_STATUS_ERROR);
+    assert_int_equal(mpHashTableGet(&mpht, "", &value), UTILS_STATUS_SUCCESS);
+    assert_int_equal(value, 14);
+    assert_int_equal(mpHashTableDelete(&mpht), UTILS_STATUS_SUCCESS);
+}
+
+static void test_mpHashTableBuildErrors(void** state) {
+    (void)state; // unused
+    mpHashTable_t mpht;
+    const void* dupKeys[] = {"one", "two", "three", "two"};
+    const size_t hugeLens[] = {UINT32_MAX, 1};
+
+    fillKeys(16);
+    assert_int_equal(mpHashTableBuild(&mpht, keys, NULL, values, 0, sizeof(uint32_t)), UTILS_STATUS_ERROR);
+    assert_int_equal(mpHashTableBuild(&mpht, NULL, NULL, values, 16, sizeof(uint32_t)), UTILS_STATUS_ERROR);
+    assert_int_equal(mpHashTableBuild(&mpht, keys, NULL, NULL, 16, sizeof(uint32_t)), UTILS_STATUS_ERROR);
+    assert_int_equal(mpHashTableBuild(&mpht, dupKeys, NULL, values, 4, sizeof(uint32_t)), UTILS_STATUS_ERROR);
+    /* Keys or values that don't fit a block */
+    assert_int_equal(mpHashTableBuild(&mpht, dupKeys, hugeLens, values, 2, sizeof(uint32_t)), UTILS_STATUS_ERROR);
+    assert_int_equal(mpHashTableBuild(&mpht, keys, NULL, values, 16, (size_t)UINT32_MAX + 1), UTILS_STATUS_ERROR);
+    assert_null(mpht.data);
+
+    skipAssert = 1;
+    mallocFail = 1;
+    assert_int_equal(mpHashTableBuild(&mpht, keys, NULL, values, 16, sizeof(uint32_t)), UTILS_STATUS_ERROR);
+    mallocFail = 0;
+    callocFail = 1;
+    assert_int_equal(mpHashTableBuild(&mpht, keys, NULL, values, 16, sizeof(uint32_t)), UTILS_STATUS_ERROR);
+    callocFail = 0;
+    skipAssert = 0;
+    assert_int_equal(mpHashTableDelete(&mpht), UTILS_STATUS_ERROR);
+}
+
+static void test_mpHashTableInitStatic(void** state) {
+    (void)state; // unused
+    static uint64_t block[4096];
+    mpHashTable_t mpht, mphtStatic;
+    size_t dataSize;
+    uint32_t value, ii, *keyOffsets, offset;
+    uint64_t* itemSize;
+
+    fillKeys(1000);
+    assert_int_equal(mpHashTableBuild(&mpht, keys, NULL, values, 1000, sizeof(uint32_t)), UTILS_STATUS_SUCCESS);
+    dataSize = mpht.dataSize;
+    assert_true(dataSize <= sizeof(block));
+    memcpy(block, mpht.data, dataSize);
+    assert_int_equal(mpHashTableDelete(&mpht), UTILS_STATUS_SUCCESS);
+
+    /* The block is position-independent, so it can be used from wherever it was copied */
+    assert_int_equal(mpHashTableInitStatic(&mphtStatic, block, dataSize), UTILS_STATUS_SUCCESS);
+    assert_int_equal(mphtStatic.items, 1000);
+    for (ii = 0; ii < 1000; ii++) {
+        assert_int_equal(mpHashTableGet(&mphtStatic, keysBuf[ii], &value), UTILS_STATUS_SUCCESS);
+        assert_int_equal(value, ii * 3 + 1);
+    }
+    assert_int_equal(mpHashTableDelete(&mphtStatic), UTILS_STATUS_SUCCESS);
+
+    /* Invalid blocks */
+    assert_int_equal(mpHashTableInitStatic(&mphtStatic, NULL, dataSize), UTILS_STATUS_ERROR);
+    assert_int_equal(mpHashTableInitStatic(&mphtStatic, block, dataSize - 1), UTILS_STATUS_ERROR);
+    assert_int_equal(mpHashTableInitStatic(&mphtStatic, block, 8), UTILS_STATUS_ERROR);
+    assert_int_equal(mpHashTableInitStatic(&mphtStatic, (uint8_t*)block + 4, dataSize), UTILS_STATUS_ERROR);
+    ((uint8_t*)block)[0] ^= 0xFF;
+    assert_int_equal(mpHashTableInitStatic(&mphtStatic, block, dataSize), UTILS_STATUS_ERROR);
+    assert_null(mphtStatic.data);
+    ((uint8_t*)block)[0] ^= 0xFF;
+    assert_int_equal(mpHashTableInitStatic(&mphtStatic, block, dataSize), UTILS_STATUS_SUCCESS);
+    keyOffsets = (uint32_t*)mphtStatic._keyOffsets;
+    assert_int_equal(mpHashTableDelete(&mphtStatic), UTILS_STATUS_SUCCESS);
+
+    /* Key offsets going back or past the keys area */
+    offset = keyOffsets[500];
+    keyOffsets[500] = keyOffsets[1000] + 1000;
+    assert_int_equal(mpHashTableInitStatic(&mphtStatic, block, dataSize), UTILS_STATUS_ERROR);
+    keyOffsets[500] = 0;
+    assert_int_equal(mpHashTableInitStatic(&mphtStatic, block, dataSize), UTILS_STATUS_ERROR);
+    keyOffsets[500] = offset;
+    offset = keyOffsets[1000];
+    keyOffsets[1000] += 1;
+    assert_int_equal(mpHashTableInitStatic(&mphtStatic, block, dataSize), UTILS_STATUS_ERROR);
+    keyOffsets[1000] = offset;
+
+    /* Item size whose product with items wraps around to the same block size (1000 * 2^61 = 0 mod 2^64) */
+    itemSize = &block[3];
+    assert_int_equal(*itemSize, sizeof(uint32_t));
+    *itemSize += (uint64_t)1 << 61;
+    assert_int_equal(mpHashTableInitStatic(&mphtStatic, block, dataSize), UTILS_STATUS_ERROR);
+    *itemSize = sizeof(uint32_t);
+    assert_int_equal(mpHashTableInitStatic(&mphtStatic, block, dataSize), UTILS_STATUS_SUCCESS);
+    assert_int_equal(mpHashTableDelete(&mphtStatic), UTILS_STATUS_SUCCESS);
+}
+
+int main(void) {
+    const struct CMUnitTest test_MPHashTable[] = {
+        cmocka_unit_test(test_mpHashTableBuildAndGet),
+        cmocka_unit_test(test_mpHashTableBinaryKeys),
+        cmocka_unit_test(test_mpHashTableBuildErrors),
+        cmocka_unit_test(test_mpHashTableInitStatic),
+    };
+
+    return cmocka_run_group_tests(test_MPHashTable, NULL, NULL);
+}
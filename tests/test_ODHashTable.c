@@ -0,0 +1,370 @@
+/* BEGIN Header */
+/**
+ ******************************************************************************
+ * \file            test_ODHashTable.c
+ * \author          Andrea Vivani
+ * \brief           Unit tests for ODHashTable.c
+ ******************************************************************************
+ * \copyright
+ *
+ * Copyright 2024 Andrea Vivani
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the “Software”), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ ******************************************************************************
+ */
+/* END Header */
+
+/* Includes ------------------------------------------------------------------*/
+
+#include <setjmp.h>
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include "ODHashTable.h"
+#include "hashFunctions.h"
+
+#include <cmocka.h>
+
+/* Support functions ---------------------------------------------------------*/
+
+static uint8_t callocFail = 0;
+
+void* ADVUtils_testCalloc(const size_t number_of_elements, const size_t size) {
+    if ((number_of_elements > 0) && !callocFail) {
+        return test_calloc(number_of_elements, size);
+    } else {
+        return NULL;
+    }
+}
+
+static uint8_t mallocFail = 0;
+
+void* ADVUtils_testMalloc(const size_t size) {
+    if (!mallocFail) {
+        return test_malloc(size);
+    } else {
+        return NULL;
+    }
+}
+
+static uint8_t skipAssert = 0;
+
+void ADVUtils_testAssert(const int result, const char* const expression, const char* const file, const int line) {
+    if (skipAssert) {
+        return;
+    } else {
+        mock_assert(result, expression, file, line);
+    }
+}
+
+static uint16_t mockHash = 0;
+
+uint32_t ADVUtils_testHash(char* key) {
+    if (!mockHash) {
+        return hash_FNV1A(key);
+    } else {
+        return mockHash;
+    }
+}
+
+/* Functions -----------------------------------------------------------------*/
+
+/* Functions -----------------------------------------------------------------*/
+
+static void test_odHashTableInit(void** state) {
+    (void)state; /* unused */
+    odHashTable_t odht;
+    assert_int_equal(odHashTableInit(&odht, sizeof(int), 10, ODHT_RESIZABLE), UTILS_STATUS_SUCCESS);
+    assert_int_equal(odht.size, 16);
+    assert_int_equal(odht.items, 0);
+    assert_int_equal(odht._capacity, 10);
+    assert_int_equal(odht._indexWidth, 1);
+    assert_ptr_equal(odht.entries, (uint8_t*)odht._index + 16);
+    test_free(odht._index);
+    /* Index slots get wider as the number of entries grows */
+    assert_int_equal(odHashTableInit(&odht, sizeof(int), 300, ODHT_RESIZABLE), UTILS_STATUS_SUCCESS);
+    assert_int_equal(odht.size, 512);
+    assert_int_equal(odht._indexWidth, 2);
+    test_free(odht._index);
+    assert_int_equal(odHashTableInit(&odht, sizeof(int), 70000, ODHT_RESIZABLE), UTILS_STATUS_SUCCESS);
+    assert_int_equal(odht.size, 131072);
+    assert_int_equal(odht._indexWidth, 4);
+    test_free(odht._index);
+    /* Check allocation failure */
+    callocFail = 1;
+    expect_assert_failure(odHashTableInit(&odht, sizeof(int), 10, ODHT_RESIZABLE));
+    skipAssert = 1;
+    assert_int_equal(odHashTableInit(&odht, sizeof(int), 10, ODHT_RESIZABLE), UTILS_STATUS_ERROR);
+    skipAssert = 0;
+    callocFail = 0;
+}
+
+static void test_odHashTablePutAndGet(void** state) {
+    (void)state; /* unused */
+    odHashTable_t odht;
+    int value1 = 42;
+    int value2 = 43;
+    int out_value;
+    char key[8];
+    char longKey[] = "a key longer than inline storage";
+    assert_int_equal(odHashTableInit(&odht, sizeof(int), 10, ODHT_NOT_RESIZABLE), UTILS_STATUS_SUCCESS);
+    assert_int_equal(odHashTableGet(&odht, "key1", &out_value, ODHT_DO_NOT_REMOVE_ITEM), UTILS_STATUS_EMPTY);
+    assert_int_equal(odHashTablePut(&odht, NULL, &value1), UTILS_STATUS_ERROR);
+    assert_int_equal(odHashTablePut(&odht, "key1", NULL), UTILS_STATUS_ERROR);
+    assert_int_equal(odHashTablePut(&odht, "key1", &value1), UTILS_STATUS_SUCCESS);
+    assert_int_equal(odHashTablePut(&odht, "key2", &value2), UTILS_STATUS_SUCCESS);
+    assert_int_equal(odht.items, 2);
+    assert_int_equal(odHashTableGet(&odht, "key1", &out_value, ODHT_DO_NOT_REMOVE_ITEM), UTILS_STATUS_SUCCESS);
+    assert_int_equal(out_value, value1);
+    assert_int_equal(odHashTableGet(&odht, "key3", &out_value, ODHT_DO_NOT_REMOVE_ITEM), UTILS_STATUS_ERROR);
+    /* Update */
+    assert_int_equal(odHashTablePut(&odht, "key1", &value2), UTILS_STATUS_SUCCESS);
+    assert_int_equal(odht.items, 2);
+    assert_int_equal(odht._used, 2);
+    assert_int_equal(odHashTableGet(&odht, "key1", &out_value, ODHT_REMOVE_ITEM), UTILS_STATUS_SUCCESS);
+    assert_int_equal(out_value, value2);
+    assert_int_equal(odht.items, 1);
+    assert_int_equal(odHashTableGet(&odht, "key1", &out_value, ODHT_DO_NOT_REMOVE_ITEM), UTILS_STATUS_ERROR);
+    /* Long keys are allocated */
+    assert_int_equal(odHashTablePut(&odht, longKey, &value1), UTILS_STATUS_SUCCESS);
+    assert_int_equal(odHashTableGet(&odht, longKey, &out_value, ODHT_DO_NOT_REMOVE_ITEM), UTILS_STATUS_SUCCESS);
+    assert_int_equal(out_value, value1);
+    mallocFail = 1;
+    skipAssert = 1;
+    assert_int_equal(odHashTablePut(&odht, "another key longer than inline storage", &value1), UTILS_STATUS_ERROR);
+    mallocFail = 0;
+    skipAssert = 0;
+    assert_int_equal(odht.items, 2);
+    /* Fill entries array, removed entries are reclaimed before reporting the table as full */
+    for (int ii = 0; ii < 7; ii++) {
+        snprintf(key, sizeof(key), "k%d", ii);
+        assert_int_equal(odHashTablePut(&odht, key, &ii), UTILS_STATUS_SUCCESS);
+    }
+    assert_int_equal(odht._used, 10);
+    assert_int_equal(odHashTablePut(&odht, "k7", &value1), UTILS_STATUS_SUCCESS);
+    assert_int_equal(odht._used, 10);
+    assert_int_equal(odht.items, 10);
+    assert_int_equal(odHashTablePut(&odht, "k8", &value1), UTILS_STATUS_FULL);
+    assert_int_equal(odHashTablePut(&odht, "k7", &value2), UTILS_STATUS_SUCCESS);
+    assert_int_equal(odht.size, 16);
+    for (int ii = 0; ii < 7; ii++) {
+        snprintf(key, sizeof(key), "k%d", ii);
+        assert_int_equal(odHashTableGet(&odht, key, &out_value, ODHT_DO_NOT_REMOVE_ITEM), UTILS_STATUS_SUCCESS);
+        assert_int_equal(out_value, ii);
+    }
+    assert_int_equal(odHashTableGet(&odht, longKey, &out_value, ODHT_REMOVE_ITEM), UTILS_STATUS_SUCCESS);
+    assert_int_equal(odHashTableFlush(&odht), UTILS_STATUS_SUCCESS);
+    assert_int_equal(odHashTableFlush(&odht), UTILS_STATUS_EMPTY);
+    assert_int_equal(odht._used, 0);
+    odHashTableDelete(&odht);
+}
+
+static void test_odHashTableBinaryKeys(void** state) {
+    (void)state; /* unused */
+    odHashTable_t odht;
+    const uint8_t key1[] = {0x00, 0x01, 0x02};
+    const uint8_t key2[] = {0x00, 0x01, 0x03};
+    uint8_t longKey[40] = {0};
+    int value1 = 1, value2 = 2, value3 = 3;
+    int out_value;
+    assert_int_equal(odHashTableInit(&odht, sizeof(int), 10, ODHT_RESIZABLE), UTILS_STATUS_SUCCESS);
+    assert_int_equal(odHashTableGetBin(&odht, key1, sizeof(key1), &out_value, ODHT_DO_NOT_REMOVE_ITEM), UTILS_STATUS_EMPTY);
+    assert_int_equal(odHashTablePutBin(&odht, NULL, sizeof(key1), &value1), UTILS_STATUS_ERROR);
+    assert_int_equal(odHashTablePutBin(&odht, key1, 0, &value1), UTILS_STATUS_ERROR);
+    assert_int_equal(odHashTablePutBin(&odht, key1, sizeof(key1), NULL), UTILS_STATUS_ERROR);
+    assert_int_equal(odHashTablePutBin(&odht, key1, sizeof(key1), &value1), UTILS_STATUS_SUCCESS);
+    assert_int_equal(odHashTablePutBin(&odht, key2, sizeof(key2), &value2), UTILS_STATUS_SUCCESS);
+    assert_int_equal(odHashTablePutBin(&odht, longKey, sizeof(longKey), &value3), UTILS_STATUS_SUCCESS);
+    assert_int_equal(odHashTableGetBin(&odht, NULL, sizeof(key1), &out_value, ODHT_DO_NOT_REMOVE_ITEM), UTILS_STATUS_ERROR);
+    assert_int_equal(odHashTableGetBin(&odht, key1, 2, &out_value, ODHT_DO_NOT_REMOVE_ITEM), UTILS_STATUS_ERROR);
+    assert_int_equal(odHashTableGetBin(&odht, key2, sizeof(key2), &out_value, ODHT_REMOVE_ITEM), UTILS_STATUS_SUCCESS);
+    assert_int_equal(out_value, value2);
+    assert_int_equal(odHashTableGetBin(&odht, longKey, sizeof(longKey), &out_value, ODHT_DO_NOT_REMOVE_ITEM), UTILS_STATUS_SUCCESS);
+    assert_int_equal(out_value, value3);
+    assert_int_equal(odHashTableGetBin(&odht, key1, sizeof(key1), &out_value, ODHT_DO_NOT_REMOVE_ITEM), UTILS_STATUS_SUCCESS);
+    assert_int_equal(out_value, value1);
+    odHashTableDelete(&odht);
+}
+
+static void test_odHashTableCollisions(void** state) {
+    (void)state; /* unused */
+    odHashTable_t odht;
+    int out_value;
+    char key[8];
+    assert_int_equal(odHashTableInit(&odht, sizeof(int), 40, ODHT_NOT_RESIZABLE), UTILS_STATUS_SUCCESS);
+    /* Same hash for all keys, they are all in the same probe sequence */
+    mockHash = 0x05;
+    for (int ii = 0; ii < 30; ii++) {
+        snprintf(key, sizeof(key), "c%d", ii);
+        assert_int_equal(odHashTablePut(&odht, key, &ii), UTILS_STATUS_SUCCESS);
+    }
+    /* Removed entries leave their index slot marked, keys after them are still found */
+    for (int ii = 0; ii < 30; ii += 2) {
+        snprintf(key, sizeof(key), "c%d", ii);
+        assert_int_equal(odHashTableGet(&odht, key, &out_value, ODHT_REMOVE_ITEM), UTILS_STATUS_SUCCESS);
+        assert_int_equal(out_value, ii);
+    }
+    for (int ii = 1; ii < 30; ii += 2) {
+        snprintf(key, sizeof(key), "c%d", ii);
+        assert_int_equal(odHashTableGet(&odht, key, &out_value, ODHT_DO_NOT_REMOVE_ITEM), UTILS_STATUS_SUCCESS);
+        assert_int_equal(out_value, ii);
+    }
+    assert_int_equal(odHashTableGet(&odht, "c0", &out_value, ODHT_DO_NOT_REMOVE_ITEM), UTILS_STATUS_ERROR);
+    mockHash = 0;
+    odHashTableDelete(&odht);
+}
+
+static void test_odHashTableResize(void** state) {
+    (void)state; /* unused */
+    odHashTable_t odht;
+    int out_value;
+    char key[8];
+    assert_int_equal(odHashTableInit(&odht, sizeof(int), 4, ODHT_RESIZABLE), UTILS_STATUS_SUCCESS);
+    for (int ii = 0; ii < 5; ii++) {
+        snprintf(key, sizeof(key), "r%d", ii);
+        assert_int_equal(odHashTablePut(&odht, key, &ii), UTILS_STATUS_SUCCESS);
+    }
+    assert_int_equal(odht.size, 8);
+    /* Resize failure */
+    callocFail = 1;
+    skipAssert = 1;
+    assert_int_equal(odHashTablePut(&odht, "r5", &out_value), UTILS_STATUS_ERROR);
+    callocFail = 0;
+    skipAssert = 0;
+    for (int ii = 5; ii < 300; ii++) {
+        snprintf(key, sizeof(key), "r%d", ii);
+        assert_int_equal(odHashTablePut(&odht, key, &ii), UTILS_STATUS_SUCCESS);
+    }
+    assert_int_equal(odht.size, 512);
+    assert_int_equal(odht._indexWidth, 2);
+    for (int ii = 0; ii < 300; ii++) {
+        snprintf(key, sizeof(key), "r%d", ii);
+        assert_int_equal(odHashTableGet(&odht, key, &out_value, ODHT_DO_NOT_REMOVE_ITEM), UTILS_STATUS_SUCCESS);
+        assert_int_equal(out_value, ii);
+    }
+    /* Down-sizing, and its failure */
+    for (int ii = 0; ii < 197; ii++) {
+        snprintf(key, sizeof(key), "r%d", ii);
+        assert_int_equal(odHashTableGet(&odht, key, &out_value, ODHT_REMOVE_ITEM), UTILS_STATUS_SUCCESS);
+    }
+    assert_int_equal(odht.size, 512);
+    callocFail = 1;
+    skipAssert = 1;
+    assert_int_equal(odHashTableGet(&odht, "r197", &out_value, ODHT_REMOVE_ITEM), UTILS_STATUS_WARNING);
+    callocFail = 0;
+    skipAssert = 0;
+    assert_int_equal(odht.size, 512);
+    assert_int_equal(odHashTableGet(&odht, "r198", &out_value, ODHT_REMOVE_ITEM), UTILS_STATUS_SUCCESS);
+    assert_int_equal(odht.size, 256);
+    assert_int_equal(odht._used, odht.items);
+    assert_int_equal(odht._indexWidth, 1);
+    for (int ii = 199; ii < 300; ii++) {
+        snprintf(key, sizeof(key), "r%d", ii);
+        assert_int_equal(odHashTableGet(&odht, key, &out_value, ODHT_REMOVE_ITEM), UTILS_STATUS_SUCCESS);
+        assert_int_equal(out_value, ii);
+    }
+    assert_int_equal(odht.size, 8);
+    assert_int_equal(odht.items, 0);
+    odHashTableDelete(&odht);
+
+    /* 32-bit index slots */
+    assert_int_equal(odHashTableInit(&odht, sizeof(int), 16, ODHT_RESIZABLE), UTILS_STATUS_SUCCESS);
+    for (int ii = 0; ii < 70000; ii++) {
+        snprintf(key, sizeof(key), "w%d", ii);
+        assert_int_equal(odHashTablePut(&odht, key, &ii), UTILS_STATUS_SUCCESS);
+    }
+    assert_int_equal(odht._indexWidth, 4);
+    for (int ii = 0; ii < 70000; ii++) {
+        snprintf(key, sizeof(key), "w%d", ii);
+        assert_int_equal(odHashTableGet(&odht, key, &out_value, ODHT_DO_NOT_REMOVE_ITEM), UTILS_STATUS_SUCCESS);
+        assert_int_equal(out_value, ii);
+    }
+    odHashTableDelete(&odht);
+}
+
+static void test_odHashTableIterator(void** state) {
+    (void)state; /* unused */
+    odHashTable_t odht;
+    odHashTableIterator_t it;
+    char key[8];
+    int out_value, expected = 1, count = 0;
+    assert_int_equal(odHashTableInit(&odht, sizeof(int), 8, ODHT_RESIZABLE), UTILS_STATUS_SUCCESS);
+    odHashTableIt(&it, &odht);
+    assert_int_equal(odHashTableItNext(&it), UTILS_STATUS_ERROR);
+    for (int ii = 0; ii < 20; ii++) {
+        snprintf(key, sizeof(key), "i%d", ii);
+        assert_int_equal(odHashTablePut(&odht, key, &ii), UTILS_STATUS_SUCCESS);
+    }
+    /* Removed items are skipped, updated ones keep their position and new ones go last, also across resizes */
+    for (int ii = 0; ii < 20; ii += 2) {
+        snprintf(key, sizeof(key), "i%d", ii);
+        assert_int_equal(odHashTableGet(&odht, key, &out_value, ODHT_REMOVE_ITEM), UTILS_STATUS_SUCCESS);
+    }
+    out_value = 5;
+    assert_int_equal(odHashTablePut(&odht, "i5", &out_value), UTILS_STATUS_SUCCESS);
+    for (int ii = 20; ii < 40; ii += 2) {
+        snprintf(key, sizeof(key), "i%d", ii + 1);
+        assert_int_equal(odHashTablePut(&odht, key, &(int){ii + 1}), UTILS_STATUS_SUCCESS);
+    }
+    odHashTableIt(&it, &odht);
+    while (odHashTableItNext(&it) == UTILS_STATUS_SUCCESS) {
+        snprintf(key, sizeof(key), "i%d", expected);
+        assert_string_equal(it.key, key);
+        assert_int_equal(it.keyLen, strlen(key) + 1);
+        assert_int_equal(*(int*)it.value, expected);
+        expected += 2;
+        count++;
+    }
+    assert_int_equal(count, 20);
+    odHashTableDelete(&odht);
+}
+
+static void test_odHashTableDelete(void** state) {
+    (void)state; /* unused */
+    odHashTable_t odht;
+    int value = 42;
+    assert_int_equal(odHashTableInit(&odht, sizeof(int), 10, ODHT_RESIZABLE), UTILS_STATUS_SUCCESS);
+    assert_int_equal(odHashTablePut(&odht, "a key longer than inline storage", &value), UTILS_STATUS_SUCCESS);
+    uint32_t size, items;
+    odHashTableInfo(&odht, &size, &items);
+    assert_int_equal(size, 16);
+    assert_int_equal(items, 1);
+    assert_int_equal(odHashTableDelete(&odht), UTILS_STATUS_SUCCESS);
+    assert_null(odht._index);
+    /* Check null deletion */
+    assert_int_equal(odHashTableDelete(&odht), UTILS_STATUS_ERROR);
+}
+
+int main(void) {
+    const struct CMUnitTest test_ODHashTable[] = {
+        cmocka_unit_test(test_odHashTableInit),
+        cmocka_unit_test(test_odHashTablePutAndGet),
+        cmocka_unit_test(test_odHashTableBinaryKeys),
+        cmocka_unit_test(test_odHashTableCollisions),
+        cmocka_unit_test(test_odHashTableResize),
+        cmocka_unit_test(test_odHashTableIterator),
+        cmocka_unit_test(test_odHashTableDelete),
+    };
+
+    return cmocka_run_group_tests(test_ODHashTable, NULL, NULL);
+}
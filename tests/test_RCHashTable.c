@@ -0,0 +1,455 @@
+/* BEGIN Header */
+/**
+ ******************************************************************************
+ * \file            test_RCHashTable.c
+ * \author          Andrea Vivani
+ * \brief           Unit tests for RCHashTable.c
+ ******************************************************************************
+ * \copyright
+ *
+ * Copyright 2024 Andrea Vivani
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the “Software”), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ ******************************************************************************
+ */
+/* END Header */
+
+/* Includes ------------------------------------------------------------------*/
+
+#include <setjmp.h>
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include "RCHashTable.h"
+#include "hashFunctions.h"
+
+#include <cmocka.h>
+
+/* Macros --------------------------------------------------------------------*/
+
+#define READERS_NUM 4
+#define KEYS_NUM    64
+
+/* Support functions ---------------------------------------------------------*/
+
+static uint8_t callocFail = 0;
+
+void* ADVUtils_testCalloc(const size_t number_of_elements, const size_t size) {
+    if ((number_of_elements > 0) && !callocFail) {
+        return test_calloc(number_of_elements, size);
+    } else {
+        return NULL;
+    }
+}
+
+static uint8_t mallocFail = 0;
+
+void* ADVUtils_testMalloc(const size_t size) {
+    if (!mallocFail) {
+        return test_malloc(size);
+    } else {
+        return NULL;
+    }
+}
+
+static uint8_t skipAssert = 0;
+
+void ADVUtils_testAssert(const int result, const char* const expression, const char* const file, const int line) {
+    if (skipAssert) {
+        return;
+    } else {
+        mock_assert(result, expression, file, line);
+    }
+}
+
+static uint16_t mockHash = 0;
+
+uint32_t ADVUtils_testHash(char* key) {
+    if (!mockHash) {
+        return hash_FNV1A(key);
+    } else {
+        return mockHash;
+    }
+}
+
+static uint32_t retiredCount(rcHashTable_t* rcht) {
+    uint32_t count = 0;
+    for (rcHashTableRetired_t* block = rcht->_retired; block != NULL; block = block->next) {
+        count++;
+    }
+    return count;
+}
+
+typedef struct {
+    rcHashTable_t* rcht;
+    atomic_int* stop;
+    uint32_t found, errors;
+} readerArgs_t;
+
+static void* readerThread(void* arg) {
+    readerArgs_t* args = (readerArgs_t*)arg;
+    rcHashTableReader_t* reader;
+    char key[16];
+    int value;
+    uint32_t ii = 0;
+
+    /* cmocka asserts and allocations are not thread-safe, errors are counted and checked by main thread */
+    if (rcHashTableReaderRegister(args->rcht, &reader) != UTILS_STATUS_SUCCESS) {
+        args->errors++;
+        return NULL;
+    }
+    while (!atomic_load(args->stop)) {
+        snprintf(key, sizeof(key), "key%u", ii % KEYS_NUM);
+        if (rcHashTableGet(args->rcht, reader, key, &value, RCHT_DO_NOT_REMOVE_ITEM) == UTILS_STATUS_SUCCESS) {
+            /* Values written for each key always encode the key index */
+            if ((value % 1000) != (int)(ii % KEYS_NUM)) {
+                args->errors++;
+            }
+            args->found++;
+        }
+        ii++;
+    }
+    rcHashTableReaderUnregister(args->rcht, reader);
+
+    return NULL;
+}
+
+/* Functions -----------------------------------------------------------------*/
+
+static void test_rcHashTableInit(void** state) {
+    (void)state; /* unused */
+    rcHashTable_t rcht;
+    uint32_t size, items;
+    assert_int_equal(rcHashTableInit(&rcht, sizeof(int), 10, 4), UTILS_STATUS_SUCCESS);
+    rcHashTableInfo(&rcht, &size, &items);
+    assert_int_equal(size, 16);
+    assert_int_equal(items, 0);
+    assert_int_equal(rcht.itemSize, sizeof(int));
+    assert_int_equal(rcht.readersNum, 4);
+    assert_int_equal((uintptr_t)rcht._readers % 64, 0);
+    assert_int_equal(rcht._readerStride % 64, 0);
+    assert_int_equal(rcHashTableDelete(&rcht), UTILS_STATUS_SUCCESS);
+    assert_int_equal(rcHashTableDelete(&rcht), UTILS_STATUS_ERROR);
+    /* Minimum size */
+    assert_int_equal(rcHashTableInit(&rcht, sizeof(int), 3, 1), UTILS_STATUS_SUCCESS);
+    rcHashTableInfo(&rcht, &size, &items);
+    assert_int_equal(size, 8);
+    assert_int_equal(rcHashTableDelete(&rcht), UTILS_STATUS_SUCCESS);
+    /* Check allocation failure */
+    mallocFail = 1;
+    expect_assert_failure(rcHashTableInit(&rcht, sizeof(int), 10, 4));
+    skipAssert = 1;
+    assert_int_equal(rcHashTableInit(&rcht, sizeof(int), 10, 4), UTILS_STATUS_ERROR);
+    mallocFail = 0;
+    callocFail = 1;
+    assert_int_equal(rcHashTableInit(&rcht, sizeof(int), 10, 4), UTILS_STATUS_ERROR);
+    assert_null(rcht._readersMem);
+    callocFail = 0;
+    skipAssert = 0;
+}
+
+static void test_rcHashTableReaders(void** state) {
+    (void)state; /* unused */
+    rcHashTable_t rcht;
+    rcHashTableReader_t *reader1, *reader2, *reader3;
+    assert_int_equal(rcHashTableInit(&rcht, sizeof(int), 10, 2), UTILS_STATUS_SUCCESS);
+    assert_int_equal(rcHashTableReaderRegister(&rcht, &reader1), UTILS_STATUS_SUCCESS);
+    assert_int_equal(rcHashTableReaderRegister(&rcht, &reader2), UTILS_STATUS_SUCCESS);
+    assert_true(reader1 != reader2);
+    assert_int_equal(rcHashTableReaderRegister(&rcht, &reader3), UTILS_STATUS_FULL);
+    rcHashTableReaderUnregister(&rcht, reader1);
+    assert_int_equal(rcHashTableReaderRegister(&rcht, &reader3), UTILS_STATUS_SUCCESS);
+    assert_ptr_equal(reader3, reader1);
+    assert_int_equal(rcHashTableDelete(&rcht), UTILS_STATUS_SUCCESS);
+}
+
+static void test_rcHashTablePutAndGet(void** state) {
+    (void)state; /* unused */
+    rcHashTable_t rcht;
+    rcHashTableReader_t* reader;
+    uint32_t size, items;
+    int value;
+    assert_int_equal(rcHashTableInit(&rcht, sizeof(int), 10, 1), UTILS_STATUS_SUCCESS);
+    assert_int_equal(rcHashTableReaderRegister(&rcht, &reader), UTILS_STATUS_SUCCESS);
+    /* Wrong parameters */
+    value = 1;
+    assert_int_equal(rcHashTablePut(&rcht, NULL, &value), UTILS_STATUS_ERROR);
+    assert_int_equal(rcHashTablePut(&rcht, "key", NULL), UTILS_STATUS_ERROR);
+    assert_int_equal(rcHashTableGet(&rcht, reader, NULL, &value, RCHT_DO_NOT_REMOVE_ITEM), UTILS_STATUS_ERROR);
+    assert_int_equal(rcHashTableGet(&rcht, NULL, "key", &value, RCHT_DO_NOT_REMOVE_ITEM), UTILS_STATUS_ERROR);
+    assert_int_equal(rcHashTableGet(&rcht, reader, "key", &value, RCHT_DO_NOT_REMOVE_ITEM), UTILS_STATUS_ERROR);
+    assert_int_equal(rcHashTableGet(&rcht, NULL, "key", &value, RCHT_REMOVE_ITEM), UTILS_STATUS_ERROR);
+    assert_int_equal(rcHashTableFlush(&rcht), UTILS_STATUS_EMPTY);
+    /* Put and replace, with no active reader replaced entries are freed right away */
+    value = 10;
+    assert_int_equal(rcHashTablePut(&rcht, "key", &value), UTILS_STATUS_SUCCESS);
+    value = 11;
+    assert_int_equal(rcHashTablePut(&rcht, "other key", &value), UTILS_STATUS_SUCCESS);
+    value = 12;
+    assert_int_equal(rcHashTablePut(&rcht, "key", &value), UTILS_STATUS_SUCCESS);
+    assert_null(rcht._retired);
+    assert_int_equal(rcHashTableGet(&rcht, reader, "key", &value, RCHT_DO_NOT_REMOVE_ITEM), UTILS_STATUS_SUCCESS);
+    assert_int_equal(value, 12);
+    assert_int_equal(atomic_load(&reader->epoch), 0);
+    assert_int_equal(rcHashTableGet(&rcht, reader, "other key", &value, RCHT_DO_NOT_REMOVE_ITEM), UTILS_STATUS_SUCCESS);
+    assert_int_equal(value, 11);
+    rcHashTableInfo(&rcht, &size, &items);
+    assert_int_equal(items, 2);
+    /* Removal, reader is not needed */
+    assert_int_equal(rcHashTableGet(&rcht, NULL, "key", &value, RCHT_REMOVE_ITEM), UTILS_STATUS_SUCCESS);
+    assert_int_equal(value, 12);
+    assert_int_equal(rcHashTableGet(&rcht, NULL, "key", &value, RCHT_REMOVE_ITEM), UTILS_STATUS_ERROR);
+    assert_int_equal(rcHashTableGet(&rcht, reader, "key", &value, RCHT_DO_NOT_REMOVE_ITEM), UTILS_STATUS_ERROR);
+    rcHashTableInfo(&rcht, &size, &items);
+    assert_int_equal(items, 1);
+    /* Flush */
+    assert_int_equal(rcHashTableFlush(&rcht), UTILS_STATUS_SUCCESS);
+    assert_int_equal(rcHashTableFlush(&rcht), UTILS_STATUS_EMPTY);
+    assert_null(rcht._retired);
+    assert_int_equal(rcHashTableGet(&rcht, reader, "other key", &value, RCHT_DO_NOT_REMOVE_ITEM), UTILS_STATUS_ERROR);
+    /* Allocation failures */
+    assert_int_equal(rcHashTablePut(&rcht, "key", &value), UTILS_STATUS_SUCCESS);
+    skipAssert = 1;
+    callocFail = 1;
+    assert_int_equal(rcHashTableFlush(&rcht), UTILS_STATUS_ERROR);
+    callocFail = 0;
+    mallocFail = 1;
+    assert_int_equal(rcHashTablePut(&rcht, "key", &value), UTILS_STATUS_ERROR);
+    mallocFail = 0;
+    skipAssert = 0;
+    assert_int_equal(rcHashTableDelete(&rcht), UTILS_STATUS_SUCCESS);
+}
+
+static void test_rcHashTableReclamation(void** state) {
+    (void)state; /* unused */
+    rcHashTable_t rcht;
+    rcHashTableReader_t *reader, *other;
+    int value = 1;
+    assert_int_equal(rcHashTableInit(&rcht, sizeof(int), 8, 2), UTILS_STATUS_SUCCESS);
+    assert_int_equal(rcHashTableReaderRegister(&rcht, &reader), UTILS_STATUS_SUCCESS);
+    assert_int_equal(rcHashTableReaderRegister(&rcht, &other), UTILS_STATUS_SUCCESS);
+    assert_int_equal(rcHashTablePut(&rcht, "key", &value), UTILS_STATUS_SUCCESS);
+    /* A reader in the middle of a Get keeps replaced entries alive */
+    atomic_store(&reader->epoch, atomic_load(&rcht._epoch));
+    value = 2;
+    assert_int_equal(rcHashTablePut(&rcht, "key", &value), UTILS_STATUS_SUCCESS);
+    assert_int_equal(retiredCount(&rcht), 1);
+    value = 3;
+    assert_int_equal(rcHashTablePut(&rcht, "key", &value), UTILS_STATUS_SUCCESS);
+    assert_int_equal(retiredCount(&rcht), 2);
+    /* A reader that started later doesn't, since it can't reach them anymore */
+    atomic_store(&other->epoch, atomic_load(&rcht._epoch));
+    atomic_store(&reader->epoch, 0);
+    rcHashTableReclaim(&rcht);
+    assert_int_equal(retiredCount(&rcht), 0);
+    /* Entry retired during other reader Get is kept until it is done */
+    assert_int_equal(rcHashTableGet(&rcht, NULL, "key", &value, RCHT_REMOVE_ITEM), UTILS_STATUS_SUCCESS);
+    assert_int_equal(value, 3);
+    assert_int_equal(retiredCount(&rcht), 1);
+    atomic_store(&other->epoch, 0);
+    rcHashTableReclaim(&rcht);
+    assert_int_equal(retiredCount(&rcht), 0);
+    /* Retired blocks still pending are freed on delete */
+    assert_int_equal(rcHashTablePut(&rcht, "key", &value), UTILS_STATUS_SUCCESS);
+    atomic_store(&reader->epoch, atomic_load(&rcht._epoch));
+    assert_int_equal(rcHashTableFlush(&rcht), UTILS_STATUS_SUCCESS);
+    assert_int_equal(retiredCount(&rcht), 2);
+    assert_int_equal(rcHashTableDelete(&rcht), UTILS_STATUS_SUCCESS);
+}
+
+static void test_rcHashTableCollisionsAndResize(void** state) {
+    (void)state; /* unused */
+    rcHashTable_t rcht;
+    rcHashTableReader_t* reader;
+    rcHashTableArray_t* arr;
+    uint32_t ii, size, items;
+    char key[16];
+    int value;
+    assert_int_equal(rcHashTableInit(&rcht, sizeof(int), 8, 1), UTILS_STATUS_SUCCESS);
+    assert_int_equal(rcHashTableReaderRegister(&rcht, &reader), UTILS_STATUS_SUCCESS);
+    /* Colliding keys are probed linearly */
+    mockHash = 3;
+    for (ii = 0; ii < 4; ii++) {
+        value = (int)ii;
+        snprintf(key, sizeof(key), "key%u", ii);
+        assert_int_equal(rcHashTablePut(&rcht, key, &value), UTILS_STATUS_SUCCESS);
+    }
+    arr = atomic_load(&rcht.table);
+    for (ii = 0; ii < 4; ii++) {
+        assert_non_null(atomic_load(&arr->slots[3 + ii]));
+    }
+    /* Removing an item in the middle of a probe sequence leaves a marker, at its end empties the slot */
+    assert_int_equal(rcHashTableGet(&rcht, NULL, "key1", &value, RCHT_REMOVE_ITEM), UTILS_STATUS_SUCCESS);
+    assert_non_null(atomic_load(&arr->slots[4]));
+    assert_int_equal(rcht._tombstones, 1);
+    assert_int_equal(rcHashTableGet(&rcht, NULL, "key3", &value, RCHT_REMOVE_ITEM), UTILS_STATUS_SUCCESS);
+    assert_null(atomic_load(&arr->slots[6]));
+    assert_int_equal(rcht._tombstones, 1);
+    assert_int_equal(rcHashTableGet(&rcht, reader, "key2", &value, RCHT_DO_NOT_REMOVE_ITEM), UTILS_STATUS_SUCCESS);
+    assert_int_equal(value, 2);
+    /* Marked slot is reused */
+    value = 5;
+    assert_int_equal(rcHashTablePut(&rcht, "key5", &value), UTILS_STATUS_SUCCESS);
+    assert_int_equal(rcht._tombstones, 0);
+    assert_int_equal(rcHashTableGet(&rcht, reader, "key5", &value, RCHT_DO_NOT_REMOVE_ITEM), UTILS_STATUS_SUCCESS);
+    assert_int_equal(value, 5);
+    assert_int_equal(rcHashTableFlush(&rcht), UTILS_STATUS_SUCCESS);
+    mockHash = 0;
+    /* Up-sizing */
+    for (ii = 0; ii < 40; ii++) {
+        value = (int)ii;
+        snprintf(key, sizeof(key), "key%u", ii);
+        assert_int_equal(rcHashTablePut(&rcht, key, &value), UTILS_STATUS_SUCCESS);
+    }
+    rcHashTableInfo(&rcht, &size, &items);
+    assert_int_equal(size, 64);
+    assert_int_equal(items, 40);
+    for (ii = 0; ii < 40; ii++) {
+        snprintf(key, sizeof(key), "key%u", ii);
+        assert_int_equal(rcHashTableGet(&rcht, reader, key, &value, RCHT_DO_NOT_REMOVE_ITEM), UTILS_STATUS_SUCCESS);
+        assert_int_equal(value, (int)ii);
+    }
+    /* Down-sizing, and its failure */
+    for (ii = 0; ii < 35; ii++) {
+        snprintf(key, sizeof(key), "key%u", ii);
+        assert_int_equal(rcHashTableGet(&rcht, NULL, key, &value, RCHT_REMOVE_ITEM), UTILS_STATUS_SUCCESS);
+    }
+    rcHashTableInfo(&rcht, &size, &items);
+    assert_int_equal(size, 16);
+    assert_int_equal(items, 5);
+    skipAssert = 1;
+    callocFail = 1;
+    assert_int_equal(rcHashTableGet(&rcht, NULL, "key35", &value, RCHT_REMOVE_ITEM), UTILS_STATUS_SUCCESS);
+    assert_int_equal(rcHashTableGet(&rcht, NULL, "key36", &value, RCHT_REMOVE_ITEM), UTILS_STATUS_WARNING);
+    callocFail = 0;
+    skipAssert = 0;
+    for (ii = 37; ii < 40; ii++) {
+        snprintf(key, sizeof(key), "key%u", ii);
+        assert_int_equal(rcHashTableGet(&rcht, reader, key, &value, RCHT_DO_NOT_REMOVE_ITEM), UTILS_STATUS_SUCCESS);
+        assert_int_equal(value, (int)ii);
+    }
+    assert_int_equal(rcHashTableDelete(&rcht), UTILS_STATUS_SUCCESS);
+}
+
+static void test_rcHashTableFull(void** state) {
+    (void)state; /* unused */
+    rcHashTable_t rcht;
+    rcHashTableReader_t* reader;
+    uint32_t ii, size, items;
+    char key[16];
+    int value;
+    assert_int_equal(rcHashTableInit(&rcht, sizeof(int), 8, 1), UTILS_STATUS_SUCCESS);
+    assert_int_equal(rcHashTableReaderRegister(&rcht, &reader), UTILS_STATUS_SUCCESS);
+    /* Check resize allocation failure, new entry is freed and the table is unchanged */
+    for (ii = 0; ii < 5; ii++) {
+        value = (int)ii;
+        snprintf(key, sizeof(key), "key%u", ii);
+        assert_int_equal(rcHashTablePut(&rcht, key, &value), UTILS_STATUS_SUCCESS);
+    }
+    skipAssert = 1;
+    callocFail = 1;
+    assert_int_equal(rcHashTablePut(&rcht, "key5", &value), UTILS_STATUS_ERROR);
+    callocFail = 0;
+    skipAssert = 0;
+    rcHashTableInfo(&rcht, &size, &items);
+    assert_int_equal(size, 8);
+    assert_int_equal(items, 5);
+    assert_int_equal(rcHashTableGet(&rcht, reader, "key5", &value, RCHT_DO_NOT_REMOVE_ITEM), UTILS_STATUS_ERROR);
+    /* At maximum size (RCHT_MAX_SIZE is 128 in tests) one slot is always left empty */
+    for (ii = 5; ii < 127; ii++) {
+        value = (int)ii;
+        snprintf(key, sizeof(key), "key%u", ii);
+        assert_int_equal(rcHashTablePut(&rcht, key, &value), UTILS_STATUS_SUCCESS);
+    }
+    assert_int_equal(rcHashTablePut(&rcht, "key127", &value), UTILS_STATUS_FULL);
+    rcHashTableInfo(&rcht, &size, &items);
+    assert_int_equal(size, 128);
+    assert_int_equal(items, 127);
+    /* Existing keys can still be updated */
+    value = 100;
+    assert_int_equal(rcHashTablePut(&rcht, "key0", &value), UTILS_STATUS_SUCCESS);
+    assert_int_equal(rcHashTableGet(&rcht, reader, "key0", &value, RCHT_DO_NOT_REMOVE_ITEM), UTILS_STATUS_SUCCESS);
+    assert_int_equal(value, 100);
+    assert_int_equal(rcHashTableGet(&rcht, reader, "key127", &value, RCHT_DO_NOT_REMOVE_ITEM), UTILS_STATUS_ERROR);
+    assert_int_equal(rcHashTableDelete(&rcht), UTILS_STATUS_SUCCESS);
+}
+
+static void test_rcHashTableConcurrency(void** state) {
+    (void)state; /* unused */
+    rcHashTable_t rcht;
+    pthread_t threads[READERS_NUM];
+    readerArgs_t args[READERS_NUM];
+    atomic_int stop;
+    char key[16];
+    int value;
+    uint32_t ii, round;
+
+    /* Only this thread writes, so cmocka allocation functions are never called concurrently */
+    atomic_init(&stop, 0);
+    assert_int_equal(rcHashTableInit(&rcht, sizeof(int), 8, READERS_NUM), UTILS_STATUS_SUCCESS);
+    for (ii = 0; ii < READERS_NUM; ii++) {
+        args[ii].rcht = &rcht;
+        args[ii].stop = &stop;
+        args[ii].found = 0;
+        args[ii].errors = 0;
+        assert_int_equal(pthread_create(&threads[ii], NULL, readerThread, &args[ii]), 0);
+    }
+
+    /* Items are added, replaced and removed while readers run, forcing up and down-sizing */
+    for (round = 0; round < 200; round++) {
+        for (ii = 0; ii < KEYS_NUM; ii++) {
+            value = (int)(round * 1000 + ii);
+            snprintf(key, sizeof(key), "key%u", ii);
+            assert_int_equal(rcHashTablePut(&rcht, key, &value), UTILS_STATUS_SUCCESS);
+        }
+        for (ii = 0; ii < KEYS_NUM; ii += 1 + (round & 1)) {
+            snprintf(key, sizeof(key), "key%u", ii);
+            assert_int_equal(rcHashTableGet(&rcht, NULL, key, &value, RCHT_REMOVE_ITEM), UTILS_STATUS_SUCCESS);
+            assert_int_equal(value % 1000, (int)ii);
+        }
+    }
+
+    atomic_store(&stop, 1);
+    for (ii = 0; ii < READERS_NUM; ii++) {
+        assert_int_equal(pthread_join(threads[ii], NULL), 0);
+        assert_int_equal(args[ii].errors, 0);
+    }
+    rcHashTableReclaim(&rcht);
+    assert_null(rcht._retired);
+    assert_int_equal(rcHashTableDelete(&rcht), UTILS_STATUS_SUCCESS);
+}
+
+int main(void) {
+    const struct CMUnitTest test_RCHashTable[] = {
+        cmocka_unit_test(test_rcHashTableInit),
+        cmocka_unit_test(test_rcHashTableReaders),
+        cmocka_unit_test(test_rcHashTablePutAndGet),
+        cmocka_unit_test(test_rcHashTableReclamation),
+        cmocka_unit_test(test_rcHashTableCollisionsAndResize),
+        cmocka_unit_test(test_rcHashTableFull),
+        cmocka_unit_test(test_rcHashTableConcurrency),
+    };
+
+    return cmocka_run_group_tests(test_RCHashTable, NULL, NULL);
+}
@@ -0,0 +1,188 @@
+/* BEGIN Header */
+/**
+ ******************************************************************************
+ * \file            test_RLS.c
+ * \author          Andrea Vivani
+ * \brief           Unit tests for RLS.c
+ ******************************************************************************
+ * \copyright
+ *
+ * Copyright 2024 Andrea Vivani
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the “Software”), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ ******************************************************************************
+ */
+/* END Header */
+
+/* Includes ------------------------------------------------------------------*/
+
+#include <setjmp.h>
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "RLS.h"
+
+#include <cmocka.h>
+
+/* Support functions ---------------------------------------------------------*/
+
+void* ADVUtils_testCalloc(const size_t number_of_elements, const size_t size) {
+    if (number_of_elements > 0) {
+        return test_calloc(number_of_elements, size);
+    } else {
+        return NULL;
+    }
+}
+
+void* ADVUtils_testMalloc(const size_t size) {
+    if (size > 0) {
+        return test_malloc(size);
+    } else {
+        return NULL;
+    }
+}
+
+static uint8_t skipAssert = 0;
+
+void ADVUtils_testAssert(const int result, const char* const expression, const char* const file, const int line) {
+    if (skipAssert) {
+        return;
+    } else {
+        mock_assert(result, expression, file, line);
+    }
+}
+
+/* Functions -----------------------------------------------------------------*/
+
+static void test_rlsInit(void** state) {
+    (void)state; /* unused */
+    rls_t rls;
+    assert_int_equal(rlsInit(&rls, 3, 0.99f, 100.0f), UTILS_STATUS_SUCCESS);
+    assert_int_equal(rls.theta.rows, 3);
+    assert_int_equal(rls.P.rows, 3);
+    assert_int_equal(rls.P.cols, 3);
+    assert_float_equal(rls.lambda, 0.99f, 1e-6);
+    assert_float_equal(matrixGet(&rls.P, 1, 1), 100.0f, 1e-6);
+    assert_float_equal(matrixGet(&rls.P, 0, 1), 0.0f, 1e-6);
+    assert_float_equal(rls.theta.data[2], 0.0f, 1e-6);
+    rlsDelete(&rls);
+    /* Check wrong forgetting factor */
+    expect_assert_failure(rlsInit(&rls, 3, 1.5f, 100.0f));
+    /* Check null initialization */
+    skipAssert = 0;
+    expect_assert_failure(rlsInit(&rls, 0, 0.99f, 100.0f));
+    skipAssert = 1;
+    assert_int_equal(rlsInit(&rls, 0, 0.99f, 100.0f), UTILS_STATUS_ERROR);
+    skipAssert = 0;
+}
+
+static void test_rlsDelete(void** state) {
+    (void)state; /* unused */
+    rls_t rls;
+    assert_int_equal(rlsInit(&rls, 3, 0.99f, 100.0f), UTILS_STATUS_SUCCESS);
+    assert_int_equal(rlsDelete(&rls), UTILS_STATUS_SUCCESS);
+    assert_null(rls.theta.data);
+    assert_null(rls.P.data);
+    assert_null(rls._Px.data);
+    /* Check null deletion */
+    assert_int_equal(rlsDelete(&rls), UTILS_STATUS_ERROR);
+}
+
+static void test_rlsInitStatic(void** state) {
+    (void)state; /* unused */
+    rls_t rls;
+    float theta[2], P[4], work[2];
+    rlsInitStatic(&rls, theta, P, work, 2, 1.0f, 10.0f);
+    assert_ptr_equal(rls.theta.data, theta);
+    assert_ptr_equal(rls.P.data, P);
+    assert_ptr_equal(rls._Px.data, work);
+    assert_float_equal(P[0], 10.0f, 1e-6);
+    assert_float_equal(P[1], 0.0f, 1e-6);
+    assert_float_equal(P[3], 10.0f, 1e-6);
+    assert_float_equal(rls._invLambda, 1.0f, 1e-6);
+}
+
+static void test_rlsUpdate(void** state) {
+    (void)state; /* unused */
+    rls_t rls;
+    float theta[3], P[9], work[3];
+    float x[3];
+    rlsInitStatic(&rls, theta, P, work, 3, 1.0f, 1e4f);
+    /* Identify y = 2 * x0 - 3 * x1 + 0.5 */
+    for (uint8_t ii = 0; ii < 20; ii++) {
+        x[0] = (float)(ii % 5) - 2.0f;
+        x[1] = (float)((ii * 3) % 7) * 0.5f;
+        x[2] = 1.0f;
+        rlsUpdate(&rls, x, 2.0f * x[0] - 3.0f * x[1] + 0.5f);
+    }
+    assert_float_equal(theta[0], 2.0f, 1e-3);
+    assert_float_equal(theta[1], -3.0f, 1e-3);
+    assert_float_equal(theta[2], 0.5f, 1e-3);
+    /* P must stay symmetric */
+    assert_float_equal(P[1], P[3], 1e-9);
+    assert_float_equal(P[2], P[6], 1e-9);
+    assert_float_equal(P[5], P[7], 1e-9);
+    /* A-priori error on a consistent sample is zero */
+    x[0] = 1.0f;
+    x[1] = 1.0f;
+    assert_float_equal(rlsUpdate(&rls, x, -0.5f), 0.0f, 1e-3);
+    assert_float_equal(rlsPredict(&rls, x), -0.5f, 1e-3);
+    /* Check tracking of changing parameters with forgetting factor */
+    rlsSetLambda(&rls, 0.9f);
+    for (uint8_t ii = 0; ii < 100; ii++) {
+        x[0] = (float)(ii % 5) - 2.0f;
+        x[1] = (float)((ii * 3) % 7) * 0.5f;
+        rlsUpdate(&rls, x, -1.0f * x[0] + 4.0f * x[1] - 2.0f);
+    }
+    assert_float_equal(theta[0], -1.0f, 1e-3);
+    assert_float_equal(theta[1], 4.0f, 1e-3);
+    assert_float_equal(theta[2], -2.0f, 1e-3);
+    /* Check that update is skipped if P is not positive-definite */
+    rlsReset(&rls, -1.0f);
+    assert_float_equal(rlsUpdate(&rls, x, 1.0f), 1.0f, 1e-6);
+    assert_float_equal(theta[0], 0.0f, 1e-6);
+    assert_float_equal(P[0], -1.0f, 1e-6);
+}
+
+static void test_rlsReset(void** state) {
+    (void)state; /* unused */
+    rls_t rls;
+    float theta[2], P[4], work[2];
+    float x[2] = {1.0f, 2.0f};
+    rlsInitStatic(&rls, theta, P, work, 2, 0.95f, 10.0f);
+    rlsUpdate(&rls, x, 3.0f);
+    rlsReset(&rls, 5.0f);
+    assert_float_equal(theta[0], 0.0f, 1e-6);
+    assert_float_equal(theta[1], 0.0f, 1e-6);
+    assert_float_equal(P[0], 5.0f, 1e-6);
+    assert_float_equal(P[1], 0.0f, 1e-6);
+    assert_float_equal(P[2], 0.0f, 1e-6);
+    assert_float_equal(P[3], 5.0f, 1e-6);
+}
+
+int main(void) {
+    const struct CMUnitTest test_RLS[] = {
+        cmocka_unit_test(test_rlsInit),   cmocka_unit_test(test_rlsDelete), cmocka_unit_test(test_rlsInitStatic),
+        cmocka_unit_test(test_rlsUpdate), cmocka_unit_test(test_rlsReset),
+    };
+
+    return cmocka_run_group_tests(test_RLS, NULL, NULL);
+}
@@ -0,0 +1,387 @@
+/* BEGIN Header */
+/**
+ ******************************************************************************
+ * \file            test_SHHashTable.c
+ * \author          Andrea Vivani
+ * \brief           Unit tests for SHHashTable.c
+ ******************************************************************************
+ * \copyright
+ *
+ * Copyright 2024 Andrea Vivani
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the “Software”), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ ******************************************************************************
+ */
+/* END Header */
+
+/* Includes ------------------------------------------------------------------*/
+
+#include <errno.h>
+#include <setjmp.h>
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <pthread.h>
+#include "SHHashTable.h"
+#include "hashFunctions.h"
+
+#include <cmocka.h>
+
+/* Macros --------------------------------------------------------------------*/
+
+#define THREADS_NUM     4
+#define THREAD_KEYS_NUM 32
+
+/* Support functions ---------------------------------------------------------*/
+
+static uint8_t callocFail = 0;
+
+void* ADVUtils_testCalloc(const size_t number_of_elements, const size_t size) {
+    if ((number_of_elements > 0) && !callocFail) {
+        return test_calloc(number_of_elements, size);
+    } else {
+        return NULL;
+    }
+}
+
+static uint8_t mallocFail = 0;
+
+void* ADVUtils_testMalloc(const size_t size) {
+    if (!mallocFail) {
+        return test_malloc(size);
+    } else {
+        return NULL;
+    }
+}
+
+static uint8_t skipAssert = 0;
+
+void ADVUtils_testAssert(const int result, const char* const expression, const char* const file, const int line) {
+    if (skipAssert) {
+        return;
+    } else {
+        mock_assert(result, expression, file, line);
+    }
+}
+
+static uint32_t rwlockInitFail = UINT32_MAX;
+
+/* Replaces the library one, fails after rwlockInitFail successful initializations */
+int pthread_rwlock_init(pthread_rwlock_t* restrict lock, const pthread_rwlockattr_t* restrict attr) {
+    (void)attr; /* unused */
+    if (!rwlockInitFail) {
+        return EAGAIN;
+    }
+    rwlockInitFail--;
+    *lock = (pthread_rwlock_t)PTHREAD_RWLOCK_INITIALIZER;
+    return 0;
+}
+
+static uint16_t mockHash = 0;
+
+uint32_t ADVUtils_testHash(char* key) {
+    if (!mockHash) {
+        return hash_FNV1A(key);
+    } else {
+        return mockHash;
+    }
+}
+
+static shHashTableShard_t* shard(shHashTable_t* shht, uint32_t ii) { return (shHashTableShard_t*)(shht->shards + (size_t)ii * shht->_shardStride); }
+
+static void increment(void* value, uint8_t inserted, void* ctx) {
+    if (inserted) {
+        assert_int_equal(*(int*)value, 0);
+    }
+    *(int*)value += *(int*)ctx;
+}
+
+typedef struct {
+    shHashTable_t* shht;
+    uint32_t id;
+    uint32_t errors;
+} threadArgs_t;
+
+static void* worker(void* arg) {
+    threadArgs_t* args = (threadArgs_t*)arg;
+    char key[16];
+    int value, one = 1;
+    uint32_t ii;
+
+    /* cmocka asserts are not thread-safe, errors are counted and checked by main thread */
+    for (ii = 0; ii < THREAD_KEYS_NUM; ii++) {
+        value = (int)(args->id * 100 + ii);
+        snprintf(key, sizeof(key), "t%u_k%u", args->id, ii);
+        if (shHashTablePut(args->shht, key, &value) != UTILS_STATUS_SUCCESS) {
+            args->errors++;
+        }
+        if (shHashTableUpdate(args->shht, "counter", increment, &one) != UTILS_STATUS_SUCCESS) {
+            args->errors++;
+        }
+
+        /* Read back own key, and a key of another thread that may not be there yet */
+        value = -1;
+        if ((shHashTableGet(args->shht, key, &value, SHHT_DO_NOT_REMOVE_ITEM) != UTILS_STATUS_SUCCESS)
+            || (value != (int)(args->id * 100 + ii))) {
+            args->errors++;
+        }
+        snprintf(key, sizeof(key), "t%u_k%u", (args->id + 1) % THREADS_NUM, ii);
+        if ((shHashTableGet(args->shht, key, &value, SHHT_DO_NOT_REMOVE_ITEM) == UTILS_STATUS_SUCCESS)
+            && (value != (int)(((args->id + 1) % THREADS_NUM) * 100 + ii))) {
+            args->errors++;
+        }
+    }
+
+    return NULL;
+}
+
+/* Functions -----------------------------------------------------------------*/
+
+static void test_shHashTableInit(void** state) {
+    (void)state; /* unused */
+    shHashTable_t shht;
+    assert_int_equal(shHashTableInit(&shht, sizeof(int), 40, 3), UTILS_STATUS_SUCCESS);
+    assert_int_equal(shht.shardCount, 8);
+    assert_int_equal(shht.itemSize, sizeof(int));
+    assert_int_equal((uintptr_t)shht.shards % 64, 0);
+    assert_int_equal(shht._shardStride % 64, 0);
+    assert_true(shht._shardStride >= sizeof(shHashTableShard_t));
+    for (uint32_t ii = 0; ii < shht.shardCount; ii++) {
+        assert_int_equal(shard(&shht, ii)->lpht.size, 8);
+        assert_int_equal(shard(&shht, ii)->lpht.items, 0);
+        assert_int_equal(shard(&shht, ii)->lpht.resizable, LPHT_RESIZABLE);
+    }
+    assert_int_equal(shHashTableDelete(&shht), UTILS_STATUS_SUCCESS);
+    assert_null(shht.shards);
+    assert_int_equal(shHashTableDelete(&shht), UTILS_STATUS_ERROR);
+    /* Single shard */
+    assert_int_equal(shHashTableInit(&shht, sizeof(int), 10, 0), UTILS_STATUS_SUCCESS);
+    assert_int_equal(shht.shardCount, 1);
+    assert_int_equal(shHashTableDelete(&shht), UTILS_STATUS_SUCCESS);
+    /* Too many shards */
+    assert_int_equal(shHashTableInit(&shht, sizeof(int), 10, 17), UTILS_STATUS_ERROR);
+    assert_int_equal(shHashTableDelete(&shht), UTILS_STATUS_ERROR);
+    /* Check allocation failure, partially initialized shards are freed */
+    mallocFail = 1;
+    expect_assert_failure(shHashTableInit(&shht, sizeof(int), 10, 2));
+    skipAssert = 1;
+    assert_int_equal(shHashTableInit(&shht, sizeof(int), 10, 2), UTILS_STATUS_ERROR);
+    mallocFail = 0;
+    callocFail = 1;
+    assert_int_equal(shHashTableInit(&shht, sizeof(int), 10, 2), UTILS_STATUS_ERROR);
+    assert_null(shht.shards);
+    callocFail = 0;
+    skipAssert = 0;
+    /* Check lock init failure on the third shard, table of the failing shard and previous shards are freed */
+    rwlockInitFail = 2;
+    assert_int_equal(shHashTableInit(&shht, sizeof(int), 10, 2), UTILS_STATUS_ERROR);
+    assert_null(shht.shards);
+    assert_int_equal(shht.shardCount, 0);
+    rwlockInitFail = UINT32_MAX;
+}
+
+static void test_shHashTablePutAndGet(void** state) {
+    (void)state; /* unused */
+    shHashTable_t shht;
+    int value;
+    uint32_t size, items;
+    uint8_t bin[3] = {0, 1, 0};
+    assert_int_equal(shHashTableInit(&shht, sizeof(int), 16, 2), UTILS_STATUS_SUCCESS);
+    shHashTableInfo(&shht, &size, &items);
+    assert_int_equal(size, 4 * 4);
+    assert_int_equal(items, 0);
+    /* Wrong parameters */
+    value = 1;
+    assert_int_equal(shHashTablePut(&shht, NULL, &value), UTILS_STATUS_ERROR);
+    assert_int_equal(shHashTablePut(&shht, "key", NULL), UTILS_STATUS_ERROR);
+    assert_int_equal(shHashTableGet(&shht, NULL, &value, SHHT_DO_NOT_REMOVE_ITEM), UTILS_STATUS_ERROR);
+    assert_int_equal(shHashTablePutBin(&shht, bin, 0, &value), UTILS_STATUS_ERROR);
+    assert_int_equal(shHashTableGetBin(&shht, bin, sizeof(bin), NULL, SHHT_DO_NOT_REMOVE_ITEM), UTILS_STATUS_ERROR);
+    assert_int_equal(shHashTablePutU64(&shht, 1, NULL), UTILS_STATUS_ERROR);
+    assert_int_equal(shHashTableGetU64(&shht, 1, NULL, SHHT_DO_NOT_REMOVE_ITEM), UTILS_STATUS_ERROR);
+    assert_int_equal(shHashTableUpdate(&shht, "key", NULL, NULL), UTILS_STATUS_ERROR);
+    /* Missing key in empty shard */
+    assert_int_equal(shHashTableGet(&shht, "key", &value, SHHT_DO_NOT_REMOVE_ITEM), UTILS_STATUS_ERROR);
+    /* String keys */
+    value = 10;
+    assert_int_equal(shHashTablePut(&shht, "key", &value), UTILS_STATUS_SUCCESS);
+    value = 11;
+    assert_int_equal(shHashTablePut(&shht, "other key", &value), UTILS_STATUS_SUCCESS);
+    value = 12;
+    assert_int_equal(shHashTablePut(&shht, "key", &value), UTILS_STATUS_SUCCESS);
+    assert_int_equal(shHashTableGet(&shht, "key", &value, SHHT_DO_NOT_REMOVE_ITEM), UTILS_STATUS_SUCCESS);
+    assert_int_equal(value, 12);
+    assert_int_equal(shHashTableGet(&shht, "other key", &value, SHHT_DO_NOT_REMOVE_ITEM), UTILS_STATUS_SUCCESS);
+    assert_int_equal(value, 11);
+    /* Binary and integer keys */
+    value = 13;
+    assert_int_equal(shHashTablePutBin(&shht, bin, sizeof(bin), &value), UTILS_STATUS_SUCCESS);
+    value = 14;
+    assert_int_equal(shHashTablePutU64(&shht, 0x123456789ULL, &value), UTILS_STATUS_SUCCESS);
+    assert_int_equal(shHashTableGetBin(&shht, bin, sizeof(bin), &value, SHHT_DO_NOT_REMOVE_ITEM), UTILS_STATUS_SUCCESS);
+    assert_int_equal(value, 13);
+    assert_int_equal(shHashTableGetBin(&shht, bin, 2, &value, SHHT_DO_NOT_REMOVE_ITEM), UTILS_STATUS_ERROR);
+    assert_int_equal(shHashTableGetU64(&shht, 0x123456789ULL, &value, SHHT_DO_NOT_REMOVE_ITEM), UTILS_STATUS_SUCCESS);
+    assert_int_equal(value, 14);
+    assert_int_equal(shHashTableGetU64(&shht, 0x123456788ULL, &value, SHHT_DO_NOT_REMOVE_ITEM), UTILS_STATUS_ERROR);
+    shHashTableInfo(&shht, &size, &items);
+    assert_int_equal(items, 4);
+    /* Removal */
+    assert_int_equal(shHashTableGet(&shht, "key", &value, SHHT_REMOVE_ITEM), UTILS_STATUS_SUCCESS);
+    assert_int_equal(value, 12);
+    assert_int_equal(shHashTableGet(&shht, "key", &value, SHHT_REMOVE_ITEM), UTILS_STATUS_ERROR);
+    assert_int_equal(shHashTableGetU64(&shht, 0x123456789ULL, &value, SHHT_REMOVE_ITEM), UTILS_STATUS_SUCCESS);
+    shHashTableInfo(&shht, &size, &items);
+    assert_int_equal(items, 2);
+    /* Flush */
+    assert_int_equal(shHashTableFlush(&shht), UTILS_STATUS_SUCCESS);
+    assert_int_equal(shHashTableFlush(&shht), UTILS_STATUS_EMPTY);
+    shHashTableInfo(&shht, &size, &items);
+    assert_int_equal(items, 0);
+    assert_int_equal(shHashTableGet(&shht, "other key", &value, SHHT_DO_NOT_REMOVE_ITEM), UTILS_STATUS_ERROR);
+    assert_int_equal(shHashTableDelete(&shht), UTILS_STATUS_SUCCESS);
+}
+
+static void test_shHashTableSharding(void** state) {
+    (void)state; /* unused */
+    shHashTable_t shht;
+    char* keys[] = {"alpha", "beta", "gamma", "delta", "epsilon", "zeta", "eta", "theta"};
+    uint32_t ii, total;
+    int value = 0;
+    assert_int_equal(shHashTableInit(&shht, sizeof(int), 64, 3), UTILS_STATUS_SUCCESS);
+    /* Each key goes to the shard selected by the 3 highest bits of its scrambled hash */
+    for (ii = 0; ii < sizeof(keys) / sizeof(keys[0]); ii++) {
+        uint32_t idx = (uint32_t)(hash_FNV1A(keys[ii]) * 0x9E3779B9UL) >> 29;
+        uint32_t before = shard(&shht, idx)->lpht.items;
+        assert_int_equal(shHashTablePut(&shht, keys[ii], &value), UTILS_STATUS_SUCCESS);
+        assert_int_equal(shard(&shht, idx)->lpht.items, before + 1);
+    }
+    total = 0;
+    for (ii = 0; ii < shht.shardCount; ii++) {
+        total += shard(&shht, ii)->lpht.items;
+    }
+    assert_int_equal(total, 8);
+    assert_int_equal(shHashTableFlush(&shht), UTILS_STATUS_SUCCESS);
+    /* Keys with the same hash all go to the same shard, and are resolved by probing inside it */
+    mockHash = 5;
+    for (ii = 0; ii < 4; ii++) {
+        value = (int)ii;
+        assert_int_equal(shHashTablePut(&shht, keys[ii], &value), UTILS_STATUS_SUCCESS);
+    }
+    assert_int_equal(shard(&shht, (uint32_t)(5 * 0x9E3779B9UL) >> 29)->lpht.items, 4);
+    for (ii = 0; ii < 4; ii++) {
+        assert_int_equal(shHashTableGet(&shht, keys[ii], &value, SHHT_DO_NOT_REMOVE_ITEM), UTILS_STATUS_SUCCESS);
+        assert_int_equal(value, (int)ii);
+    }
+    mockHash = 0;
+    assert_int_equal(shHashTableDelete(&shht), UTILS_STATUS_SUCCESS);
+}
+
+static void test_shHashTableUpdate(void** state) {
+    (void)state; /* unused */
+    shHashTable_t shht;
+    int value, step = 3;
+    assert_int_equal(shHashTableInit(&shht, sizeof(int), 16, 1), UTILS_STATUS_SUCCESS);
+    assert_int_equal(shHashTableUpdate(&shht, "counter", increment, &step), UTILS_STATUS_SUCCESS);
+    assert_int_equal(shHashTableGet(&shht, "counter", &value, SHHT_DO_NOT_REMOVE_ITEM), UTILS_STATUS_SUCCESS);
+    assert_int_equal(value, 3);
+    step = 4;
+    assert_int_equal(shHashTableUpdate(&shht, "counter", increment, &step), UTILS_STATUS_SUCCESS);
+    assert_int_equal(shHashTableGet(&shht, "counter", &value, SHHT_DO_NOT_REMOVE_ITEM), UTILS_STATUS_SUCCESS);
+    assert_int_equal(value, 7);
+    assert_int_equal(shHashTableDelete(&shht), UTILS_STATUS_SUCCESS);
+}
+
+static void test_shHashTableLockFail(void** state) {
+    (void)state; /* unused */
+    shHashTable_t shht;
+    int value = 1;
+    uint32_t ii;
+    assert_int_equal(shHashTableInit(&shht, sizeof(int), 16, 1), UTILS_STATUS_SUCCESS);
+    assert_int_equal(shHashTablePut(&shht, "key", &value), UTILS_STATUS_SUCCESS);
+    /* Locking a shard already write-locked by the same thread fails with EDEADLK instead of blocking */
+    for (ii = 0; ii < shht.shardCount; ii++) {
+        assert_int_equal(pthread_rwlock_wrlock(&shard(&shht, ii)->lock), 0);
+    }
+    assert_int_equal(shHashTablePut(&shht, "key", &value), UTILS_STATUS_ERROR);
+    assert_int_equal(shHashTableGet(&shht, "key", &value, SHHT_DO_NOT_REMOVE_ITEM), UTILS_STATUS_ERROR);
+    assert_int_equal(shHashTableGet(&shht, "key", &value, SHHT_REMOVE_ITEM), UTILS_STATUS_ERROR);
+    assert_int_equal(shHashTableUpdate(&shht, "key", increment, &value), UTILS_STATUS_ERROR);
+    for (ii = 0; ii < shht.shardCount; ii++) {
+        assert_int_equal(pthread_rwlock_unlock(&shard(&shht, ii)->lock), 0);
+    }
+    assert_int_equal(shHashTableGet(&shht, "key", &value, SHHT_REMOVE_ITEM), UTILS_STATUS_SUCCESS);
+    assert_int_equal(value, 1);
+    assert_int_equal(shHashTableDelete(&shht), UTILS_STATUS_SUCCESS);
+}
+
+static void test_shHashTableConcurrency(void** state) {
+    (void)state; /* unused */
+    shHashTable_t shht;
+    pthread_t threads[THREADS_NUM];
+    threadArgs_t args[THREADS_NUM];
+    char key[16];
+    int value;
+    uint32_t ii, jj, size, items;
+
+    /* Shards start above LPHT_MAX_SIZE, so no allocation (not thread-safe in cmocka) happens while threads are running */
+    assert_int_equal(shHashTableInit(&shht, sizeof(int), 16 * 32, 4), UTILS_STATUS_SUCCESS);
+    for (ii = 0; ii < THREADS_NUM; ii++) {
+        args[ii].shht = &shht;
+        args[ii].id = ii;
+        args[ii].errors = 0;
+        assert_int_equal(pthread_create(&threads[ii], NULL, worker, &args[ii]), 0);
+    }
+    for (ii = 0; ii < THREADS_NUM; ii++) {
+        assert_int_equal(pthread_join(threads[ii], NULL), 0);
+        assert_int_equal(args[ii].errors, 0);
+    }
+
+    /* No update is lost and every key is there */
+    shHashTableInfo(&shht, &size, &items);
+    assert_int_equal(items, THREADS_NUM * THREAD_KEYS_NUM + 1);
+    assert_int_equal(shHashTableGet(&shht, "counter", &value, SHHT_REMOVE_ITEM), UTILS_STATUS_SUCCESS);
+    assert_int_equal(value, THREADS_NUM * THREAD_KEYS_NUM);
+    for (ii = 0; ii < THREADS_NUM; ii++) {
+        for (jj = 0; jj < THREAD_KEYS_NUM; jj++) {
+            snprintf(key, sizeof(key), "t%u_k%u", ii, jj);
+            assert_int_equal(shHashTableGet(&shht, key, &value, SHHT_REMOVE_ITEM), UTILS_STATUS_SUCCESS);
+            assert_int_equal(value, (int)(ii * 100 + jj));
+        }
+    }
+    shHashTableInfo(&shht, &size, &items);
+    assert_int_equal(items, 0);
+    assert_int_equal(shHashTableDelete(&shht), UTILS_STATUS_SUCCESS);
+}
+
+int main(void) {
+    const struct CMUnitTest test_SHHashTable[] = {
+        cmocka_unit_test(test_shHashTableInit),
+        cmocka_unit_test(test_shHashTablePutAndGet),
+        cmocka_unit_test(test_shHashTableSharding),
+        cmocka_unit_test(test_shHashTableUpdate),
+        cmocka_unit_test(test_shHashTableLockFail),
+        cmocka_unit_test(test_shHashTableConcurrency),
+    };
+
+    return cmocka_run_group_tests(test_SHHashTable, NULL, NULL);
+}
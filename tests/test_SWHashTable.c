@@ -0,0 +1,353 @@
+/* BEGIN Header */
+/**
+ ******************************************************************************
+ * \file            test_SWHashTable.c
+ * \author          Andrea Vivani
+ * \brief           Unit tests for SWHashTable.c
+ ******************************************************************************
+ * \copyright
+ *
+ * Copyright 2024 Andrea Vivani
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the “Software”), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ ******************************************************************************
+ */
+/* END Header */
+
+/* Includes ------------------------------------------------------------------*/
+
+#include <setjmp.h>
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include "SWHashTable.h"
+#include "hashFunctions.h"
+
+#include <cmocka.h>
+
+/* Support functions ---------------------------------------------------------*/
+
+static uint8_t callocFail = 0;
+
+void* ADVUtils_testCalloc(const size_t number_of_elements, const size_t size) {
+    if ((number_of_elements > 0) && !callocFail) {
+        return test_calloc(number_of_elements, size);
+    } else {
+        return NULL;
+    }
+}
+
+static uint8_t mallocFail = 0;
+
+void* ADVUtils_testMalloc(const size_t size) {
+    if (!mallocFail) {
+        return test_malloc(size);
+    } else {
+        return NULL;
+    }
+}
+
+static uint8_t skipAssert = 0;
+
+void ADVUtils_testAssert(const int result, const char* const expression, const char* const file, const int line) {
+    if (skipAssert) {
+        return;
+    } else {
+        mock_assert(result, expression, file, line);
+    }
+}
+
+static uint16_t mockHash = 0;
+
+uint32_t ADVUtils_testHash(char* key) {
+    if (!mockHash) {
+        return hash_FNV1A(key);
+    } else {
+        return mockHash;
+    }
+}
+
+/* Functions -----------------------------------------------------------------*/
+
+static void test_swHashTableInit(void** state) {
+    (void)state; /* unused */
+    swHashTable_t swht;
+    assert_int_equal(swHashTableInit(&swht, sizeof(int), 10, SWHT_RESIZABLE), UTILS_STATUS_SUCCESS);
+    assert_int_equal(swht.size, 16);
+    assert_int_equal(swht.items, 0);
+    assert_non_null(swht.ctrl);
+    assert_ptr_equal(swht.entries, (uint8_t*)swht.ctrl + 16);
+    for (uint32_t ii = 0; ii < swht.size; ii++) {
+        assert_true(swht.ctrl[ii] < 0);
+    }
+    test_free(swht.ctrl);
+    assert_int_equal(swHashTableInit(&swht, sizeof(int), 40, SWHT_RESIZABLE), UTILS_STATUS_SUCCESS);
+    assert_int_equal(swht.size, 64);
+    test_free(swht.ctrl);
+    /* Check allocation failure */
+    callocFail = 1;
+    expect_assert_failure(swHashTableInit(&swht, sizeof(int), 10, SWHT_RESIZABLE));
+    skipAssert = 1;
+    assert_int_equal(swHashTableInit(&swht, sizeof(int), 10, SWHT_RESIZABLE), UTILS_STATUS_ERROR);
+    skipAssert = 0;
+    callocFail = 0;
+}
+
+static void test_swHashTablePutAndGet(void** state) {
+    (void)state; /* unused */
+    swHashTable_t swht;
+    int value1 = 42;
+    int value2 = 43;
+    int out_value;
+    assert_int_equal(swHashTableInit(&swht, sizeof(int), 16, SWHT_NOT_RESIZABLE), UTILS_STATUS_SUCCESS);
+    assert_int_equal(swHashTableGet(&swht, "key1", &out_value, SWHT_DO_NOT_REMOVE_ITEM), UTILS_STATUS_EMPTY);
+    assert_int_equal(swHashTablePut(&swht, NULL, &value1), UTILS_STATUS_ERROR);
+    assert_int_equal(swHashTablePut(&swht, "key1", NULL), UTILS_STATUS_ERROR);
+    assert_int_equal(swHashTablePut(&swht, "key1", &value1), UTILS_STATUS_SUCCESS);
+    assert_int_equal(swHashTablePut(&swht, "key2", &value2), UTILS_STATUS_SUCCESS);
+    assert_int_equal(swht.items, 2);
+    assert_int_equal(swHashTableGet(&swht, "key1", &out_value, SWHT_DO_NOT_REMOVE_ITEM), UTILS_STATUS_SUCCESS);
+    assert_int_equal(out_value, value1);
+    assert_int_equal(swHashTableGet(&swht, "key3", &out_value, SWHT_DO_NOT_REMOVE_ITEM), UTILS_STATUS_ERROR);
+    /* Update */
+    assert_int_equal(swHashTablePut(&swht, "key1", &value2), UTILS_STATUS_SUCCESS);
+    assert_int_equal(swht.items, 2);
+    assert_int_equal(swHashTableGet(&swht, "key1", &out_value, SWHT_REMOVE_ITEM), UTILS_STATUS_SUCCESS);
+    assert_int_equal(out_value, value2);
+    assert_int_equal(swht.items, 1);
+    assert_int_equal(swHashTableGet(&swht, "key1", &out_value, SWHT_DO_NOT_REMOVE_ITEM), UTILS_STATUS_ERROR);
+    /* Slot of a group that has empty slots is marked as empty on removal */
+    assert_int_equal(swht._deleted, 0);
+    /* Fill table up to its size */
+    for (uint8_t ii = 0; ii < 15; ii++) {
+        char key[8];
+        snprintf(key, sizeof(key), "k%d", ii);
+        assert_int_equal(swHashTablePut(&swht, key, &ii), UTILS_STATUS_SUCCESS);
+    }
+    assert_int_equal(swht.items, 16);
+    assert_int_equal(swHashTablePut(&swht, "key3", &value1), UTILS_STATUS_FULL);
+    assert_int_equal(swHashTablePut(&swht, "key2", &value1), UTILS_STATUS_SUCCESS);
+    assert_int_equal(swHashTableGet(&swht, "key3", &out_value, SWHT_DO_NOT_REMOVE_ITEM), UTILS_STATUS_ERROR);
+    for (uint8_t ii = 0; ii < 15; ii++) {
+        char key[8];
+        snprintf(key, sizeof(key), "k%d", ii);
+        out_value = 0;
+        assert_int_equal(swHashTableGet(&swht, key, &out_value, SWHT_DO_NOT_REMOVE_ITEM), UTILS_STATUS_SUCCESS);
+        assert_int_equal(out_value & 0xFF, ii);
+    }
+    /* Removal from a full group leaves a tombstone, that is reused by next insertion */
+    assert_int_equal(swHashTableGet(&swht, "key2", &out_value, SWHT_REMOVE_ITEM), UTILS_STATUS_SUCCESS);
+    assert_int_equal(out_value, value1);
+    assert_int_equal(swht._deleted, 1);
+    assert_int_equal(swHashTablePut(&swht, "key3", &value2), UTILS_STATUS_SUCCESS);
+    assert_int_equal(swht._deleted, 0);
+    /* Check malloc fail */
+    assert_int_equal(swHashTableGet(&swht, "key3", &out_value, SWHT_REMOVE_ITEM), UTILS_STATUS_SUCCESS);
+    mallocFail = 1;
+    skipAssert = 1;
+    assert_int_equal(swHashTablePut(&swht, "key3", &value2), UTILS_STATUS_ERROR);
+    mallocFail = 0;
+    skipAssert = 0;
+    assert_int_equal(swht.items, 15);
+    swHashTableDelete(&swht);
+}
+
+static void test_swHashTableCollisions(void** state) {
+    (void)state; /* unused */
+    swHashTable_t swht;
+    int out_value;
+    char key[8];
+    assert_int_equal(swHashTableInit(&swht, sizeof(int), 64, SWHT_NOT_RESIZABLE), UTILS_STATUS_SUCCESS);
+    /* Same hash for all keys: first group fills up, then probing moves to the following ones */
+    mockHash = 0x85;
+    for (int ii = 0; ii < 40; ii++) {
+        snprintf(key, sizeof(key), "c%d", ii);
+        assert_int_equal(swHashTablePut(&swht, key, &ii), UTILS_STATUS_SUCCESS);
+    }
+    for (uint32_t ii = 16; ii < 32; ii++) {
+        assert_int_equal(swht.ctrl[ii], 0x05);
+    }
+    for (int ii = 0; ii < 40; ii++) {
+        snprintf(key, sizeof(key), "c%d", ii);
+        assert_int_equal(swHashTableGet(&swht, key, &out_value, SWHT_DO_NOT_REMOVE_ITEM), UTILS_STATUS_SUCCESS);
+        assert_int_equal(out_value, ii);
+    }
+    assert_int_equal(swHashTableGet(&swht, "c40", &out_value, SWHT_DO_NOT_REMOVE_ITEM), UTILS_STATUS_ERROR);
+    /* Removal from full groups leaves tombstones, keys after them are still found */
+    for (int ii = 0; ii < 20; ii++) {
+        snprintf(key, sizeof(key), "c%d", ii);
+        assert_int_equal(swHashTableGet(&swht, key, &out_value, SWHT_REMOVE_ITEM), UTILS_STATUS_SUCCESS);
+        assert_int_equal(out_value, ii);
+    }
+    assert_int_equal(swht._deleted, 20);
+    for (int ii = 20; ii < 40; ii++) {
+        snprintf(key, sizeof(key), "c%d", ii);
+        assert_int_equal(swHashTableGet(&swht, key, &out_value, SWHT_DO_NOT_REMOVE_ITEM), UTILS_STATUS_SUCCESS);
+        assert_int_equal(out_value, ii);
+    }
+    /* Different fingerprint in same groups */
+    mockHash = 0x86;
+    assert_int_equal(swHashTableGet(&swht, "c30", &out_value, SWHT_DO_NOT_REMOVE_ITEM), UTILS_STATUS_ERROR);
+    mockHash = 0;
+    assert_int_equal(swHashTableFlush(&swht), UTILS_STATUS_SUCCESS);
+    assert_int_equal(swht._deleted, 0);
+    assert_int_equal(swHashTableFlush(&swht), UTILS_STATUS_EMPTY);
+    swHashTableDelete(&swht);
+}
+
+static void test_swHashTableResize(void** state) {
+    (void)state; /* unused */
+    swHashTable_t swht;
+    int out_value;
+    char key[8];
+    assert_int_equal(swHashTableInit(&swht, sizeof(int), 16, SWHT_RESIZABLE), UTILS_STATUS_SUCCESS);
+    for (int ii = 0; ii < 14; ii++) {
+        snprintf(key, sizeof(key), "r%d", ii);
+        assert_int_equal(swHashTablePut(&swht, key, &ii), UTILS_STATUS_SUCCESS);
+    }
+    assert_int_equal(swht.size, 16);
+    /* Resize failure */
+    callocFail = 1;
+    skipAssert = 1;
+    assert_int_equal(swHashTablePut(&swht, "r14", &out_value), UTILS_STATUS_ERROR);
+    callocFail = 0;
+    skipAssert = 0;
+    for (int ii = 14; ii < 64; ii++) {
+        snprintf(key, sizeof(key), "r%d", ii);
+        assert_int_equal(swHashTablePut(&swht, key, &ii), UTILS_STATUS_SUCCESS);
+        assert_int_equal(swht.size, ii < 28 ? 32 : 64);
+    }
+    /* Maximum size reached */
+    assert_int_equal(swHashTablePut(&swht, "r64", &out_value), UTILS_STATUS_FULL);
+    for (int ii = 0; ii < 64; ii++) {
+        snprintf(key, sizeof(key), "r%d", ii);
+        assert_int_equal(swHashTableGet(&swht, key, &out_value, SWHT_DO_NOT_REMOVE_ITEM), UTILS_STATUS_SUCCESS);
+        assert_int_equal(out_value, ii);
+    }
+    /* Down-sizing, and its failure */
+    for (int ii = 0; ii < 51; ii++) {
+        snprintf(key, sizeof(key), "r%d", ii);
+        assert_int_equal(swHashTableGet(&swht, key, &out_value, SWHT_REMOVE_ITEM), UTILS_STATUS_SUCCESS);
+    }
+    assert_int_equal(swht.size, 64);
+    callocFail = 1;
+    skipAssert = 1;
+    assert_int_equal(swHashTableGet(&swht, "r51", &out_value, SWHT_REMOVE_ITEM), UTILS_STATUS_WARNING);
+    callocFail = 0;
+    skipAssert = 0;
+    assert_int_equal(swht.size, 64);
+    assert_int_equal(swHashTableGet(&swht, "r52", &out_value, SWHT_REMOVE_ITEM), UTILS_STATUS_SUCCESS);
+    assert_int_equal(swht.size, 32);
+    assert_int_equal(swht._deleted, 0);
+    for (int ii = 53; ii < 64; ii++) {
+        snprintf(key, sizeof(key), "r%d", ii);
+        assert_int_equal(swHashTableGet(&swht, key, &out_value, SWHT_REMOVE_ITEM), UTILS_STATUS_SUCCESS);
+        assert_int_equal(out_value, ii);
+    }
+    assert_int_equal(swht.size, 16);
+    assert_int_equal(swht.items, 0);
+    swHashTableDelete(&swht);
+
+    /* Tombstones are purged by rehashing at the same size when table can't grow */
+    assert_int_equal(swHashTableInit(&swht, sizeof(int), 64, SWHT_RESIZABLE), UTILS_STATUS_SUCCESS);
+    mockHash = 0x85;
+    for (int ii = 0; ii < 48; ii++) {
+        snprintf(key, sizeof(key), "t%d", ii);
+        assert_int_equal(swHashTablePut(&swht, key, &ii), UTILS_STATUS_SUCCESS);
+    }
+    for (int ii = 0; ii < 16; ii++) {
+        snprintf(key, sizeof(key), "t%d", ii);
+        assert_int_equal(swHashTableGet(&swht, key, &out_value, SWHT_REMOVE_ITEM), UTILS_STATUS_SUCCESS);
+    }
+    assert_int_equal(swht._deleted, 16);
+    /* New keys go to the last group, so tombstones are not reused */
+    mockHash = 0x185;
+    for (int ii = 48; ii < 57; ii++) {
+        snprintf(key, sizeof(key), "t%d", ii);
+        assert_int_equal(swHashTablePut(&swht, key, &ii), UTILS_STATUS_SUCCESS);
+        assert_int_equal(swht._deleted, ii < 56 ? 16 : 0);
+    }
+    assert_int_equal(swht.size, 64);
+    for (int ii = 16; ii < 57; ii++) {
+        mockHash = ii < 48 ? 0x85 : 0x185;
+        snprintf(key, sizeof(key), "t%d", ii);
+        assert_int_equal(swHashTableGet(&swht, key, &out_value, SWHT_DO_NOT_REMOVE_ITEM), UTILS_STATUS_SUCCESS);
+        assert_int_equal(out_value, ii);
+    }
+    mockHash = 0;
+    swHashTableDelete(&swht);
+}
+
+static void test_swHashTableIterator(void** state) {
+    (void)state; /* unused */
+    swHashTable_t swht;
+    swHashTableIterator_t it;
+    char key[8];
+    int sum = 0, count = 0;
+    assert_int_equal(swHashTableInit(&swht, sizeof(int), 16, SWHT_RESIZABLE), UTILS_STATUS_SUCCESS);
+    swHashTableIt(&it, &swht);
+    assert_int_equal(swHashTableItNext(&it), UTILS_STATUS_ERROR);
+    for (int ii = 0; ii < 20; ii++) {
+        snprintf(key, sizeof(key), "i%d", ii);
+        assert_int_equal(swHashTablePut(&swht, key, &ii), UTILS_STATUS_SUCCESS);
+    }
+    swHashTableIt(&it, &swht);
+    while (swHashTableItNext(&it) == UTILS_STATUS_SUCCESS) {
+        int value = *(int*)it.value;
+        snprintf(key, sizeof(key), "i%d", value);
+        assert_string_equal(it.key, key);
+        sum += value;
+        count++;
+    }
+    assert_int_equal(count, 20);
+    assert_int_equal(sum, 190);
+    swHashTableDelete(&swht);
+}
+
+static void test_swHashTableDelete(void** state) {
+    (void)state; /* unused */
+    swHashTable_t swht;
+    int value = 42;
+    assert_int_equal(swHashTableInit(&swht, sizeof(int), 16, SWHT_RESIZABLE), UTILS_STATUS_SUCCESS);
+    assert_int_equal(swHashTablePut(&swht, "key1", &value), UTILS_STATUS_SUCCESS);
+    uint32_t size, items;
+    swHashTableInfo(&swht, &size, &items);
+    assert_int_equal(size, 16);
+    assert_int_equal(items, 1);
+    assert_int_equal(swHashTableDelete(&swht), UTILS_STATUS_SUCCESS);
+    assert_null(swht.ctrl);
+    /* Check null deletion */
+    assert_int_equal(swHashTableDelete(&swht), UTILS_STATUS_ERROR);
+}
+
+int main(void) {
+    const struct CMUnitTest test_SWHashTable[] = {
+        cmocka_unit_test(test_swHashTableInit),
+        cmocka_unit_test(test_swHashTablePutAndGet),
+        cmocka_unit_test(test_swHashTableCollisions),
+        cmocka_unit_test(test_swHashTableResize),
+        cmocka_unit_test(test_swHashTableIterator),
+        cmocka_unit_test(test_swHashTableDelete),
+    };
+
+    return cmocka_run_group_tests(test_SWHashTable, NULL, NULL);
+}
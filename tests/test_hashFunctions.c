@@ -167,6 +167,116 @@ static void test_hash_sdbm_numeric_string(void** state) {
     assert_int_equal(hash_sdbm("1234567890"), 800103739);
 }
 
+// Test cases for hash_FNV1A_buf
+static void test_hash_FNV1A_buf_matches_string(void** state) {
+    (void)state; // unused
+    assert_int_equal(hash_FNV1A_buf("test", 4), hash_FNV1A("test"));
+    assert_int_equal(hash_FNV1A_buf("", 0), 2216829733);
+}
+
+static void test_hash_FNV1A_buf_embedded_nul(void** state) {
+    (void)state; // unused
+    const uint8_t key1[] = {'a', 0x00, 'b'};
+    const uint8_t key2[] = {'a', 0x00, 'c'};
+    assert_int_not_equal(hash_FNV1A_buf(key1, sizeof(key1)), hash_FNV1A_buf(key2, sizeof(key2)));
+    assert_int_not_equal(hash_FNV1A_buf(key1, sizeof(key1)), hash_FNV1A_buf(key1, 1));
+}
+
+static void test_hash_FNV1A_buf_null_pointer(void** state) {
+    (void)state; // unused
+    expect_assert_failure(hash_FNV1A_buf(NULL, 0));
+}
+
+static void test_hash_FNV1A64_buf_values(void** state) {
+    (void)state; // unused
+    assert_true(hash_FNV1A64_buf("", 0) == 0xCBF29CE484222325ULL);
+    assert_true(hash_FNV1A64_buf("a", 1) == 0xAF63DC4C8601EC8CULL);
+    assert_int_equal((uint32_t)hash_FNV1A64_buf("test", 4), hash_FNV1A_buf("test", 4));
+}
+
+// Test cases for hash_mix32 / hash_mix64
+static void test_hash_mix32_values(void** state) {
+    (void)state; // unused
+    assert_int_equal(hash_mix32(0), 0);
+    assert_int_equal(hash_mix32(1), 0x514E28B7);
+    assert_int_not_equal(hash_mix32(1), hash_mix32(2));
+}
+
+static void test_hash_mix64_values(void** state) {
+    (void)state; // unused
+    assert_int_equal(hash_mix64(0), 0);
+    assert_int_not_equal(hash_mix64(1), hash_mix64(1ULL << 32));
+    assert_int_not_equal(hash_mix64(1ULL << 40), hash_mix64(1ULL << 41));
+}
+
+static void test_hash_mix_low_bits(void** state) {
+    (void)state; // unused
+    /* consecutive and strided keys must spread over the lowest bits, that are used as table index */
+    uint8_t buckets32[16] = {0}, buckets64[16] = {0};
+    for (uint32_t ii = 0; ii < 64; ii++) {
+        buckets32[hash_mix32(ii << 4) & 0xF]++;
+        buckets64[hash_mix64((uint64_t)ii << 36) & 0xF]++;
+    }
+    for (uint8_t ii = 0; ii < 16; ii++) {
+        assert_true(buckets32[ii] < 16);
+        assert_true(buckets64[ii] < 16);
+    }
+}
+
+// Test cases for hash_murmur3
+static void test_hash_murmur3_values(void** state) {
+    (void)state; // unused
+    /* Reference MurmurHash3_x86_32 values with seed 0 */
+    assert_int_equal(hash_murmur3(""), 0);
+    assert_int_equal(hash_murmur3("hello"), 0x248BFA47);
+    assert_int_equal(hash_murmur3("Hello, world!"), 0xC0363E43);
+    assert_int_equal(hash_murmur3("The quick brown fox jumps over the lazy dog"), 0x2E4FF723);
+    assert_int_equal(hash_murmur3_buf("hello", 5), hash_murmur3("hello"));
+}
+
+static void test_hash_murmur3_tail(void** state) {
+    (void)state; // unused
+    const uint8_t key[] = {'a', 0x00, 'b', 'c', 'd', 'e', 'f'};
+    for (size_t ii = 1; ii < sizeof(key); ii++) {
+        assert_int_not_equal(hash_murmur3_buf(key, ii), hash_murmur3_buf(key, ii + 1));
+    }
+}
+
+static void test_hash_murmur3_null_pointer(void** state) {
+    (void)state; // unused
+    expect_assert_failure(hash_murmur3(NULL));
+    expect_assert_failure(hash_murmur3_buf(NULL, 0));
+}
+
+// Test cases for hash_wy
+static void test_hash_wy_values(void** state) {
+    (void)state; // unused
+    /* Reference wyhash (final version 3) values with seed 0, covering short, medium and long (more than 48 bytes) keys */
+    assert_true(hash_wy64_buf("", 0) == 0x42BC986DC5EEC4D3ULL);
+    assert_true(hash_wy64_buf("a", 1) == 0x6CF84E5A2465E867ULL);
+    assert_true(hash_wy64_buf("abc", 3) == 0xB4808DF22D44FFCFULL);
+    assert_true(hash_wy64_buf("message digest", 14) == 0x42290CF3F6384B2CULL);
+    assert_true(hash_wy64_buf("abcdefghijklmnopqrstuvwxyz", 26) == 0xD66714ECBA3A36B2ULL);
+    assert_true(hash_wy64_buf("ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789", 62) == 0x20D629ACDB4D259DULL);
+    assert_true(hash_wy64_buf("12345678901234567890123456789012345678901234567890123456789012345678901234567890", 80) == 0xF4B6595C78546C93ULL);
+    assert_int_equal(hash_wy("abc"), 0xB4808DF2UL ^ 0x2D44FFCFUL);
+    assert_int_equal(hash_wy_buf("abc", 3), hash_wy("abc"));
+}
+
+static void test_hash_wy_embedded_nul(void** state) {
+    (void)state; // unused
+    const uint8_t key1[] = {'a', 0x00, 'b'};
+    const uint8_t key2[] = {'a', 0x00, 'c'};
+    assert_int_not_equal(hash_wy_buf(key1, sizeof(key1)), hash_wy_buf(key2, sizeof(key2)));
+    assert_int_not_equal(hash_wy_buf(key1, sizeof(key1)), hash_wy_buf(key1, 1));
+}
+
+static void test_hash_wy_null_pointer(void** state) {
+    (void)state; // unused
+    expect_assert_failure(hash_wy(NULL));
+    expect_assert_failure(hash_wy64_buf(NULL, 0));
+}
+
 int main(void) {
     const struct CMUnitTest test_hashFunctions[] = {
         // hash_FNV1A tests
@@ -195,6 +305,27 @@ int main(void) {
         cmocka_unit_test(test_hash_sdbm_different_cases),
         cmocka_unit_test(test_hash_sdbm_long_string),
         cmocka_unit_test(test_hash_sdbm_numeric_string),
+
+        // hash_FNV1A_buf tests
+        cmocka_unit_test(test_hash_FNV1A_buf_matches_string),
+        cmocka_unit_test(test_hash_FNV1A_buf_embedded_nul),
+        cmocka_unit_test(test_hash_FNV1A_buf_null_pointer),
+        cmocka_unit_test(test_hash_FNV1A64_buf_values),
+
+        // hash_mix tests
+        cmocka_unit_test(test_hash_mix32_values),
+        cmocka_unit_test(test_hash_mix64_values),
+        cmocka_unit_test(test_hash_mix_low_bits),
+
+        // hash_murmur3 tests
+        cmocka_unit_test(test_hash_murmur3_values),
+        cmocka_unit_test(test_hash_murmur3_tail),
+        cmocka_unit_test(test_hash_murmur3_null_pointer),
+
+        // hash_wy tests
+        cmocka_unit_test(test_hash_wy_values),
+        cmocka_unit_test(test_hash_wy_embedded_nul),
+        cmocka_unit_test(test_hash_wy_null_pointer),
     };
 
     return cmocka_run_group_tests(test_hashFunctions, NULL, NULL);
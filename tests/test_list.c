@@ -45,16 +45,20 @@
 
 /* Support functions ---------------------------------------------------------*/
 
+static uint8_t callocFail = 0;
+
 void* ADVUtils_testCalloc(const size_t number_of_elements, const size_t size) {
-    if (number_of_elements > 0) {
+    if ((number_of_elements > 0) && !callocFail) {
         return test_calloc(number_of_elements, size);
     } else {
         return NULL;
     }
 }
 
+static uint8_t mallocFail = 0;
+
 void* ADVUtils_testMalloc(const size_t size) {
-    if (size > 0) {
+    if ((size > 0) && !mallocFail) {
         return test_malloc(size);
     } else {
         return NULL;
@@ -166,6 +170,33 @@ static void test_listInsert(void** state) {
     listFlush(&list);
 }
 
+static void test_listAllocFail(void** state) {
+    (void)state; /* unused */
+    list_t list;
+    listInit(&list, sizeof(int), 10);
+    int value = 42;
+    skipAssert = 1;
+    /* Check malloc fail of node */
+    mallocFail = 1;
+    assert_int_equal(listPush(&list, &value), UTILS_STATUS_ERROR);
+    assert_int_equal(listPushFront(&list, &value), UTILS_STATUS_ERROR);
+    assert_int_equal(listInsert(&list, &value, 0), UTILS_STATUS_ERROR);
+    mallocFail = 0;
+    /* Check calloc fail of data, node is freed */
+    callocFail = 1;
+    assert_int_equal(listPush(&list, &value), UTILS_STATUS_ERROR);
+    assert_int_equal(listPushFront(&list, &value), UTILS_STATUS_ERROR);
+    assert_int_equal(listInsert(&list, &value, 0), UTILS_STATUS_ERROR);
+    callocFail = 0;
+    skipAssert = 0;
+    assert_int_equal(list.items, 0);
+    assert_null(list._front);
+    assert_null(list._rear);
+    assert_int_equal(listPush(&list, &value), UTILS_STATUS_SUCCESS);
+    assert_int_equal(list.items, 1);
+    listFlush(&list);
+}
+
 static void test_listUpdate(void** state) {
     (void)state; /* unused */
     list_t list;
@@ -405,6 +436,7 @@ int main(void) {
         cmocka_unit_test(test_listPopBack),   cmocka_unit_test(test_listPopBackEmpty),  cmocka_unit_test(test_listRemove),
         cmocka_unit_test(test_listPeek),      cmocka_unit_test(test_listPeekBack),      cmocka_unit_test(test_listPeekAtPos),
         cmocka_unit_test(test_listInfo),      cmocka_unit_test(test_listFlush),         cmocka_unit_test(test_listIterator),
+        cmocka_unit_test(test_listAllocFail),
     };
 
     return cmocka_run_group_tests(test_list, NULL, NULL);
@@ -53,8 +53,10 @@ void* ADVUtils_testCalloc(const size_t number_of_elements, const size_t size) {
     }
 }
 
+static uint8_t failMalloc = 0;
+
 void* ADVUtils_testMalloc(const size_t size) {
-    if (size > 0) {
+    if ((size > 0) && !failMalloc) {
         return test_malloc(size);
     } else {
         return NULL;
@@ -73,6 +75,15 @@ void ADVUtils_testAssert(const int result, const char* const expression, const c
 
 /* Functions -----------------------------------------------------------------*/
 
+/* 6x6 matrix used to check Gauss-Jordan inversion and Gauss determinant */
+static const float matrix6_data[36] = {0.5508, 0.7081, 0.2909, 0.5108, 0.8929, 0.8963, 0.1256, 0.2072, 0.0515, 0.4408, 0.0299, 0.4568,
+                                       0.6491, 0.2785, 0.6763, 0.5909, 0.024,  0.5589, 0.2593, 0.4151, 0.2835, 0.6931, 0.4405, 0.1569,
+                                       0.5446, 0.7803, 0.3064, 0.222,  0.388,  0.9364, 0.976,  0.6724, 0.9028, 0.8458, 0.378,  0.0922};
+static const float matrix6_inv[36] = {2.722029,  5.072745,  -2.873173, -6.859682, -2.612272, 4.026542,  -2.189387, -0.722232, -1.079742,
+                                      2.191203,  2.731114,  -0.059484, -2.088479, -6.277176, 4.037899,  5.453667,  2.062138,  -3.298595,
+                                      0.11918,   2.151233,  -0.42032,  0.107039,  -0.974975, 0.451032,  1.522881,  -1.600005, 0.341185,
+                                      0.514918,  -0.917297, -0.505393, 0.265417,  -0.141504, 1.207786,  0.140359,  0.247834,  -1.110408};
+
 static void test_matrixInit(void** state) {
     (void)state; /* unused */
     matrix_t matrix;
@@ -253,6 +264,39 @@ static void test_matrixMult_rhsT(void** state) {
     assert_float_equal(result.data[3], 167.0f, 1e-5);
 }
 
+static void test_matrixMultStrassen(void** state) {
+    (void)state; /* unused */
+    matrix_t lhs, rhs, result, expected;
+    float lhs_data[16 * 16], rhs_data[16 * 16], result_data[16 * 16], expected_data[16 * 16];
+    float workspace[MATRIX_STRASSEN_WORKSPACE_SIZE(16)];
+    uint8_t sizes[] = {4, 13, 16};
+    uint16_t ii, jj;
+
+    /* Cutoff is 4 in unit tests: 4 hits the direct kernel, 13 exercises odd-size peeling and 16 two recursion levels */
+    for (ii = 0; ii < sizeof(sizes); ii++) {
+        uint8_t n = sizes[ii];
+        matrixInitStatic(&lhs, lhs_data, n, n);
+        matrixInitStatic(&rhs, rhs_data, n, n);
+        matrixInitStatic(&result, result_data, n, n);
+        matrixInitStatic(&expected, expected_data, n, n);
+        for (jj = 0; jj < n * n; jj++) {
+            lhs_data[jj] = (float)((jj * 7) % 11) - 5.0f;
+            rhs_data[jj] = (float)((jj * 5) % 13) * 0.5f - 3.0f;
+        }
+        matrixMult(&lhs, &rhs, &expected);
+        matrixMultStrassen(&lhs, &rhs, &result, workspace);
+        for (jj = 0; jj < n * n; jj++) {
+            assert_float_equal(result.data[jj], expected.data[jj], 1e-3);
+        }
+    }
+
+    /* Non-square matrices */
+    matrixInitStatic(&lhs, lhs_data, 2, 3);
+    matrixInitStatic(&rhs, rhs_data, 3, 2);
+    matrixInitStatic(&result, result_data, 2, 2);
+    expect_assert_failure(matrixMultStrassen(&lhs, &rhs, &result, workspace));
+}
+
 static void test_matrixMultScalar(void** state) {
     (void)state; /* unused */
     matrix_t matrix, result;
@@ -335,12 +379,104 @@ static void test_matrixDet(void** state) {
     memcpy(matrix2.data, matrix2_data, 16 * sizeof(float));
     assert_float_equal(matrixDet(&matrix2), -1782.0f, 1e-3);
     matrixDelete(&matrix2);
+    /* Check closed forms of smaller matrices */
+    matrixInit(&matrix, 3, 3);
+    float matrix3_data[] = {2, -1, 0, 1, 3, 2, 0, 1, 4};
+    memcpy(matrix.data, matrix3_data, 9 * sizeof(float));
+    assert_float_equal(matrixDet(&matrix), 24.0f, 1e-5);
+    matrix.rows = matrix.cols = 2;
+    assert_float_equal(matrixDet(&matrix), 2.0f, 1e-5);
+    matrix.rows = matrix.cols = 1;
+    assert_float_equal(matrixDet(&matrix), 2.0f, 1e-5);
+    matrixDelete(&matrix);
+    /* Check Gauss elimination of larger matrices */
+    matrixInit(&matrix, 6, 6);
+    memcpy(matrix.data, matrix6_data, 36 * sizeof(float));
+    assert_float_equal(matrixDet(&matrix), -0.0154140f, 1e-6);
+    /* Check singular matrix */
+    for (uint8_t ii = 0; ii < 6; ii++) {
+        ELEM(matrix, ii, 3) = 2.0f * ELEM(matrix, ii, 1);
+    }
+    assert_float_equal(matrixDet(&matrix), 0.0f, 1e-6);
+    /* Check matrix with a zero column, where no pivot can be found */
+    for (uint8_t ii = 0; ii < 6; ii++) {
+        ELEM(matrix, ii, 3) = 0.0f;
+    }
+    assert_float_equal(matrixDet(&matrix), 0.0f, 0.0f);
+    matrixDelete(&matrix);
+    /* Check allocation failure */
+    matrix_t matrix6;
+    float matrix6_buf[36];
+    matrixInitStatic(&matrix6, matrix6_buf, 6, 6);
+    memcpy(matrix6_buf, matrix6_data, 36 * sizeof(float));
+    failMalloc = 1;
+    skipAssert = 1;
+    assert_float_equal(matrixDet(&matrix6), 0.0f, 1e-6);
+    failMalloc = 0;
+    skipAssert = 0;
     /* Check rows != columns */
     matrixInit(&matrix, 4, 3);
     assert_float_equal(matrixDet(&matrix), 0, 1e-5);
     matrixDelete(&matrix);
 }
 
+static void checkSmallAndLargeInversion(void (*inversion)(matrix_t*, matrix_t*)) {
+    matrix_t matrix, result;
+    float matrix_data[36], result_data[36];
+    /* Check 1x1, 2x2 and 3x3 closed forms */
+    matrix_data[0] = 4.0f;
+    matrixInitStatic(&matrix, matrix_data, 1, 1);
+    matrixInitStatic(&result, result_data, 1, 1);
+    inversion(&matrix, &result);
+    assert_float_equal(result_data[0], 0.25f, 1e-6);
+    float matrix2_data[] = {4, 7, 2, 6};
+    matrixInitStatic(&matrix, matrix2_data, 2, 2);
+    matrixInitStatic(&result, result_data, 2, 2);
+    inversion(&matrix, &result);
+    assert_float_equal(result_data[0], 0.6f, 1e-6);
+    assert_float_equal(result_data[1], -0.7f, 1e-6);
+    assert_float_equal(result_data[2], -0.2f, 1e-6);
+    assert_float_equal(result_data[3], 0.4f, 1e-6);
+    float matrix3_data[] = {2, -1, 0, 1, 3, 2, 0, 1, 4};
+    float matrix3_inv[] = {0.416667, 0.166667, -0.083333, -0.166667, 0.333333, -0.166667, 0.041667, -0.083333, 0.291667};
+    matrixInitStatic(&matrix, matrix3_data, 3, 3);
+    matrixInitStatic(&result, result_data, 3, 3);
+    inversion(&matrix, &result);
+    for (uint8_t ii = 0; ii < 9; ii++) {
+        assert_float_equal(result_data[ii], matrix3_inv[ii], 1e-5);
+    }
+    /* Check in-place closed form */
+    inversion(&matrix, &matrix);
+    for (uint8_t ii = 0; ii < 9; ii++) {
+        assert_float_equal(matrix3_data[ii], matrix3_inv[ii], 1e-5);
+    }
+    /* Check Gauss-Jordan inversion of larger matrices */
+    memcpy(matrix_data, matrix6_data, 36 * sizeof(float));
+    matrixInitStatic(&matrix, matrix_data, 6, 6);
+    matrixInitStatic(&result, result_data, 6, 6);
+    inversion(&matrix, &result);
+    for (uint8_t ii = 0; ii < 36; ii++) {
+        assert_float_equal(result_data[ii], matrix6_inv[ii], 1e-4);
+    }
+    assert_memory_equal(matrix_data, matrix6_data, 36 * sizeof(float));
+    /* Check in-place Gauss-Jordan inversion */
+    inversion(&matrix, &matrix);
+    for (uint8_t ii = 0; ii < 36; ii++) {
+        assert_float_equal(matrix_data[ii], matrix6_inv[ii], 1e-4);
+    }
+    /* Check that singular matrices give a zero result */
+    for (uint8_t nn = 1; nn <= 6; nn++) {
+        memset(matrix_data, 0x00, sizeof(matrix_data));
+        memset(result_data, 0xFF, sizeof(result_data));
+        matrixInitStatic(&matrix, matrix_data, nn, nn);
+        matrixInitStatic(&result, result_data, nn, nn);
+        inversion(&matrix, &result);
+        for (uint8_t ii = 0; ii < nn * nn; ii++) {
+            assert_float_equal(result_data[ii], 0.0f, 1e-6);
+        }
+    }
+}
+
 static void test_matrixInversed(void** state) {
     (void)state; /* unused */
     matrix_t matrix, result;
@@ -367,6 +503,7 @@ static void test_matrixInversed(void** state) {
     assert_float_equal(result.data[15], -2.813918, 1e-5);
     matrixDelete(&matrix);
     matrixDelete(&result);
+    checkSmallAndLargeInversion(matrixInversed);
 }
 
 static void test_matrixInversed_rob(void** state) {
@@ -426,6 +563,18 @@ static void test_matrixDetStatic(void** state) {
     float matrix2_data[] = {0, 7, 6, 2, 9, 5, 1, 3, 4, 3, 8, 4, 5, 6, 7, 8};
     matrixInitStatic(&matrix2, matrix2_data, 4, 4);
     assert_float_equal(matrixDetStatic(&matrix2), -1782.0f, 1e-3);
+    /* Check closed forms of smaller matrices */
+    float matrix3_data[] = {2, -1, 0, 1, 3, 2, 0, 1, 4};
+    matrixInitStatic(&matrix, matrix3_data, 3, 3);
+    assert_float_equal(matrixDetStatic(&matrix), 24.0f, 1e-5);
+    matrixInitStatic(&matrix, matrix3_data, 2, 2);
+    assert_float_equal(matrixDetStatic(&matrix), 2.0f, 1e-5);
+    /* Check Gauss elimination of larger matrices */
+    float matrix6_buf[36];
+    memcpy(matrix6_buf, matrix6_data, 36 * sizeof(float));
+    matrixInitStatic(&matrix, matrix6_buf, 6, 6);
+    assert_float_equal(matrixDetStatic(&matrix), -0.0154140f, 1e-6);
+    assert_memory_equal(matrix6_buf, matrix6_data, 36 * sizeof(float));
     /* Check rows != columns */
     matrixInitStatic(&matrix2, matrix2_data, 1, 4);
     assert_float_equal(matrixDetStatic(&matrix2), 0, 1e-5);
@@ -455,6 +604,7 @@ static void test_matrixInversedStatic(void** state) {
     assert_float_equal(result.data[13], 0.167199, 1e-5);
     assert_float_equal(result.data[14], -4.399540, 1e-5);
     assert_float_equal(result.data[15], -2.813918, 1e-5);
+    checkSmallAndLargeInversion(matrixInversedStatic);
 }
 
 static void test_matrixInversedStatic_rob(void** state) {
@@ -497,6 +647,47 @@ static void test_matrixPseudoInvStatic(void** state) {
     assert_float_equal(result.data[3], -0.5f, 1e-5);
 }
 
+static void test_matrixExpm(void** state) {
+    (void)state; /* unused */
+    matrix_t matrix, result;
+    float matrix_data[] = {0.5, -1.2, 0.3, 2.0, -0.7, 1.1, -0.4, 0.9, -1.5};
+    float result_data[9];
+    float workspace[MATRIX_EXPM_WORKSPACE_SIZE(3)];
+    matrixInitStatic(&matrix, matrix_data, 3, 3);
+    matrixInitStatic(&result, result_data, 3, 3);
+    assert_int_equal(matrixExpm(&matrix, &result, workspace), UTILS_STATUS_SUCCESS);
+    assert_float_equal(result.data[0], 0.517653f, 1e-5);
+    assert_float_equal(result.data[1], -0.789203f, 1e-5);
+    assert_float_equal(result.data[2], -0.193767f, 1e-5);
+    assert_float_equal(result.data[3], 1.317958f, 1e-5);
+    assert_float_equal(result.data[4], -0.051452f, 1e-5);
+    assert_float_equal(result.data[5], 0.369052f, 1e-5);
+    assert_float_equal(result.data[6], 0.268836f, 1e-5);
+    assert_float_equal(result.data[7], 0.299093f, 1e-5);
+    assert_float_equal(result.data[8], 0.391893f, 1e-5);
+    /* Check larger norm (more squarings) and in-place calculation */
+    matrixMultScalar(&matrix, 4.0f, &matrix);
+    assert_int_equal(matrixExpm(&matrix, &matrix, workspace), UTILS_STATUS_SUCCESS);
+    assert_float_equal(matrix.data[0], 0.07689f, 1e-4);
+    assert_float_equal(matrix.data[1], 0.79746f, 1e-4);
+    assert_float_equal(matrix.data[2], 0.34154f, 1e-4);
+    assert_float_equal(matrix.data[3], -1.33273f, 1e-4);
+    assert_float_equal(matrix.data[4], 0.56992f, 1e-4);
+    assert_float_equal(matrix.data[5], -0.24083f, 1e-4);
+    assert_float_equal(matrix.data[6], -0.46989f, 1e-4);
+    assert_float_equal(matrix.data[7], -0.19309f, 1e-4);
+    assert_float_equal(matrix.data[8], -0.23939f, 1e-4);
+    /* Check zero matrix */
+    float zero_data[4] = {0, 0, 0, 0};
+    matrixInitStatic(&matrix, zero_data, 2, 2);
+    matrixInitStatic(&result, result_data, 2, 2);
+    assert_int_equal(matrixExpm(&matrix, &result, workspace), UTILS_STATUS_SUCCESS);
+    assert_float_equal(result.data[0], 1.0f, 1e-6);
+    assert_float_equal(result.data[1], 0.0f, 1e-6);
+    assert_float_equal(result.data[2], 0.0f, 1e-6);
+    assert_float_equal(result.data[3], 1.0f, 1e-6);
+}
+
 int main(void) {
     const struct CMUnitTest test_matrix[] = {
         cmocka_unit_test(test_matrixInit),
@@ -519,11 +710,13 @@ int main(void) {
         cmocka_unit_test(test_matrixMult),
         cmocka_unit_test(test_matrixMult_lhsT),
         cmocka_unit_test(test_matrixMult_rhsT),
+        cmocka_unit_test(test_matrixMultStrassen),
         cmocka_unit_test(test_matrixMultScalar),
         cmocka_unit_test(test_matrixTrans),
         cmocka_unit_test(test_matrixNorm),
         cmocka_unit_test(test_matrixNormalized),
         cmocka_unit_test(test_matrixSetAndGet),
+        cmocka_unit_test(test_matrixExpm),
     };
 
     return cmocka_run_group_tests(test_matrix, NULL, NULL);
@@ -149,6 +149,151 @@ static void test_QuadProd(void** state) {
     assert_float_equal(result.data[3], 592.0f, 1e-5);
 }
 
+static void test_LinSolveGaussInPlace(void** state) {
+    (void)state; /* unused */
+    matrix_t A, B;
+    float A_data[] = {0.5432, 0.3171, 0.3816, 0.4898, 0.0462, 0.4358, 0.6651, 0.4456, 0.8235, 0.1324, 0.7952, 0.6463, 0.6948, 0.9745, 0.1869, 0.4456};
+    float B_data[] = {0.7547, 0.1626, 0.3404, 0.2551, 0.2760, 0.1190, 0.5853, 0.5060, 0.6797, 0.4984, 0.2238, 0.6991, 0.6551, 0.9597, 0.7513, 0.8909};
+    matrixInitStatic(&A, A_data, 4, 4);
+    matrixInitStatic(&B, B_data, 4, 4);
+    assert_int_equal(LinSolveGaussInPlace(&A, &B), UTILS_STATUS_SUCCESS);
+    assert_float_equal(B.data[0], -0.142065f, 1e-5);
+    assert_float_equal(B.data[1], 1.492795f, 1e-5);
+    assert_float_equal(B.data[2], -0.310884f, 1e-5);
+    assert_float_equal(B.data[3], 1.097069f, 1e-5);
+    assert_float_equal(B.data[4], -0.318367f, 1e-5);
+    assert_float_equal(B.data[5], 1.098035f, 1e-5);
+    assert_float_equal(B.data[6], 0.753304f, 1e-5);
+    assert_float_equal(B.data[7], 1.084532f, 1e-5);
+    assert_float_equal(B.data[8], -1.344099f, 1e-5);
+    assert_float_equal(B.data[9], 1.503635f, 1e-5);
+    assert_float_equal(B.data[10], 0.079810f, 1e-5);
+    assert_float_equal(B.data[11], 1.904844f, 1e-5);
+    assert_float_equal(B.data[12], 2.951679f, 1e-5);
+    assert_float_equal(B.data[13], -3.205921f, 1e-5);
+    assert_float_equal(B.data[14], 0.489882f, 1e-5);
+    assert_float_equal(B.data[15], -2.882036f, 1e-5);
+
+    /* Check error if matrix is singular */
+    float A2_data[] = {0, 0, 6, 0, 0, 2, 1, 1, 3};
+    float B2_data[] = {12, 7, 9};
+    matrixInitStatic(&A, A2_data, 3, 3);
+    matrixInitStatic(&B, B2_data, 3, 1);
+    assert_int_equal(LinSolveGaussInPlace(&A, &B), UTILS_STATUS_ERROR);
+}
+
+static void test_LinSolveLUPBatch(void** state) {
+    (void)state; /* unused */
+    matrix_t A, B;
+    float A_data[] = {0.5432, 0.3171, 0.3816, 0.4898, 0.0462, 0.4358, 0.6651, 0.4456, 0.8235, 0.1324, 0.7952, 0.6463, 0.6948, 0.9745, 0.1869, 0.4456};
+    float B_data[] = {0.7547, 0.1626, 0.3404, 0.2551, 0.2760, 0.1190, 0.5853, 0.5060};
+    float As_data[6][16], Bs_data[6][8];
+    float A_batch[16 * 6], B_batch[8 * 6];
+    uint8_t singular[6];
+    uint8_t ii, jj, ss;
+
+    /* Systems with rows rotated by s, so that each one needs a different pivoting sequence. Unit tests use 4 lanes, so last tile is partial */
+    for (ss = 0; ss < 6; ss++) {
+        for (ii = 0; ii < 4; ii++) {
+            for (jj = 0; jj < 4; jj++) {
+                As_data[ss][ii * 4 + jj] = A_data[((ii + ss) % 4) * 4 + jj] * (1.0f + ss);
+            }
+            for (jj = 0; jj < 2; jj++) {
+                Bs_data[ss][ii * 2 + jj] = B_data[ii * 2 + jj] - ss;
+            }
+        }
+    }
+    /* System 3 is singular */
+    for (jj = 0; jj < 4; jj++) {
+        As_data[3][2 * 4 + jj] = 0.0f;
+    }
+
+    for (ss = 0; ss < 6; ss++) {
+        for (ii = 0; ii < 16; ii++) {
+            A_batch[ii * 6 + ss] = As_data[ss][ii];
+        }
+        for (ii = 0; ii < 8; ii++) {
+            B_batch[ii * 6 + ss] = Bs_data[ss][ii];
+        }
+    }
+    assert_int_equal(LinSolveLUPBatch(A_batch, B_batch, 4, 2, 6, singular), UTILS_STATUS_ERROR);
+
+    for (ss = 0; ss < 6; ss++) {
+        assert_int_equal(singular[ss], ss == 3);
+        if (ss == 3) {
+            continue;
+        }
+        matrixInitStatic(&A, As_data[ss], 4, 4);
+        matrixInitStatic(&B, Bs_data[ss], 4, 2);
+        assert_int_equal(LinSolveGaussInPlace(&A, &B), UTILS_STATUS_SUCCESS);
+        for (ii = 0; ii < 8; ii++) {
+            assert_float_equal(B_batch[ii * 6 + ss], B.data[ii], 1e-4);
+        }
+    }
+
+    /* All systems regular, no flags requested */
+    float b_data[] = {0.7547, 0.2760, 0.6797, 0.6551};
+    for (ss = 0; ss < 2; ss++) {
+        for (ii = 0; ii < 16; ii++) {
+            A_batch[ii * 2 + ss] = A_data[ii];
+        }
+        for (ii = 0; ii < 4; ii++) {
+            B_batch[ii * 2 + ss] = b_data[ii];
+        }
+    }
+    assert_int_equal(LinSolveLUPBatch(A_batch, B_batch, 4, 1, 2, NULL), UTILS_STATUS_SUCCESS);
+    for (ss = 0; ss < 2; ss++) {
+        assert_float_equal(B_batch[0 * 2 + ss], -0.142065f, 1e-5);
+        assert_float_equal(B_batch[1 * 2 + ss], -0.318367f, 1e-5);
+        assert_float_equal(B_batch[2 * 2 + ss], -1.344099f, 1e-5);
+        assert_float_equal(B_batch[3 * 2 + ss], 2.951679f, 1e-5);
+    }
+}
+
+static void test_DiscretizeZOH(void** state) {
+    (void)state; /* unused */
+    matrix_t A, B, Ad, Bd;
+    float A_data[] = {0, 1, -4, -0.8};
+    float B_data[] = {0, 1};
+    float Ad_data[4], Bd_data[2];
+    float workspace[DISCRETIZE_ZOH_WORKSPACE_SIZE(2, 1)];
+    matrixInitStatic(&A, A_data, 2, 2);
+    matrixInitStatic(&B, B_data, 2, 1);
+    matrixInitStatic(&Ad, Ad_data, 2, 2);
+    matrixInitStatic(&Bd, Bd_data, 2, 1);
+    assert_int_equal(DiscretizeZOH(&A, &B, 50.f, &Ad, &Bd, workspace), UTILS_STATUS_SUCCESS);
+    assert_float_equal(Ad.data[0], 0.9950701f, 1e-5);
+    assert_float_equal(Ad.data[1], 0.0489316f, 1e-5);
+    assert_float_equal(Ad.data[2], -0.1957262f, 1e-5);
+    assert_float_equal(Ad.data[3], 0.9559249f, 1e-5);
+    assert_float_equal(Bd.data[0], 0.0012325f, 1e-6);
+    assert_float_equal(Bd.data[1], 0.0489316f, 1e-5);
+}
+
+static void test_DiscretizeTustin(void** state) {
+    (void)state; /* unused */
+    matrix_t A, B, Ad, Bd;
+    float A_data[] = {0, 1, -4, -0.8};
+    float B_data[] = {0, 1};
+    float Ad_data[4], Bd_data[2];
+    float workspace[DISCRETIZE_TUSTIN_WORKSPACE_SIZE(2, 1)];
+    matrixInitStatic(&A, A_data, 2, 2);
+    matrixInitStatic(&B, B_data, 2, 1);
+    matrixInitStatic(&Ad, Ad_data, 2, 2);
+    matrixInitStatic(&Bd, Bd_data, 2, 1);
+    assert_int_equal(DiscretizeTustin(&A, &B, 50.f, &Ad, &Bd, workspace), UTILS_STATUS_SUCCESS);
+    assert_float_equal(Ad.data[0], 0.99511f, 1e-5);
+    assert_float_equal(Ad.data[1], 0.0488998f, 1e-5);
+    assert_float_equal(Ad.data[2], -0.195599f, 1e-5);
+    assert_float_equal(Ad.data[3], 0.9559902f, 1e-5);
+    assert_float_equal(Bd.data[0], 0.0012225f, 1e-6);
+    assert_float_equal(Bd.data[1], 0.0488998f, 1e-5);
+    /* Check error if (I - A * dT / 2) is singular */
+    float A2_data[] = {40, 0, 0, 0};
+    matrixInitStatic(&A, A2_data, 2, 2);
+    assert_int_equal(DiscretizeTustin(&A, &B, 50.f, &Ad, &Bd, workspace), UTILS_STATUS_ERROR);
+}
+
 static void test_LU_Crout(void** state) {
     (void)state; /* unused */
     matrix_t A, L, U;
@@ -773,6 +918,10 @@ int main(void) {
         cmocka_unit_test(test_bksub),
         cmocka_unit_test(test_bksubPerm),
         cmocka_unit_test(test_QuadProd),
+        cmocka_unit_test(test_LinSolveGaussInPlace),
+        cmocka_unit_test(test_LinSolveLUPBatch),
+        cmocka_unit_test(test_DiscretizeZOH),
+        cmocka_unit_test(test_DiscretizeTustin),
         cmocka_unit_test(test_LU_Crout),
         cmocka_unit_test(test_LU_Cormen),
         cmocka_unit_test(test_LUP_Cormen),